@@ -254,6 +254,10 @@ shared libraries and run with --known-mpi-shared-libraries=1')
     self.framework.saveLog()
     if self.libraries.check(self.dlib, "MPI_Win_create"):
       self.addDefine('HAVE_MPI_WIN_CREATE',1)
+    if self.libraries.check(self.dlib, "MPI_Win_allocate_shared"):
+      self.addDefine('HAVE_MPI_WIN_ALLOCATE_SHARED',1)
+    if self.libraries.check(self.dlib, "MPI_Win_shared_query"):
+      self.addDefine('HAVE_MPI_WIN_SHARED_QUERY',1)
     if self.checkLink('#include <mpi.h>\n', 'MPI_Comm scomm; if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &scomm));\n'):
       self.haveMPISharedComm = 1
       self.addDefine('HAVE_MPI_SHARED_COMM', 1)
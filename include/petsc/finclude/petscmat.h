@@ -30,6 +30,7 @@
 #define MatFactorSchurStatus PetscEnum
 #define MatOrderingType character*(80)
 #define MatSORType PetscEnum
+#define MatSOROrdering PetscEnum
 #define MatInfoType PetscEnum
 #define MatReuse PetscEnum
 #define MatOperation PetscEnum
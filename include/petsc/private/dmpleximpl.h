@@ -214,6 +214,9 @@ typedef struct {
   PetscBool            useHashLocation;   /* Use grid hashing for point location */
   PetscGridHash        lbox;              /* Local box for searching */
 
+  /* Closure */
+  PetscBool            closureCache;      /* Cache the dof indices of cell closures in the section */
+
   /* Debugging */
   PetscBool            printSetValues;
   PetscInt             printFEM;
@@ -632,6 +635,9 @@ PETSC_INTERN PetscErrorCode DMPlexGetIndicesPoint_Internal(PetscSection,PetscInt
 PETSC_INTERN PetscErrorCode DMPlexGetIndicesPointFields_Internal(PetscSection,PetscInt,PetscInt,PetscInt[],PetscBool,const PetscInt***,PetscInt,const PetscInt[],PetscInt[]);
 PETSC_INTERN PetscErrorCode DMPlexGetCompressedClosure(DM, PetscSection, PetscInt, PetscInt *, PetscInt **, PetscSection *, IS *, const PetscInt **);
 PETSC_INTERN PetscErrorCode DMPlexRestoreCompressedClosure(DM, PetscSection, PetscInt, PetscInt *, PetscInt **, PetscSection *, IS *, const PetscInt **);
+PETSC_INTERN PetscErrorCode DMPlexGetClosureIndices_Internal(DM, PetscSection, PetscSection, PetscInt, PetscInt *, PetscInt **, PetscInt *);
+PETSC_INTERN PetscErrorCode DMPlexGetClosureDofIndex_Internal(DM, PetscSection, PetscInt, PetscInt *, const PetscInt *[]);
+PETSC_INTERN PetscErrorCode DMPlexGetClosureGlobalDofIndex_Internal(DM, PetscSection, PetscSection, PetscInt, PetscInt *, const PetscInt *[]);
 
 PETSC_EXTERN PetscErrorCode DMSNESGetFEGeom(DMField, IS, PetscQuadrature, PetscBool, PetscFEGeom **);
 PETSC_EXTERN PetscErrorCode DMSNESRestoreFEGeom(DMField, IS, PetscQuadrature, PetscBool, PetscFEGeom **);
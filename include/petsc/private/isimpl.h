@@ -111,12 +111,26 @@ struct _p_PetscSection {
   PetscInt                      clSize;       /* The size of a dof closure of a cell, when it is uniform */
   PetscInt                     *clPerm;       /* A permutation of the cell dof closure, of size clSize */
   PetscInt                     *clInvPerm;    /* The inverse of clPerm */
+  PetscObject                   clIdxObj;     /* Key for the closure dof index cache */
+  PetscObjectState              clIdxState;   /* Topology state of clIdxObj when the cache was built */
+  PetscInt                      clIdxStart;   /* The cached points are [clIdxStart, clIdxEnd) */
+  PetscInt                      clIdxEnd;
+  PetscInt                     *clIdxOff;     /* Offset of the closure of each cached point into clIdx, or NULL if the closures cannot be cached */
+  PetscInt                     *clIdx;        /* Local dof indices in closure order, constrained dofs are encoded as -(off+1) */
+  PetscSection                  clIdxGSec;    /* The global section used to compute clIdxGlobal */
+  PetscObjectState              clIdxGState;  /* The state of clIdxGSec when clIdxGlobal was computed */
+  PetscInt                     *clIdxGlobal;  /* Global dof indices in closure order, laid out like clIdx */
   PetscSectionSym               sym;          /* Symmetries of the data */
 };
 
 PETSC_EXTERN PetscErrorCode PetscSectionSetClosurePermutation_Internal(PetscSection, PetscObject, PetscInt, PetscCopyMode, PetscInt *);
 PETSC_EXTERN PetscErrorCode PetscSectionGetClosurePermutation_Internal(PetscSection, PetscObject, PetscInt *, const PetscInt *[]);
 PETSC_EXTERN PetscErrorCode PetscSectionGetClosureInversePermutation_Internal(PetscSection, PetscObject, PetscInt *, const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode PetscSectionSetClosureDofIndex_Internal(PetscSection, PetscObject, PetscObjectState, PetscInt, PetscInt, PetscInt *, PetscInt *);
+PETSC_EXTERN PetscErrorCode PetscSectionGetClosureDofIndex_Internal(PetscSection, PetscObject, PetscObjectState, PetscBool *, PetscInt *, PetscInt *, const PetscInt *[], const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode PetscSectionSetClosureGlobalDofIndex_Internal(PetscSection, PetscSection, PetscInt *);
+PETSC_EXTERN PetscErrorCode PetscSectionGetClosureGlobalDofIndex_Internal(PetscSection, PetscSection, const PetscInt *[]);
+PETSC_EXTERN PetscErrorCode PetscSectionResetClosureDofIndex_Internal(PetscSection);
 
 struct _PetscSectionSymOps {
   PetscErrorCode (*getpoints)(PetscSectionSym,PetscSection,PetscInt,const PetscInt *,const PetscInt **,const PetscScalar **);
@@ -79,6 +79,16 @@ PETSC_EXTERN PetscErrorCode PetscEventPerfLogDeactivate(PetscEventPerfLog, Petsc
 PETSC_EXTERN PetscErrorCode PetscEventPerfLogActivateClass(PetscEventPerfLog, PetscEventRegLog, PetscClassId);
 PETSC_EXTERN PetscErrorCode PetscEventPerfLogDeactivateClass(PetscEventPerfLog, PetscEventRegLog, PetscClassId);
 
+/* Hardware counters: cycles, instructions and last level cache misses */
+#define PETSC_LOG_HW_NUM 3
+PETSC_INTERN PetscErrorCode PetscLogHWCountersBegin_Internal(void);
+PETSC_INTERN PetscErrorCode PetscLogHWCountersEnd_Internal(void);
+PETSC_INTERN PetscErrorCode PetscLogHWCountersGet_Internal(PetscLogDouble[]);
+PETSC_INTERN PetscErrorCode PetscLogHWCountersGetInfo_Internal(PetscBool[],PetscLogDouble*);
+
+/* Timeline in the Chrome trace event format */
+PETSC_INTERN PetscErrorCode PetscLogChromeTraceEnd_Internal(void);
+
 /* Logging functions */
 PETSC_EXTERN PetscErrorCode PetscLogEventBeginDefault(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject);
 PETSC_EXTERN PetscErrorCode PetscLogEventEndDefault(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject);
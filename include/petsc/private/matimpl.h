@@ -366,6 +366,45 @@ typedef struct {
 } Mat_CompressedRow;
 PETSC_EXTERN PetscErrorCode MatCheckCompressedRow(Mat,PetscInt,Mat_CompressedRow*,PetscInt*,PetscInt,PetscReal);
 
+/* Assembly plan built by MatSetPreallocationCOO() and used by MatSetValuesCOO() */
+typedef struct _n_Mat_COO *Mat_COO;
+struct _n_Mat_COO {
+  PetscInt    n;              /* number of COO entries provided on this process */
+  PetscInt    nown;           /* number of COO entries (from all processes) owned by this process */
+  PetscSF     sf;             /* leaves are the user entries, roots are the owned entries; NULL for sequential matrices */
+  PetscScalar *buf;           /* values of the owned entries, root space of sf */
+  PetscInt    nslots;         /* number of matrix storage locations addressed by the plan */
+  PetscInt    *jmap;          /* the values perm[jmap[t]] ... perm[jmap[t+1]-1] are summed into storage location t */
+  PetscInt    *perm;          /* indices into the user values (sf == NULL) or into buf */
+};
+PETSC_INTERN PetscErrorCode MatCOOCreate_Private(Mat,PetscInt,const PetscInt[],const PetscInt[],Mat_COO*,PetscInt**,PetscInt**);
+PETSC_INTERN PetscErrorCode MatCOOBuildCSR_Private(Mat,Mat_COO,PetscInt,const PetscInt[],const PetscInt[],PetscInt**,PetscInt**);
+PETSC_INTERN PetscErrorCode MatCOOSetSlots_Private(Mat_COO,PetscInt,const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatCOOGetValues_Private(Mat_COO,const PetscScalar[],const PetscScalar**);
+PETSC_INTERN PetscErrorCode MatCOODestroy_Private(Mat_COO*);
+
+/*
+   Sums the COO values addressed to storage locations [tstart,tstart+nt) of the plan into a[]
+*/
+PETSC_STATIC_INLINE void MatCOOScatter_Private(Mat_COO coo,PetscInt tstart,PetscInt nt,const PetscScalar v[],MatScalar a[],InsertMode imode)
+{
+  const PetscInt *jmap = coo->jmap + tstart,*perm = coo->perm;
+  PetscInt       t,k;
+  PetscScalar    sum;
+
+  if (imode == INSERT_VALUES) {
+    for (t=0; t<nt; t++) {
+      for (sum=0.0,k=jmap[t]; k<jmap[t+1]; k++) sum += v[perm[k]];
+      a[t] = sum;
+    }
+  } else {
+    for (t=0; t<nt; t++) {
+      for (sum=0.0,k=jmap[t]; k<jmap[t+1]; k++) sum += v[perm[k]];
+      a[t] += sum;
+    }
+  }
+}
+
 typedef struct { /* used by MatCreateRedundantMatrix() for reusing matredundant */
   PetscInt     nzlocal,nsends,nrecvs;
   PetscMPIInt  *send_rank,*recv_rank;
@@ -1718,6 +1757,10 @@ PETSC_EXTERN PetscLogEvent MATMFFD_Mult;
 PETSC_EXTERN PetscLogEvent MAT_GetMultiProcBlock;
 PETSC_EXTERN PetscLogEvent MAT_CUSPARSECopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_SetValuesBatch;
+PETSC_EXTERN PetscLogEvent MAT_PreallCOO;
+PETSC_EXTERN PetscLogEvent MAT_SetValuesCOO;
+PETSC_EXTERN PetscLogEvent MAT_MultInterior;
+PETSC_EXTERN PetscLogEvent MAT_MultBoundary;
 PETSC_EXTERN PetscLogEvent MAT_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_DenseCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_DenseCopyFromGPU;
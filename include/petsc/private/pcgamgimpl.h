@@ -30,6 +30,7 @@ typedef struct gamg_TAG {
   PetscReal threshold_scale;
   PetscInt  current_level; /* stash construction state */
   PetscReal threshold[PETSC_GAMG_MAXLEVELS]; /* common quatity to many AMG methods so keep it up here */
+  PetscBool moved_crs[PETSC_GAMG_MAXLEVELS]; /* coarse operator of the level moved with MatCreateSubMatrix() and not yet a MatPtAP() product */
 
   /* these 4 are all related to the method data and should be in the subctx */
   PetscInt  data_sz;      /* nloc*data_rows*data_cols */
@@ -62,7 +63,7 @@ PetscErrorCode PCGAMGGetDataWithGhosts(Mat, PetscInt, PetscReal[],PetscInt*, Pet
 
 #if defined PETSC_USE_LOG
 #define PETSC_GAMG_USE_LOG
-enum tag {SET1,SET2,GRAPH,GRAPH_MAT,GRAPH_FILTER,GRAPH_SQR,SET4,SET5,SET6,FIND_V,SET7,SET8,SET9,SET10,SET11,SET12,SET13,SET14,SET15,SET16,NUM_SET};
+enum tag {SET1,SET2,GRAPH,GRAPH_MAT,GRAPH_FILTER,GRAPH_SQR,SET4,SET5,SET6,FIND_V,SET7,SET8,SET9,SET10,SET11,SET12,SET13,SET14,SET15,SET16,SET_PTAP_SYM,SET_PTAP_NUM,SET_SMOOTH,NUM_SET};
 #if defined PETSC_GAMG_USE_LOG
 PETSC_EXTERN PetscLogEvent petsc_gamg_setup_events[NUM_SET];
 #endif
@@ -29,6 +29,14 @@ typedef void (*PetscPointJac)(PetscInt, PetscInt, PetscInt,
                               const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
                               const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
                               PetscReal, PetscReal, const PetscReal[], PetscInt, const PetscScalar[], PetscScalar[]);
+typedef void (*PetscPointFuncBatch)(PetscInt, PetscInt, PetscInt, PetscInt,
+                                    const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
+                                    const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
+                                    PetscReal, const PetscReal[], PetscInt, const PetscScalar[], PetscScalar[]);
+typedef void (*PetscPointJacBatch)(PetscInt, PetscInt, PetscInt, PetscInt,
+                                   const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
+                                   const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
+                                   PetscReal, PetscReal, const PetscReal[], PetscInt, const PetscScalar[], PetscScalar[]);
 typedef void (*PetscBdPointFunc)(PetscInt, PetscInt, PetscInt,
                                  const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
                                  const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
@@ -143,6 +151,10 @@ PETSC_EXTERN PetscErrorCode PetscDSSetJacobian(PetscDS, PetscInt, PetscInt,
                                                         const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
                                                         const PetscInt[], const PetscInt[], const PetscScalar[], const PetscScalar[], const PetscScalar[],
                                                         PetscReal, PetscReal, const PetscReal[], PetscInt, const PetscScalar[], PetscScalar[]));
+PETSC_EXTERN PetscErrorCode PetscDSGetResidualBatch(PetscDS, PetscInt, PetscPointFuncBatch *, PetscPointFuncBatch *);
+PETSC_EXTERN PetscErrorCode PetscDSSetResidualBatch(PetscDS, PetscInt, PetscPointFuncBatch, PetscPointFuncBatch);
+PETSC_EXTERN PetscErrorCode PetscDSGetJacobianBatch(PetscDS, PetscInt, PetscInt, PetscPointJacBatch *, PetscPointJacBatch *, PetscPointJacBatch *, PetscPointJacBatch *);
+PETSC_EXTERN PetscErrorCode PetscDSSetJacobianBatch(PetscDS, PetscInt, PetscInt, PetscPointJacBatch, PetscPointJacBatch, PetscPointJacBatch, PetscPointJacBatch);
 PETSC_EXTERN PetscErrorCode PetscDSUseJacobianPreconditioner(PetscDS, PetscBool);
 PETSC_EXTERN PetscErrorCode PetscDSHasJacobianPreconditioner(PetscDS, PetscBool *);
 PETSC_EXTERN PetscErrorCode PetscDSGetJacobianPreconditioner(PetscDS, PetscInt, PetscInt,
@@ -148,6 +148,9 @@ typedef struct {
   PetscLogDouble mallocIncrease;/* How much the maximum malloced space has increased in this event */
   PetscLogDouble mallocSpace;   /* How much the space was malloced and kept during this event */
   PetscLogDouble mallocIncreaseEvent;  /* Maximum of the high water mark with in event minus memory available at the end of the event */
+  PetscLogDouble cycles;        /* The number of CPU cycles counted in this event, with -log_view_hwcounters */
+  PetscLogDouble instructions;  /* The number of instructions retired in this event */
+  PetscLogDouble cacheMisses;   /* The number of last level cache misses in this event */
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
   PetscLogDouble CpuToGpuCount; /* The total number of CPU to GPU copies */
   PetscLogDouble GpuToCpuCount; /* The total number of GPU to CPU copies */
@@ -293,6 +296,7 @@ PETSC_EXTERN PetscErrorCode PetscLogDefaultBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogAllBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogNestedBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogTraceBegin(FILE *);
+PETSC_EXTERN PetscErrorCode PetscLogChromeTraceBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogActions(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogObjects(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogSetThreshold(PetscLogDouble,PetscLogDouble*);
@@ -303,6 +307,7 @@ PETSC_EXTERN PetscErrorCode PetscLogSet(PetscErrorCode (*)(int, int, PetscObject
 PETSC_EXTERN PetscErrorCode PetscLogView(PetscViewer);
 PETSC_EXTERN PetscErrorCode PetscLogViewFromOptions(void);
 PETSC_EXTERN PetscErrorCode PetscLogDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogChromeTraceDump(const char[]);
 
 /* Stage functions */
 PETSC_EXTERN PetscErrorCode PetscLogStageRegister(const char[],PetscLogStage*);
@@ -347,6 +352,8 @@ PETSC_EXTERN PetscLogDouble petsc_wait_all_ct;
 PETSC_EXTERN PetscLogDouble petsc_sum_of_waits_ct;
 
 PETSC_EXTERN PetscBool      PetscLogMemory;
+PETSC_EXTERN PetscBool      PetscLogHWCounters;
+PETSC_EXTERN PetscBool      PetscLogChromeTraceOn; /* true if the MPI waits are recorded for PetscLogChromeTraceDump() */
 
 PETSC_EXTERN PetscBool PetscLogSyncOn;  /* true if logging synchronization is enabled */
 PETSC_EXTERN PetscErrorCode PetscLogEventSynchronize(PetscLogEvent, MPI_Comm);
@@ -449,14 +456,18 @@ PETSC_STATIC_INLINE int PetscMPIParallelComm(MPI_Comm comm)
 #define MPI_Send(buf,count,datatype,dest,tag,comm) \
   ((petsc_send_ct++,0) || PetscMPITypeSize((count),(datatype),(&petsc_send_len)) || MPI_Send((buf),(count),(datatype),(dest),(tag),(comm)))
 
+PETSC_EXTERN int PetscLogChromeTraceMPIWait(MPI_Request*,MPI_Status*);
+PETSC_EXTERN int PetscLogChromeTraceMPIWaitany(int,MPI_Request[],int*,MPI_Status*);
+PETSC_EXTERN int PetscLogChromeTraceMPIWaitall(int,MPI_Request[],MPI_Status[]);
+
 #define MPI_Wait(request,status) \
-  ((petsc_wait_ct++,petsc_sum_of_waits_ct++,0) || MPI_Wait((request),(status)))
+  ((petsc_wait_ct++,petsc_sum_of_waits_ct++,0) || (PetscLogChromeTraceOn ? PetscLogChromeTraceMPIWait((request),(status)) : MPI_Wait((request),(status))))
 
 #define MPI_Waitany(a,b,c,d) \
-  ((petsc_wait_any_ct++,petsc_sum_of_waits_ct++,0) || MPI_Waitany((a),(b),(c),(d)))
+  ((petsc_wait_any_ct++,petsc_sum_of_waits_ct++,0) || (PetscLogChromeTraceOn ? PetscLogChromeTraceMPIWaitany((a),(b),(c),(d)) : MPI_Waitany((a),(b),(c),(d))))
 
 #define MPI_Waitall(count,array_of_requests,array_of_statuses) \
-  ((petsc_wait_all_ct++,petsc_sum_of_waits_ct += (PetscLogDouble) (count),0) || MPI_Waitall((count),(array_of_requests),(array_of_statuses)))
+  ((petsc_wait_all_ct++,petsc_sum_of_waits_ct += (PetscLogDouble) (count),0) || (PetscLogChromeTraceOn ? PetscLogChromeTraceMPIWaitall((count),(array_of_requests),(array_of_statuses)) : MPI_Waitall((count),(array_of_requests),(array_of_statuses))))
 
 #define MPI_Allreduce(sendbuf,recvbuf,count,datatype,op,comm) \
   ((petsc_allreduce_ct += PetscMPIParallelComm((comm)),0) || MPI_Allreduce((sendbuf),(recvbuf),(count),(datatype),(op),(comm)))
@@ -545,6 +556,8 @@ PETSC_STATIC_INLINE int PetscMPIParallelComm(MPI_Comm comm)
 #else  /* ---Logging is turned off --------------------------------------------*/
 
 #define PetscLogMemory                     PETSC_FALSE
+#define PetscLogHWCounters                 PETSC_FALSE
+#define PetscLogChromeTraceOn              PETSC_FALSE
 
 #define PetscLogFlops(n)                   0
 #define PetscGetFlops(a)                   (*(a) = 0.0,0)
@@ -586,6 +599,7 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject,const char[],...);
 #define PetscLogAllBegin()                 0
 #define PetscLogNestedBegin()              0
 #define PetscLogTraceBegin(file)           0
+#define PetscLogChromeTraceBegin()         0
 #define PetscLogActions(a)                 0
 #define PetscLogObjects(a)                 0
 #define PetscLogSetThreshold(a,b)          0
@@ -594,6 +608,7 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject,const char[],...);
 #define PetscLogView(viewer)               0
 #define PetscLogViewFromOptions()          0
 #define PetscLogDump(c)                    0
+#define PetscLogChromeTraceDump(c)         0
 
 #define PetscLogEventSync(e,comm)          0
 #define PetscLogEventBegin(e,o1,o2,o3,o4)  0
@@ -49,6 +49,9 @@ typedef const char* MatType;
 #define MATAIJSELL         "aijsell"
 #define MATSEQAIJSELL      "seqaijsell"
 #define MATMPIAIJSELL      "mpiaijsell"
+#define MATAIJOMP          "aijomp"
+#define MATSEQAIJOMP       "seqaijomp"
+#define MATMPIAIJOMP       "mpiaijomp"
 #define MATAIJMKL          "aijmkl"
 #define MATSEQAIJMKL       "seqaijmkl"
 #define MATMPIAIJMKL       "mpiaijmkl"
@@ -233,6 +236,11 @@ PETSC_EXTERN PetscErrorCode MatCreateBAIJMKL(MPI_Comm,PetscInt,PetscInt,PetscInt
 PETSC_EXTERN PetscErrorCode MatCreateSeqBAIJMKL(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,const PetscInt[],Mat*);
 #endif
 
+#if defined PETSC_HAVE_OPENMP
+PETSC_EXTERN PetscErrorCode MatCreateSeqAIJOMP(MPI_Comm,PetscInt,PetscInt,PetscInt,const PetscInt[],Mat*);
+PETSC_EXTERN PetscErrorCode MatCreateMPIAIJOMP(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,PetscInt,const PetscInt[],PetscInt,const PetscInt[],Mat*);
+#endif
+
 PETSC_EXTERN PetscErrorCode MatCreateSeqSELL(MPI_Comm,PetscInt,PetscInt,PetscInt,const PetscInt[],Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateSELL(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,PetscInt,const PetscInt[],PetscInt,const PetscInt[],Mat*);
 PETSC_EXTERN PetscErrorCode MatSeqSELLSetPreallocation(Mat,PetscInt,const PetscInt[]);
@@ -324,6 +332,8 @@ PETSC_EXTERN PetscErrorCode MatSetValuesBlocked(Mat,PetscInt,const PetscInt[],Pe
 PETSC_EXTERN PetscErrorCode MatSetValuesRow(Mat,PetscInt,const PetscScalar[]);
 PETSC_EXTERN PetscErrorCode MatSetValuesRowLocal(Mat,PetscInt,const PetscScalar[]);
 PETSC_EXTERN PetscErrorCode MatSetValuesBatch(Mat,PetscInt,PetscInt,PetscInt[],const PetscScalar[]);
+PETSC_EXTERN PetscErrorCode MatSetPreallocationCOO(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_EXTERN PetscErrorCode MatSetValuesCOO(Mat,const PetscScalar[],InsertMode);
 PETSC_EXTERN PetscErrorCode MatSetRandom(Mat,PetscRandom);
 
 /*S
@@ -597,6 +607,7 @@ PETSC_EXTERN PetscErrorCode MatGetGhosts(Mat, PetscInt *,const PetscInt *[]);
 PETSC_EXTERN PetscErrorCode MatIncreaseOverlap(Mat,PetscInt,IS[],PetscInt);
 PETSC_EXTERN PetscErrorCode MatIncreaseOverlapSplit(Mat mat,PetscInt n,IS is[],PetscInt ov);
 PETSC_EXTERN PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat,PetscBool);
+PETSC_EXTERN PetscErrorCode MatMPIAIJSetMultSplit(Mat,PetscBool);
 
 PETSC_EXTERN PetscErrorCode MatMatMult(Mat,Mat,MatReuse,PetscReal,Mat*);
 PETSC_EXTERN PetscErrorCode MatMatMultSymbolic(Mat,Mat,PetscReal,Mat*);
@@ -1204,6 +1215,23 @@ typedef enum {SOR_FORWARD_SWEEP=1,SOR_BACKWARD_SWEEP=2,SOR_SYMMETRIC_SWEEP=3,
               SOR_EISENSTAT=32,SOR_APPLY_UPPER=64,SOR_APPLY_LOWER=128} MatSORType;
 PETSC_EXTERN PetscErrorCode MatSOR(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
 
+/*E
+    MatSOROrdering - The order in which MatSOR() relaxes the local rows
+
+    Level: intermediate
+
+   Any additions/changes here MUST also be made in include/petsc/finclude/petscmat.h
+
+$  MAT_SOR_ORDERING_NATURAL - rows are relaxed in their natural order
+$  MAT_SOR_ORDERING_MULTICOLOR - rows are grouped by the colors of a coloring of the local matrix graph,
+$                                all the rows of one color are relaxed together (with threads and SIMD)
+
+.seealso: MatSetSOROrdering(), MatSOR(), PCSORSetOrdering()
+E*/
+typedef enum {MAT_SOR_ORDERING_NATURAL,MAT_SOR_ORDERING_MULTICOLOR} MatSOROrdering;
+PETSC_EXTERN const char *const MatSOROrderings[];
+PETSC_EXTERN PetscErrorCode MatSetSOROrdering(Mat,MatSOROrdering);
+
 /*
     These routines are for efficiently computing Jacobians via finite differences.
 */
@@ -1588,8 +1616,14 @@ PETSC_EXTERN PetscErrorCode MatShellSetManageScalingShifts(Mat);
    be stored in a way natural for the matrix, for example dense matrices
    would be stored as dense. Matrices stored this way may only be
    read into matrices of the same type.
+
+   With PetscViewerPushFormat(viewer,PETSC_VIEWER_BINARY_MMAP) sequential AIJ matrices
+   keep their CSR arrays in the byte order of the machine, aligned so that MatLoad()
+   can map them from the file without copying (see -matload_mmap). Such files can
+   only be loaded into MATSEQAIJ matrices on machines with the same byte order.
 */
 #define MATRIX_BINARY_FORMAT_DENSE -1
+#define MATRIX_BINARY_FORMAT_AIJ_NATIVE -2
 
 PETSC_EXTERN PetscErrorCode MatMPIBAIJSetHashTableFactor(Mat,PetscReal);
 
@@ -119,6 +119,8 @@ PETSC_EXTERN PetscErrorCode PCSORSetOmega(PC,PetscReal);
 PETSC_EXTERN PetscErrorCode PCSORGetOmega(PC,PetscReal*);
 PETSC_EXTERN PetscErrorCode PCSORSetIterations(PC,PetscInt,PetscInt);
 PETSC_EXTERN PetscErrorCode PCSORGetIterations(PC,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode PCSORSetOrdering(PC,MatSOROrdering);
+PETSC_EXTERN PetscErrorCode PCSORGetOrdering(PC,MatSOROrdering*);
 
 PETSC_EXTERN PetscErrorCode PCEisenstatSetOmega(PC,PetscReal);
 PETSC_EXTERN PetscErrorCode PCEisenstatGetOmega(PC,PetscReal*);
@@ -302,6 +302,7 @@ typedef const char* TSTrajectoryType;
 #define TSTRAJECTORYSINGLEFILE    "singlefile"
 #define TSTRAJECTORYMEMORY        "memory"
 #define TSTRAJECTORYVISUALIZATION "visualization"
+#define TSTRAJECTORYASYNC         "async"
 
 PETSC_EXTERN PetscFunctionList TSTrajectoryList;
 PETSC_EXTERN PetscClassId      TSTRAJECTORY_CLASSID;
@@ -52,10 +52,14 @@ PETSC_EXTERN PetscErrorCode PetscViewerBinaryGetFlowControl(PetscViewer,PetscInt
 PETSC_EXTERN PetscErrorCode PetscViewerBinarySetFlowControl(PetscViewer,PetscInt);
 PETSC_EXTERN PetscErrorCode PetscViewerBinarySetUseMPIIO(PetscViewer,PetscBool);
 PETSC_EXTERN PetscErrorCode PetscViewerBinaryGetUseMPIIO(PetscViewer,PetscBool *);
+PETSC_EXTERN PetscErrorCode PetscViewerBinarySetMPIIOAggregation(PetscViewer,PetscInt,PetscInt);
+PETSC_EXTERN PetscErrorCode PetscViewerBinaryGetMPIIOAggregation(PetscViewer,PetscInt*,PetscInt*);
 #if defined(PETSC_HAVE_MPIIO)
 PETSC_EXTERN PetscErrorCode PetscViewerBinaryGetMPIIODescriptor(PetscViewer,MPI_File*);
 PETSC_EXTERN PetscErrorCode PetscViewerBinaryGetMPIIOOffset(PetscViewer,MPI_Offset*);
 PETSC_EXTERN PetscErrorCode PetscViewerBinaryAddMPIIOOffset(PetscViewer,MPI_Offset);
+PETSC_EXTERN PetscErrorCode PetscViewerBinaryWriteAllMPIIO(PetscViewer,void*,PetscInt,PetscInt,PetscInt,PetscDataType);
+PETSC_EXTERN PetscErrorCode PetscViewerBinaryReadAllMPIIO(PetscViewer,void*,PetscInt,PetscInt,PetscInt,PetscDataType);
 #endif
 
 PETSC_EXTERN PetscErrorCode PetscViewerSocketOpen(MPI_Comm,const char[],int,PetscViewer*);
@@ -151,7 +155,8 @@ typedef enum {
   PETSC_VIEWER_HDF5_XDMF,
   PETSC_VIEWER_HDF5_MAT,
   PETSC_VIEWER_NOFORMAT,
-  PETSC_VIEWER_LOAD_BALANCE
+  PETSC_VIEWER_LOAD_BALANCE,
+  PETSC_VIEWER_BINARY_MMAP
   } PetscViewerFormat;
 PETSC_EXTERN const char *const PetscViewerFormats[];
 
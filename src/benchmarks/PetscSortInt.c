@@ -0,0 +1,88 @@
+static char help[] = "Compares the quicksort and the radix sort of PetscSortInt() and PetscSortIntWithArray() on index distributions\n\
+found in PETSc: random global indices, element connectivity, sorted and reversed runs, many duplicates and negative\n\
+(ignored) entries.\n\
+  -n <length of the arrays>, default=1000000\n\
+  -r <repeat times for each sort>, default=5\n\n";
+
+#include <petscsys.h>
+#include <petsctime.h>
+
+#define NDIST 6
+static const char *names[NDIST] = {"random","connectivity","sorted","reversed","duplicates","negatives"};
+
+static PetscErrorCode FillIndices(PetscInt dist,PetscInt n,PetscRandom rdm,PetscInt X[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscReal      val;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    ierr = PetscRandomGetValueReal(rdm,&val);CHKERRQ(ierr);
+    switch (dist) {
+    case 0: X[i] = (PetscInt)(val*100*(PetscReal)n); break;        /* global indices spread over a much larger space */
+    case 1: X[i] = i/8 + (PetscInt)(val*64); break;                /* vertices of hexahedra numbered close to the cell */
+    case 2: X[i] = i; break;
+    case 3: X[i] = n-i; break;
+    case 4: X[i] = (PetscInt)(val*(n/16)); break;                  /* each value about 16 times */
+    case 5: X[i] = val < 0.1 ? -1 : (PetscInt)(val*(PetscReal)n); break; /* off-process entries marked -1 */
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Time one sort with the given radix thresholds, check the result is sorted and return the mean time */
+static PetscErrorCode TimeSort(PetscInt dist,PetscInt n,PetscInt r,PetscInt radix,PetscInt threads,PetscBool witharray,PetscRandom rdm,PetscInt X[],PetscInt Y[],PetscLogDouble *time)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l;
+
+  PetscFunctionBegin;
+  ierr  = PetscSortSetRadixThresholds(radix,threads);CHKERRQ(ierr);
+  *time = 0.0;
+  for (l=0; l<r; l++) {
+    ierr = FillIndices(dist,n,rdm,X);CHKERRQ(ierr);
+    for (i=0; i<n; i++) Y[i] = X[i];
+    ierr = PetscTimeSubtract(time);CHKERRQ(ierr);
+    if (witharray) {ierr = PetscSortIntWithArray(n,X,Y);CHKERRQ(ierr);}
+    else           {ierr = PetscSortInt(n,X);CHKERRQ(ierr);}
+    ierr = PetscTimeAdd(time);CHKERRQ(ierr);
+    for (i=0; i<n-1; i++) if (X[i] > X[i+1]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Result of the %s distribution is not sorted",names[dist]);
+    if (witharray) for (i=0; i<n; i++) if (X[i] != Y[i]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Companion array of the %s distribution does not follow the keys",names[dist]);
+  }
+  *time /= r;
+  ierr = PetscSortSetRadixThresholds(PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = 1000000,r = 5,dist,*X,*Y;
+  PetscBool      witharray;
+  PetscLogDouble tq,tr,tt;
+  PetscRandom    rdm;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-r",&r,NULL);CHKERRQ(ierr);
+  if (n < 1 || r < 1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Need n >= 1 and r >= 1, not n=%D r=%D",n,r);
+  ierr = PetscMalloc2(n,&X,n,&Y);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rdm);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rdm);CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Sorting %D integers, mean of %D runs, in seconds\n",n,r);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%-24s %-13s %12s %12s %12s %8s\n","Routine","Distribution","Quicksort","Radix","Radix+OMP","Speedup");CHKERRQ(ierr);
+  for (witharray=PETSC_FALSE; witharray<=PETSC_TRUE; witharray++) {
+    for (dist=0; dist<NDIST; dist++) {
+      ierr = TimeSort(dist,n,r,-1,-1,witharray,rdm,X,Y,&tq);CHKERRQ(ierr);
+      ierr = TimeSort(dist,n,r,0,-1,witharray,rdm,X,Y,&tr);CHKERRQ(ierr);
+      ierr = TimeSort(dist,n,r,0,0,witharray,rdm,X,Y,&tt);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%-24s %-13s %12.4e %12.4e %12.4e %8.2f\n",witharray ? "PetscSortIntWithArray()" : "PetscSortInt()",names[dist],tq,tr,tt,tq/PetscMin(tr,tt));CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscRandomDestroy(&rdm);CHKERRQ(ierr);
+  ierr = PetscFree2(X,Y);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -375,6 +375,263 @@ PetscErrorCode PetscFEIntegrateBd_Basic(PetscDS ds, PetscInt field,
   PetscFunctionReturn(0);
 }
 
+/*
+  Batched integration: the pointwise functions set with PetscDSSetResidualBatch() and PetscDSSetJacobianBatch() are called once
+  for all the quadrature points of a batch of cells, in struct-of-arrays layout, so that the loop over points inside them vectorizes.
+  The batch size is the PetscFE batchSize from PetscFEGetTileSizes(), which DMPlex sets from -petscfe_num_blocks.
+*/
+static PetscErrorCode PetscFEGetBatchGeometry_Basic(PetscFEGeom *cgeom, PetscInt e, PetscInt q, PetscReal v[], PetscFEGeom *fegeom)
+{
+  const PetscInt dE = cgeom->dimEmbed, Np = cgeom->numPoints;
+
+  PetscFunctionBegin;
+  if (cgeom->isAffine) {
+    fegeom->v    = v;
+    fegeom->xi   = cgeom->xi;
+    fegeom->J    = &cgeom->J[e*dE*dE];
+    fegeom->invJ = &cgeom->invJ[e*dE*dE];
+    fegeom->detJ = &cgeom->detJ[e];
+  } else {
+    fegeom->v    = &cgeom->v[(e*Np+q)*dE];
+    fegeom->J    = &cgeom->J[(e*Np+q)*dE*dE];
+    fegeom->invJ = &cgeom->invJ[(e*Np+q)*dE*dE];
+    fegeom->detJ = &cgeom->detJ[e*Np+q];
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Evaluate the fields, auxiliary fields and coordinates at the quadrature points of cells [eStart, eEnd) in struct-of-arrays
+   layout, with point p = (e-eStart)*Nq+q, and the quadrature weights times the Jacobian determinant */
+static PetscErrorCode PetscFEEvaluateBatch_Basic(PetscDS ds, PetscDS dsAux, PetscQuadrature quad, PetscInt eStart, PetscInt eEnd, PetscFEGeom *cgeom,
+                                                 const PetscScalar coefficients[], const PetscScalar coefficients_t[], const PetscScalar coefficientsAux[],
+                                                 PetscScalar u[], PetscScalar u_t[], PetscScalar u_x[], PetscScalar a[], PetscScalar a_x[], PetscReal x[], PetscReal w[])
+{
+  PetscScalar     *uq, *u_tq = NULL, *u_xq, *aq = NULL, *a_xq = NULL;
+  PetscReal      **B, **D, **BAux = NULL, **DAux = NULL, v[3];
+  PetscInt        *Nb, *Nc, *NbAux = NULL, *NcAux = NULL;
+  PetscInt         dim, dE, Nf, NfAux = 0, totDim, totDimAux = 0, totComp, totCompAux = 0, Nq, Np, e, q, i;
+  const PetscReal *quadPoints, *quadWeights;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetSpatialDimension(ds, &dim);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &totComp);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  ierr = PetscDSGetEvaluationArrays(ds, &uq, coefficients_t ? &u_tq : NULL, &u_xq);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalComponents(dsAux, &totCompAux);CHKERRQ(ierr);
+    ierr = PetscDSGetDimensions(dsAux, &NbAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponents(dsAux, &NcAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTabulation(dsAux, &BAux, &DAux);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &aq, NULL, &a_xq);CHKERRQ(ierr);
+  }
+  ierr = PetscQuadratureGetData(quad, NULL, NULL, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  Np = (eEnd - eStart)*Nq;
+  dE = cgeom->dimEmbed;
+  for (e = eStart; e < eEnd; ++e) {
+    for (q = 0; q < Nq; ++q) {
+      const PetscInt p = (e - eStart)*Nq + q;
+      PetscFEGeom    fegeom;
+
+      ierr = PetscFEGetBatchGeometry_Basic(cgeom, e, q, v, &fegeom);CHKERRQ(ierr);
+      if (cgeom->isAffine) CoordinatesRefToReal(dE, dim, fegeom.xi, &cgeom->v[e*dE], fegeom.J, &quadPoints[q*dim], v);
+      w[p] = fegeom.detJ[0]*quadWeights[q];
+      for (i = 0; i < dE; ++i) x[i*Np+p] = fegeom.v[i];
+      if (coefficients) {
+        ierr = PetscFEEvaluateFieldJets_Internal(ds, dim, Nf, Nb, Nc, q, B, D, &fegeom, &coefficients[e*totDim], coefficients_t ? &coefficients_t[e*totDim] : NULL, uq, u_xq, u_tq);CHKERRQ(ierr);
+        for (i = 0; i < totComp; ++i)     u[i*Np+p]   = uq[i];
+        for (i = 0; i < totComp*dim; ++i) u_x[i*Np+p] = u_xq[i];
+        if (u_tq) for (i = 0; i < totComp; ++i) u_t[i*Np+p] = u_tq[i];
+      }
+      if (dsAux) {
+        ierr = PetscFEEvaluateFieldJets_Internal(dsAux, dim, NfAux, NbAux, NcAux, q, BAux, DAux, &fegeom, &coefficientsAux[e*totDimAux], NULL, aq, a_xq, NULL);CHKERRQ(ierr);
+        for (i = 0; i < totCompAux; ++i)     a[i*Np+p]   = aq[i];
+        for (i = 0; i < totCompAux*dim; ++i) a_x[i*Np+p] = a_xq[i];
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Allocate the struct-of-arrays evaluation arrays for batches of Eb cells */
+static PetscErrorCode PetscFEGetBatchArrays_Basic(PetscDS ds, PetscDS dsAux, PetscInt Eb, PetscInt Nq, PetscScalar **u, PetscScalar **u_t, PetscScalar **u_x, PetscScalar **a, PetscScalar **a_x, PetscReal **x, PetscReal **w)
+{
+  PetscInt       dim, dE, totComp, totCompAux = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetSpatialDimension(ds, &dim);CHKERRQ(ierr);
+  ierr = PetscDSGetCoordinateDimension(ds, &dE);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &totComp);CHKERRQ(ierr);
+  if (dsAux) {ierr = PetscDSGetTotalComponents(dsAux, &totCompAux);CHKERRQ(ierr);}
+  ierr = PetscMalloc7(Eb*Nq*totComp, u, Eb*Nq*totComp, u_t, Eb*Nq*totComp*dim, u_x, Eb*Nq*totCompAux, a, Eb*Nq*totCompAux*dim, a_x, Eb*Nq*dE, x, Eb*Nq, w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEIntegrateResidual_Basic_Batch(PetscDS ds, PetscInt field, PetscPointFuncBatch f0_func, PetscPointFuncBatch f1_func, PetscInt Ne, PetscFEGeom *cgeom,
+                                                           const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
+{
+  PetscFE            fe;
+  PetscQuadrature    quad;
+  PetscScalar       *f0, *f1, *f0q, *f1q, *u, *u_t, *u_x, *a, *a_x, *ut, *aa, *ax, *basisReal, *basisDerReal;
+  const PetscScalar *constants;
+  PetscReal         *x, *w, **B, **D, v[3];
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, totDim, fOffset, NbI, NcI, Nq, Eb, eStart, e, q, c, d, p;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (!Ne) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscFEGetTileSizes(fe, NULL, NULL, &Eb, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, field, &fOffset);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, NULL, &basisReal, &basisDerReal, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, &f0q, &f1q, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+  }
+  ierr = PetscQuadratureGetData(quad, NULL, NULL, &Nq, NULL, NULL);CHKERRQ(ierr);
+  NbI = Nb[field];
+  NcI = Nc[field];
+  if (Eb <= 0 || Eb > Ne) Eb = Ne;
+  ierr = PetscFEGetBatchArrays_Basic(ds, dsAux, Eb, Nq, &u, &u_t, &u_x, &a, &a_x, &x, &w);CHKERRQ(ierr);
+  ierr = PetscMalloc2(Eb*Nq*NcI, &f0, Eb*Nq*NcI*dim, &f1);CHKERRQ(ierr);
+  ut = coefficients_t ? u_t : NULL;
+  aa = dsAux ? a   : NULL;
+  ax = dsAux ? a_x : NULL;
+  for (eStart = 0; eStart < Ne; eStart += Eb) {
+    const PetscInt eEnd = PetscMin(eStart + Eb, Ne), Np = (eEnd - eStart)*Nq;
+
+    ierr = PetscFEEvaluateBatch_Basic(ds, dsAux, quad, eStart, eEnd, cgeom, coefficients, coefficients_t, coefficientsAux, u, ut, u_x, aa, ax, x, w);CHKERRQ(ierr);
+    ierr = PetscArrayzero(f0, Np*NcI);CHKERRQ(ierr);
+    ierr = PetscArrayzero(f1, Np*NcI*dim);CHKERRQ(ierr);
+    if (f0_func) {
+      f0_func(dim, Nf, NfAux, Np, uOff, uOff_x, u, ut, u_x, aOff, aOff_x, aa, NULL, ax, t, x, numConstants, constants, f0);
+      for (c = 0; c < NcI; ++c) for (p = 0; p < Np; ++p) f0[c*Np+p] *= w[p];
+    }
+    if (f1_func) {
+      f1_func(dim, Nf, NfAux, Np, uOff, uOff_x, u, ut, u_x, aOff, aOff_x, aa, NULL, ax, t, x, numConstants, constants, f1);
+      for (c = 0; c < NcI*dim; ++c) for (p = 0; p < Np; ++p) f1[c*Np+p] *= w[p];
+    }
+    for (e = eStart; e < eEnd; ++e) {
+      PetscFEGeom fegeom;
+
+      /* Gather the integrands of the cell back into the pointwise layout */
+      for (q = 0; q < Nq; ++q) {
+        p = (e - eStart)*Nq + q;
+        for (c = 0; c < NcI; ++c) {
+          f0q[q*NcI+c] = f0[c*Np+p];
+          for (d = 0; d < dim; ++d) f1q[(q*NcI+c)*dim+d] = f1[(c*dim+d)*Np+p];
+        }
+      }
+      ierr = PetscFEGetBatchGeometry_Basic(cgeom, e, 0, v, &fegeom);CHKERRQ(ierr);
+      ierr = PetscFEUpdateElementVec_Internal(fe, dim, Nq, NbI, NcI, B[field], D[field], basisReal, basisDerReal, &fegeom, f0q, f1q, &elemVec[e*totDim+fOffset]);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree2(f0, f1);CHKERRQ(ierr);
+  ierr = PetscFree7(u, u_t, u_x, a, a_x, x, w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscFEIntegrateJacobian_Basic_Batch(PetscDS ds, PetscInt fieldI, PetscInt fieldJ, PetscPointJacBatch g_func[], PetscInt Ne, PetscFEGeom *cgeom,
+                                                           const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, PetscScalar elemMat[])
+{
+  PetscFE            feI, feJ;
+  PetscQuadrature    quad;
+  PetscScalar       *g[4], *gq[4], *u, *u_t, *u_x, *a, *a_x, *ut, *aa, *ax, *basisReal, *basisDerReal, *testReal, *testDerReal;
+  const PetscScalar *constants;
+  PetscReal         *x, *w, **B, **D, v[3];
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nb, *Nc, gSize[4];
+  PetscInt           dim, numConstants, Nf, NfAux = 0, totDim, offsetI, offsetJ, NbI, NcI, NbJ, NcJ, Nq, Eb, eStart, e, q, i, k, p;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (!Ne) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, fieldI, (PetscObject *) &feI);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldJ, (PetscObject *) &feJ);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(feI, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(feI, &quad);CHKERRQ(ierr);
+  ierr = PetscFEGetTileSizes(feI, NULL, NULL, &Eb, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldI, &offsetI);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldJ, &offsetJ);CHKERRQ(ierr);
+  ierr = PetscDSGetTabulation(ds, &B, &D);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, NULL, &basisReal, &basisDerReal, &testReal, &testDerReal);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, NULL, NULL, &gq[0], &gq[1], &gq[2], &gq[3]);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+  }
+  ierr = PetscQuadratureGetData(quad, NULL, NULL, &Nq, NULL, NULL);CHKERRQ(ierr);
+  NbI = Nb[fieldI], NbJ = Nb[fieldJ];
+  NcI = Nc[fieldI], NcJ = Nc[fieldJ];
+  gSize[0] = NcI*NcJ;
+  gSize[1] = NcI*NcJ*dim;
+  gSize[2] = NcI*NcJ*dim;
+  gSize[3] = NcI*NcJ*dim*dim;
+  /* Terms without a function stay zero */
+  for (k = 0; k < 4; ++k) {ierr = PetscArrayzero(gq[k], gSize[k]);CHKERRQ(ierr);}
+  if (Eb <= 0 || Eb > Ne) Eb = Ne;
+  ierr = PetscFEGetBatchArrays_Basic(ds, dsAux, Eb, Nq, &u, &u_t, &u_x, &a, &a_x, &x, &w);CHKERRQ(ierr);
+  ierr = PetscMalloc4(Eb*Nq*gSize[0], &g[0], Eb*Nq*gSize[1], &g[1], Eb*Nq*gSize[2], &g[2], Eb*Nq*gSize[3], &g[3]);CHKERRQ(ierr);
+  ut = coefficients_t ? u_t : NULL;
+  aa = dsAux ? a   : NULL;
+  ax = dsAux ? a_x : NULL;
+  for (eStart = 0; eStart < Ne; eStart += Eb) {
+    const PetscInt eEnd = PetscMin(eStart + Eb, Ne), Np = (eEnd - eStart)*Nq;
+
+    ierr = PetscFEEvaluateBatch_Basic(ds, dsAux, quad, eStart, eEnd, cgeom, coefficients, coefficients_t, coefficientsAux, u, ut, u_x, aa, ax, x, w);CHKERRQ(ierr);
+    for (k = 0; k < 4; ++k) {
+      if (!g_func[k]) continue;
+      ierr = PetscArrayzero(g[k], Np*gSize[k]);CHKERRQ(ierr);
+      g_func[k](dim, Nf, NfAux, Np, uOff, uOff_x, u, ut, u_x, aOff, aOff_x, aa, NULL, ax, t, u_tshift, x, numConstants, constants, g[k]);
+      for (i = 0; i < gSize[k]; ++i) for (p = 0; p < Np; ++p) g[k][i*Np+p] *= w[p];
+    }
+    for (e = eStart; e < eEnd; ++e) {
+      for (q = 0; q < Nq; ++q) {
+        PetscFEGeom fegeom;
+
+        p = (e - eStart)*Nq + q;
+        /* Gather the integrands at the point back into the pointwise layout */
+        for (k = 0; k < 4; ++k) {
+          if (!g_func[k]) continue;
+          for (i = 0; i < gSize[k]; ++i) gq[k][i] = g[k][i*Np+p];
+        }
+        ierr = PetscFEGetBatchGeometry_Basic(cgeom, e, q, v, &fegeom);CHKERRQ(ierr);
+        ierr = PetscFEUpdateElementMat_Internal(feI, feJ, dim, NbI, NcI, &B[fieldI][q*NbI*NcI], &D[fieldI][q*NbI*NcI*dim], basisReal, basisDerReal, NbJ, NcJ, &B[fieldJ][q*NbJ*NcJ], &D[fieldJ][q*NbJ*NcJ*dim], testReal, testDerReal, &fegeom, gq[0], gq[1], gq[2], gq[3], e*PetscSqr(totDim), totDim, offsetI, offsetJ, elemMat);CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = PetscFree4(g[0], g[1], g[2], g[3]);CHKERRQ(ierr);
+  ierr = PetscFree7(u, u_t, u_x, a, a_x, x, w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PetscFEIntegrateResidual_Basic(PetscDS ds, PetscInt field, PetscInt Ne, PetscFEGeom *cgeom,
                                               const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
 {
@@ -382,6 +639,7 @@ PetscErrorCode PetscFEIntegrateResidual_Basic(PetscDS ds, PetscInt field, PetscI
   PetscFE            fe;
   PetscPointFunc     f0_func;
   PetscPointFunc     f1_func;
+  PetscPointFuncBatch f0_batch, f1_batch;
   PetscQuadrature    quad;
   PetscScalar       *f0, *f1, *u, *u_t = NULL, *u_x, *a, *a_x, *basisReal, *basisDerReal;
   const PetscScalar *constants;
@@ -395,6 +653,11 @@ PetscErrorCode PetscFEIntegrateResidual_Basic(PetscDS ds, PetscInt field, PetscI
   PetscErrorCode     ierr;
 
   PetscFunctionBegin;
+  ierr = PetscDSGetResidualBatch(ds, field, &f0_batch, &f1_batch);CHKERRQ(ierr);
+  if (f0_batch || f1_batch) {
+    ierr = PetscFEIntegrateResidual_Basic_Batch(ds, field, f0_batch, f1_batch, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
   ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
   ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
@@ -630,6 +893,15 @@ PetscErrorCode PetscFEIntegrateJacobian_Basic(PetscDS ds, PetscFEJacobianType jt
   PetscErrorCode     ierr;
 
   PetscFunctionBegin;
+  if (jtype == PETSCFE_JACOBIAN) {
+    PetscPointJacBatch g_batch[4];
+
+    ierr = PetscDSGetJacobianBatch(ds, fieldI, fieldJ, &g_batch[0], &g_batch[1], &g_batch[2], &g_batch[3]);CHKERRQ(ierr);
+    if (g_batch[0] || g_batch[1] || g_batch[2] || g_batch[3]) {
+      ierr = PetscFEIntegrateJacobian_Basic_Batch(ds, fieldI, fieldJ, g_batch, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, u_tshift, elemMat);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
   ierr = PetscDSGetDiscretization(ds, fieldI, (PetscObject *) &feI);CHKERRQ(ierr);
   ierr = PetscDSGetDiscretization(ds, fieldJ, (PetscObject *) &feJ);CHKERRQ(ierr);
   ierr = PetscFEGetSpatialDimension(feI, &dim);CHKERRQ(ierr);
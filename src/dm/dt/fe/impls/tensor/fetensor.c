@@ -0,0 +1,720 @@
+#include <petsc/private/petscfeimpl.h> /*I "petscfe.h" I*/
+
+/*
+  Sum factorization for tensor product elements
+
+  On a tensor product cell, the nodal Lagrange element of the tensor polynomial space Q_k has the basis functions
+
+    \psi_{(i_0,...,i_{d-1}),c}(\xi) = l_{i_0}(\xi_0) ... l_{i_{d-1}}(\xi_{d-1}) e_c
+
+  for the 1D Lagrange polynomials l_i on the P = k+1 nodes of one direction. When the quadrature is also a tensor product
+  of a 1D rule with Q points, we store the coefficients of each component as a P^d array, and the values at the quadrature
+  points as a Q^d array, both in lexicographic order with the first coordinate varying slowest. The interpolation to the
+  quadrature points then factors into d contractions with the Q x P matrix B of the 1D basis at the 1D points, one along
+  each axis, and the reference derivative in direction e uses the matrix D of 1D derivatives on axis e instead. Integration
+  against the test functions applies the transposed contractions. This costs O(d P^{d+1}) per element and component, rather
+  than O(P^{2d}) for the dense tabulation.
+
+  The structure is detected from the dual space and the quadrature, and checked against the dense tabulation. When it is
+  missing, for instance on simplices, in a mixed discretization, or for non-Lagrange fields, we use the basic kernels.
+*/
+
+PetscErrorCode PetscFEDestroy_Tensor(PetscFE fem)
+{
+  PetscFE_Tensor *t = (PetscFE_Tensor *) fem->data;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscQuadratureDestroy(&t->quad);CHKERRQ(ierr);
+  ierr = PetscFree2(t->B, t->D);CHKERRQ(ierr);
+  ierr = PetscFree(t->perm);CHKERRQ(ierr);
+  ierr = PetscFree(t);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Find the 1D points of a tensor product quadrature, or return Q = 0 */
+static PetscErrorCode PetscFETensorGetQuadrature1D_Private(PetscQuadrature quad, PetscReal tol, PetscInt *Q, PetscReal **x)
+{
+  const PetscReal *points;
+  PetscInt         dim, qNc, Nq, q, d;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  *Q = 0;
+  *x = NULL;
+  ierr = PetscQuadratureGetData(quad, &dim, &qNc, &Nq, &points, NULL);CHKERRQ(ierr);
+  if (qNc != 1 || Nq < 1 || dim < 1) PetscFunctionReturn(0);
+  for (*Q = 1; PetscPowInt(*Q, dim) < Nq; ++(*Q));
+  if (PetscPowInt(*Q, dim) != Nq) {*Q = 0; PetscFunctionReturn(0);}
+  ierr = PetscMalloc1(*Q, x);CHKERRQ(ierr);
+  for (q = 0; q < *Q; ++q) (*x)[q] = points[q*PetscPowInt(*Q, dim-1)*dim];
+  for (q = 0; q < Nq; ++q) {
+    PetscInt r = q;
+
+    for (d = dim-1; d >= 0; --d, r /= *Q) {
+      if (PetscAbsReal(points[q*dim+d] - (*x)[r % *Q]) > tol) {
+        ierr = PetscFree(*x);CHKERRQ(ierr);
+        *Q   = 0;
+        PetscFunctionReturn(0);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Find the 1D nodes of a tensor product Lagrange dual space and the element dof of each lexicographic node and component, or return P = 0 */
+static PetscErrorCode PetscFETensorGetNodes1D_Private(PetscFE fem, PetscReal tol, PetscInt *P, PetscReal **x, PetscInt **perm)
+{
+  PetscDualSpace   dsp;
+  const PetscReal *points, *weights;
+  PetscReal       *coords;
+  PetscInt        *comp;
+  PetscInt         dim, Nc, pdim, k, Ncoords, b, c, d, i;
+  PetscBool        ok = PETSC_TRUE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  *P    = 0;
+  *x    = NULL;
+  *perm = NULL;
+  ierr = PetscFEGetSpatialDimension(fem, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fem, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fem, &dsp);CHKERRQ(ierr);
+  ierr = PetscDualSpaceGetDimension(dsp, &pdim);CHKERRQ(ierr);
+  ierr = PetscDualSpaceGetDeRahm(dsp, &k);CHKERRQ(ierr);
+  if (k != 0 || pdim % Nc) PetscFunctionReturn(0);
+  for (*P = 1; PetscPowInt(*P, dim) < pdim/Nc; ++(*P));
+  if (PetscPowInt(*P, dim) != pdim/Nc) {*P = 0; PetscFunctionReturn(0);}
+  /* Each functional must be the evaluation of one component at one point */
+  ierr = PetscMalloc2(pdim*dim, &coords, pdim, &comp);CHKERRQ(ierr);
+  ierr = PetscMalloc1(pdim*dim, x);CHKERRQ(ierr);
+  for (b = 0; b < pdim && ok; ++b) {
+    PetscQuadrature f;
+    PetscInt        fNc, fNq, nnz = 0;
+
+    ierr = PetscDualSpaceGetFunctional(dsp, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, &fNc, &fNq, &points, &weights);CHKERRQ(ierr);
+    if (fNq != 1 || (fNc != Nc && fNc != 1) || (fNc == 1 && Nc > 1)) {ok = PETSC_FALSE; break;}
+    for (c = 0; c < fNc; ++c) if (weights[c] != 0.0) {comp[b] = c; ++nnz;}
+    if (nnz != 1) ok = PETSC_FALSE;
+    for (d = 0; d < dim; ++d) coords[b*dim+d] = (*x)[b*dim+d] = points[d];
+  }
+  /* The nodes must lie on a grid of P points in each direction */
+  if (ok) {
+    ierr = PetscSortReal(pdim*dim, *x);CHKERRQ(ierr);
+    for (i = 1, Ncoords = 1; i < pdim*dim; ++i) if ((*x)[i] - (*x)[Ncoords-1] > tol) (*x)[Ncoords++] = (*x)[i];
+    if (Ncoords != *P) ok = PETSC_FALSE;
+  }
+  if (ok) {
+    ierr = PetscMalloc1(pdim, perm);CHKERRQ(ierr);
+    for (b = 0; b < pdim; ++b) (*perm)[b] = -1;
+    for (b = 0; b < pdim && ok; ++b) {
+      PetscInt L = 0;
+
+      for (d = 0; d < dim; ++d) {
+        for (i = 0; i < *P; ++i) if (PetscAbsReal(coords[b*dim+d] - (*x)[i]) <= tol) break;
+        L = L*(*P) + i;
+      }
+      if ((*perm)[L*Nc+comp[b]] >= 0) ok = PETSC_FALSE;
+      else (*perm)[L*Nc+comp[b]] = b;
+    }
+    if (!ok) {ierr = PetscFree(*perm);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree2(coords, comp);CHKERRQ(ierr);
+  if (!ok) {ierr = PetscFree(*x);CHKERRQ(ierr); *P = 0;}
+  PetscFunctionReturn(0);
+}
+
+/* Build the 1D tabulation for the current quadrature, and check that it reproduces the dense tabulation */
+static PetscErrorCode PetscFETensorSetUpKernels_Private(PetscFE fem)
+{
+  PetscFE_Tensor  *t   = (PetscFE_Tensor *) fem->data;
+  const PetscReal  tol = PETSC_SQRT_MACHINE_EPSILON;
+  PetscQuadrature  quad;
+  PetscReal       *xq, *xn, *Bf, *Df;
+  PetscInt         dim, Nc, pdim, P, Q, Nq, Pd, q, L, c, cc, d, e, i, j, m, l;
+  PetscBool        ok = PETSC_TRUE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetQuadrature(fem, &quad);CHKERRQ(ierr);
+  if (quad == t->quad) PetscFunctionReturn(0);
+  ierr = PetscObjectReference((PetscObject) quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureDestroy(&t->quad);CHKERRQ(ierr);
+  ierr = PetscFree2(t->B, t->D);CHKERRQ(ierr);
+  ierr = PetscFree(t->perm);CHKERRQ(ierr);
+  t->quad   = quad;
+  t->tensor = PETSC_FALSE;
+  t->P      = t->Q = 0;
+  if (!quad) PetscFunctionReturn(0);
+  ierr = PetscFEGetSpatialDimension(fem, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fem, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fem, &pdim);CHKERRQ(ierr);
+  ierr = PetscFETensorGetQuadrature1D_Private(quad, tol, &Q, &xq);CHKERRQ(ierr);
+  if (!Q) {ierr = PetscInfo(fem, "Quadrature is not a tensor product, using dense tabulation\n");CHKERRQ(ierr); PetscFunctionReturn(0);}
+  ierr = PetscFETensorGetNodes1D_Private(fem, tol, &P, &xn, &t->perm);CHKERRQ(ierr);
+  if (!P) {
+    ierr = PetscInfo(fem, "Dual space is not a tensor product of Lagrange nodes, using dense tabulation\n");CHKERRQ(ierr);
+    ierr = PetscFree(xq);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* The 1D Lagrange basis on the nodes, and its derivative, at the 1D quadrature points */
+  ierr = PetscMalloc2(Q*P, &t->B, Q*P, &t->D);CHKERRQ(ierr);
+  for (i = 0; i < Q; ++i) {
+    for (j = 0; j < P; ++j) {
+      t->B[i*P+j] = 1.0;
+      t->D[i*P+j] = 0.0;
+      for (m = 0; m < P; ++m) {
+        PetscReal prod;
+
+        if (m == j) continue;
+        prod = 1.0/(xn[j] - xn[m]);
+        t->B[i*P+j] *= (xq[i] - xn[m])/(xn[j] - xn[m]);
+        for (l = 0; l < P; ++l) if (l != j && l != m) prod *= (xq[i] - xn[l])/(xn[j] - xn[l]);
+        t->D[i*P+j] += prod;
+      }
+    }
+  }
+  ierr = PetscFree(xq);CHKERRQ(ierr);
+  ierr = PetscFree(xn);CHKERRQ(ierr);
+  /* Check the products of 1D functions against the dense tabulation */
+  ierr = PetscFEGetDefaultTabulation(fem, &Bf, &Df, NULL);CHKERRQ(ierr);
+  Nq = PetscPowInt(Q, dim);
+  Pd = PetscPowInt(P, dim);
+  for (q = 0; q < Nq && ok; ++q) {
+    for (L = 0; L < Pd && ok; ++L) {
+      for (c = 0; c < Nc && ok; ++c) {
+        const PetscInt b = t->perm[L*Nc+c];
+
+        for (cc = 0; cc < Nc && ok; ++cc) {
+          for (e = -1; e < dim && ok; ++e) {
+            PetscReal val = c == cc ? 1.0 : 0.0, ref;
+            PetscInt  rq = q, rL = L;
+
+            for (d = dim-1; d >= 0; --d, rq /= Q, rL /= P) val *= (d == e ? t->D : t->B)[(rq%Q)*P + rL%P];
+            ref = e < 0 ? Bf[(q*pdim+b)*Nc+cc] : Df[((q*pdim+b)*Nc+cc)*dim+e];
+            if (PetscAbsReal(val - ref) > tol*(1.0 + PetscAbsReal(ref))) ok = PETSC_FALSE;
+          }
+        }
+      }
+    }
+  }
+  if (!ok) {
+    ierr = PetscInfo(fem, "Basis is not a tensor product of 1D Lagrange polynomials, using dense tabulation\n");CHKERRQ(ierr);
+    ierr = PetscFree2(t->B, t->D);CHKERRQ(ierr);
+    ierr = PetscFree(t->perm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  t->tensor = PETSC_TRUE;
+  t->P      = P;
+  t->Q      = Q;
+  ierr = PetscInfo3(fem, "Using sum factorization with %D nodes and %D quadrature points in each of %D directions\n", P, Q, dim);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* out[a][i][b] = \sum_j M[i][j] in[a][j][b] for the Q x P matrix M, or its transpose */
+PETSC_STATIC_INLINE void PetscFETensorContract_Private(PetscInt Na, PetscInt Nb, PetscInt P, PetscInt Q, const PetscReal M[], PetscBool transpose, const PetscScalar in[], PetscScalar out[])
+{
+  const PetscInt nin = transpose ? Q : P, nout = transpose ? P : Q;
+  PetscInt       a, i, j, b;
+
+  for (a = 0; a < Na; ++a) {
+    const PetscScalar *ina  = &in[a*nin*Nb];
+    PetscScalar       *outa = &out[a*nout*Nb];
+
+    for (i = 0; i < nout*Nb; ++i) outa[i] = 0.0;
+    for (i = 0; i < nout; ++i) {
+      for (j = 0; j < nin; ++j) {
+        const PetscReal m = transpose ? M[j*P+i] : M[i*P+j];
+
+        for (b = 0; b < Nb; ++b) outa[i*Nb+b] += m*ina[j*Nb+b];
+      }
+    }
+  }
+}
+
+/*
+  Interpolate the Nc x P^dim coefficients to the Nc x Q^dim quadrature points, or with transpose, integrate the values at
+  the quadrature points against the basis. On axis deriv, use the 1D derivative instead of the basis (-1 for none).
+*/
+static void PetscFETensorApply_Private(PetscFE_Tensor *t, PetscInt dim, PetscInt Nc, PetscInt deriv, PetscBool transpose, const PetscScalar in[], PetscScalar out[], PetscScalar work[])
+{
+  const PetscInt     nin = transpose ? t->Q : t->P, nout = transpose ? t->P : t->Q;
+  const PetscInt     N   = Nc*PetscPowInt(PetscMax(t->P, t->Q), dim);
+  const PetscScalar *src = in;
+  PetscInt           d;
+
+  for (d = dim-1; d >= 0; --d) {
+    PetscScalar *dst = d ? &work[(d%2)*N] : out;
+
+    PetscFETensorContract_Private(Nc*PetscPowInt(nin, d), PetscPowInt(nout, dim-1-d), t->P, t->Q, d == deriv ? t->D : t->B, transpose, src, dst);
+    src = dst;
+  }
+}
+
+/* The scalar workspace needed by PetscFETensorInterpolate_Private() and PetscFETensorIntegrate_Private() */
+PETSC_STATIC_INLINE PetscInt PetscFETensorWorkSize_Private(PetscFE_Tensor *t, PetscInt dim, PetscInt Nc)
+{
+  return 2*Nc*(PetscPowInt(t->P, dim) + PetscPowInt(PetscMax(t->P, t->Q), dim));
+}
+
+/* Evaluate a field at the quadrature points of an element, as u[c][q] and reference gradients u_x[e][c][q] */
+static void PetscFETensorInterpolate_Private(PetscFE fe, PetscInt dim, const PetscScalar coefficients[], PetscScalar u[], PetscScalar u_x[], PetscScalar work[])
+{
+  PetscFE_Tensor *t  = (PetscFE_Tensor *) fe->data;
+  const PetscInt  Nc = fe->numComponents, Pd = PetscPowInt(t->P, dim), Nq = PetscPowInt(t->Q, dim);
+  PetscScalar    *cl = work;
+  PetscInt        L, c, e;
+
+  for (L = 0; L < Pd; ++L) for (c = 0; c < Nc; ++c) cl[c*Pd+L] = coefficients[t->perm[L*Nc+c]];
+  PetscFETensorApply_Private(t, dim, Nc, -1, PETSC_FALSE, cl, u, &work[Nc*Pd]);
+  if (u_x) for (e = 0; e < dim; ++e) PetscFETensorApply_Private(t, dim, Nc, e, PETSC_FALSE, cl, &u_x[e*Nc*Nq], &work[Nc*Pd]);
+}
+
+/* Add the integrals of f0[c][q] against the basis and of f1[e][c][q] against its reference derivatives to an element vector */
+static void PetscFETensorIntegrate_Private(PetscFE fe, PetscInt dim, const PetscScalar f0[], const PetscScalar f1[], PetscScalar elemVec[], PetscScalar work[])
+{
+  PetscFE_Tensor *t   = (PetscFE_Tensor *) fe->data;
+  const PetscInt  Nc  = fe->numComponents, Pd = PetscPowInt(t->P, dim), Nq = PetscPowInt(t->Q, dim);
+  PetscScalar    *cl  = work, *tmp = &work[Nc*Pd];
+  PetscInt        L, c, e, i;
+
+  PetscFETensorApply_Private(t, dim, Nc, -1, PETSC_TRUE, f0, cl, &work[2*Nc*Pd]);
+  for (e = 0; e < dim; ++e) {
+    PetscFETensorApply_Private(t, dim, Nc, e, PETSC_TRUE, &f1[e*Nc*Nq], tmp, &work[2*Nc*Pd]);
+    for (i = 0; i < Nc*Pd; ++i) cl[i] += tmp[i];
+  }
+  for (L = 0; L < Pd; ++L) for (c = 0; c < Nc; ++c) elemVec[t->perm[L*Nc+c]] += cl[c*Pd+L];
+}
+
+/* We can use sum factorization if every field is a tensor product element on the same quadrature, in a cell of full dimension */
+static PetscErrorCode PetscFETensorUseSumFactorization_Private(PetscDS ds, PetscFEGeom *cgeom, PetscInt *workSize, PetscBool *use)
+{
+  PetscInt       Nf, f, dim = 0, Nq = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *use      = PETSC_FALSE;
+  *workSize = 0;
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject     obj;
+    PetscFE_Tensor *t;
+    PetscBool       istensor;
+
+    ierr = PetscDSGetDiscretization(ds, f, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare(obj, PETSCFETENSOR, &istensor);CHKERRQ(ierr);
+    if (!istensor || obj->classid != PETSCFE_CLASSID) PetscFunctionReturn(0);
+    ierr = PetscFETensorSetUpKernels_Private((PetscFE) obj);CHKERRQ(ierr);
+    t = (PetscFE_Tensor *) ((PetscFE) obj)->data;
+    if (!t->tensor) PetscFunctionReturn(0);
+    if (!f) {
+      ierr = PetscFEGetSpatialDimension((PetscFE) obj, &dim);CHKERRQ(ierr);
+      Nq   = PetscPowInt(t->Q, dim);
+    }
+    if (PetscPowInt(t->Q, dim) != Nq) PetscFunctionReturn(0);
+    *workSize = PetscMax(*workSize, PetscFETensorWorkSize_Private(t, dim, ((PetscFE) obj)->numComponents));
+  }
+  if (dim > 3 || cgeom->dimEmbed != dim) PetscFunctionReturn(0);
+  *use = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* Evaluate all fields at the quadrature points of an element, with the values u[c][q] and reference gradients u_x[e][c][q] of each field stored contiguously */
+static PetscErrorCode PetscFETensorEvaluateFields_Private(PetscDS ds, PetscInt dim, PetscInt Nq, const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscScalar u[], PetscScalar u_x[], PetscScalar u_t[], PetscScalar work[])
+{
+  PetscInt      *Nb, *Nc;
+  PetscInt       Nf, f, dOffset = 0, fOffset = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetDimensions(ds, &Nb);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    PetscFE fe;
+
+    ierr = PetscDSGetDiscretization(ds, f, (PetscObject *) &fe);CHKERRQ(ierr);
+    PetscFETensorInterpolate_Private(fe, dim, &coefficients[dOffset], &u[fOffset*Nq], &u_x[fOffset*Nq*dim], work);
+    if (u_t) PetscFETensorInterpolate_Private(fe, dim, &coefficients_t[dOffset], &u_t[fOffset*Nq], NULL, work);
+    dOffset += Nb[f];
+    fOffset += Nc[f];
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Gather the field jets at quadrature point q into the pointwise layout, pushing the gradients forward to real space */
+PETSC_STATIC_INLINE void PetscFETensorGetPointJets_Private(PetscInt dim, PetscInt Nf, const PetscInt Nc[], PetscInt Nq, PetscInt q, const PetscReal invJ[], const PetscScalar uq[], const PetscScalar uxq[], const PetscScalar utq[], PetscScalar u[], PetscScalar u_x[], PetscScalar u_t[])
+{
+  PetscInt f, c, d, e, fOffset = 0;
+
+  for (f = 0; f < Nf; ++f) {
+    for (c = 0; c < Nc[f]; ++c) {
+      u[fOffset+c] = uq[(fOffset+c)*Nq+q];
+      if (u_t) u_t[fOffset+c] = utq[(fOffset+c)*Nq+q];
+      for (d = 0; d < dim; ++d) {
+        u_x[(fOffset+c)*dim+d] = 0.0;
+        for (e = 0; e < dim; ++e) u_x[(fOffset+c)*dim+d] += invJ[e*dim+d]*uxq[(fOffset*dim+e*Nc[f]+c)*Nq+q];
+      }
+    }
+    fOffset += Nc[f];
+  }
+}
+
+PetscErrorCode PetscFEIntegrateResidual_Tensor(PetscDS ds, PetscInt field, PetscInt Ne, PetscFEGeom *cgeom,
+                                               const PetscScalar coefficients[], const PetscScalar coefficients_t[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscScalar elemVec[])
+{
+  PetscFE            fe;
+  PetscPointFunc     f0_func;
+  PetscPointFunc     f1_func;
+  PetscPointFuncBatch f0_batch, f1_batch;
+  PetscQuadrature    quad;
+  PetscScalar       *f0, *f1, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL, *uq, *uxq, *utq = NULL, *f0q, *f1q, *work;
+  const PetscScalar *constants;
+  PetscReal         *x;
+  PetscReal        **BAux = NULL, **DAux = NULL;
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nc, *NbAux = NULL, *NcAux = NULL;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcTot, totDim, totDimAux = 0, cOffset = 0, cOffsetAux = 0, fOffset, e, NbI, NcI, workSize;
+  PetscBool          isAffine, useTensor;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           Nq, q, Np, dE;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFETensorUseSumFactorization_Private(ds, cgeom, &workSize, &useTensor);CHKERRQ(ierr);
+  ierr = PetscDSGetResidualBatch(ds, field, &f0_batch, &f1_batch);CHKERRQ(ierr);
+  /* The batched callbacks are evaluated by the basic kernel */
+  if (!useTensor || f0_batch || f1_batch) {
+    ierr = PetscFEIntegrateResidual_Basic(ds, field, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscDSGetResidual(ds, field, &f0_func, &f1_func);CHKERRQ(ierr);
+  if (!f0_func && !f1_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, field, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(fe, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcTot);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, field, &fOffset);CHKERRQ(ierr);
+  ierr = PetscDSGetEvaluationArrays(ds, &u, coefficients_t ? &u_t : NULL, &u_x);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, &x, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, &f0, &f1, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetDimensions(dsAux, &NbAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponents(dsAux, &NcAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &a, NULL, &a_x);CHKERRQ(ierr);
+    ierr = PetscDSGetTabulation(dsAux, &BAux, &DAux);CHKERRQ(ierr);
+  }
+  ierr = PetscFEGetDimension(fe, &NbI);CHKERRQ(ierr);
+  NcI  = Nc[field];
+  ierr = PetscQuadratureGetData(quad, NULL, NULL, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  ierr = PetscMalloc6(NcTot*Nq, &uq, NcTot*Nq*dim, &uxq, coefficients_t ? NcTot*Nq : 0, &utq, NcI*Nq, &f0q, NcI*Nq*dim, &f1q, workSize, &work);CHKERRQ(ierr);
+  Np = cgeom->numPoints;
+  dE = cgeom->dimEmbed;
+  isAffine = cgeom->isAffine;
+  for (e = 0; e < Ne; ++e) {
+    PetscFEGeom fegeom;
+
+    if (isAffine) {
+      fegeom.v    = x;
+      fegeom.xi   = cgeom->xi;
+      fegeom.J    = &cgeom->J[e*dE*dE];
+      fegeom.invJ = &cgeom->invJ[e*dE*dE];
+      fegeom.detJ = &cgeom->detJ[e];
+    }
+    ierr = PetscFETensorEvaluateFields_Private(ds, dim, Nq, &coefficients[cOffset], coefficients_t ? &coefficients_t[cOffset] : NULL, uq, uxq, coefficients_t ? utq : NULL, work);CHKERRQ(ierr);
+    for (q = 0; q < Nq; ++q) {
+      PetscReal w;
+      PetscInt  c, d, k;
+
+      if (isAffine) {
+        CoordinatesRefToReal(dE, dim, fegeom.xi, &cgeom->v[e*dE], fegeom.J, &quadPoints[q*dim], x);
+      } else {
+        fegeom.v    = &cgeom->v[(e*Np+q)*dE];
+        fegeom.J    = &cgeom->J[(e*Np+q)*dE*dE];
+        fegeom.invJ = &cgeom->invJ[(e*Np+q)*dE*dE];
+        fegeom.detJ = &cgeom->detJ[e*Np+q];
+      }
+      w = fegeom.detJ[0]*quadWeights[q];
+      PetscFETensorGetPointJets_Private(dim, Nf, Nc, Nq, q, fegeom.invJ, uq, uxq, utq, u, u_x, u_t);
+      if (dsAux) {ierr = PetscFEEvaluateFieldJets_Internal(dsAux, dim, NfAux, NbAux, NcAux, q, BAux, DAux, &fegeom, &coefficientsAux[cOffsetAux], NULL, a, a_x, NULL);CHKERRQ(ierr);}
+      for (c = 0; c < NcI; ++c) f0q[c*Nq+q] = 0.0;
+      for (c = 0; c < NcI*dim; ++c) f1q[c*Nq+q] = 0.0;
+      if (f0_func) {
+        ierr = PetscArrayzero(f0, NcI);CHKERRQ(ierr);
+        f0_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, fegeom.v, numConstants, constants, f0);
+        for (c = 0; c < NcI; ++c) f0q[c*Nq+q] = w*f0[c];
+      }
+      if (f1_func) {
+        ierr = PetscArrayzero(f1, NcI*dim);CHKERRQ(ierr);
+        f1_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, fegeom.v, numConstants, constants, f1);
+        /* Pull the flux back to the reference directions, \nabla\psi \cdot f_1 = \sum_k \partial_k\psi (J^{-1} f_1)_k */
+        for (c = 0; c < NcI; ++c) {
+          for (k = 0; k < dim; ++k) {
+            for (d = 0; d < dim; ++d) f1q[(k*NcI+c)*Nq+q] += w*fegeom.invJ[k*dim+d]*f1[c*dim+d];
+          }
+        }
+      }
+    }
+    ierr = PetscArrayzero(&elemVec[cOffset+fOffset], NbI);CHKERRQ(ierr);
+    PetscFETensorIntegrate_Private(fe, dim, f0q, f1q, &elemVec[cOffset+fOffset], work);
+    cOffset    += totDim;
+    cOffsetAux += totDimAux;
+  }
+  ierr = PetscFree6(uq, uxq, utq, f0q, f1q, work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Without sum factorization, we form the element matrices and multiply */
+static PetscErrorCode PetscFEIntegrateJacobianAction_Dense(PetscDS ds, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                                           const PetscScalar coefficients[], const PetscScalar coefficients_t[], const PetscScalar y[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, PetscScalar elemVec[])
+{
+  PetscScalar   *elemMat;
+  PetscInt       totDim, offsetI, offsetJ, NbI, NbJ, e, i, j;
+  PetscObject    objI, objJ;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldI, &offsetI);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldJ, &offsetJ);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldI, &objI);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldJ, &objJ);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension((PetscFE) objI, &NbI);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension((PetscFE) objJ, &NbJ);CHKERRQ(ierr);
+  ierr = PetscCalloc1(Ne*totDim*totDim, &elemMat);CHKERRQ(ierr);
+  ierr = PetscFEIntegrateJacobian_Basic(ds, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, dsAux, coefficientsAux, t, u_tshift, elemMat);CHKERRQ(ierr);
+  for (e = 0; e < Ne; ++e) {
+    for (i = offsetI; i < offsetI+NbI; ++i) {
+      for (j = offsetJ; j < offsetJ+NbJ; ++j) elemVec[e*totDim+i] += elemMat[(e*totDim+i)*totDim+j]*y[e*totDim+j];
+    }
+  }
+  ierr = PetscFree(elemMat);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEIntegrateJacobianAction_Tensor(PetscDS ds, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                                     const PetscScalar coefficients[], const PetscScalar coefficients_t[], const PetscScalar y[], PetscDS dsAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, PetscScalar elemVec[])
+{
+  PetscFE            feI, feJ;
+  PetscPointJac      g0_func, g1_func, g2_func, g3_func;
+  PetscQuadrature    quad;
+  PetscScalar       *g0, *g1, *g2, *g3, *f0, *f1, *u, *u_t = NULL, *u_x, *a = NULL, *a_x = NULL, *uq, *uxq, *utq = NULL, *yq, *yxq, *f0q, *f1q, *work;
+  const PetscScalar *constants;
+  PetscReal         *x;
+  PetscReal        **BAux = NULL, **DAux = NULL;
+  PetscInt          *uOff, *uOff_x, *aOff = NULL, *aOff_x = NULL, *Nc, *NbAux = NULL, *NcAux = NULL;
+  PetscInt           dim, numConstants, Nf, NfAux = 0, NcTot, totDim, totDimAux = 0, cOffset = 0, cOffsetAux = 0, offsetI, offsetJ, e, NcI, NcJ, workSize;
+  PetscBool          isAffine, useTensor;
+  const PetscReal   *quadPoints, *quadWeights;
+  PetscInt           Nq, q, Np, dE;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFETensorUseSumFactorization_Private(ds, cgeom, &workSize, &useTensor);CHKERRQ(ierr);
+  if (jtype == PETSCFE_JACOBIAN) {
+    PetscPointJacBatch g0_batch, g1_batch, g2_batch, g3_batch;
+
+    ierr = PetscDSGetJacobianBatch(ds, fieldI, fieldJ, &g0_batch, &g1_batch, &g2_batch, &g3_batch);CHKERRQ(ierr);
+    if (g0_batch || g1_batch || g2_batch || g3_batch) useTensor = PETSC_FALSE;
+  }
+  if (!useTensor) {
+    ierr = PetscFEIntegrateJacobianAction_Dense(ds, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, y, dsAux, coefficientsAux, t, u_tshift, elemVec);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  switch(jtype) {
+  case PETSCFE_JACOBIAN_DYN: ierr = PetscDSGetDynamicJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN_PRE: ierr = PetscDSGetJacobianPreconditioner(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  case PETSCFE_JACOBIAN:     ierr = PetscDSGetJacobian(ds, fieldI, fieldJ, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);break;
+  }
+  if (!g0_func && !g1_func && !g2_func && !g3_func) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, fieldI, (PetscObject *) &feI);CHKERRQ(ierr);
+  ierr = PetscDSGetDiscretization(ds, fieldJ, (PetscObject *) &feJ);CHKERRQ(ierr);
+  ierr = PetscFEGetSpatialDimension(feI, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(feI, &quad);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalDimension(ds, &totDim);CHKERRQ(ierr);
+  ierr = PetscDSGetTotalComponents(ds, &NcTot);CHKERRQ(ierr);
+  ierr = PetscDSGetComponents(ds, &Nc);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldI, &offsetI);CHKERRQ(ierr);
+  ierr = PetscDSGetFieldOffset(ds, fieldJ, &offsetJ);CHKERRQ(ierr);
+  ierr = PetscDSGetEvaluationArrays(ds, &u, coefficients_t ? &u_t : NULL, &u_x);CHKERRQ(ierr);
+  ierr = PetscDSGetWorkspace(ds, &x, NULL, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakFormArrays(ds, &f0, &f1, &g0, &g1, &g2, &g3);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  if (dsAux) {
+    ierr = PetscDSGetNumFields(dsAux, &NfAux);CHKERRQ(ierr);
+    ierr = PetscDSGetTotalDimension(dsAux, &totDimAux);CHKERRQ(ierr);
+    ierr = PetscDSGetDimensions(dsAux, &NbAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponents(dsAux, &NcAux);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentOffsets(dsAux, &aOff);CHKERRQ(ierr);
+    ierr = PetscDSGetComponentDerivativeOffsets(dsAux, &aOff_x);CHKERRQ(ierr);
+    ierr = PetscDSGetEvaluationArrays(dsAux, &a, NULL, &a_x);CHKERRQ(ierr);
+    ierr = PetscDSGetTabulation(dsAux, &BAux, &DAux);CHKERRQ(ierr);
+  }
+  NcI = Nc[fieldI];
+  NcJ = Nc[fieldJ];
+  ierr = PetscQuadratureGetData(quad, NULL, NULL, &Nq, &quadPoints, &quadWeights);CHKERRQ(ierr);
+  ierr = PetscMalloc7(NcTot*Nq, &uq, NcTot*Nq*dim, &uxq, coefficients_t ? NcTot*Nq : 0, &utq, NcJ*Nq, &yq, NcJ*Nq*dim, &yxq, NcI*Nq*(dim+1), &f0q, workSize, &work);CHKERRQ(ierr);
+  f1q  = &f0q[NcI*Nq];
+  /* The pointwise Jacobian does not depend on the state if it is not given */
+  ierr = PetscArrayzero(u, NcTot);CHKERRQ(ierr);
+  ierr = PetscArrayzero(u_x, NcTot*dim);CHKERRQ(ierr);
+  Np = cgeom->numPoints;
+  dE = cgeom->dimEmbed;
+  isAffine = cgeom->isAffine;
+  for (e = 0; e < Ne; ++e) {
+    PetscFEGeom fegeom;
+
+    if (isAffine) {
+      fegeom.v    = x;
+      fegeom.xi   = cgeom->xi;
+      fegeom.J    = &cgeom->J[e*dE*dE];
+      fegeom.invJ = &cgeom->invJ[e*dE*dE];
+      fegeom.detJ = &cgeom->detJ[e];
+    }
+    if (coefficients) {ierr = PetscFETensorEvaluateFields_Private(ds, dim, Nq, &coefficients[cOffset], coefficients_t ? &coefficients_t[cOffset] : NULL, uq, uxq, coefficients_t ? utq : NULL, work);CHKERRQ(ierr);}
+    PetscFETensorInterpolate_Private(feJ, dim, &y[cOffset+offsetJ], yq, yxq, work);
+    for (q = 0; q < Nq; ++q) {
+      PetscScalar  yx[3];
+      PetscReal    w;
+      PetscInt     c, fc, gc, df, dg, k;
+
+      if (isAffine) {
+        CoordinatesRefToReal(dE, dim, fegeom.xi, &cgeom->v[e*dE], fegeom.J, &quadPoints[q*dim], x);
+      } else {
+        fegeom.v    = &cgeom->v[(e*Np+q)*dE];
+        fegeom.J    = &cgeom->J[(e*Np+q)*dE*dE];
+        fegeom.invJ = &cgeom->invJ[(e*Np+q)*dE*dE];
+        fegeom.detJ = &cgeom->detJ[e*Np+q];
+      }
+      w = fegeom.detJ[0]*quadWeights[q];
+      if (coefficients) PetscFETensorGetPointJets_Private(dim, Nf, Nc, Nq, q, fegeom.invJ, uq, uxq, utq, u, u_x, u_t);
+      if (dsAux) {ierr = PetscFEEvaluateFieldJets_Internal(dsAux, dim, NfAux, NbAux, NcAux, q, BAux, DAux, &fegeom, &coefficientsAux[cOffsetAux], NULL, a, a_x, NULL);CHKERRQ(ierr);}
+      ierr = PetscArrayzero(g0, NcI*NcJ);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g1, NcI*NcJ*dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g2, NcI*NcJ*dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g3, NcI*NcJ*dim*dim);CHKERRQ(ierr);
+      if (g0_func) g0_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, fegeom.v, numConstants, constants, g0);
+      if (g1_func) g1_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, fegeom.v, numConstants, constants, g1);
+      if (g2_func) g2_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, fegeom.v, numConstants, constants, g2);
+      if (g3_func) g3_func(dim, Nf, NfAux, uOff, uOff_x, u, u_t, u_x, aOff, aOff_x, a, NULL, a_x, t, u_tshift, fegeom.v, numConstants, constants, g3);
+      /* The linearized residual f0 = g0 y + g1 \nabla y and f1 = g2 y + g3 \nabla y at this point */
+      ierr = PetscArrayzero(f0, NcI);CHKERRQ(ierr);
+      ierr = PetscArrayzero(f1, NcI*dim);CHKERRQ(ierr);
+      for (gc = 0; gc < NcJ; ++gc) {
+        const PetscScalar yg = yq[gc*Nq+q];
+
+        for (dg = 0; dg < dim; ++dg) {
+          yx[dg] = 0.0;
+          for (k = 0; k < dim; ++k) yx[dg] += fegeom.invJ[k*dim+dg]*yxq[(k*NcJ+gc)*Nq+q];
+        }
+        for (fc = 0; fc < NcI; ++fc) {
+          f0[fc] += g0[fc*NcJ+gc]*yg;
+          for (dg = 0; dg < dim; ++dg) f0[fc] += g1[(fc*NcJ+gc)*dim+dg]*yx[dg];
+          for (df = 0; df < dim; ++df) {
+            f1[fc*dim+df] += g2[(fc*NcJ+gc)*dim+df]*yg;
+            for (dg = 0; dg < dim; ++dg) f1[fc*dim+df] += g3[((fc*NcJ+gc)*dim+df)*dim+dg]*yx[dg];
+          }
+        }
+      }
+      for (c = 0; c < NcI; ++c) {
+        f0q[c*Nq+q] = w*f0[c];
+        for (k = 0; k < dim; ++k) {
+          f1q[(k*NcI+c)*Nq+q] = 0.0;
+          for (df = 0; df < dim; ++df) f1q[(k*NcI+c)*Nq+q] += w*fegeom.invJ[k*dim+df]*f1[c*dim+df];
+        }
+      }
+    }
+    PetscFETensorIntegrate_Private(feI, dim, f0q, f1q, &elemVec[cOffset+offsetI], work);
+    cOffset    += totDim;
+    cOffsetAux += totDimAux;
+  }
+  ierr = PetscFree7(uq, uxq, utq, yq, yxq, f0q, work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEView_Tensor(PetscFE fem, PetscViewer v)
+{
+  PetscFE_Tensor *t = (PetscFE_Tensor *) fem->data;
+  PetscInt        dim, Nc;
+  PetscBool       iascii;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) v, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  if (fem->setupcalled) {ierr = PetscFETensorSetUpKernels_Private(fem);CHKERRQ(ierr);}
+  ierr = PetscFEGetSpatialDimension(fem, &dim);CHKERRQ(ierr);
+  ierr = PetscFEGetNumComponents(fem, &Nc);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPushTab(v);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(v, "Tensor Finite Element in %D dimensions with %D components\n", dim, Nc);CHKERRQ(ierr);
+  if (t->tensor) {ierr = PetscViewerASCIIPrintf(v, "Sum factorization with %D nodes and %D quadrature points per direction\n", t->P, t->Q);CHKERRQ(ierr);}
+  else           {ierr = PetscViewerASCIIPrintf(v, "No tensor product structure, using the dense tabulation\n");CHKERRQ(ierr);}
+  if (fem->basisSpace) {ierr = PetscSpaceView(fem->basisSpace, v);CHKERRQ(ierr);}
+  if (fem->dualSpace)  {ierr = PetscDualSpaceView(fem->dualSpace, v);CHKERRQ(ierr);}
+  if (fem->quadrature) {ierr = PetscQuadratureView(fem->quadrature, v);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPopTab(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscFEInitialize_Tensor(PetscFE fem)
+{
+  PetscFunctionBegin;
+  fem->ops->setfromoptions          = NULL;
+  fem->ops->setup                   = PetscFESetUp_Basic;
+  fem->ops->view                    = PetscFEView_Tensor;
+  fem->ops->destroy                 = PetscFEDestroy_Tensor;
+  fem->ops->getdimension            = PetscFEGetDimension_Basic;
+  fem->ops->gettabulation           = PetscFEGetTabulation_Basic;
+  fem->ops->integrate               = PetscFEIntegrate_Basic;
+  fem->ops->integratebd             = PetscFEIntegrateBd_Basic;
+  fem->ops->integrateresidual       = PetscFEIntegrateResidual_Tensor;
+  fem->ops->integratebdresidual     = PetscFEIntegrateBdResidual_Basic;
+  fem->ops->integratejacobianaction = PetscFEIntegrateJacobianAction_Tensor;
+  fem->ops->integratejacobian       = PetscFEIntegrateJacobian_Basic;
+  fem->ops->integratebdjacobian     = PetscFEIntegrateBdJacobian_Basic;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  PETSCFETENSOR = "tensor" - A PetscFE object that integrates tensor product Lagrange elements with sum factorization
+
+  Notes:
+  On tensor product cells, with a tensor product quadrature, the element residual and the action of the element Jacobian
+  are computed by applying the 1D basis tabulation along each direction in turn, so that the cost per element grows as
+  O(p^{d+1}) instead of O(p^{2d}) for polynomial degree p in d dimensions. This makes high order elements affordable,
+  especially with a matrix-free Jacobian, see DMPlexSNESCreateJacobianMF(). Elements without this structure, or in
+  discretizations with other element types, are integrated as for PETSCFEBASIC.
+
+  Element Jacobian matrices, used to assemble the preconditioner, are still formed with the dense tabulation.
+
+  Level: intermediate
+
+.seealso: PetscFEType, PetscFECreate(), PetscFESetType(), PETSCFEBASIC, PetscFEIntegrateJacobianAction()
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscFECreate_Tensor(PetscFE fem)
+{
+  PetscFE_Tensor *t;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(fem, PETSCFE_CLASSID, 1);
+  ierr      = PetscNewLog(fem,&t);CHKERRQ(ierr);
+  fem->data = t;
+
+  ierr = PetscFEInitialize_Tensor(fem);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -1366,6 +1366,57 @@ PetscErrorCode PetscFEIntegrateJacobian(PetscDS prob, PetscFEJacobianType jtype,
   PetscFunctionReturn(0);
 }
 
+/*@C
+  PetscFEIntegrateJacobianAction - Add the action of the element Jacobian on a vector for a chunk of elements, without forming the element matrices
+
+  Not collective
+
+  Input Parameters:
++ prob         - The PetscDS specifying the discretizations and continuum functions
+. jtype        - The type of matrix pointwise functions that should be used
+. fieldI       - The test field being integrated
+. fieldJ       - The basis field being integrated
+. Ne           - The number of elements in the chunk
+. cgeom        - The cell geometry for each cell in the chunk
+. coefficients - The array of FEM basis coefficients for the elements for the Jacobian evaluation point
+. coefficients_t - The array of FEM basis time derivative coefficients for the elements
+. y            - The array of FEM basis coefficients for the elements of the vector the Jacobian is applied to
+. probAux      - The PetscDS specifying the auxiliary discretizations
+. coefficientsAux - The array of FEM auxiliary basis coefficients for the elements
+. t            - The time
+- u_tShift     - A multiplier for the dF/du_t term (as opposed to the dF/du term)
+
+  Output Parameter:
+. elemVec      - the element vectors, to which the block of the element Jacobian for fieldI and fieldJ applied to y is added
+
+  Note:
+$ Loop over batch of elements (e):
+$   Loop over quadrature points (q):
+$     Make u_q and gradU_q (loops over fields,Nb,Ncomp), and y_q and gradY_q for fieldJ
+$     Make f0_{fc} = g0_{fc,gc} y_{gc} + g1_{fc,gc,dg} \nabla y_{gc,dg} and f1_{fc,df} = g2_{fc,gc,df} y_{gc} + g3_{fc,gc,df,dg} \nabla y_{gc,dg}
+$   Loop over element vector entries (f,fc --> i):
+$     elemVec[i] += \psi^{fc}_f(q) f0_{fc} + \nabla\psi^{fc}_f(q) \cdot f1_{fc,df}
+
+  Only some PetscFE types provide this operation, see PETSCFETENSOR.
+
+  Level: developer
+
+.seealso: PetscFEIntegrateJacobian(), PetscFEIntegrateResidual(), DMPlexComputeJacobianAction()
+@*/
+PetscErrorCode PetscFEIntegrateJacobianAction(PetscDS prob, PetscFEJacobianType jtype, PetscInt fieldI, PetscInt fieldJ, PetscInt Ne, PetscFEGeom *cgeom,
+                                              const PetscScalar coefficients[], const PetscScalar coefficients_t[], const PetscScalar y[], PetscDS probAux, const PetscScalar coefficientsAux[], PetscReal t, PetscReal u_tshift, PetscScalar elemVec[])
+{
+  PetscFE        fe;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  ierr = PetscDSGetDiscretization(prob, fieldI, (PetscObject *) &fe);CHKERRQ(ierr);
+  if (!fe->ops->integratejacobianaction) SETERRQ1(PetscObjectComm((PetscObject) fe), PETSC_ERR_SUP, "PetscFE type %s does not integrate the Jacobian action", ((PetscObject) fe)->type_name);
+  ierr = (*fe->ops->integratejacobianaction)(prob, jtype, fieldI, fieldJ, Ne, cgeom, coefficients, coefficients_t, y, probAux, coefficientsAux, t, u_tshift, elemVec);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   PetscFEIntegrateBdJacobian - Produce the boundary element Jacobian for a chunk of elements by quadrature integration
 
@@ -426,6 +426,8 @@ static PetscErrorCode PetscDSEnlarge_Static(PetscDS prob, PetscInt NfNew)
   PetscBool        *tmpi;
   PetscPointFunc   *tmpobj, *tmpf, *tmpup;
   PetscPointJac    *tmpg, *tmpgp, *tmpgt;
+  PetscPointFuncBatch *tmpfb;
+  PetscPointJacBatch  *tmpgb;
   PetscBdPointFunc *tmpfbd;
   PetscBdPointJac  *tmpgbd;
   PetscRiemannFunc *tmpr;
@@ -487,6 +489,12 @@ static PetscErrorCode PetscDSEnlarge_Static(PetscDS prob, PetscInt NfNew)
   prob->gBd = tmpgbd;
   prob->exactSol = tmpexactSol;
   prob->exactCtx = tmpexactCtx;
+  ierr = PetscCalloc2(NfNew*2, &tmpfb, NfNew*NfNew*4, &tmpgb);CHKERRQ(ierr);
+  for (f = 0; f < Nf*2; ++f) tmpfb[f] = prob->fBatch[f];
+  for (f = 0; f < Nf*Nf*4; ++f) tmpgb[f] = prob->gBatch[f];
+  ierr = PetscFree2(prob->fBatch, prob->gBatch);CHKERRQ(ierr);
+  prob->fBatch = tmpfb;
+  prob->gBatch = tmpgb;
   PetscFunctionReturn(0);
 }
 
@@ -529,6 +537,7 @@ PetscErrorCode PetscDSDestroy(PetscDS *prob)
   ierr = PetscFree7((*prob)->obj,(*prob)->f,(*prob)->g,(*prob)->gp,(*prob)->gt,(*prob)->r,(*prob)->ctx);CHKERRQ(ierr);
   ierr = PetscFree((*prob)->update);CHKERRQ(ierr);
   ierr = PetscFree4((*prob)->fBd,(*prob)->gBd,(*prob)->exactSol,(*prob)->exactCtx);CHKERRQ(ierr);
+  ierr = PetscFree2((*prob)->fBatch,(*prob)->gBatch);CHKERRQ(ierr);
   if ((*prob)->ops->destroy) {ierr = (*(*prob)->ops->destroy)(*prob);CHKERRQ(ierr);}
   next = (*prob)->boundary;
   while (next) {
@@ -1113,7 +1122,8 @@ PetscErrorCode PetscDSHasJacobian(PetscDS prob, PetscBool *hasJac)
   for (f = 0; f < prob->Nf; ++f) {
     for (g = 0; g < prob->Nf; ++g) {
       for (h = 0; h < 4; ++h) {
-        if (prob->g[(f*prob->Nf + g)*4+h]) *hasJac = PETSC_TRUE;
+        if (prob->g[(f*prob->Nf + g)*4+h])      *hasJac = PETSC_TRUE;
+        if (prob->gBatch[(f*prob->Nf + g)*4+h]) *hasJac = PETSC_TRUE;
       }
     }
   }
@@ -1283,6 +1293,183 @@ PetscErrorCode PetscDSSetJacobian(PetscDS prob, PetscInt f, PetscInt g,
   PetscFunctionReturn(0);
 }
 
+/*@C
+  PetscDSGetResidualBatch - Get the batched pointwise residual function for a given test field
+
+  Not collective
+
+  Input Parameters:
++ prob - The PetscDS
+- f    - The test field number
+
+  Output Parameters:
++ f0 - batched integrand for the test function term
+- f1 - batched integrand for the test function gradient term
+
+  Note: See PetscDSSetResidualBatch() for the calling sequence and data layout of the callbacks.
+
+  Level: intermediate
+
+.seealso: PetscDSSetResidualBatch(), PetscDSGetResidual()
+@*/
+PetscErrorCode PetscDSGetResidualBatch(PetscDS prob, PetscInt f, PetscPointFuncBatch *f0, PetscPointFuncBatch *f1)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  if ((f < 0) || (f >= prob->Nf)) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Field number %d must be in [0, %d)", f, prob->Nf);
+  if (f0) {PetscValidPointer(f0, 3); *f0 = prob->fBatch[f*2+0];}
+  if (f1) {PetscValidPointer(f1, 4); *f1 = prob->fBatch[f*2+1];}
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscDSSetResidualBatch - Set the batched pointwise residual function for a given test field
+
+  Not collective
+
+  Input Parameters:
++ prob - The PetscDS
+. f    - The test field number
+. f0 - batched integrand for the test function term
+- f1 - batched integrand for the test function gradient term
+
+  Note: The batched functions compute the same integrands as those given to PetscDSSetResidual(), but for Np quadrature points at
+  once, taken from several cells. All arrays are in struct-of-arrays layout, with the point index running fastest, so that the loop
+  over points in the callback can be vectorized by the compiler. The calling sequence for the callbacks f0 and f1 is given by:
+
+$ f0(PetscInt dim, PetscInt Nf, PetscInt NfAux, PetscInt Np,
+$    const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+$    const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+$    PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+
++ dim - the spatial dimension
+. Nf - the number of fields
+. NfAux - the number of auxiliary fields
+. Np - the number of points in the batch
+. uOff - the offset into u[] and u_t[] for each field, in units of Np
+. uOff_x - the offset into u_x[] for each field, in units of Np
+. u - each field evaluated at the points, component c of point p is u[c*Np+p]
+. u_t - the time derivative of each field evaluated at the points, laid out as u
+. u_x - the gradient of each field evaluated at the points, derivative d of component c of point p is u_x[(c*dim+d)*Np+p]
+. aOff - the offset into a[] and a_t[] for each auxiliary field, in units of Np
+. aOff_x - the offset into a_x[] for each auxiliary field, in units of Np
+. a - each auxiliary field evaluated at the points, laid out as u
+. a_t - the time derivative of each auxiliary field evaluated at the points, laid out as u
+. a_x - the gradient of each auxiliary field evaluated at the points, laid out as u_x
+. t - current time
+. x - coordinates of the points, coordinate d of point p is x[d*Np+p]
+. numConstants - number of constant parameters
+. constants - constant parameters
+- f0 - output values at the points, component c of point p is f0[c*Np+p], and for f1 derivative d of component c is f1[(c*dim+d)*Np+p]
+
+  The output arrays are zeroed before the call. When batched functions are set for a field, PETSCFEBASIC uses them instead of the
+  pointwise functions, and evaluates batches of PetscFEGetTileSizes() batchSize cells, see -petscfe_num_blocks and -petscfe_num_batches.
+
+  Level: intermediate
+
+.seealso: PetscDSGetResidualBatch(), PetscDSSetResidual(), PetscDSSetJacobianBatch()
+@*/
+PetscErrorCode PetscDSSetResidualBatch(PetscDS prob, PetscInt f, PetscPointFuncBatch f0, PetscPointFuncBatch f1)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  if (f0) PetscValidFunction(f0, 3);
+  if (f1) PetscValidFunction(f1, 4);
+  if (f < 0) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Field number %d must be non-negative", f);
+  ierr = PetscDSEnlarge_Static(prob, f+1);CHKERRQ(ierr);
+  prob->fBatch[f*2+0] = f0;
+  prob->fBatch[f*2+1] = f1;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscDSGetJacobianBatch - Get the batched pointwise Jacobian function for given test and basis field
+
+  Not collective
+
+  Input Parameters:
++ prob - The PetscDS
+. f    - The test field number
+- g    - The field number
+
+  Output Parameters:
++ g0 - batched integrand for the test and basis function term
+. g1 - batched integrand for the test function and basis function gradient term
+. g2 - batched integrand for the test function gradient and basis function term
+- g3 - batched integrand for the test function gradient and basis function gradient term
+
+  Note: See PetscDSSetJacobianBatch() for the calling sequence and data layout of the callbacks.
+
+  Level: intermediate
+
+.seealso: PetscDSSetJacobianBatch(), PetscDSGetJacobian()
+@*/
+PetscErrorCode PetscDSGetJacobianBatch(PetscDS prob, PetscInt f, PetscInt g, PetscPointJacBatch *g0, PetscPointJacBatch *g1, PetscPointJacBatch *g2, PetscPointJacBatch *g3)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  if ((f < 0) || (f >= prob->Nf)) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Test field number %d must be in [0, %d)", f, prob->Nf);
+  if ((g < 0) || (g >= prob->Nf)) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Field number %d must be in [0, %d)", g, prob->Nf);
+  if (g0) {PetscValidPointer(g0, 4); *g0 = prob->gBatch[(f*prob->Nf + g)*4+0];}
+  if (g1) {PetscValidPointer(g1, 5); *g1 = prob->gBatch[(f*prob->Nf + g)*4+1];}
+  if (g2) {PetscValidPointer(g2, 6); *g2 = prob->gBatch[(f*prob->Nf + g)*4+2];}
+  if (g3) {PetscValidPointer(g3, 7); *g3 = prob->gBatch[(f*prob->Nf + g)*4+3];}
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscDSSetJacobianBatch - Set the batched pointwise Jacobian function for given test and basis fields
+
+  Not collective
+
+  Input Parameters:
++ prob - The PetscDS
+. f    - The test field number
+. g    - The field number
+. g0 - batched integrand for the test and basis function term
+. g1 - batched integrand for the test function and basis function gradient term
+. g2 - batched integrand for the test function gradient and basis function term
+- g3 - batched integrand for the test function gradient and basis function gradient term
+
+  Note: The batched functions compute the same integrands as those given to PetscDSSetJacobian(), but for Np quadrature points at
+  once, in the struct-of-arrays layout described in PetscDSSetResidualBatch(). The calling sequence for the callbacks g0, g1, g2 and g3 is given by:
+
+$ g0(PetscInt dim, PetscInt Nf, PetscInt NfAux, PetscInt Np,
+$    const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+$    const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+$    PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g0[])
+
+  where u_tShift is the multiplier a for dF/dU_t and the other arguments are those of the batched residual functions. Entry i of
+  the pointwise function output at point p is stored in g0[i*Np+p], so for instance g3[((fc*NcJ+gc)*dim+df)*dim+dg)*Np+p].
+
+  The batched functions are only used for the Jacobian itself, not for the preconditioner or the dynamic Jacobian.
+
+  Level: intermediate
+
+.seealso: PetscDSGetJacobianBatch(), PetscDSSetJacobian(), PetscDSSetResidualBatch()
+@*/
+PetscErrorCode PetscDSSetJacobianBatch(PetscDS prob, PetscInt f, PetscInt g, PetscPointJacBatch g0, PetscPointJacBatch g1, PetscPointJacBatch g2, PetscPointJacBatch g3)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(prob, PETSCDS_CLASSID, 1);
+  if (g0) PetscValidFunction(g0, 4);
+  if (g1) PetscValidFunction(g1, 5);
+  if (g2) PetscValidFunction(g2, 6);
+  if (g3) PetscValidFunction(g3, 7);
+  if (f < 0) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Field number %d must be non-negative", f);
+  if (g < 0) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Field number %d must be non-negative", g);
+  ierr = PetscDSEnlarge_Static(prob, PetscMax(f, g)+1);CHKERRQ(ierr);
+  prob->gBatch[(f*prob->Nf + g)*4+0] = g0;
+  prob->gBatch[(f*prob->Nf + g)*4+1] = g1;
+  prob->gBatch[(f*prob->Nf + g)*4+2] = g2;
+  prob->gBatch[(f*prob->Nf + g)*4+3] = g3;
+  PetscFunctionReturn(0);
+}
+
 /*@C
   PetscDSUseJacobianPreconditioner - Whether to construct a Jacobian preconditioner
 
@@ -2977,14 +3164,17 @@ PetscErrorCode PetscDSSelectEquations(PetscDS prob, PetscInt numFields, const Pe
     PetscPointFunc   f0, f1;
     PetscBdPointFunc f0Bd, f1Bd;
     PetscRiemannFunc r;
+    PetscPointFuncBatch f0b, f1b;
 
     if (f >= Nf) continue;
     ierr = PetscDSGetObjective(prob, f, &obj);CHKERRQ(ierr);
     ierr = PetscDSGetResidual(prob, f, &f0, &f1);CHKERRQ(ierr);
+    ierr = PetscDSGetResidualBatch(prob, f, &f0b, &f1b);CHKERRQ(ierr);
     ierr = PetscDSGetBdResidual(prob, f, &f0Bd, &f1Bd);CHKERRQ(ierr);
     ierr = PetscDSGetRiemannSolver(prob, f, &r);CHKERRQ(ierr);
     ierr = PetscDSSetObjective(newprob, fn, obj);CHKERRQ(ierr);
     ierr = PetscDSSetResidual(newprob, fn, f0, f1);CHKERRQ(ierr);
+    ierr = PetscDSSetResidualBatch(newprob, fn, f0b, f1b);CHKERRQ(ierr);
     ierr = PetscDSSetBdResidual(newprob, fn, f0Bd, f1Bd);CHKERRQ(ierr);
     ierr = PetscDSSetRiemannSolver(newprob, fn, r);CHKERRQ(ierr);
     for (gn = 0; gn < numFields; ++gn) {
@@ -2992,12 +3182,15 @@ PetscErrorCode PetscDSSelectEquations(PetscDS prob, PetscInt numFields, const Pe
       PetscPointJac   g0, g1, g2, g3;
       PetscPointJac   g0p, g1p, g2p, g3p;
       PetscBdPointJac g0Bd, g1Bd, g2Bd, g3Bd;
+      PetscPointJacBatch g0b, g1b, g2b, g3b;
 
       if (g >= Nf) continue;
       ierr = PetscDSGetJacobian(prob, f, g, &g0, &g1, &g2, &g3);CHKERRQ(ierr);
+      ierr = PetscDSGetJacobianBatch(prob, f, g, &g0b, &g1b, &g2b, &g3b);CHKERRQ(ierr);
       ierr = PetscDSGetJacobianPreconditioner(prob, f, g, &g0p, &g1p, &g2p, &g3p);CHKERRQ(ierr);
       ierr = PetscDSGetBdJacobian(prob, f, g, &g0Bd, &g1Bd, &g2Bd, &g3Bd);CHKERRQ(ierr);
       ierr = PetscDSSetJacobian(newprob, fn, gn, g0, g1, g2, g3);CHKERRQ(ierr);
+      ierr = PetscDSSetJacobianBatch(newprob, fn, gn, g0b, g1b, g2b, g3b);CHKERRQ(ierr);
       ierr = PetscDSSetJacobianPreconditioner(prob, fn, gn, g0p, g1p, g2p, g3p);CHKERRQ(ierr);
       ierr = PetscDSSetBdJacobian(newprob, fn, gn, g0Bd, g1Bd, g2Bd, g3Bd);CHKERRQ(ierr);
     }
@@ -12,6 +12,7 @@ typedef struct {
   PetscInt *numComponents;     /* The number of field components */
   PetscInt *numDof;            /* The dof signature for the section */
   PetscInt  numGroups;         /* If greater than 1, use grouping in test */
+  char      order[256];        /* The ordering type */
 } AppCtx;
 
 PetscErrorCode ProcessOptions(AppCtx *options)
@@ -30,6 +31,7 @@ PetscErrorCode ProcessOptions(AppCtx *options)
   options->numComponents     = NULL;
   options->numDof            = NULL;
   options->numGroups         = 0;
+  ierr = PetscStrcpy(options->order, MATORDERINGRCM);CHKERRQ(ierr);
 
   ierr = PetscOptionsBegin(PETSC_COMM_SELF, "", "Meshing Problem Options", "DMPLEX");CHKERRQ(ierr);
   ierr = PetscOptionsRangeInt("-dim", "The topological mesh dimension", "ex10.c", options->dim, &options->dim, NULL,1,3);CHKERRQ(ierr);
@@ -49,6 +51,7 @@ PetscErrorCode ProcessOptions(AppCtx *options)
   ierr = PetscOptionsIntArray("-num_dof", "The dof signature for the section", "ex10.c", options->numDof, &len, &flg);CHKERRQ(ierr);
   if (flg && (len != (options->dim+1) * PetscMax(1, options->numFields))) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Length of dof array is %D should be %D", len, (options->dim+1) * PetscMax(1, options->numFields));
   ierr = PetscOptionsBoundedInt("-num_groups", "Group permutation by this many label values", "ex10.c", options->numGroups, &options->numGroups, NULL,0);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-order", "The ordering type, e.g. rcm, hilbert or morton", "ex10.c", options->order, options->order, sizeof(options->order), NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -84,7 +87,7 @@ PetscErrorCode TestReordering(DM dm, AppCtx *user)
   IS              perm;
   Mat             A, pA;
   PetscInt        bw, pbw;
-  MatOrderingType order = MATORDERINGRCM;
+  MatOrderingType order = user->order;
   PetscErrorCode  ierr;
 
   PetscFunctionBegin;
@@ -213,6 +216,16 @@ int main(int argc, char **argv)
   test:
     suffix: 7
     args: -dim 3 -interpolate 1 -cell_simplex 0 -refinement_uniform       -num_dof 1,0,0,0
+  # Space filling curve tests
+  test:
+    suffix: hilbert_0
+    args: -dim 2 -interpolate 1 -cell_simplex 0 -refinement_uniform -num_dof 1,0,0 -order hilbert
+  test:
+    suffix: morton_0
+    args: -dim 2 -interpolate 1 -cell_simplex 0 -refinement_uniform -num_dof 1,0,0 -order morton
+  test:
+    suffix: hilbert_1
+    args: -dim 3 -interpolate 1 -cell_simplex 0 -refinement_uniform -num_dof 1,0,0,0 -order hilbert
   # Parallel tests
   # Grouping tests
   test:
@@ -35,6 +35,8 @@ typedef struct {
   PetscBool testPartition;                /* Use a fixed partitioning for testing */
   PetscBool testRedundant;                /* Use a redundant partitioning for testing */
   PetscBool loadBalance;                  /* Load balance via a second distribute step */
+  PetscBool rebalance;                    /* Load balance with DMPlexRebalance() and check the transfer of a cell field */
+  PetscInt  heavy;                        /* Extra dofs of the cell field in the lower corner of the domain, to unbalance the load */
   PetscBool partitionBalance;             /* Balance shared point partition */
   PetscLogStage stages[4];
 } AppCtx;
@@ -55,6 +57,8 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->testPartition    = PETSC_FALSE;
   options->testRedundant    = PETSC_FALSE;
   options->loadBalance      = PETSC_FALSE;
+  options->rebalance        = PETSC_FALSE;
+  options->heavy            = 0;
   options->partitionBalance = PETSC_FALSE;
 
   ierr = PetscOptionsBegin(comm, "", "Meshing Problem Options", "DMPLEX");CHKERRQ(ierr);
@@ -67,6 +71,8 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   ierr = PetscOptionsBool("-test_partition", "Use a fixed partition for testing", "ex12.c", options->testPartition, &options->testPartition, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-test_redundant", "Use a redundant partition for testing", "ex12.c", options->testRedundant, &options->testRedundant, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-load_balance", "Perform parallel load balancing in a second distribution step", "ex12.c", options->loadBalance, &options->loadBalance, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-rebalance", "Load balance with DMPlexRebalance(), migrating only the cells that change process", "ex12.c", options->rebalance, &options->rebalance, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBoundedInt("-heavy", "Extra dofs of the cell field in the lower corner of the domain when rebalancing", "ex12.c", options->heavy, &options->heavy, NULL, 0);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-partition_balance", "Balance the ownership of shared points", "ex12.c", options->partitionBalance, &options->partitionBalance, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();
 
@@ -77,6 +83,94 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   PetscFunctionReturn(0);
 }
 
+/* Store the centroid of each cell in a cell field on the local section of dm, with heavy more dofs in the lower corner [0,1/2]^dim */
+static PetscErrorCode CreateCentroidField(DM dm, PetscInt heavy, Vec *centroids)
+{
+  PetscSection   section;
+  PetscScalar   *a;
+  PetscReal      centroid[3];
+  PetscInt       dim, cStart, cEnd, c, d, off, size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(PETSC_COMM_SELF, &section);CHKERRQ(ierr);
+  ierr = PetscSectionSetChart(section, cStart, cEnd);CHKERRQ(ierr);
+  for (c = cStart; c < cEnd; ++c) {
+    PetscBool corner = PETSC_TRUE;
+
+    ierr = DMPlexComputeCellGeometryFVM(dm, c, NULL, centroid, NULL);CHKERRQ(ierr);
+    for (d = 0; d < dim; ++d) if (centroid[d] > 0.5) corner = PETSC_FALSE;
+    ierr = PetscSectionSetDof(section, c, corner ? dim + heavy : dim);CHKERRQ(ierr);
+  }
+  ierr = PetscSectionSetUp(section);CHKERRQ(ierr);
+  ierr = DMSetLocalSection(dm, section);CHKERRQ(ierr);
+  ierr = PetscSectionGetStorageSize(section, &size);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF, size, centroids);CHKERRQ(ierr);
+  ierr = VecGetArray(*centroids, &a);CHKERRQ(ierr);
+  for (c = cStart; c < cEnd; ++c) {
+    ierr = PetscSectionGetOffset(section, c, &off);CHKERRQ(ierr);
+    ierr = DMPlexComputeCellGeometryFVM(dm, c, NULL, centroid, NULL);CHKERRQ(ierr);
+    for (d = 0; d < dim; ++d) a[off+d] = centroid[d];
+  }
+  ierr = VecRestoreArray(*centroids, &a);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&section);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Check the transfer of the centroid field by DMPlexDistributeField() over the rebalancing SF, and count the migrated cells */
+static PetscErrorCode CheckRebalance(DM dm, Vec centroids, PetscSF sf, DM rdm)
+{
+  MPI_Comm           comm;
+  PetscSection       section, rsection, newSection;
+  Vec                rcentroids;
+  const PetscScalar *a;
+  PetscReal          centroid[3];
+  const PetscInt    *leaves;
+  const PetscSFNode *remotes;
+  PetscInt           dim, cStart, cEnd, c, d, size, rsize, nleaves, l, moved = 0;
+  PetscMPIInt        rank;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject) dm, &comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(rdm, &rsection);CHKERRQ(ierr);
+  if (!rsection) SETERRQ(comm, PETSC_ERR_PLIB, "The local section was not carried over");
+  ierr = PetscSectionCreate(comm, &newSection);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_SELF, &rcentroids);CHKERRQ(ierr);
+  ierr = DMPlexDistributeField(dm, sf, section, centroids, newSection, rcentroids);CHKERRQ(ierr);
+  ierr = PetscSectionGetStorageSize(newSection, &size);CHKERRQ(ierr);
+  ierr = PetscSectionGetStorageSize(rsection, &rsize);CHKERRQ(ierr);
+  if (size != rsize) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Carried over section has size %D instead of %D", rsize, size);
+  ierr = DMPlexGetHeightStratum(rdm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(rcentroids, &a);CHKERRQ(ierr);
+  for (c = cStart; c < cEnd; ++c) {
+    PetscInt off;
+
+    ierr = PetscSectionGetOffset(newSection, c, &off);CHKERRQ(ierr);
+    ierr = DMPlexComputeCellGeometryFVM(rdm, c, NULL, centroid, NULL);CHKERRQ(ierr);
+    for (d = 0; d < dim; ++d) {
+      if (PetscAbsReal(PetscRealPart(a[off+d]) - centroid[d]) > PETSC_SMALL) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Wrong field value transferred to cell %D", c);
+    }
+  }
+  ierr = VecRestoreArrayRead(rcentroids, &a);CHKERRQ(ierr);
+  ierr = PetscSFGetGraph(sf, NULL, &nleaves, &leaves, &remotes);CHKERRQ(ierr);
+  for (l = 0; l < nleaves; ++l) {
+    const PetscInt leaf = leaves ? leaves[l] : l;
+
+    if (leaf >= cStart && leaf < cEnd && remotes[l].rank != rank) ++moved;
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &moved, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm, "Cells migrated: %D\n", moved);CHKERRQ(ierr);
+  ierr = VecDestroy(&rcentroids);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&newSection);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
 {
   DM             pdm             = NULL;
@@ -174,7 +268,19 @@ PetscErrorCode CreateMesh(MPI_Comm comm, AppCtx *user, DM *dm)
       ierr = PetscPartitionerShellSetPartition(part, size, reSizes_n2, rePoints_n2);CHKERRQ(ierr);
     }
     ierr = DMPlexSetPartitionBalance(*dm, user->partitionBalance);CHKERRQ(ierr);
-    ierr = DMPlexDistribute(*dm, overlap, NULL, &pdm);CHKERRQ(ierr);
+    if (user->rebalance) {
+      Vec     centroids;
+      PetscSF sf;
+
+      ierr = CreateCentroidField(*dm, user->heavy, &centroids);CHKERRQ(ierr);
+      ierr = DMPlexRebalance(*dm, overlap, &sf, &pdm);CHKERRQ(ierr);
+      if (pdm) {ierr = CheckRebalance(*dm, centroids, sf, pdm);CHKERRQ(ierr);}
+      else     {ierr = PetscPrintf(comm, "Cells migrated: 0\n");CHKERRQ(ierr);}
+      ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+      ierr = VecDestroy(&centroids);CHKERRQ(ierr);
+    } else {
+      ierr = DMPlexDistribute(*dm, overlap, NULL, &pdm);CHKERRQ(ierr);
+    }
     if (pdm) {
       ierr = DMDestroy(dm);CHKERRQ(ierr);
       *dm  = pdm;
@@ -258,6 +364,30 @@ int main(int argc, char **argv)
     requires: parmetis
     nsize: 4
     args: -cell_simplex 0 -cells 4,4 -petscpartitioner_type shell -petscpartitioner_shell_random -lb_petscpartitioner_type parmetis -load_balance -lb_petscpartitioner_view -prelb_dm_view ::load_balance -dm_view ::load_balance
+  test:
+    suffix: lb_multilevel_0
+    nsize: 4
+    args: -cell_simplex 0 -cells 8,8 -petscpartitioner_type shell -petscpartitioner_shell_random -lb_petscpartitioner_type multilevel -load_balance -lb_petscpartitioner_view -prelb_dm_view ::load_balance -dm_view ::load_balance
+  test:
+    suffix: lb_multilevel_1
+    nsize: 3
+    args: -cell_simplex 0 -dim 3 -cells 6,6,6 -petscpartitioner_type multilevel -petscpartitioner_multilevel_coarsen_size 10 -petscpartitioner_view -dm_view ::load_balance
+  test:
+    suffix: lb_multilevel_2
+    nsize: 7
+    args: -cell_simplex 0 -cells 3,3 -petscpartitioner_type multilevel -petscpartitioner_view -dm_view ::load_balance
+  test:
+    suffix: lb_rebalance_0
+    nsize: 4
+    args: -cell_simplex 0 -cells 16,16 -petscpartitioner_type simple -load_balance -rebalance -heavy 2 -lb_petscpartitioner_type multilevel -lb_petscpartitioner_multilevel_repartition -lb_petscpartitioner_view -prelb_dm_view ::load_balance -dm_view ::load_balance
+  test:
+    suffix: lb_rebalance_1
+    nsize: 4
+    args: -cell_simplex 0 -cells 16,16 -petscpartitioner_type simple -load_balance -rebalance -heavy 2 -lb_petscpartitioner_type multilevel -lb_petscpartitioner_view -prelb_dm_view ::load_balance -dm_view ::load_balance
+  test:
+    suffix: lb_rebalance_2
+    nsize: 3
+    args: -cell_simplex 0 -dim 3 -cells 6,6,6 -petscpartitioner_type multilevel -load_balance -rebalance -lb_petscpartitioner_type multilevel -lb_petscpartitioner_multilevel_repartition -prelb_dm_view ::load_balance
 
   # Same tests as above, but with balancing of the shared point partition
   test:
@@ -0,0 +1,945 @@
+#include <petsc/private/dmpleximpl.h>   /*I      "petscdmplex.h"   I*/
+#include <petsc/private/hashseti.h>
+
+/*
+   A multilevel graph partitioner without external dependencies.
+
+   The distributed graph is coarsened by heavy edge matching, first among the vertices owned by each process and then across
+   processes through a request and grant handshake, so that the coarsening does not stall when the initial distribution of
+   the vertices is poor. A coarse vertex lives on the process of one of its fine vertices.
+   The coarsest graph is gathered on all processes, each of them computes a recursive bisection by greedy graph growing from
+   a different start vertex, and the partition with the smallest edge cut is kept. It is then refined on every level, from
+   the coarsest to the finest, by parallel boundary label propagation: a vertex moves to the neighboring part it is most
+   connected to as long as this does not overload that part, and overloaded parts give away their boundary vertices.
+
+   When repartitioning, the graph is only coarsened within each process, the current distribution is taken as the partition
+   of the coarsest graph, and the refinement also counts the weight of the vertices leaving their process, so that the load
+   diffuses to neighboring processes and the vertices that move are few.
+*/
+
+typedef struct {
+  PetscReal imbalanceRatio; /* Largest allowed ratio of a part weight to the average part weight */
+  PetscInt  coarsenSize;    /* Coarsening stops when the graph has fewer vertices than coarsenSize per part */
+  PetscInt  refineIts;      /* Largest number of refinement sweeps on each level */
+  PetscBool repartition;    /* Start from the current distribution instead of partitioning from scratch */
+  PetscReal migrationCost;  /* Cost of migrating a unit of vertex weight relative to cutting a unit of edge weight */
+} PetscPartitioner_Multilevel;
+
+/* One level of the distributed graph: the local vertices are [0,n), the ghost vertices, owned by other processes, [n,n+nghost) */
+typedef struct {
+  PetscInt  n, nghost;
+  PetscInt *vtxdist;        /* Global number of the first vertex of each process */
+  PetscInt *xadj, *adjncy;  /* Adjacency of the local vertices in local numbering */
+  PetscInt *adjwgt, *vwgt;  /* Edge and vertex weights */
+  PetscInt *ghosts;         /* Global numbers of the ghost vertices, sorted */
+  PetscSF   sf;             /* Roots are the local vertices, leaves the ghost vertices */
+  PetscInt *cmap;           /* Local coarse vertex of each local vertex, or -1 minus the ghost index of its remote partner */
+} PetscPartitionerMLGraph;
+
+#define PETSCPARTITIONER_MULTILEVEL_MAXLEVELS 64
+#define PETSCPARTITIONER_MULTILEVEL_TRIALS    8
+
+static PetscErrorCode PetscPartitionerMLGraphDestroy_Private(PetscPartitionerMLGraph *g)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(g->vtxdist);CHKERRQ(ierr);
+  ierr = PetscFree4(g->xadj, g->adjncy, g->adjwgt, g->vwgt);CHKERRQ(ierr);
+  ierr = PetscFree(g->ghosts);CHKERRQ(ierr);
+  ierr = PetscFree(g->cmap);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&g->sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Takes the arrays, allocated with PetscMalloc4(), and converts the adjacency from global to local numbering */
+static PetscErrorCode PetscPartitionerMLGraphSetUp_Private(MPI_Comm comm, PetscInt n, PetscInt *vtxdist, PetscInt *xadj, PetscInt *adjncy, PetscInt *adjwgt, PetscInt *vwgt, PetscPartitionerMLGraph *g)
+{
+  PetscHSetI     ht;
+  PetscSFNode   *remote;
+  PetscInt       rStart, rEnd, e, i, r, off = 0;
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  ierr = PetscMemzero(g, sizeof(*g));CHKERRQ(ierr);
+  g->n       = n;
+  g->vtxdist = vtxdist;
+  g->xadj    = xadj;
+  g->adjncy  = adjncy;
+  g->adjwgt  = adjwgt;
+  g->vwgt    = vwgt;
+  rStart     = vtxdist[rank];
+  rEnd       = vtxdist[rank+1];
+  ierr = PetscHSetICreate(&ht);CHKERRQ(ierr);
+  for (e = 0; e < xadj[n]; ++e) {
+    if (adjncy[e] < rStart || adjncy[e] >= rEnd) {ierr = PetscHSetIAdd(ht, adjncy[e]);CHKERRQ(ierr);}
+  }
+  ierr = PetscHSetIGetSize(ht, &g->nghost);CHKERRQ(ierr);
+  ierr = PetscMalloc1(g->nghost, &g->ghosts);CHKERRQ(ierr);
+  ierr = PetscHSetIGetElems(ht, &off, g->ghosts);CHKERRQ(ierr);
+  ierr = PetscHSetIDestroy(&ht);CHKERRQ(ierr);
+  ierr = PetscSortInt(g->nghost, g->ghosts);CHKERRQ(ierr);
+  for (e = 0; e < xadj[n]; ++e) {
+    if (adjncy[e] >= rStart && adjncy[e] < rEnd) adjncy[e] -= rStart;
+    else {
+      ierr = PetscFindInt(adjncy[e], g->nghost, g->ghosts, &i);CHKERRQ(ierr);
+      adjncy[e] = n + i;
+    }
+  }
+  ierr = PetscMalloc1(g->nghost, &remote);CHKERRQ(ierr);
+  for (i = 0, r = 0; i < g->nghost; ++i) {
+    while (g->ghosts[i] >= vtxdist[r+1]) ++r;
+    remote[i].rank  = r;
+    remote[i].index = g->ghosts[i] - vtxdist[r];
+  }
+  ierr = PetscSFCreate(comm, &g->sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(g->sf, n, g->nghost, NULL, PETSC_OWN_POINTER, remote, PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(g->sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Copies the values of the local vertices to the ghost vertices */
+static PetscErrorCode PetscPartitionerMLGraphUpdateGhosts_Private(PetscPartitionerMLGraph *g, PetscInt array[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastBegin(g->sf, MPIU_INT, array, array+g->n);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(g->sf, MPIU_INT, array, array+g->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Process owning the global vertex gid */
+static PetscMPIInt PetscPartitionerMLOwner_Private(PetscMPIInt size, const PetscInt vtxdist[], PetscInt gid)
+{
+  PetscMPIInt lo = 0, hi = size, mid;
+
+  while (hi - lo > 1) {
+    mid = (lo + hi)/2;
+    if (gid < vtxdist[mid]) hi = mid;
+    else                    lo = mid;
+  }
+  return lo;
+}
+
+/* Heavy edge matching of the unmatched local vertices, if heaviest is set only along edges at least as heavy as those to other processes */
+static PetscErrorCode PetscPartitionerMLGraphMatchLocal_Private(PetscPartitionerMLGraph *g, PetscInt maxvwgt, PetscBool heaviest, PetscInt mate[], PetscInt owns[])
+{
+  const PetscInt n = g->n;
+  PetscInt       u, v, e;
+
+  PetscFunctionBegin;
+  for (u = 0; u < n; ++u) {
+    PetscInt best = -1, remote = 0;
+
+    if (mate[u] >= 0) continue;
+    for (e = g->xadj[u]; e < g->xadj[u+1]; ++e) {
+      v = g->adjncy[e];
+      if (v >= n) {remote = PetscMax(remote, g->adjwgt[e]); continue;}
+      if (v == u || mate[v] >= 0 || g->vwgt[u] + g->vwgt[v] > maxvwgt) continue;
+      if (best < 0 || g->adjwgt[e] > g->adjwgt[best] || (g->adjwgt[e] == g->adjwgt[best] && g->vwgt[v] < g->vwgt[g->adjncy[best]])) best = e;
+    }
+    if (best >= 0 && (!heaviest || g->adjwgt[best] >= remote)) {
+      v       = g->adjncy[best];
+      mate[u] = v;
+      mate[v] = u;
+      owns[u] = 1;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  Heavy edge matching, sets cg to the coarse graph unless it would not be significantly smaller.
+
+  The local vertices are first matched among themselves along their heaviest edges. The vertices left then request their
+  heaviest unmatched neighbor on a process of higher rank, then on a process of lower rank, in alternating rounds, and a
+  requested vertex that did not request grants one of the requests.
+  The coarse vertex of a match across processes belongs to the process of the granting vertex, the other process sends it the
+  weight and edges of its vertex, and cmap[] holds -1 minus the ghost index of the partner for such a vertex. The vertices still
+  left are finally matched among themselves along any edge. If local is set, vertices are only matched on their process.
+*/
+static PetscErrorCode PetscPartitionerMLGraphCoarsen_Private(MPI_Comm comm, PetscPartitionerMLGraph *g, PetscInt maxvwgt, PetscBool local, PetscPartitionerMLGraph *cg, PetscBool *coarsened)
+{
+  const PetscInt n = g->n, nt = g->n + g->nghost;
+  PetscInt       cn = 0, cN, N, rStart, rEnd, u, v, c, e, i, k, len, round, nrecv, ncedges;
+  PetscInt       *mate, *owns, *asked, *grant, *first, *gc, *gvwgt, *req, *cvtxdist, *cxadj, *cadjncy, *cadjwgt, *cvwgt, *sbuf, *rbuf, *roff;
+  PetscMPIInt    size, rank, r, *scounts, *sdispls, *rcounts, *rdispls;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr   = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  ierr   = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  rStart = g->vtxdist[rank];
+  rEnd   = g->vtxdist[rank+1];
+  ierr   = PetscMalloc1(n, &g->cmap);CHKERRQ(ierr);
+  ierr   = PetscMalloc7(n, &mate, n, &owns, n, &asked, n, &grant, n, &first, nt, &gc, nt, &gvwgt);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(g->nghost, &req);CHKERRQ(ierr);
+  for (u = 0; u < n; ++u) {mate[u] = -1; owns[u] = 0;}
+  ierr = PetscPartitionerMLGraphMatchLocal_Private(g, maxvwgt, PETSC_TRUE, mate, owns);CHKERRQ(ierr);
+  ierr = PetscArraycpy(gvwgt, g->vwgt, n);CHKERRQ(ierr);
+  ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, gvwgt);CHKERRQ(ierr);
+  for (round = 0; round < (local ? 0 : 4); ++round) {
+    for (u = 0; u < n; ++u) gc[u] = mate[u] >= 0 ? 1 : 0;
+    ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, gc);CHKERRQ(ierr);
+    for (i = 0; i < g->nghost; ++i) req[i] = -1;
+    for (u = 0; u < n; ++u) {
+      PetscInt best = -1;
+
+      asked[u] = -1;
+      grant[u] = -1;
+      if (mate[u] >= 0) continue;
+      for (e = g->xadj[u]; e < g->xadj[u+1]; ++e) {
+        v = g->adjncy[e];
+        if (v < n || gc[v] || g->vwgt[u] + gvwgt[v] > maxvwgt) continue;
+        if ((round % 2) ? g->ghosts[v-n] >= rStart : g->ghosts[v-n] < rEnd) continue;
+        if (best < 0 || g->adjwgt[e] > g->adjwgt[best]) best = e;
+      }
+      if (best >= 0) {
+        asked[u]   = g->adjncy[best];
+        req[asked[u]-n] = PetscMax(req[asked[u]-n], rStart + u);
+      }
+    }
+    ierr = PetscSFReduceBegin(g->sf, MPIU_INT, req, grant, MPI_MAX);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(g->sf, MPIU_INT, req, grant, MPI_MAX);CHKERRQ(ierr);
+    for (u = 0; u < n; ++u) {
+      gc[u] = -1;
+      if (mate[u] >= 0 || asked[u] >= 0 || grant[u] < 0) continue;
+      ierr = PetscFindInt(grant[u], g->nghost, g->ghosts, &i);CHKERRQ(ierr);
+      if (i < 0) continue;
+      mate[u] = n + i;
+      owns[u] = 1;
+      gc[u]   = grant[u];
+    }
+    ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, gc);CHKERRQ(ierr);
+    for (u = 0; u < n; ++u) {
+      if (asked[u] >= 0 && gc[asked[u]] == rStart + u) mate[u] = asked[u];
+    }
+  }
+  ierr = PetscFree(req);CHKERRQ(ierr);
+  ierr = PetscPartitionerMLGraphMatchLocal_Private(g, maxvwgt, PETSC_FALSE, mate, owns);CHKERRQ(ierr);
+  /* Number the coarse vertices of this process */
+  for (u = 0; u < n; ++u) {
+    if (mate[u] >= 0 && !owns[u]) {
+      if (mate[u] >= n) g->cmap[u] = -1 - mate[u];
+      continue;
+    }
+    first[cn]  = u;
+    g->cmap[u] = cn;
+    if (mate[u] >= 0 && mate[u] < n) g->cmap[mate[u]] = cn;
+    ++cn;
+  }
+  N    = g->vtxdist[size];
+  ierr = MPIU_Allreduce(&cn, &cN, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  *coarsened = cN < 0.95*N ? PETSC_TRUE : PETSC_FALSE;
+  if (!*coarsened) {
+    ierr = PetscFree(g->cmap);CHKERRQ(ierr);
+    ierr = PetscFree7(mate, owns, asked, grant, first, gc, gvwgt);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc1(size+1, &cvtxdist);CHKERRQ(ierr);
+  cvtxdist[0] = 0;
+  ierr = MPI_Allgather(&cn, 1, MPIU_INT, &cvtxdist[1], 1, MPIU_INT, comm);CHKERRQ(ierr);
+  for (r = 1; r <= size; ++r) cvtxdist[r] += cvtxdist[r-1];
+  /* Global coarse vertex of the local and ghost vertices */
+  for (u = 0; u < n; ++u) gc[u] = g->cmap[u] >= 0 ? cvtxdist[rank] + g->cmap[u] : -1;
+  ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, gc);CHKERRQ(ierr);
+  for (u = 0; u < n; ++u) if (g->cmap[u] < 0) gc[u] = gc[-1 - g->cmap[u]];
+  ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, gc);CHKERRQ(ierr);
+
+  /* Send the weight and edges of the vertices matched to a coarse vertex of another process, as triples (coarse vertex, neighbor or -1, weight) */
+  ierr = PetscCalloc4(size, &scounts, size+1, &sdispls, size, &rcounts, size+1, &rdispls);CHKERRQ(ierr);
+  for (u = 0; u < n; ++u) {
+    if (g->cmap[u] >= 0) continue;
+    r = PetscPartitionerMLOwner_Private(size, cvtxdist, gc[u]);
+    scounts[r] += 3*(1 + g->xadj[u+1] - g->xadj[u]);
+  }
+  ierr = MPI_Alltoall(scounts, 1, MPI_INT, rcounts, 1, MPI_INT, comm);CHKERRQ(ierr);
+  for (r = 0; r < size; ++r) {
+    sdispls[r+1] = sdispls[r] + scounts[r];
+    rdispls[r+1] = rdispls[r] + rcounts[r];
+  }
+  ierr = PetscMalloc2(sdispls[size], &sbuf, rdispls[size], &rbuf);CHKERRQ(ierr);
+  for (r = 0; r < size; ++r) scounts[r] = sdispls[r];
+  for (u = 0; u < n; ++u) {
+    if (g->cmap[u] >= 0) continue;
+    r = PetscPartitionerMLOwner_Private(size, cvtxdist, gc[u]);
+    sbuf[scounts[r]++] = gc[u]; sbuf[scounts[r]++] = -1; sbuf[scounts[r]++] = g->vwgt[u];
+    for (e = g->xadj[u]; e < g->xadj[u+1]; ++e) {
+      sbuf[scounts[r]++] = gc[u]; sbuf[scounts[r]++] = gc[g->adjncy[e]]; sbuf[scounts[r]++] = g->adjwgt[e];
+    }
+  }
+  for (r = 0; r < size; ++r) scounts[r] = sdispls[r+1] - sdispls[r];
+  ierr  = MPI_Alltoallv(sbuf, scounts, sdispls, MPIU_INT, rbuf, rcounts, rdispls, MPIU_INT, comm);CHKERRQ(ierr);
+  nrecv = rdispls[size]/3;
+  /* Sort the received triples by coarse vertex */
+  ierr = PetscCalloc1(cn+1, &roff);CHKERRQ(ierr);
+  for (i = 0; i < nrecv; ++i) ++roff[rbuf[3*i] - cvtxdist[rank] + 1];
+  for (c = 0; c < cn; ++c) roff[c+1] += roff[c];
+  ierr = PetscMalloc1(rdispls[size], &req);CHKERRQ(ierr);
+  for (i = 0; i < nrecv; ++i) {
+    c = rbuf[3*i] - cvtxdist[rank];
+    ierr = PetscArraycpy(&req[3*roff[c]], &rbuf[3*i], 3);CHKERRQ(ierr);
+    ++roff[c];
+  }
+  for (c = cn; c > 0; --c) roff[c] = roff[c-1];
+  roff[0] = 0;
+
+  /* Coarse adjacency in global numbering: the edges of the fine vertices, without the edges between them and with the weights of parallel edges added */
+  ncedges = g->xadj[n] + nrecv;
+  ierr    = PetscMalloc4(cn+1, &cxadj, ncedges, &cadjncy, ncedges, &cadjwgt, cn, &cvwgt);CHKERRQ(ierr);
+  cxadj[0] = 0;
+  for (c = 0; c < cn; ++c) {
+    const PetscInt cgid = cvtxdist[rank] + c, start = cxadj[c];
+    PetscInt       fine[2], nf = 1, f;
+
+    fine[0]  = first[c];
+    cvwgt[c] = 0;
+    if (mate[fine[0]] >= 0 && mate[fine[0]] < n) fine[nf++] = mate[fine[0]];
+    for (f = 0, len = 0; f < nf; ++f) {
+      cvwgt[c] += g->vwgt[fine[f]];
+      for (e = g->xadj[fine[f]]; e < g->xadj[fine[f]+1]; ++e) {
+        if (gc[g->adjncy[e]] == cgid) continue;
+        cadjncy[start+len] = gc[g->adjncy[e]];
+        cadjwgt[start+len] = g->adjwgt[e];
+        ++len;
+      }
+    }
+    for (i = roff[c]; i < roff[c+1]; ++i) {
+      if (req[3*i+1] < 0) {cvwgt[c] += req[3*i+2]; continue;}
+      if (req[3*i+1] == cgid) continue;
+      cadjncy[start+len] = req[3*i+1];
+      cadjwgt[start+len] = req[3*i+2];
+      ++len;
+    }
+    ierr = PetscSortIntWithArray(len, &cadjncy[start], &cadjwgt[start]);CHKERRQ(ierr);
+    for (e = 0, k = -1; e < len; ++e) {
+      if (k >= 0 && cadjncy[start+k] == cadjncy[start+e]) cadjwgt[start+k] += cadjwgt[start+e];
+      else {
+        ++k;
+        cadjncy[start+k] = cadjncy[start+e];
+        cadjwgt[start+k] = cadjwgt[start+e];
+      }
+    }
+    cxadj[c+1] = start + k + 1;
+  }
+  ierr = PetscFree(req);CHKERRQ(ierr);
+  ierr = PetscFree(roff);CHKERRQ(ierr);
+  ierr = PetscFree2(sbuf, rbuf);CHKERRQ(ierr);
+  ierr = PetscFree4(scounts, sdispls, rcounts, rdispls);CHKERRQ(ierr);
+  ierr = PetscFree7(mate, owns, asked, grant, first, gc, gvwgt);CHKERRQ(ierr);
+  ierr = PetscPartitionerMLGraphSetUp_Private(comm, cn, cvtxdist, cxadj, cadjncy, cadjwgt, cvwgt, cg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Projects the partition of the coarse graph to the graph g, local and ghost vertices */
+static PetscErrorCode PetscPartitionerMLGraphProject_Private(PetscPartitionerMLGraph *g, const PetscInt cpart[], PetscInt part[])
+{
+  PetscInt       v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (v = 0; v < g->n; ++v) part[v] = g->cmap[v] >= 0 ? cpart[g->cmap[v]] : -1;
+  ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, part);CHKERRQ(ierr);
+  for (v = 0; v < g->n; ++v) if (g->cmap[v] < 0) part[v] = part[-1 - g->cmap[v]];
+  ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, part);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  Fiduccia-Mattheyses refinement of the bisection of the ns vertices of subset between the parts side[0] and side[1]: the vertex
+  with the largest gain moves, even if the gain is negative, and the sequence of moves is rolled back to its best point.
+  A state is better if its weights exceed the largest ones, target[] times ratio, by less, then if its edge cut is smaller.
+  Within a pass the sides may exceed their largest weight by the heaviest vertex, so that a balanced bisection can change.
+  No move leaves a side with fewer than nmin[] vertices, so that each of its parts can still get one.
+*/
+static PetscErrorCode PetscPartitionerMultilevelFM_Private(const PetscInt xadj[], const PetscInt adjncy[], const PetscInt adjwgt[], const PetscInt vwgt[], PetscInt ns, const PetscInt subset[], const PetscInt side[], const PetscReal target[], const PetscInt nmin[], PetscReal ratio, PetscInt part[], PetscInt gain[], PetscInt locked[], PetscInt moved[])
+{
+  PetscHeap      heap;
+  PetscReal      wt[2] = {0.0, 0.0}, mx[2], excess, bestExcess;
+  PetscInt       cnt[2] = {0, 0}, i, e, v, u, s, t, w, val, nmoves, best, cum, bestCum, pass, size = ns, maxw = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  mx[0] = target[0]*ratio;
+  mx[1] = target[1]*ratio;
+  for (i = 0; i < ns; ++i) {
+    v   = subset[i];
+    wt[part[v] == side[1]] += vwgt[v];
+    ++cnt[part[v] == side[1]];
+    size += xadj[v+1] - xadj[v];
+    maxw  = PetscMax(maxw, vwgt[v]);
+  }
+  for (pass = 0; pass < 4; ++pass) {
+    ierr = PetscHeapCreate(size, &heap);CHKERRQ(ierr);
+    for (i = 0; i < ns; ++i) {
+      v = subset[i];
+      locked[v] = 0;
+      gain[v]   = 0;
+      for (e = xadj[v]; e < xadj[v+1]; ++e) {
+        u = adjncy[e];
+        if (part[u] == part[v]) gain[v] -= adjwgt[e];
+        else if (part[u] == side[0] || part[u] == side[1]) gain[v] += adjwgt[e];
+      }
+      ierr = PetscHeapAdd(heap, v, -gain[v]);CHKERRQ(ierr);
+    }
+    bestExcess = PetscMax(wt[0]-mx[0], 0.0) + PetscMax(wt[1]-mx[1], 0.0);
+    nmoves = best = cum = bestCum = 0;
+    while (nmoves - best < PetscMax(ns/10, 25)) {
+      ierr = PetscHeapPop(heap, &v, &val);CHKERRQ(ierr);
+      if (v < 0) break;
+      if (locked[v] || -val != gain[v]) continue;
+      s = part[v] == side[1];
+      t = 1 - s;
+      w = vwgt[v];
+      if (cnt[s] <= nmin[s] || (wt[t] + w > mx[t] + maxw && wt[t] + w >= wt[s])) {locked[v] = 1; continue;}
+      locked[v]        = 1;
+      part[v]          = side[t];
+      wt[s]           -= w;
+      wt[t]           += w;
+      --cnt[s];
+      ++cnt[t];
+      cum             += gain[v];
+      moved[nmoves++]  = v;
+      for (e = xadj[v]; e < xadj[v+1]; ++e) {
+        u = adjncy[e];
+        if (locked[u] || (part[u] != side[0] && part[u] != side[1])) continue;
+        gain[u] += part[u] == part[v] ? -2*adjwgt[e] : 2*adjwgt[e];
+        ierr = PetscHeapAdd(heap, u, -gain[u]);CHKERRQ(ierr);
+      }
+      excess = PetscMax(wt[0]-mx[0], 0.0) + PetscMax(wt[1]-mx[1], 0.0);
+      if (excess < bestExcess || (excess == bestExcess && cum > bestCum)) {
+        best       = nmoves;
+        bestCum    = cum;
+        bestExcess = excess;
+      }
+    }
+    ierr = PetscHeapDestroy(&heap);CHKERRQ(ierr);
+    /* Roll back the moves after the best state */
+    for (i = nmoves-1; i >= best; --i) {
+      v = moved[i];
+      s = part[v] == side[1];
+      part[v]  = side[1-s];
+      wt[s]   -= vwgt[v];
+      wt[1-s] += vwgt[v];
+      --cnt[s];
+      ++cnt[1-s];
+    }
+    if (!best) break;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  Recursive bisection of a serial graph by greedy graph growing refined by FM, each growth starts from the vertex farthest from the
+  start-th vertex. When there are at least as many vertices as parts, each half keeps at least as many vertices as its parts, so that
+  no part is empty.
+*/
+static PetscErrorCode PetscPartitionerMultilevelBisect_Private(PetscInt N, const PetscInt xadj[], const PetscInt adjncy[], const PetscInt adjwgt[], const PetscInt vwgt[], PetscInt nparts, PetscReal ratio, PetscInt start, PetscInt part[])
+{
+  PetscInt       *stack, *queue, *mark, *subset, *gain, *locked, nstack = 0, stamp = 0, v, e;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc6(2*nparts, &stack, N, &queue, N, &mark, N, &subset, N, &gain, N, &locked);CHKERRQ(ierr);
+  for (v = 0; v < N; ++v) {part[v] = 0; mark[v] = -1;}
+  stack[nstack++] = 0; stack[nstack++] = nparts;
+  while (nstack) {
+    const PetscInt k = stack[--nstack], p0 = stack[--nstack], kl = k/2;
+    PetscInt       ns = 0, nl = 0, nmin[2] = {0, 0}, head, tail, next, u, seed, val, hsize;
+    PetscHeap      heap;
+    PetscReal      total = 0.0, target, wl = 0.0;
+
+    if (k < 2) continue;
+    for (v = 0; v < N; ++v) if (part[v] == p0) {subset[ns++] = v; total += vwgt[v];}
+    target = total*kl/k;
+    if (ns >= k) {nmin[0] = kl; nmin[1] = k - kl;}
+    /* The right half is everything the left half does not grow into */
+    for (v = 0; v < ns; ++v) part[subset[v]] = p0 + kl;
+    if (ns) {
+      /* Breadth first search for a vertex far from the start vertex */
+      seed = subset[start % ns];
+      head = tail = 0; queue[tail++] = seed; mark[seed] = ++stamp;
+      while (head < tail) {
+        u = queue[head++];
+        for (e = xadj[u]; e < xadj[u+1]; ++e) {
+          v = adjncy[e];
+          if (part[v] == p0 + kl && mark[v] != stamp) {mark[v] = stamp; queue[tail++] = v;}
+        }
+      }
+      seed = queue[tail-1];
+      /* Grow the left half from there, adding the neighbor whose move cuts the fewest edges, and jumping to another component when one is exhausted */
+      for (v = 0, hsize = ns; v < ns; ++v) {
+        u       = subset[v];
+        gain[u] = 0;
+        for (e = xadj[u]; e < xadj[u+1]; ++e) if (part[adjncy[e]] == p0 + kl) gain[u] -= adjwgt[e];
+        hsize  += xadj[u+1] - xadj[u];
+      }
+      ierr = PetscHeapCreate(hsize, &heap);CHKERRQ(ierr);
+      ierr = PetscHeapAdd(heap, seed, -gain[seed]);CHKERRQ(ierr);
+      next = 0;
+      while ((wl < target || nl < nmin[0]) && nl < ns - nmin[1]) {
+        ierr = PetscHeapPop(heap, &u, &val);CHKERRQ(ierr);
+        if (u < 0) {
+          while (next < ns && part[subset[next]] != p0 + kl) ++next;
+          if (next == ns) break;
+          u = subset[next];
+        } else if (part[u] != p0 + kl || -val != gain[u]) continue;
+        if (nl >= nmin[0] && wl > 0.0 && wl + vwgt[u] - target > target - wl) break;
+        part[u] = p0;
+        wl     += vwgt[u];
+        ++nl;
+        for (e = xadj[u]; e < xadj[u+1]; ++e) {
+          v = adjncy[e];
+          if (part[v] != p0 + kl) continue;
+          gain[v] += 2*adjwgt[e];
+          ierr     = PetscHeapAdd(heap, v, -gain[v]);CHKERRQ(ierr);
+        }
+      }
+      ierr = PetscHeapDestroy(&heap);CHKERRQ(ierr);
+      {
+        const PetscInt  side[2]   = {p0, p0 + kl};
+        const PetscReal targets[2] = {target, total - target};
+
+        ierr = PetscPartitionerMultilevelFM_Private(xadj, adjncy, adjwgt, vwgt, ns, subset, side, targets, nmin, ratio, part, gain, locked, queue);CHKERRQ(ierr);
+      }
+    }
+    stack[nstack++] = p0;      stack[nstack++] = kl;
+    stack[nstack++] = p0 + kl; stack[nstack++] = k - kl;
+  }
+  ierr = PetscFree6(stack, queue, mark, subset, gain, locked);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Partition of the coarsest graph: gathered on every process, bisected from different starts on each, the smallest edge cut wins */
+static PetscErrorCode PetscPartitionerMultilevelInitial_Private(MPI_Comm comm, PetscPartitionerMLGraph *g, PetscInt nparts, PetscReal ratio, PetscInt part[])
+{
+  PetscInt       N, M, v, e, t, ntrials, ne, cut = 0, minCut, winner, *gxadj, *gadjncy, *gadjwgt, *gvwgt, *gpart, *tpart, *deg, *adj;
+  PetscMPIInt    size, rank, r, *counts, *displs, *ecounts, *edispls, nloc, neloc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  N    = g->vtxdist[size];
+  ne   = g->xadj[g->n];
+  ierr = PetscMalloc4(size, &counts, size, &displs, size, &ecounts, size+1, &edispls);CHKERRQ(ierr);
+  for (r = 0; r < size; ++r) {
+    ierr = PetscMPIIntCast(g->vtxdist[r+1]-g->vtxdist[r], &counts[r]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(g->vtxdist[r], &displs[r]);CHKERRQ(ierr);
+  }
+  ierr = PetscMPIIntCast(g->n, &nloc);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(ne, &neloc);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&neloc, 1, MPI_INT, ecounts, 1, MPI_INT, comm);CHKERRQ(ierr);
+  for (r = 0, edispls[0] = 0; r < size; ++r) edispls[r+1] = edispls[r] + ecounts[r];
+  M    = edispls[size];
+  ierr = PetscMalloc6(N+1, &gxadj, M, &gadjncy, M, &gadjwgt, N, &gvwgt, N, &gpart, N, &tpart);CHKERRQ(ierr);
+  ierr = PetscMalloc2(g->n, &deg, ne, &adj);CHKERRQ(ierr);
+  for (v = 0; v < g->n; ++v) deg[v] = g->xadj[v+1] - g->xadj[v];
+  for (e = 0; e < ne; ++e) adj[e] = g->adjncy[e] < g->n ? g->adjncy[e] + g->vtxdist[rank] : g->ghosts[g->adjncy[e] - g->n];
+  ierr = MPI_Allgatherv(deg, nloc, MPIU_INT, gxadj+1, counts, displs, MPIU_INT, comm);CHKERRQ(ierr);
+  ierr = MPI_Allgatherv(g->vwgt, nloc, MPIU_INT, gvwgt, counts, displs, MPIU_INT, comm);CHKERRQ(ierr);
+  ierr = MPI_Allgatherv(adj, neloc, MPIU_INT, gadjncy, ecounts, edispls, MPIU_INT, comm);CHKERRQ(ierr);
+  ierr = MPI_Allgatherv(g->adjwgt, neloc, MPIU_INT, gadjwgt, ecounts, edispls, MPIU_INT, comm);CHKERRQ(ierr);
+  ierr = PetscFree2(deg, adj);CHKERRQ(ierr);
+  for (v = 0, gxadj[0] = 0; v < N; ++v) gxadj[v+1] += gxadj[v];
+
+  /* At least PETSCPARTITIONER_MULTILEVEL_TRIALS bisections are tried in total */
+  ntrials = PetscMax(1, (PETSCPARTITIONER_MULTILEVEL_TRIALS + size - 1)/size);
+  for (t = 0; t < ntrials; ++t) {
+    PetscInt tcut = 0;
+
+    ierr = PetscPartitionerMultilevelBisect_Private(N, gxadj, gadjncy, gadjwgt, gvwgt, nparts, ratio, rank + t*size, tpart);CHKERRQ(ierr);
+    for (v = 0; v < N; ++v) {
+      for (e = gxadj[v]; e < gxadj[v+1]; ++e) if (tpart[gadjncy[e]] != tpart[v]) tcut += gadjwgt[e];
+    }
+    if (!t || tcut < cut) {
+      cut  = tcut;
+      ierr = PetscArraycpy(gpart, tpart, N);CHKERRQ(ierr);
+    }
+  }
+  ierr   = MPIU_Allreduce(&cut, &minCut, 1, MPIU_INT, MPI_MIN, comm);CHKERRQ(ierr);
+  winner = cut == minCut ? rank : size;
+  ierr   = MPIU_Allreduce(MPI_IN_PLACE, &winner, 1, MPIU_INT, MPI_MIN, comm);CHKERRQ(ierr);
+  ierr   = MPI_Bcast(gpart, N, MPIU_INT, (PetscMPIInt) winner, comm);CHKERRQ(ierr);
+  ierr   = PetscArraycpy(part, &gpart[g->vtxdist[rank]], g->n);CHKERRQ(ierr);
+  ierr   = PetscPartitionerMLGraphUpdateGhosts_Private(g, part);CHKERRQ(ierr);
+  ierr   = PetscFree6(gxadj, gadjncy, gadjwgt, gvwgt, gpart, tpart);CHKERRQ(ierr);
+  ierr   = PetscFree4(counts, displs, ecounts, edispls);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  Parallel boundary refinement by label propagation. In each sweep a local vertex moves to the neighboring part with the largest
+  gain in edge cut, if positive, or if it improves the balance without changing the cut. To avoid two neighboring vertices on
+  different processes trading their parts, moves go only to higher parts in even sweeps and to lower parts in odd sweeps. The
+  room left in a part is shared among the processes with vertices next to it, or given to one process at a time when too small
+  to share, so that simultaneous moves cannot overload it.
+  Vertices of an overloaded part move whatever their gain, each process giving away its share of the excess weight. A positive
+  migration cost, with parts matching processes, is charged per unit of vertex weight leaving its process and refunded on return.
+  The process holding the most vertices of a part keeps its last one, so that no part is emptied.
+*/
+static PetscErrorCode PetscPartitionerMultilevelRefine_Private(MPI_Comm comm, PetscPartitionerMLGraph *g, PetscInt nparts, PetscReal imbalance, PetscReal migration, PetscInt its, PetscInt part[])
+{
+  PetscInt       *pw, *delta, *flow, *conn, *touched, *border, *cnt, u, e, p, t, it, tw, maxvw = 0, moves, idle = 0;
+  PetscInt64     *keeper;
+  PetscReal      *room, maxw;
+  PetscBool      starved;
+  PetscMPIInt    size, rank;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  /* flow holds the weight moved into each part then out of each part, border the number of processes next to each part then holding it */
+  ierr = PetscCalloc7(nparts, &pw, nparts, &delta, 2*nparts, &flow, nparts, &conn, nparts, &touched, 2*nparts, &border, 2*nparts, &room);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nparts, &cnt, nparts, &keeper);CHKERRQ(ierr);
+  for (u = 0; u < g->n; ++u) pw[part[u]] += g->vwgt[u];
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, pw, nparts, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  for (p = 0, tw = 0; p < nparts; ++p) tw += pw[p];
+  /* Leave room for at least one vertex, so that vertices can still move from a balanced partition */
+  for (u = 0; u < g->n; ++u) maxvw = PetscMax(maxvw, g->vwgt[u]);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &maxvw, 1, MPIU_INT, MPI_MAX, comm);CHKERRQ(ierr);
+  maxw = PetscMax(imbalance*tw/nparts, (PetscReal) tw/nparts + maxvw);
+  for (it = 0; it < its && idle < 2; ++it) {
+    /* Count the processes with vertices next to each part and holding vertices of each part */
+    ierr = PetscArrayzero(border, 2*nparts);CHKERRQ(ierr);
+    ierr = PetscArrayzero(flow, 2*nparts);CHKERRQ(ierr);
+    ierr = PetscArrayzero(delta, nparts);CHKERRQ(ierr);
+    for (u = 0; u < g->n; ++u) {
+      border[nparts+part[u]] = 1;
+      for (e = g->xadj[u]; e < g->xadj[u+1]; ++e) if (part[g->adjncy[e]] != part[u]) border[part[g->adjncy[e]]] = 1;
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE, border, 2*nparts, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+    /* The keeper of each part is the process with the most of its vertices, the lowest rank among equals, from a 64-bit key */
+    ierr = PetscArrayzero(cnt, nparts);CHKERRQ(ierr);
+    for (u = 0; u < g->n; ++u) ++cnt[part[u]];
+    for (p = 0; p < nparts; ++p) keeper[p] = (PetscInt64) cnt[p]*size + size-1 - rank;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE, keeper, nparts, MPIU_INT64, MPI_MAX, comm);CHKERRQ(ierr);
+    for (p = 0; p < nparts; ++p) keeper[p] = size-1 - keeper[p]%size;
+    for (p = 0, starved = PETSC_FALSE; p < nparts; ++p) {
+      room[p]        = (maxw - pw[p])/PetscMax(border[p], 1);
+      /* A room too small to share goes whole to a single process, in turn */
+      if (room[p] > 0.0 && room[p] < maxvw) {
+        room[p] = (it % size == rank) ? maxw - pw[p] : 0.0;
+        starved = PETSC_TRUE;
+      }
+      room[nparts+p] = pw[p] > maxw ? PetscCeilReal(((PetscReal) pw[p] - (PetscReal) tw/nparts)/PetscMax(border[nparts+p], 1)) : 0.0;
+    }
+    for (u = 0, moves = 0; u < g->n; ++u) {
+      const PetscInt own = part[u], w = g->vwgt[u];
+      PetscInt       nt = 0, best = -1;
+      PetscReal      gain = 0.0, pgain;
+      PetscBool      over;
+
+      if (cnt[own] == 1 && keeper[own] == rank) continue;
+      for (e = g->xadj[u]; e < g->xadj[u+1]; ++e) {
+        p = part[g->adjncy[e]];
+        if (!conn[p]) touched[nt++] = p;
+        conn[p] += g->adjwgt[e];
+      }
+      over = flow[nparts+own] + w <= room[nparts+own] ? PETSC_TRUE : PETSC_FALSE;
+      for (t = 0; t < nt; ++t) {
+        p = touched[t];
+        if (p == own || flow[p] + w > room[p]) continue;
+        if (!over && ((it % 2) ? p > own : p < own)) continue;
+        pgain = conn[p] - conn[own] + migration*w*((p == rank ? 1 : 0) - (own == rank ? 1 : 0));
+        if (best < 0 || pgain > gain || (pgain == gain && pw[p] + delta[p] < pw[best] + delta[best])) {
+          best = p;
+          gain = pgain;
+        }
+      }
+      if (best >= 0 && (gain > 0.0 || over || (gain == 0.0 && pw[own] + delta[own] - w > pw[best] + delta[best]))) {
+        part[u]            = best;
+        delta[own]        -= w;
+        delta[best]       += w;
+        flow[best]        += w;
+        flow[nparts+own]  += w;
+        --cnt[own];
+        ++cnt[best];
+        ++moves;
+      }
+      for (t = 0; t < nt; ++t) conn[touched[t]] = 0;
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE, delta, nparts, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE, &moves, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+    for (p = 0; p < nparts; ++p) pw[p] += delta[p];
+    ierr = PetscPartitionerMLGraphUpdateGhosts_Private(g, part);CHKERRQ(ierr);
+    idle = moves || starved ? 0 : idle + 1;
+  }
+  ierr = PetscFree7(pw, delta, flow, conn, touched, border, room);CHKERRQ(ierr);
+  ierr = PetscFree2(cnt, keeper);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerMultilevelSetRepartition_Multilevel(PetscPartitioner part, PetscBool repartition, PetscReal migrationCost)
+{
+  PetscPartitioner_Multilevel *p = (PetscPartitioner_Multilevel *) part->data;
+
+  PetscFunctionBegin;
+  p->repartition = repartition;
+  if (migrationCost != PETSC_DEFAULT) p->migrationCost = migrationCost;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  PetscPartitionerMultilevelSetRepartition - Make a PETSCPARTITIONERMULTILEVEL partitioner improve the current distribution instead of partitioning from scratch
+
+  Logically collective on part
+
+  Input Parameters:
++ part          - The PetscPartitioner
+. repartition   - The flag to repartition starting from the current distribution
+- migrationCost - The cost of migrating a unit of cell weight relative to cutting a unit of edge weight, or PETSC_DEFAULT
+
+  Options Database Keys:
++ -petscpartitioner_multilevel_repartition - Repartition starting from the current distribution
+- -petscpartitioner_multilevel_migration_cost <1.0> - The migration cost
+
+  Notes:
+  When repartitioning, each process keeps its cells unless moving them reduces the edge cut by more than the migration cost or
+  is needed to meet the load imbalance ratio, so the load diffuses to neighboring processes and few cells migrate. This suits
+  the rebalancing of an adapted mesh with DMPlexRebalance(). Repartitioning requires as many parts as processes.
+
+  This does nothing for other partitioner types.
+
+  Level: intermediate
+
+.seealso: PETSCPARTITIONERMULTILEVEL, DMPlexRebalance(), PetscPartitionerCreate()
+@*/
+PetscErrorCode PetscPartitionerMultilevelSetRepartition(PetscPartitioner part, PetscBool repartition, PetscReal migrationCost)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(part, PETSCPARTITIONER_CLASSID, 1);
+  PetscValidLogicalCollectiveBool(part, repartition, 2);
+  PetscValidLogicalCollectiveReal(part, migrationCost, 3);
+  ierr = PetscTryMethod(part, "PetscPartitionerMultilevelSetRepartition_C", (PetscPartitioner,PetscBool,PetscReal), (part,repartition,migrationCost));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerDestroy_Multilevel(PetscPartitioner part)
+{
+  PetscPartitioner_Multilevel *p = (PetscPartitioner_Multilevel *) part->data;
+  PetscErrorCode               ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectComposeFunction((PetscObject) part, "PetscPartitionerMultilevelSetRepartition_C", NULL);CHKERRQ(ierr);
+  ierr = PetscFree(p);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerView_Multilevel_Ascii(PetscPartitioner part, PetscViewer viewer)
+{
+  PetscPartitioner_Multilevel *p = (PetscPartitioner_Multilevel *) part->data;
+  PetscErrorCode               ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "load imbalance ratio %g\n", (double) p->imbalanceRatio);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "coarsest graph size per part %D\n", p->coarsenSize);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "refinement sweeps per level %D\n", p->refineIts);CHKERRQ(ierr);
+  if (p->repartition) {ierr = PetscViewerASCIIPrintf(viewer, "repartitioning with migration cost %g\n", (double) p->migrationCost);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerView_Multilevel(PetscPartitioner part, PetscViewer viewer)
+{
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(part, PETSCPARTITIONER_CLASSID, 1);
+  PetscValidHeaderSpecific(viewer, PETSC_VIEWER_CLASSID, 2);
+  ierr = PetscObjectTypeCompare((PetscObject) viewer, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (iascii) {ierr = PetscPartitionerView_Multilevel_Ascii(part, viewer);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerSetFromOptions_Multilevel(PetscOptionItems *PetscOptionsObject, PetscPartitioner part)
+{
+  PetscPartitioner_Multilevel *p = (PetscPartitioner_Multilevel *) part->data;
+  PetscErrorCode               ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject, "PetscPartitioner Multilevel Options");CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-petscpartitioner_multilevel_imbalance_ratio", "Load imbalance ratio limit", "", p->imbalanceRatio, &p->imbalanceRatio, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBoundedInt("-petscpartitioner_multilevel_coarsen_size", "Coarsening stops below this number of vertices per part", "", p->coarsenSize, &p->coarsenSize, NULL, 1);CHKERRQ(ierr);
+  ierr = PetscOptionsBoundedInt("-petscpartitioner_multilevel_refine_its", "Largest number of refinement sweeps on each level", "", p->refineIts, &p->refineIts, NULL, 0);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-petscpartitioner_multilevel_repartition", "Repartition starting from the current distribution", "PetscPartitionerMultilevelSetRepartition", p->repartition, &p->repartition, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-petscpartitioner_multilevel_migration_cost", "Cost of migrating a unit of vertex weight relative to cutting a unit of edge weight", "PetscPartitionerMultilevelSetRepartition", p->migrationCost, &p->migrationCost, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerPartition_Multilevel(PetscPartitioner part, DM dm, PetscInt nparts, PetscInt numVertices, PetscInt start[], PetscInt adjacency[], PetscSection partSection, IS *partition)
+{
+  PetscPartitioner_Multilevel *pm = (PetscPartitioner_Multilevel *) part->data;
+  PetscPartitionerMLGraph      graphs[PETSCPARTITIONER_MULTILEVEL_MAXLEVELS];
+  MPI_Comm                     comm;
+  PetscSection                 section;
+  PetscInt                    *vtxdist, *xadj, *adjncy, *adjwgt, *vwgt, *cpart, *fpart, *points, *offsets;
+  PetscInt                     nlevels = 1, l, v, e, N, tw = 0, maxvwgt, cut = 0, maxpw;
+  PetscReal                    migration = 0.0;
+  PetscBool                    coarsened = PETSC_TRUE, repartition = PETSC_FALSE;
+  PetscMPIInt                  size, rank, p;
+  PetscErrorCode               ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject) part, &comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  if (pm->repartition) {
+    if (nparts == size) {
+      repartition = PETSC_TRUE;
+      migration   = pm->migrationCost;
+    } else {ierr = PetscInfo2(part, "Cannot repartition into %D parts on %d processes, partitioning from scratch\n", nparts, size);CHKERRQ(ierr);}
+  }
+  /* Calculate vertex distribution */
+  ierr = PetscMalloc1(size+1, &vtxdist);CHKERRQ(ierr);
+  vtxdist[0] = 0;
+  ierr = MPI_Allgather(&numVertices, 1, MPIU_INT, &vtxdist[1], 1, MPIU_INT, comm);CHKERRQ(ierr);
+  for (p = 2; p <= size; ++p) vtxdist[p] += vtxdist[p-1];
+  N    = vtxdist[size];
+  ierr = PetscMalloc4(numVertices+1, &xadj, start[numVertices], &adjncy, start[numVertices], &adjwgt, numVertices, &vwgt);CHKERRQ(ierr);
+  ierr = PetscArraycpy(xadj, start, numVertices+1);CHKERRQ(ierr);
+  ierr = PetscArraycpy(adjncy, adjacency, start[numVertices]);CHKERRQ(ierr);
+  for (e = 0; e < start[numVertices]; ++e) adjwgt[e] = 1;
+  /* Weight cells by dofs on cell by default */
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  for (v = 0; v < numVertices; ++v) vwgt[v] = 1;
+  if (section) {
+    PetscInt cStart, cEnd, dof;
+
+    /* WARNING: Assumes that meshes with overlap have the overlapped cells at the end of the stratum. */
+    /* To do this properly, we should use the cell numbering created in DMPlexCreatePartitionerGraph. */
+    ierr = DMPlexGetHeightStratum(dm, part->height, &cStart, &cEnd);CHKERRQ(ierr);
+    for (v = cStart; v < cStart + numVertices; ++v) {
+      ierr = PetscSectionGetDof(section, v, &dof);CHKERRQ(ierr);
+      vwgt[v-cStart] = PetscMax(dof, 1);
+    }
+  }
+  for (v = 0; v < numVertices; ++v) tw += vwgt[v];
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &tw, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  ierr = PetscPartitionerMLGraphSetUp_Private(comm, numVertices, vtxdist, xadj, adjncy, adjwgt, vwgt, &graphs[0]);CHKERRQ(ierr);
+
+  /* Coarsen, limiting the weight of coarse vertices so that the coarsest graph can still be balanced */
+  maxvwgt = (PetscInt) PetscMax(1.5*tw/(pm->coarsenSize*nparts), 2);
+  while (N > pm->coarsenSize*nparts && nlevels < PETSCPARTITIONER_MULTILEVEL_MAXLEVELS) {
+    ierr = PetscPartitionerMLGraphCoarsen_Private(comm, &graphs[nlevels-1], maxvwgt, repartition, &graphs[nlevels], &coarsened);CHKERRQ(ierr);
+    if (!coarsened) break;
+    /* Keep at least one vertex per part on the coarsest graph */
+    if (graphs[nlevels].vtxdist[size] < nparts) {
+      ierr = PetscPartitionerMLGraphDestroy_Private(&graphs[nlevels]);CHKERRQ(ierr);
+      break;
+    }
+    N = graphs[nlevels++].vtxdist[size];
+  }
+  ierr = PetscInfo3(part, "Multilevel partitioning into %D parts with %D levels, coarsest graph has %D vertices\n", nparts, nlevels, N);CHKERRQ(ierr);
+
+  /* Partition the coarsest graph, then project and refine on each finer level */
+  l    = nlevels-1;
+  ierr = PetscMalloc1(graphs[l].n + graphs[l].nghost, &cpart);CHKERRQ(ierr);
+  if (nparts == 1) {
+    ierr = PetscArrayzero(cpart, graphs[l].n + graphs[l].nghost);CHKERRQ(ierr);
+  } else {
+    if (repartition) {
+      for (v = 0; v < graphs[l].n; ++v) cpart[v] = rank;
+      ierr = PetscPartitionerMLGraphUpdateGhosts_Private(&graphs[l], cpart);CHKERRQ(ierr);
+    } else {
+      ierr = PetscPartitionerMultilevelInitial_Private(comm, &graphs[l], nparts, pm->imbalanceRatio, cpart);CHKERRQ(ierr);
+    }
+    ierr = PetscPartitionerMultilevelRefine_Private(comm, &graphs[l], nparts, pm->imbalanceRatio, migration, pm->refineIts, cpart);CHKERRQ(ierr);
+  }
+  for (--l; l >= 0; --l) {
+    ierr = PetscMalloc1(graphs[l].n + graphs[l].nghost, &fpart);CHKERRQ(ierr);
+    ierr = PetscPartitionerMLGraphProject_Private(&graphs[l], cpart, fpart);CHKERRQ(ierr);
+    ierr = PetscFree(cpart);CHKERRQ(ierr);
+    if (nparts > 1) {ierr = PetscPartitionerMultilevelRefine_Private(comm, &graphs[l], nparts, pm->imbalanceRatio, migration, pm->refineIts, fpart);CHKERRQ(ierr);}
+    cpart = fpart;
+  }
+
+  /* Edge cut and balance of the partition */
+  ierr = PetscCalloc1(nparts+1, &offsets);CHKERRQ(ierr);
+  for (v = 0; v < numVertices; ++v) {
+    offsets[cpart[v]+1] += graphs[0].vwgt[v];
+    for (e = graphs[0].xadj[v]; e < graphs[0].xadj[v+1]; ++e) if (cpart[graphs[0].adjncy[e]] != cpart[v]) ++cut;
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &cut, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, offsets+1, nparts, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  for (p = 0, maxpw = 0; p < nparts; ++p) maxpw = PetscMax(maxpw, offsets[p+1]);
+  part->edgeCut = cut/2;
+  part->balance = tw ? (PetscReal) maxpw*nparts/tw : 1.0;
+
+  /* Convert to PetscSection+IS */
+  ierr = PetscSectionSetChart(partSection, 0, nparts);CHKERRQ(ierr);
+  for (v = 0; v < numVertices; ++v) {ierr = PetscSectionAddDof(partSection, cpart[v], 1);CHKERRQ(ierr);}
+  ierr = PetscSectionSetUp(partSection);CHKERRQ(ierr);
+  ierr = PetscArrayzero(offsets, nparts+1);CHKERRQ(ierr);
+  for (v = 0; v < numVertices; ++v) ++offsets[cpart[v]+1];
+  for (p = 0; p < nparts; ++p) offsets[p+1] += offsets[p];
+  ierr = PetscMalloc1(numVertices, &points);CHKERRQ(ierr);
+  for (v = 0; v < numVertices; ++v) points[offsets[cpart[v]]++] = v;
+  ierr = ISCreateGeneral(comm, numVertices, points, PETSC_OWN_POINTER, partition);CHKERRQ(ierr);
+  ierr = PetscFree(offsets);CHKERRQ(ierr);
+  ierr = PetscFree(cpart);CHKERRQ(ierr);
+  for (l = 0; l < nlevels; ++l) {ierr = PetscPartitionerMLGraphDestroy_Private(&graphs[l]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscPartitionerInitialize_Multilevel(PetscPartitioner part)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  part->noGraph             = PETSC_FALSE;
+  part->ops->view           = PetscPartitionerView_Multilevel;
+  part->ops->setfromoptions = PetscPartitionerSetFromOptions_Multilevel;
+  part->ops->destroy        = PetscPartitionerDestroy_Multilevel;
+  part->ops->partition      = PetscPartitionerPartition_Multilevel;
+  ierr = PetscObjectComposeFunction((PetscObject) part, "PetscPartitionerMultilevelSetRepartition_C", PetscPartitionerMultilevelSetRepartition_Multilevel);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  PETSCPARTITIONERMULTILEVEL = "multilevel" - A PetscPartitioner object implementing a parallel multilevel graph partitioner, which needs no external package
+
+  The graph is coarsened by heavy edge matching, the coarsest graph is partitioned by recursive bisection with greedy graph growing, and the
+  partition is refined on each level by parallel label propagation with a balance constraint. Cells are weighted by their number of dofs in
+  the local section of the DM, if any.
+
+  Options Database Keys:
++ -petscpartitioner_multilevel_imbalance_ratio <1.05> - Largest allowed ratio of a part weight to the average part weight
+. -petscpartitioner_multilevel_coarsen_size <20>      - Coarsening stops when the graph has fewer vertices than this number times the number of parts
+. -petscpartitioner_multilevel_refine_its <10>        - Largest number of refinement sweeps on each level
+. -petscpartitioner_multilevel_repartition            - Repartition starting from the current distribution, see PetscPartitionerMultilevelSetRepartition()
+- -petscpartitioner_multilevel_migration_cost <1.0>   - Cost of migrating a unit of cell weight relative to cutting a unit of edge weight when repartitioning
+
+  Level: intermediate
+
+.seealso: PetscPartitionerType, PetscPartitionerCreate(), PetscPartitionerSetType(), PetscPartitionerMultilevelSetRepartition(), DMPlexRebalance(), PETSCPARTITIONERPARMETIS
+M*/
+
+PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_Multilevel(PetscPartitioner part)
+{
+  PetscPartitioner_Multilevel *p;
+  PetscErrorCode               ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(part, PETSCPARTITIONER_CLASSID, 1);
+  ierr       = PetscNewLog(part, &p);CHKERRQ(ierr);
+  part->data = p;
+
+  p->imbalanceRatio = 1.05;
+  p->coarsenSize    = 20;
+  p->refineIts      = 10;
+  p->repartition    = PETSC_FALSE;
+  p->migrationCost  = 1.0;
+
+  ierr = PetscPartitionerInitialize_Multilevel(part);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -4417,7 +4417,7 @@ PetscErrorCode DMPlexVecGetClosure(DM dm, PetscSection section, Vec v, PetscInt
   PetscScalar       *array;
   const PetscScalar *vArray;
   PetscInt          *points = NULL;
-  const PetscInt    *clp, *perm;
+  const PetscInt    *clp, *perm, *clIdx;
   PetscInt           depth, numFields, numPoints, size;
   PetscErrorCode     ierr;
 
@@ -4426,6 +4426,26 @@ PetscErrorCode DMPlexVecGetClosure(DM dm, PetscSection section, Vec v, PetscInt
   if (!section) {ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);}
   PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 2);
   PetscValidHeaderSpecific(v, VEC_CLASSID, 3);
+  ierr = DMPlexGetClosureDofIndex_Internal(dm, section, point, &size, &clIdx);CHKERRQ(ierr);
+  if (clIdx) {
+    PetscInt i;
+
+    if (!values) {
+      if (csize) *csize = size;
+      PetscFunctionReturn(0);
+    }
+    if (!*values) {ierr = DMGetWorkArray(dm, size, MPIU_SCALAR, &array);CHKERRQ(ierr);}
+    else {
+      if (size > *csize) SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Size of input array %D < actual size %D", *csize, size);
+      array = *values;
+    }
+    ierr = VecGetArrayRead(v, &vArray);CHKERRQ(ierr);
+    for (i = 0; i < size; ++i) array[i] = vArray[clIdx[i] < 0 ? -(clIdx[i]+1) : clIdx[i]];
+    ierr = VecRestoreArrayRead(v, &vArray);CHKERRQ(ierr);
+    if (csize) *csize = size;
+    *values = array;
+    PetscFunctionReturn(0);
+  }
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   ierr = PetscSectionGetNumFields(section, &numFields);CHKERRQ(ierr);
   if (depth == 1 && numFields < 2) {
@@ -4840,7 +4860,7 @@ PetscErrorCode DMPlexVecSetClosure(DM dm, PetscSection section, Vec v, PetscInt
   IS              clPoints;
   PetscScalar    *array;
   PetscInt       *points = NULL;
-  const PetscInt *clp, *clperm;
+  const PetscInt *clp, *clperm, *clIdx;
   PetscInt        depth, numFields, numPoints, p;
   PetscErrorCode  ierr;
 
@@ -4849,6 +4869,35 @@ PetscErrorCode DMPlexVecSetClosure(DM dm, PetscSection section, Vec v, PetscInt
   if (!section) {ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);}
   PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 2);
   PetscValidHeaderSpecific(v, VEC_CLASSID, 3);
+  ierr = DMPlexGetClosureDofIndex_Internal(dm, section, point, &numPoints, &clIdx);CHKERRQ(ierr);
+  if (clIdx) {
+    /* Constrained dofs are encoded as -(off+1) in the cached indices */
+    ierr = VecGetArray(v, &array);CHKERRQ(ierr);
+    switch (mode) {
+    case INSERT_VALUES:
+      for (p = 0; p < numPoints; ++p) if (clIdx[p] >= 0) array[clIdx[p]] = values[p];
+      break;
+    case INSERT_ALL_VALUES:
+      for (p = 0; p < numPoints; ++p) array[clIdx[p] < 0 ? -(clIdx[p]+1) : clIdx[p]] = values[p];
+      break;
+    case INSERT_BC_VALUES:
+      for (p = 0; p < numPoints; ++p) if (clIdx[p] < 0) array[-(clIdx[p]+1)] = values[p];
+      break;
+    case ADD_VALUES:
+      for (p = 0; p < numPoints; ++p) if (clIdx[p] >= 0) array[clIdx[p]] += values[p];
+      break;
+    case ADD_ALL_VALUES:
+      for (p = 0; p < numPoints; ++p) array[clIdx[p] < 0 ? -(clIdx[p]+1) : clIdx[p]] += values[p];
+      break;
+    case ADD_BC_VALUES:
+      for (p = 0; p < numPoints; ++p) if (clIdx[p] < 0) array[-(clIdx[p]+1)] += values[p];
+      break;
+    default:
+      SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_ARG_OUTOFRANGE, "Invalid insert mode %d", mode);
+    }
+    ierr = VecRestoreArray(v, &array);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = DMPlexGetDepth(dm, &depth);CHKERRQ(ierr);
   ierr = PetscSectionGetNumFields(section, &numFields);CHKERRQ(ierr);
   if (depth == 1 && numFields < 2 && mode == ADD_VALUES) {
@@ -5790,6 +5839,32 @@ PetscErrorCode DMPlexAnchorsModifyMat(DM dm, PetscSection section, PetscInt numP
 .seealso DMPlexRestoreClosureIndices(), DMPlexVecGetClosure(), DMPlexMatSetClosure()
 @*/
 PetscErrorCode DMPlexGetClosureIndices(DM dm, PetscSection section, PetscSection globalSection, PetscInt point, PetscInt *numIndices, PetscInt **indices, PetscInt *outOffsets)
+{
+  const PetscInt *clIdx;
+  PetscInt        clSize, Nf;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 2);
+  PetscValidHeaderSpecific(globalSection, PETSC_SECTION_CLASSID, 3);
+  if (numIndices) PetscValidPointer(numIndices, 4);
+  PetscValidPointer(indices, 5);
+  ierr = PetscSectionGetNumFields(section, &Nf);CHKERRQ(ierr);
+  if (!Nf || !outOffsets) {ierr = DMPlexGetClosureGlobalDofIndex_Internal(dm, section, globalSection, point, &clSize, &clIdx);CHKERRQ(ierr);}
+  else                    clIdx = NULL;
+  if (clIdx) {
+    ierr = DMGetWorkArray(dm, clSize, MPIU_INT, indices);CHKERRQ(ierr);
+    ierr = PetscArraycpy(*indices, clIdx, clSize);CHKERRQ(ierr);
+    if (numIndices) *numIndices = clSize;
+    PetscFunctionReturn(0);
+  }
+  ierr = DMPlexGetClosureIndices_Internal(dm, section, globalSection, point, numIndices, indices, outOffsets);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Computes the closure indices without consulting the closure dof index cache */
+PetscErrorCode DMPlexGetClosureIndices_Internal(DM dm, PetscSection section, PetscSection globalSection, PetscInt point, PetscInt *numIndices, PetscInt **indices, PetscInt *outOffsets)
 {
   PetscSection    clSection;
   IS              clPoints;
@@ -5942,12 +6017,13 @@ PetscErrorCode DMPlexMatSetClosure(DM dm, PetscSection section, PetscSection glo
   PetscSection        clSection;
   IS                  clPoints;
   PetscInt           *points = NULL, *newPoints;
-  const PetscInt     *clp, *clperm;
+  const PetscInt     *clp, *clperm, *clIdx = NULL;
   PetscInt           *indices;
   PetscInt            offsets[32];
   const PetscInt    **perms[32] = {NULL};
   const PetscScalar **flips[32] = {NULL};
   PetscInt            numFields, numPoints, newNumPoints, numIndices, newNumIndices, dof, off, globalOff, p, f;
+  PetscBool           useFieldOffsets;
   PetscScalar        *valCopy = NULL;
   PetscScalar        *newValues;
   PetscErrorCode      ierr;
@@ -5961,6 +6037,28 @@ PetscErrorCode DMPlexMatSetClosure(DM dm, PetscSection section, PetscSection glo
   PetscValidHeaderSpecific(A, MAT_CLASSID, 4);
   ierr = PetscSectionGetNumFields(section, &numFields);CHKERRQ(ierr);
   if (numFields > 31) SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_ARG_OUTOFRANGE, "Number of fields %D limited to 31", numFields);
+  ierr = PetscSectionGetUseFieldOffsets(globalSection, &useFieldOffsets);CHKERRQ(ierr);
+  if (!numFields || !useFieldOffsets) {ierr = DMPlexGetClosureGlobalDofIndex_Internal(dm, section, globalSection, point, &numIndices, &clIdx);CHKERRQ(ierr);}
+  if (clIdx) {
+    if (mesh->printSetValues) {ierr = DMPlexPrintMatSetValues(PETSC_VIEWER_STDOUT_SELF, A, point, numIndices, clIdx, 0, NULL, values);CHKERRQ(ierr);}
+    ierr = MatSetValues(A, numIndices, clIdx, numIndices, clIdx, values, mode);
+    if (mesh->printFEM > 1) {
+      PetscInt i;
+      ierr = PetscPrintf(PETSC_COMM_SELF, "  Indices:");CHKERRQ(ierr);
+      for (i = 0; i < numIndices; ++i) {ierr = PetscPrintf(PETSC_COMM_SELF, " %D", clIdx[i]);CHKERRQ(ierr);}
+      ierr = PetscPrintf(PETSC_COMM_SELF, "\n");CHKERRQ(ierr);
+    }
+    if (ierr) {
+      PetscMPIInt    rank;
+      PetscErrorCode ierr2;
+
+      ierr2 = MPI_Comm_rank(PetscObjectComm((PetscObject)A), &rank);CHKERRQ(ierr2);
+      ierr2 = (*PetscErrorPrintf)("[%d]ERROR in DMPlexMatSetClosure\n", rank);CHKERRQ(ierr2);
+      ierr2 = DMPlexPrintMatSetValues(PETSC_VIEWER_STDERR_SELF, A, point, numIndices, clIdx, 0, NULL, values);CHKERRQ(ierr2);
+      CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
   ierr = PetscArrayzero(offsets, 32);CHKERRQ(ierr);
   ierr = PetscSectionGetClosureInversePermutation_Internal(section, (PetscObject) dm, NULL, &clperm);CHKERRQ(ierr);
   ierr = DMPlexGetCompressedClosure(dm,section,point,&numPoints,&points,&clSection,&clPoints,&clp);CHKERRQ(ierr);
@@ -6035,9 +6133,6 @@ PetscErrorCode DMPlexMatSetClosure(DM dm, PetscSection section, PetscSection glo
   }
   ierr = DMGetWorkArray(dm, numIndices, MPIU_INT, &indices);CHKERRQ(ierr);
   if (numFields) {
-    PetscBool useFieldOffsets;
-
-    ierr = PetscSectionGetUseFieldOffsets(globalSection, &useFieldOffsets);CHKERRQ(ierr);
     if (useFieldOffsets) {
       for (p = 0; p < numPoints; p++) {
         DMPlexGetIndicesPointFieldsSplit_Internal(section, globalSection, points[2*p], offsets, PETSC_FALSE, perms, p, clperm, indices);
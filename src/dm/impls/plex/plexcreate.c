@@ -2265,6 +2265,8 @@ PetscErrorCode DMSetFromOptions_NonRefinement_Plex(PetscOptionItems *PetscOption
   /* Projection behavior */
   ierr = PetscOptionsBoundedInt("-dm_plex_max_projection_height", "Maxmimum mesh point height used to project locally", "DMPlexSetMaxProjectionHeight", 0, &mesh->maxProjectionHeight, NULL,0);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-dm_plex_regular_refinement", "Use special nested projection algorithm for regular refinement", "DMPlexSetRegularRefinement", mesh->regularRefinement, &mesh->regularRefinement, NULL);CHKERRQ(ierr);
+  /* Closure operations */
+  ierr = PetscOptionsBool("-dm_plex_closure_cache", "Cache the dof indices of cell closures", "DMPlexSetClosureCache", mesh->closureCache, &mesh->closureCache, NULL);CHKERRQ(ierr);
   /* Checking structure */
   {
     PetscBool   flg = PETSC_FALSE, flg2 = PETSC_FALSE;
@@ -2360,6 +2362,27 @@ static PetscErrorCode DMSetFromOptions_Plex(PetscOptionItems *PetscOptionsObject
       ierr = DMDestroy(&coarseMesh);CHKERRQ(ierr);
     }
   }
+  /* Handle DMPlex reordering */
+  {
+    char      otype[256] = "";
+    PetscBool flg;
+
+    ierr = PetscOptionsString("-dm_plex_reorder", "Reorder the local mesh points, e.g. hilbert, morton or rcm", "DMPlexGetOrdering", otype, otype, sizeof(otype), &flg);CHKERRQ(ierr);
+    if (flg) {
+      DM        pdm;
+      IS        perm;
+      PetscBool hasSection = dm->defaultSection ? PETSC_TRUE : PETSC_FALSE;
+
+      ierr = DMPlexGetOrdering(dm, otype, NULL, &perm);CHKERRQ(ierr);
+      ierr = DMPlexPermute(dm, perm, &pdm);CHKERRQ(ierr);
+      ierr = ISDestroy(&perm);CHKERRQ(ierr);
+      /* Total hack since we do not pass in a pointer */
+      ierr = DMPlexReplace_Static(dm, pdm);CHKERRQ(ierr);
+      /* DMPlexPermute() builds a section if none was set, which must not outlive the discretization setup */
+      ierr = DMSetLocalSection(dm, hasSection ? pdm->defaultSection : NULL);CHKERRQ(ierr);
+      ierr = DMDestroy(&pdm);CHKERRQ(ierr);
+    }
+  }
   /* Handle */
   ierr = DMSetFromOptions_NonRefinement_Plex(PetscOptionsObject, dm);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
@@ -2565,6 +2588,8 @@ PETSC_EXTERN PetscErrorCode DMCreate_Plex(DM dm)
 
   mesh->maxProjectionHeight = 0;
 
+  mesh->closureCache = PETSC_FALSE;
+
   mesh->printSetValues = PETSC_FALSE;
   mesh->printFEM       = 0;
   mesh->printTol       = 1.0e-10;
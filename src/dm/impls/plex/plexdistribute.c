@@ -1546,60 +1546,15 @@ PetscErrorCode DMPlexMigrate(DM dm, PetscSF sf, DM targetDM)
   PetscFunctionReturn(0);
 }
 
-/*@C
-  DMPlexDistribute - Distributes the mesh and any associated sections.
-
-  Collective on dm
-
-  Input Parameter:
-+ dm  - The original DMPlex object
-- overlap - The overlap of partitions, 0 is the default
-
-  Output Parameter:
-+ sf - The PetscSF used for point distribution, or NULL if not needed
-- dmParallel - The distributed DMPlex object
-
-  Note: If the mesh was not distributed, the output dmParallel will be NULL.
-
-  The user can control the definition of adjacency for the mesh using DMSetAdjacency(). They should choose the combination appropriate for the function
-  representation on the mesh.
-
-  Level: intermediate
-
-.seealso: DMPlexCreate(), DMSetAdjacency()
-@*/
-PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmParallel)
+/* Convert a cell partition to the stratified migration SF, rankMap[] giving the process receiving each part, or NULL for the identity */
+static PetscErrorCode DMPlexCreateMigrationSF_Private(DM dm, PetscSection cellPartSection, IS cellPart, const PetscInt rankMap[], PetscSF *sfMigration)
 {
-  MPI_Comm               comm;
-  PetscPartitioner       partitioner;
-  IS                     cellPart;
-  PetscSection           cellPartSection;
-  DM                     dmCoord;
-  DMLabel                lblPartition, lblMigration;
-  PetscSF                sfMigration, sfStratified, sfPoint;
-  PetscBool              flg, balance;
-  PetscMPIInt            rank, size;
-  PetscErrorCode         ierr;
+  DMLabel        lblPartition, lblMigration;
+  PetscSF        sfStratified;
+  PetscBool      flg;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
-  PetscValidLogicalCollectiveInt(dm, overlap, 2);
-  if (sf) PetscValidPointer(sf,3);
-  PetscValidPointer(dmParallel,4);
-
-  if (sf) *sf = NULL;
-  *dmParallel = NULL;
-  ierr = PetscObjectGetComm((PetscObject)dm,&comm);CHKERRQ(ierr);
-  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
-  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
-  if (size == 1) PetscFunctionReturn(0);
-
-  ierr = PetscLogEventBegin(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
-  /* Create cell partition */
-  ierr = PetscLogEventBegin(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
-  ierr = PetscSectionCreate(comm, &cellPartSection);CHKERRQ(ierr);
-  ierr = DMPlexGetPartitioner(dm, &partitioner);CHKERRQ(ierr);
-  ierr = PetscPartitionerPartition(partitioner, dm, cellPartSection, &cellPart);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(DMPLEX_PartSelf,dm,0,0,0);CHKERRQ(ierr);
   {
     /* Convert partition to DMLabel */
@@ -1615,7 +1570,7 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
     ierr = PetscSectionGetChart(cellPartSection, &pStart, &pEnd);CHKERRQ(ierr);
     for (proc = pStart; proc < pEnd; proc++) {
       ierr = PetscSectionGetDof(cellPartSection, proc, &npoints);CHKERRQ(ierr);
-      if (npoints) {ierr = PetscHSetIAdd(ht, proc);CHKERRQ(ierr);}
+      if (npoints) {ierr = PetscHSetIAdd(ht, rankMap ? rankMap[proc] : proc);CHKERRQ(ierr);}
     }
     ierr = PetscHSetIGetSize(ht, &nranks);CHKERRQ(ierr);
     ierr = PetscMalloc1(nranks, &iranks);CHKERRQ(ierr);
@@ -1631,7 +1586,7 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
       if (!npoints) continue;
       ierr = PetscSectionGetOffset(cellPartSection, proc, &poff);CHKERRQ(ierr);
       ierr = DMPlexClosurePoints_Private(dm, npoints, points+poff, &is);CHKERRQ(ierr);
-      ierr = DMLabelSetStratumIS(lblPartition, proc, is);CHKERRQ(ierr);
+      ierr = DMLabelSetStratumIS(lblPartition, rankMap ? rankMap[proc] : proc, is);CHKERRQ(ierr);
       ierr = ISDestroy(&is);CHKERRQ(ierr);
     }
     ierr = ISRestoreIndices(cellPart, &points);CHKERRQ(ierr);
@@ -1640,18 +1595,33 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
 
   ierr = DMLabelCreate(PETSC_COMM_SELF, "Point migration", &lblMigration);CHKERRQ(ierr);
   ierr = DMPlexPartitionLabelInvert(dm, lblPartition, NULL, lblMigration);CHKERRQ(ierr);
-  ierr = DMPlexPartitionLabelCreateSF(dm, lblMigration, &sfMigration);CHKERRQ(ierr);
-  ierr = DMPlexStratifyMigrationSF(dm, sfMigration, &sfStratified);CHKERRQ(ierr);
-  ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);
-  sfMigration = sfStratified;
-  ierr = PetscSFSetUp(sfMigration);CHKERRQ(ierr);
-  ierr = PetscLogEventEnd(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
+  ierr = DMPlexPartitionLabelCreateSF(dm, lblMigration, sfMigration);CHKERRQ(ierr);
+  ierr = DMPlexStratifyMigrationSF(dm, *sfMigration, &sfStratified);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(sfMigration);CHKERRQ(ierr);
+  *sfMigration = sfStratified;
+  ierr = PetscSFSetUp(*sfMigration);CHKERRQ(ierr);
   ierr = PetscOptionsHasName(((PetscObject) dm)->options,((PetscObject) dm)->prefix, "-partition_view", &flg);CHKERRQ(ierr);
   if (flg) {
-    ierr = DMLabelView(lblPartition, PETSC_VIEWER_STDOUT_(comm));CHKERRQ(ierr);
-    ierr = PetscSFView(sfMigration, PETSC_VIEWER_STDOUT_(comm));CHKERRQ(ierr);
+    ierr = DMLabelView(lblPartition, PETSC_VIEWER_STDOUT_(PetscObjectComm((PetscObject) dm)));CHKERRQ(ierr);
+    ierr = PetscSFView(*sfMigration, PETSC_VIEWER_STDOUT_(PetscObjectComm((PetscObject) dm)));CHKERRQ(ierr);
   }
+  ierr = DMLabelDestroy(&lblPartition);CHKERRQ(ierr);
+  ierr = DMLabelDestroy(&lblMigration);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
+/* Migrate the mesh over the migration SF, which is consumed, and add the overlap */
+static PetscErrorCode DMPlexMigrateAndOverlap_Private(DM dm, PetscInt overlap, PetscSF sfMigration, PetscSF *sf, DM *dmParallel)
+{
+  MPI_Comm               comm;
+  DM                     dmCoord;
+  PetscSF                sfPoint;
+  PetscBool              flg, balance;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)dm,&comm);CHKERRQ(ierr);
+  ierr = PetscOptionsHasName(((PetscObject) dm)->options,((PetscObject) dm)->prefix, "-partition_view", &flg);CHKERRQ(ierr);
   /* Create non-overlapping parallel DM and migrate internal data */
   ierr = DMPlexCreate(comm, dmParallel);CHKERRQ(ierr);
   ierr = PetscObjectSetName((PetscObject) *dmParallel, "Parallel Mesh");CHKERRQ(ierr);
@@ -1704,11 +1674,6 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
     ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);
     sfMigration = sfOverlapPoint;
   }
-  /* Cleanup Partition */
-  ierr = DMLabelDestroy(&lblPartition);CHKERRQ(ierr);
-  ierr = DMLabelDestroy(&lblMigration);CHKERRQ(ierr);
-  ierr = PetscSectionDestroy(&cellPartSection);CHKERRQ(ierr);
-  ierr = ISDestroy(&cellPart);CHKERRQ(ierr);
   /* Copy BC */
   ierr = DMCopyBoundary(dm, *dmParallel);CHKERRQ(ierr);
   /* Create sfNatural */
@@ -1723,6 +1688,190 @@ PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmPara
   if (sf) {*sf = sfMigration;}
   else    {ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);}
   ierr = PetscSFDestroy(&sfPoint);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  DMPlexDistribute - Distributes the mesh and any associated sections.
+
+  Collective on dm
+
+  Input Parameter:
++ dm  - The original DMPlex object
+- overlap - The overlap of partitions, 0 is the default
+
+  Output Parameter:
++ sf - The PetscSF used for point distribution, or NULL if not needed
+- dmParallel - The distributed DMPlex object
+
+  Note: If the mesh was not distributed, the output dmParallel will be NULL.
+
+  The user can control the definition of adjacency for the mesh using DMSetAdjacency(). They should choose the combination appropriate for the function
+  representation on the mesh.
+
+  Level: intermediate
+
+.seealso: DMPlexCreate(), DMSetAdjacency(), DMPlexRebalance()
+@*/
+PetscErrorCode DMPlexDistribute(DM dm, PetscInt overlap, PetscSF *sf, DM *dmParallel)
+{
+  MPI_Comm               comm;
+  PetscPartitioner       partitioner;
+  IS                     cellPart;
+  PetscSection           cellPartSection;
+  PetscSF                sfMigration;
+  PetscMPIInt            rank, size;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(dm, overlap, 2);
+  if (sf) PetscValidPointer(sf,3);
+  PetscValidPointer(dmParallel,4);
+
+  if (sf) *sf = NULL;
+  *dmParallel = NULL;
+  ierr = PetscObjectGetComm((PetscObject)dm,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  if (size == 1) PetscFunctionReturn(0);
+
+  ierr = PetscLogEventBegin(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
+  /* Create cell partition */
+  ierr = PetscLogEventBegin(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(comm, &cellPartSection);CHKERRQ(ierr);
+  ierr = DMPlexGetPartitioner(dm, &partitioner);CHKERRQ(ierr);
+  ierr = PetscPartitionerPartition(partitioner, dm, cellPartSection, &cellPart);CHKERRQ(ierr);
+  ierr = DMPlexCreateMigrationSF_Private(dm, cellPartSection, cellPart, NULL, &sfMigration);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&cellPartSection);CHKERRQ(ierr);
+  ierr = ISDestroy(&cellPart);CHKERRQ(ierr);
+  ierr = DMPlexMigrateAndOverlap_Private(dm, overlap, sfMigration, sf, dmParallel);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  DMPlexRebalance - Redistributes a distributed mesh, moving only the cells whose process changes
+
+  Collective on dm
+
+  Input Parameter:
++ dm      - The distributed DMPlex object
+- overlap - The overlap of partitions, 0 is the default
+
+  Output Parameter:
++ sf         - The PetscSF used for point migration, or NULL if not needed
+- dmBalanced - The rebalanced DMPlex object, or NULL if no cell needs to move
+
+  Notes:
+  The mesh is partitioned with the partitioner of dm, and each part is then assigned to the process holding most of its cells,
+  so that a new partition similar to the current one migrates few cells. The cells staying on their process are copied locally
+  by the migration PetscSF, only the others are communicated. Labels and coordinates are migrated, the discretization is copied,
+  and a local section set without fields is distributed, so that a Vec on the local section can be transferred with
+  DMPlexDistributeField() using sf. If the partition keeps every cell on its process, nothing is migrated and dmBalanced is NULL.
+
+  Use PETSCPARTITIONERMULTILEVEL with PetscPartitionerMultilevelSetRepartition(), or -petscpartitioner_multilevel_repartition,
+  to compute a diffusive partition that trades the edge cut against the number of migrated cells, which suits the dynamic load
+  balancing of adapted meshes. Other partitioners partition from scratch, and only the assignment of parts to processes
+  limits the migration.
+
+  Level: intermediate
+
+.seealso: DMPlexDistribute(), DMPlexDistributeField(), PetscPartitionerMultilevelSetRepartition(), DMPlexGetPartitioner()
+@*/
+PetscErrorCode DMPlexRebalance(DM dm, PetscInt overlap, PetscSF *sf, DM *dmBalanced)
+{
+  MPI_Comm         comm;
+  PetscPartitioner partitioner;
+  IS               cellPart;
+  PetscSection     cellPartSection, section;
+  PetscSF          sfMigration;
+  PetscInt        *local, *pairs, *keys, *vals, *rankMap, *procMap, nparts, npairs = 0, moved = 0, Nf, p, r, i;
+  PetscMPIInt      rank, size, nlocal, *counts, *displs, q;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(dm, overlap, 2);
+  if (sf) PetscValidPointer(sf,3);
+  PetscValidPointer(dmBalanced,4);
+
+  if (sf) *sf = NULL;
+  *dmBalanced = NULL;
+  ierr = PetscObjectGetComm((PetscObject)dm,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm, &rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
+  if (size == 1) PetscFunctionReturn(0);
+
+  ierr = PetscLogEventBegin(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(comm, &cellPartSection);CHKERRQ(ierr);
+  ierr = DMPlexGetPartitioner(dm, &partitioner);CHKERRQ(ierr);
+  ierr = PetscPartitionerPartition(partitioner, dm, cellPartSection, &cellPart);CHKERRQ(ierr);
+  ierr = PetscSectionGetChart(cellPartSection, NULL, &nparts);CHKERRQ(ierr);
+  if (nparts != size) SETERRQ2(comm, PETSC_ERR_ARG_SIZ, "Partition into %D parts does not match the %d processes", nparts, size);
+  /* Gather the number of local cells in each part, as (cells, part*size+rank) pairs */
+  ierr = PetscMalloc3(2*nparts, &local, size, &counts, size+1, &displs);CHKERRQ(ierr);
+  for (p = 0; p < nparts; ++p) {
+    PetscInt dof;
+
+    ierr = PetscSectionGetDof(cellPartSection, p, &dof);CHKERRQ(ierr);
+    if (!dof) continue;
+    local[2*npairs]   = dof;
+    local[2*npairs+1] = p*size + rank;
+    ++npairs;
+  }
+  ierr = PetscMPIIntCast(2*npairs, &nlocal);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&nlocal, 1, MPI_INT, counts, 1, MPI_INT, comm);CHKERRQ(ierr);
+  for (q = 0, displs[0] = 0; q < size; ++q) displs[q+1] = displs[q] + counts[q];
+  npairs = displs[size]/2;
+  ierr = PetscMalloc5(2*npairs, &pairs, npairs, &keys, npairs, &vals, nparts, &rankMap, size, &procMap);CHKERRQ(ierr);
+  ierr = MPI_Allgatherv(local, nlocal, MPIU_INT, pairs, counts, displs, MPIU_INT, comm);CHKERRQ(ierr);
+  /* Greedily give each part to the process holding most of its cells, every process computing the same assignment */
+  for (i = 0; i < npairs; ++i) {keys[i] = -pairs[2*i]; vals[i] = pairs[2*i+1];}
+  ierr = PetscSortIntWithArray(npairs, keys, vals);CHKERRQ(ierr);
+  for (p = 0; p < nparts; ++p) rankMap[p] = -1;
+  for (r = 0; r < size; ++r)   procMap[r] = -1;
+  for (i = 0; i < npairs; ++i) {
+    p = vals[i] / size;
+    r = vals[i] % size;
+    if (rankMap[p] < 0 && procMap[r] < 0) {rankMap[p] = r; procMap[r] = p;}
+  }
+  for (p = 0, r = 0; p < nparts; ++p) {
+    if (rankMap[p] >= 0) continue;
+    while (procMap[r] >= 0) ++r;
+    rankMap[p] = r;
+    procMap[r] = p;
+  }
+  for (i = 0; i < nlocal/2; ++i) if (rankMap[local[2*i+1]/size] != rank) moved += local[2*i];
+  ierr = MPIU_Allreduce(MPI_IN_PLACE, &moved, 1, MPIU_INT, MPI_SUM, comm);CHKERRQ(ierr);
+  ierr = PetscInfo1(dm, "Rebalancing moves %D cells\n", moved);CHKERRQ(ierr);
+  ierr = PetscFree3(local, counts, displs);CHKERRQ(ierr);
+  if (moved) {ierr = DMPlexCreateMigrationSF_Private(dm, cellPartSection, cellPart, rankMap, &sfMigration);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(DMPLEX_Partition,dm,0,0,0);CHKERRQ(ierr);
+  ierr = PetscFree5(pairs, keys, vals, rankMap, procMap);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&cellPartSection);CHKERRQ(ierr);
+  ierr = ISDestroy(&cellPart);CHKERRQ(ierr);
+  if (!moved) {
+    ierr = PetscLogEventEnd(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = DMPlexMigrateAndOverlap_Private(dm, overlap, sfMigration, &sfMigration, dmBalanced);CHKERRQ(ierr);
+  /* Carry over the discretization, or the local section if it was set directly */
+  ierr = DMCopyDisc(dm, *dmBalanced);CHKERRQ(ierr);
+  ierr = DMGetNumFields(dm, &Nf);CHKERRQ(ierr);
+  section = dm->defaultSection;
+  if (!Nf && section) {
+    PetscSection newSection;
+
+    ierr = PetscSectionCreate(comm, &newSection);CHKERRQ(ierr);
+    ierr = PetscSFDistributeSection(sfMigration, section, NULL, newSection);CHKERRQ(ierr);
+    ierr = DMSetLocalSection(*dmBalanced, newSection);CHKERRQ(ierr);
+    ierr = PetscSectionDestroy(&newSection);CHKERRQ(ierr);
+  }
+  if (sf) {*sf = sfMigration;}
+  else    {ierr = PetscSFDestroy(&sfMigration);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(DMPLEX_Distribute,dm,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1,4 +1,5 @@
 #include <petsc/private/dmpleximpl.h>   /*I      "petscdmplex.h"   I*/
+#include <petsc/private/isimpl.h>
 
 /*@
   DMPlexCreateClosureIndex - Calculate an index for the given PetscSection for the closure operation on the DM
@@ -71,3 +72,228 @@ PetscErrorCode DMPlexCreateClosureIndex(DM dm, PetscSection section)
   ierr = PetscSectionSetClosureIndex(section, (PetscObject) dm, closureSection, closureIS);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+/*@
+  DMPlexSetClosureCache - Cache the dof indices of cell closures, so that closure operations become a single gather or scatter
+
+  Not collective
+
+  Input Parameters:
++ dm  - The DM
+- use - Flag to cache the closure dof indices
+
+  Options Database:
+. -dm_plex_closure_cache - Cache the closure dof indices
+
+  Notes:
+  When this flag is set, the first call to DMPlexVecGetClosure(), DMPlexVecSetClosure(), DMPlexMatSetClosure() or DMPlexGetClosureIndices()
+  for a cell computes, for every cell and the given section, the local dof indices of the closure with the closure permutation and the
+  orientation permutations already applied, and stores them in one contiguous array attached to the section. Global indices are computed
+  the same way for the first global section used with DMPlexMatSetClosure() or DMPlexGetClosureIndices(). Later calls read the indices
+  directly instead of traversing the closure.
+
+  The cache is discarded when the section is set up again or its symmetries or closure permutation change, and it is ignored once the
+  mesh is stratified again. Sections with anchor constraints or dof sign flips are not cached.
+
+  Level: intermediate
+
+.seealso: DMPlexGetClosureCache(), DMPlexCreateClosureIndex(), DMPlexVecGetClosure(), DMPlexVecSetClosure(), DMPlexMatSetClosure()
+@*/
+PetscErrorCode DMPlexSetClosureCache(DM dm, PetscBool use)
+{
+  DM_Plex *mesh = (DM_Plex *) dm->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  mesh->closureCache = use;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexGetClosureCache - Get the flag indicating that the dof indices of cell closures are cached
+
+  Not collective
+
+  Input Parameter:
+. dm - The DM
+
+  Output Parameter:
+. use - Flag to cache the closure dof indices
+
+  Level: intermediate
+
+.seealso: DMPlexSetClosureCache()
+@*/
+PetscErrorCode DMPlexGetClosureCache(DM dm, PetscBool *use)
+{
+  DM_Plex *mesh = (DM_Plex *) dm->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidPointer(use, 2);
+  *use = mesh->closureCache;
+  PetscFunctionReturn(0);
+}
+
+/* Fill idx with the local dof indices of the closure of point, in the order used by DMPlexVecGetClosure() */
+static PetscErrorCode DMPlexGetClosureDofIndexPoint_Private(DM dm, PetscSection section, PetscInt point, const PetscInt clperm[], PetscInt *size, PetscBool *flipped, PetscInt idx[])
+{
+  PetscSection    clSection;
+  IS              clPoints;
+  const PetscInt *clp;
+  PetscInt       *points = NULL;
+  PetscInt        Nf, numPoints, offset = 0, f, p;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSectionGetNumFields(section, &Nf);CHKERRQ(ierr);
+  ierr = DMPlexGetCompressedClosure(dm, section, point, &numPoints, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+  for (f = 0; f < PetscMax(1, Nf); ++f) {
+    const PetscInt    **perms = NULL;
+    const PetscScalar **flips = NULL;
+
+    if (Nf) {ierr = PetscSectionGetFieldPointSyms(section, f, numPoints, points, &perms, &flips);CHKERRQ(ierr);}
+    else    {ierr = PetscSectionGetPointSyms(section, numPoints, points, &perms, &flips);CHKERRQ(ierr);}
+    for (p = 0; p < numPoints; ++p) {
+      const PetscInt  q    = points[2*p];
+      const PetscInt *perm = perms ? perms[p] : NULL;
+      const PetscInt *cdofs;
+      PetscInt        dof, cdof, off, cind = 0, d;
+
+      if (flips && flips[p]) *flipped = PETSC_TRUE;
+      if (Nf) {
+        ierr = PetscSectionGetFieldDof(section, q, f, &dof);CHKERRQ(ierr);
+        ierr = PetscSectionGetFieldConstraintDof(section, q, f, &cdof);CHKERRQ(ierr);
+        ierr = PetscSectionGetFieldOffset(section, q, f, &off);CHKERRQ(ierr);
+        if (cdof) {ierr = PetscSectionGetFieldConstraintIndices(section, q, f, &cdofs);CHKERRQ(ierr);}
+      } else {
+        ierr = PetscSectionGetDof(section, q, &dof);CHKERRQ(ierr);
+        ierr = PetscSectionGetConstraintDof(section, q, &cdof);CHKERRQ(ierr);
+        ierr = PetscSectionGetOffset(section, q, &off);CHKERRQ(ierr);
+        if (cdof) {ierr = PetscSectionGetConstraintIndices(section, q, &cdofs);CHKERRQ(ierr);}
+      }
+      if (idx) {
+        for (d = 0; d < dof; ++d) {
+          const PetscInt preind = perm ? offset+perm[d] : offset+d;
+          const PetscInt ind    = clperm ? clperm[preind] : preind;
+
+          if ((cind < cdof) && (d == cdofs[cind])) {idx[ind] = -(off+d+1); ++cind;}
+          else                                     {idx[ind] = off+d;}
+        }
+      }
+      offset += dof;
+    }
+    if (Nf) {ierr = PetscSectionRestoreFieldPointSyms(section, f, numPoints, points, &perms, &flips);CHKERRQ(ierr);}
+    else    {ierr = PetscSectionRestorePointSyms(section, numPoints, points, &perms, &flips);CHKERRQ(ierr);}
+  }
+  ierr = DMPlexRestoreCompressedClosure(dm, section, point, &numPoints, &points, &clSection, &clPoints, &clp);CHKERRQ(ierr);
+  *size = offset;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexCreateClosureDofIndex_Private(DM dm, PetscSection section)
+{
+  DM_Plex        *mesh = (DM_Plex *) dm->data;
+  PetscSection    aSec;
+  const PetscInt *clperm;
+  PetscInt       *clOff = NULL, *clIdx = NULL;
+  PetscInt        cStart, cEnd, c, size;
+  PetscBool       flipped = PETSC_FALSE;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetAnchors(dm, &aSec, NULL);CHKERRQ(ierr);
+  if (aSec) {
+    ierr = PetscInfo(dm, "Not caching closure dof indices since the mesh has anchor constraints\n");CHKERRQ(ierr);
+    ierr = PetscSectionSetClosureDofIndex_Internal(section, (PetscObject) dm, mesh->depthState, cStart, cEnd, NULL, NULL);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscSectionGetClosureInversePermutation_Internal(section, (PetscObject) dm, NULL, &clperm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(cEnd-cStart+1, &clOff);CHKERRQ(ierr);
+  clOff[0] = 0;
+  for (c = cStart; c < cEnd && !flipped; ++c) {
+    ierr = DMPlexGetClosureDofIndexPoint_Private(dm, section, c, clperm, &size, &flipped, NULL);CHKERRQ(ierr);
+    clOff[c-cStart+1] = clOff[c-cStart] + size;
+  }
+  if (!flipped) {
+    ierr = PetscMalloc1(clOff[cEnd-cStart], &clIdx);CHKERRQ(ierr);
+    for (c = cStart; c < cEnd; ++c) {
+      ierr = DMPlexGetClosureDofIndexPoint_Private(dm, section, c, clperm, &size, &flipped, &clIdx[clOff[c-cStart]]);CHKERRQ(ierr);
+    }
+  } else {
+    ierr = PetscInfo(dm, "Not caching closure dof indices since the section has sign flips\n");CHKERRQ(ierr);
+    ierr = PetscFree(clOff);CHKERRQ(ierr);
+  }
+  ierr = PetscSectionSetClosureDofIndex_Internal(section, (PetscObject) dm, mesh->depthState, cStart, cEnd, clOff, clIdx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMPlexGetClosureDofIndex_Internal - Get the cached local dof indices of the closure of point, building the cache on first use
+
+  Output Parameters:
++ size - The closure size
+- idx  - The local dof indices in closure order with constrained dofs encoded as -(off+1), or NULL if the closure is not cached
+*/
+PetscErrorCode DMPlexGetClosureDofIndex_Internal(DM dm, PetscSection section, PetscInt point, PetscInt *size, const PetscInt *idx[])
+{
+  DM_Plex        *mesh = (DM_Plex *) dm->data;
+  const PetscInt *clOff, *clIdx;
+  PetscInt        pStart, pEnd;
+  PetscBool       cached;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBeginHot;
+  *size = 0;
+  *idx  = NULL;
+  if (!mesh->closureCache) PetscFunctionReturn(0);
+  ierr = PetscSectionGetClosureDofIndex_Internal(section, (PetscObject) dm, mesh->depthState, &cached, &pStart, &pEnd, &clOff, &clIdx);CHKERRQ(ierr);
+  if (!cached) {
+    ierr = DMPlexCreateClosureDofIndex_Private(dm, section);CHKERRQ(ierr);
+    ierr = PetscSectionGetClosureDofIndex_Internal(section, (PetscObject) dm, mesh->depthState, &cached, &pStart, &pEnd, &clOff, &clIdx);CHKERRQ(ierr);
+  }
+  if (!clOff || (point < pStart) || (point >= pEnd)) PetscFunctionReturn(0);
+  *size = clOff[point-pStart+1] - clOff[point-pStart];
+  *idx  = &clIdx[clOff[point-pStart]];
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMPlexGetClosureGlobalDofIndex_Internal - Get the cached global dof indices of the closure of point, as DMPlexGetClosureIndices() would return them
+
+  Output Parameters:
++ size - The closure size
+- idx  - The global dof indices, or NULL if the closure is not cached
+*/
+PetscErrorCode DMPlexGetClosureGlobalDofIndex_Internal(DM dm, PetscSection section, PetscSection globalSection, PetscInt point, PetscInt *size, const PetscInt *idx[])
+{
+  const PetscInt *lidx, *gidx;
+  PetscInt        lsize;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBeginHot;
+  *size = 0;
+  *idx  = NULL;
+  ierr = DMPlexGetClosureDofIndex_Internal(dm, section, point, &lsize, &lidx);CHKERRQ(ierr);
+  if (!lidx) PetscFunctionReturn(0);
+  ierr = PetscSectionGetClosureGlobalDofIndex_Internal(section, globalSection, &gidx);CHKERRQ(ierr);
+  if (!gidx) {
+    PetscInt *clIdx, cStart = section->clIdxStart, cEnd = section->clIdxEnd, c;
+
+    ierr = PetscMalloc1(section->clIdxOff[cEnd-cStart], &clIdx);CHKERRQ(ierr);
+    for (c = cStart; c < cEnd; ++c) {
+      PetscInt *indices, n;
+
+      ierr = DMPlexGetClosureIndices_Internal(dm, section, globalSection, c, &n, &indices, NULL);CHKERRQ(ierr);
+      if (n != section->clIdxOff[c-cStart+1] - section->clIdxOff[c-cStart]) SETERRQ3(PetscObjectComm((PetscObject) dm), PETSC_ERR_PLIB, "Invalid size for closure of %D: %D should be %D", c, n, section->clIdxOff[c-cStart+1] - section->clIdxOff[c-cStart]);
+      ierr = PetscArraycpy(&clIdx[section->clIdxOff[c-cStart]], indices, n);CHKERRQ(ierr);
+      ierr = DMPlexRestoreClosureIndices(dm, section, globalSection, c, &n, &indices, NULL);CHKERRQ(ierr);
+    }
+    ierr = PetscSectionSetClosureGlobalDofIndex_Internal(section, globalSection, clIdx);CHKERRQ(ierr);
+    gidx = clIdx;
+  }
+  *size = lsize;
+  *idx  = &gidx[lidx - section->clIdx];
+  PetscFunctionReturn(0);
+}
@@ -45,6 +45,104 @@ static PetscErrorCode DMPlexCreateOrderingClosure_Static(DM dm, PetscInt numPoin
   PetscFunctionReturn(0);
 }
 
+typedef struct {
+  PetscInt64 key;  /* Position of the cell centroid along the curve */
+  PetscInt   cell;
+} DMPlexSFCItem;
+
+static int DMPlexSFCItemCompare_Private(const void *a, const void *b)
+{
+  const DMPlexSFCItem *x = (const DMPlexSFCItem *) a, *y = (const DMPlexSFCItem *) b;
+
+  if (x->key < y->key) return -1;
+  if (x->key > y->key) return  1;
+  return (int) (x->cell - y->cell);
+}
+
+/* Transform integer coordinates into the transposed Hilbert index, J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707, 2004 */
+static void DMPlexHilbertAxesToTranspose_Private(PetscInt dim, PetscInt bits, unsigned int X[])
+{
+  const unsigned int M = 1U << (bits-1);
+  unsigned int       P, Q, t;
+  PetscInt           i;
+
+  for (Q = M; Q > 1; Q >>= 1) {
+    P = Q - 1;
+    for (i = 0; i < dim; ++i) {
+      if (X[i] & Q) X[0] ^= P;
+      else {t = (X[0] ^ X[i]) & P; X[0] ^= t; X[i] ^= t;}
+    }
+  }
+  for (i = 1; i < dim; ++i) X[i] ^= X[i-1];
+  t = 0;
+  for (Q = M; Q > 1; Q >>= 1) if (X[dim-1] & Q) t ^= Q-1;
+  for (i = 0; i < dim; ++i) X[i] ^= t;
+}
+
+/* Order the cells by the position of their centroid along a Hilbert or Morton curve through the local bounding box, cperm[new cell] = old cell */
+static PetscErrorCode DMPlexCreateSpaceFillingCurveOrdering_Static(DM dm, PetscBool hilbert, PetscInt *numCells, PetscInt **cperm)
+{
+  DM             cdm;
+  PetscSection   csection;
+  Vec            coordinates;
+  DMPlexSFCItem *items;
+  PetscReal     *centroids, lower[3], upper[3];
+  PetscInt       cdim, bits, cStart, cEnd, c, d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetCoordinateDim(dm, &cdim);CHKERRQ(ierr);
+  if (cdim > 3) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "Space filling curve ordering not supported in dimension %D", cdim);
+  ierr = DMGetCoordinateDM(dm, &cdm);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(cdm, &csection);CHKERRQ(ierr);
+  ierr = DMGetCoordinatesLocal(dm, &coordinates);CHKERRQ(ierr);
+  if (!coordinates) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_ARG_WRONGSTATE, "Space filling curve ordering needs mesh coordinates");
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  ierr = PetscMalloc2(cEnd-cStart, &items, (cEnd-cStart)*cdim, &centroids);CHKERRQ(ierr);
+  for (d = 0; d < cdim; ++d) {lower[d] = PETSC_MAX_REAL; upper[d] = PETSC_MIN_REAL;}
+  for (c = cStart; c < cEnd; ++c) {
+    PetscScalar *coords = NULL;
+    PetscInt     csize, n, i;
+
+    ierr = DMPlexVecGetClosure(cdm, csection, coordinates, c, &csize, &coords);CHKERRQ(ierr);
+    n    = csize/cdim;
+    for (d = 0; d < cdim; ++d) {
+      PetscReal x = 0.0;
+
+      for (i = 0; i < n; ++i) x += PetscRealPart(coords[i*cdim+d]);
+      x /= PetscMax(n, 1);
+      centroids[(c-cStart)*cdim+d] = x;
+      lower[d] = PetscMin(lower[d], x);
+      upper[d] = PetscMax(upper[d], x);
+    }
+    ierr = DMPlexVecRestoreClosure(cdm, csection, coordinates, c, &csize, &coords);CHKERRQ(ierr);
+  }
+  /* Quantize the centroids so that the interleaved key fits in 63 bits */
+  bits = cdim == 1 ? 31 : (cdim == 2 ? 31 : 21);
+  for (c = 0; c < cEnd-cStart; ++c) {
+    const unsigned int maxq = (1U << bits) - 1;
+    unsigned int       X[3] = {0, 0, 0};
+    PetscInt64         key  = 0;
+    PetscInt           b;
+
+    for (d = 0; d < cdim; ++d) {
+      const PetscReal h = upper[d] - lower[d];
+
+      X[d] = h > 0.0 ? (unsigned int) ((centroids[c*cdim+d] - lower[d])/h * maxq) : 0;
+    }
+    if (hilbert && cdim > 1) DMPlexHilbertAxesToTranspose_Private(cdim, bits, X);
+    for (b = bits-1; b >= 0; --b) for (d = 0; d < cdim; ++d) key = (key << 1) | ((X[d] >> b) & 1U);
+    items[c].key  = key;
+    items[c].cell = c + cStart;
+  }
+  qsort(items, cEnd-cStart, sizeof(DMPlexSFCItem), DMPlexSFCItemCompare_Private);
+  ierr = PetscMalloc1(cEnd-cStart, cperm);CHKERRQ(ierr);
+  for (c = 0; c < cEnd-cStart; ++c) (*cperm)[c] = items[c].cell;
+  *numCells = cEnd-cStart;
+  ierr = PetscFree2(items, centroids);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMPlexGetOrdering - Calculate a reordering of the mesh
 
@@ -58,40 +156,55 @@ $     MATORDERINGND - Nested Dissection
 $     MATORDERING1WD - One-way Dissection
 $     MATORDERINGRCM - Reverse Cuthill-McKee
 $     MATORDERINGQMD - Quotient Minimum Degree
+$     DMPLEXORDERINGHILBERT - Cells sorted by the position of their centroid along a Hilbert curve
+$     DMPLEXORDERINGMORTON - Cells sorted by the position of their centroid along a Morton (Z-order) curve
 - label - [Optional] Label used to segregate ordering into sets, or NULL
 
 
   Output Parameter:
 . perm - The point permutation as an IS, perm[old point number] = new point number
 
-  Note: The label is used to group sets of points together by label value. This makes it easy to reorder a mesh which
+  Notes:
+  The label is used to group sets of points together by label value. This makes it easy to reorder a mesh which
   has different types of cells, and then loop over each set of reordered cells for assembly.
 
+  The space filling curve orderings use the local bounding box of the cell centroids, so on a distributed mesh each process
+  orders its own cells. Points of lower dimension are numbered in the order they first appear in the closure of the reordered
+  cells, so that the data for a cell and its closure is close in memory. The other ordering types currently all use
+  Reverse Cuthill-McKee on the cell adjacency graph.
+
   Level: intermediate
 
-.seealso: MatGetOrdering()
+.seealso: MatGetOrdering(), DMPlexPermute()
 @*/
 PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS *perm)
 {
   PetscInt       numCells = 0;
   PetscInt      *start = NULL, *adjacency = NULL, *cperm, *clperm = NULL, *invclperm = NULL, *mask, *xls, pStart, pEnd, c, i;
+  PetscBool      isHilbert, isMorton;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
   PetscValidPointer(perm, 3);
-  ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
-  ierr = PetscMalloc3(numCells,&cperm,numCells,&mask,numCells*2,&xls);CHKERRQ(ierr);
-  if (numCells) {
+  ierr = PetscStrcmp(otype, DMPLEXORDERINGHILBERT, &isHilbert);CHKERRQ(ierr);
+  ierr = PetscStrcmp(otype, DMPLEXORDERINGMORTON, &isMorton);CHKERRQ(ierr);
+  if (isHilbert || isMorton) {
+    ierr = DMPlexCreateSpaceFillingCurveOrdering_Static(dm, isHilbert, &numCells, &cperm);CHKERRQ(ierr);
+  } else {
+    ierr = DMPlexCreateNeighborCSR(dm, 0, &numCells, &start, &adjacency);CHKERRQ(ierr);
+    ierr = PetscMalloc3(numCells,&cperm,numCells,&mask,numCells*2,&xls);CHKERRQ(ierr);
+    if (numCells) {
+      /* Shift for Fortran numbering */
+      for (i = 0; i < start[numCells]; ++i) ++adjacency[i];
+      for (i = 0; i <= numCells; ++i)       ++start[i];
+      ierr = SPARSEPACKgenrcm(&numCells, start, adjacency, cperm, mask, xls);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(start);CHKERRQ(ierr);
+    ierr = PetscFree(adjacency);CHKERRQ(ierr);
     /* Shift for Fortran numbering */
-    for (i = 0; i < start[numCells]; ++i) ++adjacency[i];
-    for (i = 0; i <= numCells; ++i)       ++start[i];
-    ierr = SPARSEPACKgenrcm(&numCells, start, adjacency, cperm, mask, xls);CHKERRQ(ierr);
+    for (c = 0; c < numCells; ++c) --cperm[c];
   }
-  ierr = PetscFree(start);CHKERRQ(ierr);
-  ierr = PetscFree(adjacency);CHKERRQ(ierr);
-  /* Shift for Fortran numbering */
-  for (c = 0; c < numCells; ++c) --cperm[c];
   /* Segregate */
   if (label) {
     IS              valueIS;
@@ -130,7 +243,8 @@ PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS
   }
   /* Construct closure */
   ierr = DMPlexCreateOrderingClosure_Static(dm, numCells, cperm, &clperm, &invclperm);CHKERRQ(ierr);
-  ierr = PetscFree3(cperm,mask,xls);CHKERRQ(ierr);
+  if (isHilbert || isMorton) {ierr = PetscFree(cperm);CHKERRQ(ierr);}
+  else                       {ierr = PetscFree3(cperm,mask,xls);CHKERRQ(ierr);}
   ierr = PetscFree(clperm);CHKERRQ(ierr);
   /* Invert permutation */
   ierr = DMPlexGetChart(dm, &pStart, &pEnd);CHKERRQ(ierr);
@@ -150,9 +264,12 @@ PetscErrorCode DMPlexGetOrdering(DM dm, MatOrderingType otype, DMLabel label, IS
   Output Parameter:
 . pdm - The permuted DM
 
+  Note: On a distributed mesh each process passes the permutation of its local points, and the point SF is renumbered to
+  match, so that the local-to-global maps of the permuted DM follow the new local order.
+
   Level: intermediate
 
-.seealso: MatPermute()
+.seealso: MatPermute(), DMPlexGetOrdering()
 @*/
 PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
 {
@@ -178,7 +295,7 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
   }
   plexNew = (DM_Plex *) (*pdm)->data;
   /* Ignore ltogmap, ltogmapb */
-  /* Ignore sf, defaultSF */
+  /* Ignore defaultSF */
   /* Ignore globalVertexNumbers, globalCellNumbers */
   /* Remap coordinates */
   {
@@ -274,6 +391,43 @@ PetscErrorCode DMPlexPermute(DM dm, IS perm, DM *pdm)
     }
     ierr = ISRestoreIndices(perm, &pperm);CHKERRQ(ierr);
   }
+  /* Remap the point SF, using the permutation on the owning process for the remote points */
+  {
+    PetscSF            sf, sfNew;
+    const PetscSFNode *remotes;
+    const PetscInt    *leaves, *pperm;
+    PetscSFNode       *remotesNew;
+    PetscInt          *leavesNew, *rpperm, nroots, nleaves, l;
+
+    ierr = DMGetPointSF(dm, &sf);CHKERRQ(ierr);
+    ierr = PetscSFGetGraph(sf, &nroots, &nleaves, &leaves, &remotes);CHKERRQ(ierr);
+    if (nroots >= 0) {
+      ierr = ISGetIndices(perm, &pperm);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nroots, &rpperm);CHKERRQ(ierr);
+      ierr = PetscSFBcastBegin(sf, MPIU_INT, pperm, rpperm);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf, MPIU_INT, pperm, rpperm);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nleaves, &leavesNew);CHKERRQ(ierr);
+      ierr = PetscMalloc1(nleaves, &remotesNew);CHKERRQ(ierr);
+      for (l = 0; l < nleaves; ++l) {
+        const PetscInt leaf = leaves ? leaves[l] : l;
+
+        leavesNew[l]        = pperm[leaf];
+        remotesNew[l].rank  = remotes[l].rank;
+        remotesNew[l].index = rpperm[leaf];
+      }
+      {
+        PetscSFNode tmp;
+
+        ierr = PetscSortIntWithDataArray(nleaves, leavesNew, remotesNew, sizeof(PetscSFNode), &tmp);CHKERRQ(ierr);
+      }
+      ierr = ISRestoreIndices(perm, &pperm);CHKERRQ(ierr);
+      ierr = PetscFree(rpperm);CHKERRQ(ierr);
+      ierr = PetscSFCreate(PetscObjectComm((PetscObject) dm), &sfNew);CHKERRQ(ierr);
+      ierr = PetscSFSetGraph(sfNew, nroots, nleaves, leavesNew, PETSC_OWN_POINTER, remotesNew, PETSC_OWN_POINTER);CHKERRQ(ierr);
+      ierr = DMSetPointSF(*pdm, sfNew);CHKERRQ(ierr);
+      ierr = PetscSFDestroy(&sfNew);CHKERRQ(ierr);
+    }
+  }
   ierr = DMCopyDisc(dm, *pdm);CHKERRQ(ierr);
   (*pdm)->setupcalled = PETSC_TRUE;
   PetscFunctionReturn(0);
@@ -75,6 +75,7 @@ PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_Shell(PetscPartitioner);
 PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_Simple(PetscPartitioner);
 PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_Gather(PetscPartitioner);
 PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_MatPartitioning(PetscPartitioner);
+PETSC_EXTERN PetscErrorCode PetscPartitionerCreate_Multilevel(PetscPartitioner);
 
 /*@C
   PetscPartitionerRegisterAll - Registers all of the PetscPartitioner components in the DM package.
@@ -103,6 +104,7 @@ PetscErrorCode PetscPartitionerRegisterAll(void)
   ierr = PetscPartitionerRegister(PETSCPARTITIONERSIMPLE,   PetscPartitionerCreate_Simple);CHKERRQ(ierr);
   ierr = PetscPartitionerRegister(PETSCPARTITIONERGATHER,   PetscPartitionerCreate_Gather);CHKERRQ(ierr);
   ierr = PetscPartitionerRegister(PETSCPARTITIONERMATPARTITIONING, PetscPartitionerCreate_MatPartitioning);CHKERRQ(ierr);
+  ierr = PetscPartitionerRegister(PETSCPARTITIONERMULTILEVEL, PetscPartitionerCreate_Multilevel);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 #include <petscfe.h>     /*I  "petscfe.h"  I*/
@@ -172,6 +174,7 @@ PetscErrorCode PetscDualSpaceRegisterAll(void)
 PETSC_EXTERN PetscErrorCode PetscFECreate_Basic(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Nonaffine(PetscFE);
 PETSC_EXTERN PetscErrorCode PetscFECreate_Composite(PetscFE);
+PETSC_EXTERN PetscErrorCode PetscFECreate_Tensor(PetscFE);
 #if defined(PETSC_HAVE_OPENCL)
 PETSC_EXTERN PetscErrorCode PetscFECreate_OpenCL(PetscFE);
 #endif
@@ -198,6 +201,7 @@ PetscErrorCode PetscFERegisterAll(void)
 
   ierr = PetscFERegister(PETSCFEBASIC,     PetscFECreate_Basic);CHKERRQ(ierr);
   ierr = PetscFERegister(PETSCFECOMPOSITE, PetscFECreate_Composite);CHKERRQ(ierr);
+  ierr = PetscFERegister(PETSCFETENSOR,    PetscFECreate_Tensor);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_OPENCL)
   ierr = PetscFERegister(PETSCFEOPENCL, PetscFECreate_OpenCL);CHKERRQ(ierr);
 #endif
@@ -228,6 +228,10 @@ int main(int argc,char **args)
       suffix: 3
       args: -pc_type sor -pc_sor_symmetric -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
 
+   test:
+      suffix: sor_multicolor
+      args: -pc_type sor -pc_sor_symmetric -pc_sor_ordering multicolor -ksp_monitor_short -ksp_view
+
    test:
       suffix: 4
       args: -pc_type eisenstat -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
@@ -238,6 +242,12 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -m 5 -n 5 -mat_view draw -ksp_gmres_cgs_refinement_type refine_always -nox
       output_file: output/ex2_2.out
 
+   test:
+      suffix: mult_split
+      nsize: 2
+      args: -ksp_monitor_short -m 5 -n 5 -mat_mult_split -ksp_gmres_cgs_refinement_type refine_always
+      output_file: output/ex2_2.out
+
    test:
       suffix: bjacobi
       nsize: 4
@@ -205,4 +205,9 @@ int main(int argc,char **args)
       nsize: 2
       args: -ksp_monitor -ksp_rtol 1e-6   -pc_type hmg -pc_hmg_reuse_interpolation 1 -test_reuse_interpolation 1 -hmg_inner_pc_type gamg
 
+   test:
+      suffix: gamg_reuse
+      nsize: 4
+      args: -ksp_monitor -ksp_rtol 1e-6 -m 24 -n 24 -pc_type gamg -pc_gamg_reuse_interpolation 1 -pc_gamg_process_eq_limit 50 -test_reuse_interpolation 1
+
 TEST*/
@@ -74,6 +74,7 @@ static PetscErrorCode PCGAMGCreateLevel_GAMG(PC pc,Mat Amat_fine,PetscInt cr_bs,
   ierr = MPI_Comm_size(comm, &size);CHKERRQ(ierr);
   ierr = MatGetBlockSize(Amat_fine, &f_bs);CHKERRQ(ierr);
   ierr = MatPtAP(Amat_fine, Pold, MAT_INITIAL_MATRIX, 2.0, &Cmat);CHKERRQ(ierr);
+  pc_gamg->moved_crs[pc_gamg->current_level+1] = PETSC_FALSE;
 
   /* set 'ncrs' (nodes), 'ncrs_eq' (equations)*/
   ierr = MatGetLocalSize(Cmat, &ncrs_eq, NULL);CHKERRQ(ierr);
@@ -356,12 +357,13 @@ static PetscErrorCode PCGAMGCreateLevel_GAMG(PC pc,Mat Amat_fine,PetscInt cr_bs,
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET13],0,0,0,0);CHKERRQ(ierr);
     ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET14],0,0,0,0);CHKERRQ(ierr);
 #endif
-    /* 'a_Amat_crs' output */
+    /* 'a_Amat_crs' output, not a product of the new prolongator so a rebuild with reused interpolations redoes the symbolic MatPtAP() once */
     {
       Mat mat;
       ierr        = MatCreateSubMatrix(Cmat, new_eq_indices, new_eq_indices, MAT_INITIAL_MATRIX, &mat);CHKERRQ(ierr);
       *a_Amat_crs = mat;
     }
+    pc_gamg->moved_crs[pc_gamg->current_level+1] = PETSC_TRUE;
     ierr = MatDestroy(&Cmat);CHKERRQ(ierr);
 
 #if defined PETSC_GAMG_USE_LOG
@@ -435,6 +437,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
       PC_MG_Levels **mglevels = mg->levels;
       /* just do Galerkin grids */
       Mat          B,dA,dB;
+      PetscBool    symbolic = (PetscBool)(pc->flag == DIFFERENT_NONZERO_PATTERN);
 
       if (!pc->setupcalled) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"PCSetUp() has not been called yet");
       if (pc_gamg->Nlevels > 1) {
@@ -443,24 +446,45 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
         /* (re)set to get dirty flag */
         ierr = KSPSetOperators(mglevels[pc_gamg->Nlevels-1]->smoothd,dA,dB);CHKERRQ(ierr);
 
+        /* the coarse grids are MatPtAP() products of the interpolations kept here, except those moved to fewer processes in
+           PCGAMGCreateLevel_GAMG() before their first rebuild, so only these and a new nonzero pattern require the symbolic product */
         for (level=pc_gamg->Nlevels-2; level>=0; level--) {
-          /* 2nd solve, matrix structure can change from repartitioning or process reduction but don't know if we have process reduction here. Should fix */
-          if (pc_gamg->setup_count==2 /* && pc_gamg->repart||reduction */) {
-            ierr = PetscInfo2(pc,"new RAP after first solve level %D, %D setup\n",level,pc_gamg->setup_count);CHKERRQ(ierr);
+          if (symbolic || pc_gamg->moved_crs[pc_gamg->Nlevels-1-level]) {
+            ierr = PetscInfo2(pc,"new RAP level %D, %D setup\n",level,pc_gamg->setup_count);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+            ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET_PTAP_SYM],0,0,0,0);CHKERRQ(ierr);
+#endif
             ierr = MatPtAP(dB,mglevels[level+1]->interpolate,MAT_INITIAL_MATRIX,2.0,&B);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+            ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET_PTAP_SYM],0,0,0,0);CHKERRQ(ierr);
+#endif
             ierr = MatDestroy(&mglevels[level]->A);CHKERRQ(ierr);
             mglevels[level]->A = B;
+            pc_gamg->moved_crs[pc_gamg->Nlevels-1-level] = PETSC_FALSE;
           } else {
-            ierr = PetscInfo2(pc,"RAP after first solve reusing matrix level %D, %D setup\n",level,pc_gamg->setup_count);CHKERRQ(ierr);
+            ierr = PetscInfo2(pc,"RAP reusing matrix level %D, %D setup\n",level,pc_gamg->setup_count);CHKERRQ(ierr);
             ierr = KSPGetOperators(mglevels[level]->smoothd,NULL,&B);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+            ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET_PTAP_NUM],0,0,0,0);CHKERRQ(ierr);
+#endif
             ierr = MatPtAP(dB,mglevels[level+1]->interpolate,MAT_REUSE_MATRIX,1.0,&B);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+            ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET_PTAP_NUM],0,0,0,0);CHKERRQ(ierr);
+#endif
           }
           ierr = KSPSetOperators(mglevels[level]->smoothd,B,B);CHKERRQ(ierr);
           dB   = B;
         }
       }
 
+      /* smoothers keep their data structures for an unchanged nonzero pattern (e.g. the symbolic factorization on the coarse grid) */
+#if defined PETSC_GAMG_USE_LOG
+      ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET_SMOOTH],0,0,0,0);CHKERRQ(ierr);
+#endif
       ierr = PCSetUp_MG(pc);CHKERRQ(ierr);
+#if defined PETSC_GAMG_USE_LOG
+      ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET_SMOOTH],0,0,0,0);CHKERRQ(ierr);
+#endif
       PetscFunctionReturn(0);
     }
   }
@@ -844,7 +868,11 @@ static PetscErrorCode PCGAMGSetRepartition_GAMG(PC pc, PetscBool n)
     this may negatively affect the convergence rate of the method on new matrices if the matrix entries change a great deal, but allows
           rebuilding the preconditioner quicker.
 
-.seealso: ()
+    The coarse grid operators are then formed with MatPtAP() of the kept interpolations at the first rebuild, also on the levels that are
+    repartitioned or reduced to fewer processes. Later rebuilds with a matrix with the same nonzero pattern only do the numeric part of MatPtAP()
+    on every level and update the smoothers, which keep their data structures (for example the symbolic factorization of the coarse grid solver).
+
+.seealso: PCGAMGSetRepartition()
 @*/
 PetscErrorCode PCGAMGSetReuseInterpolation(PC pc, PetscBool n)
 {
@@ -1395,6 +1423,9 @@ PetscErrorCode PCGAMGInitializePackage(void)
   ierr = PetscLogEventRegister("  Invert-Sort", PC_CLASSID, &petsc_gamg_setup_events[SET13]);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("  Move A", PC_CLASSID, &petsc_gamg_setup_events[SET14]);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("  Move P", PC_CLASSID, &petsc_gamg_setup_events[SET15]);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("GAMG: PtAP sym", PC_CLASSID, &petsc_gamg_setup_events[SET_PTAP_SYM]);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("GAMG: PtAP num", PC_CLASSID, &petsc_gamg_setup_events[SET_PTAP_NUM]);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("GAMG: smoothers", PC_CLASSID, &petsc_gamg_setup_events[SET_SMOOTH]);CHKERRQ(ierr);
 
   /* PetscLogEventRegister(" PL move data", PC_CLASSID, &petsc_gamg_setup_events[SET13]); */
   /* PetscLogEventRegister("GAMG: fix", PC_CLASSID, &petsc_gamg_setup_events[SET10]); */
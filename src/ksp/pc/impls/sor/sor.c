@@ -10,6 +10,8 @@ typedef struct {
   MatSORType sym;         /* forward, reverse, symmetric etc. */
   PetscReal  omega;
   PetscReal  fshift;
+  MatSOROrdering ordering; /* order in which the local rows are relaxed */
+  PetscBool  orderingset; /* ordering was set on the PC, otherwise the ordering of the matrix is used */
 } PC_SOR;
 
 static PetscErrorCode PCDestroy_SOR(PC pc)
@@ -21,6 +23,16 @@ static PetscErrorCode PCDestroy_SOR(PC pc)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PCSetUp_SOR(PC pc)
+{
+  PC_SOR         *jac = (PC_SOR*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (jac->orderingset) {ierr = MatSetSOROrdering(pc->pmat,jac->ordering);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApply_SOR(PC pc,Vec x,Vec y)
 {
   PC_SOR         *jac = (PC_SOR*)pc->data;
@@ -76,6 +88,8 @@ PetscErrorCode PCSetFromOptions_SOR(PetscOptionItems *PetscOptionsObject,PC pc)
   ierr = PetscOptionsReal("-pc_sor_diagonal_shift","Add to the diagonal entries","",jac->fshift,&jac->fshift,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_its","number of inner SOR iterations","PCSORSetIterations",jac->its,&jac->its,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_lits","number of local inner SOR iterations","PCSORSetIterations",jac->lits,&jac->lits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-pc_sor_ordering","order in which the local rows are relaxed","PCSORSetOrdering",MatSOROrderings,(PetscEnum)jac->ordering,(PetscEnum*)&jac->ordering,&flg);CHKERRQ(ierr);
+  if (flg) jac->orderingset = PETSC_TRUE;
   ierr = PetscOptionsBoolGroupBegin("-pc_sor_symmetric","SSOR, not SOR","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCSORSetSymmetric(pc,SOR_SYMMETRIC_SWEEP);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroup("-pc_sor_backward","use backward sweep instead of forward","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
@@ -115,6 +129,7 @@ PetscErrorCode PCView_SOR(PC pc,PetscViewer viewer)
     else if (sym & SOR_LOCAL_BACKWARD_SWEEP)                                 sortype = "local_backward";
     else                                                                     sortype = "unknown";
     ierr = PetscViewerASCIIPrintf(viewer,"  type = %s, iterations = %D, local iterations = %D, omega = %g\n",sortype,jac->its,jac->lits,(double)jac->omega);CHKERRQ(ierr);
+    if (jac->ordering != MAT_SOR_ORDERING_NATURAL) {ierr = PetscViewerASCIIPrintf(viewer,"  ordering = %s\n",MatSOROrderings[jac->ordering]);CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -150,6 +165,25 @@ static PetscErrorCode  PCSORSetIterations_SOR(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode  PCSORSetOrdering_SOR(PC pc,MatSOROrdering ordering)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  jac->ordering    = ordering;
+  jac->orderingset = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode  PCSORGetOrdering_SOR(PC pc,MatSOROrdering *ordering)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  *ordering = jac->ordering;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCSORGetSymmetric_SOR(PC pc,MatSORType *flag)
 {
   PC_SOR *jac = (PC_SOR*)pc->data;
@@ -395,6 +429,68 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCSORSetOrdering - Sets the order in which the SOR preconditioner relaxes the rows on each process
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  ordering - MAT_SOR_ORDERING_NATURAL (the default) or MAT_SOR_ORDERING_MULTICOLOR
+
+   Options Database Key:
+.  -pc_sor_ordering <natural,multicolor> - Sets the ordering
+
+   Notes:
+   With the multicolor ordering the rows are relaxed color by color, all the rows of one color at once using
+   SIMD and OpenMP threads, see MatSetSOROrdering(). This gives different iterates than the natural ordering
+   but each sweep is cheaper on many-core processors; it is typically used for the smoothers of PCMG with
+   -mg_levels_pc_sor_ordering multicolor.
+
+   The ordering is passed to the preconditioning matrix in PCSetUp(), it replaces an ordering set there with MatSetSOROrdering().
+   Without this call or -pc_sor_ordering the ordering of the matrix is kept. It is ignored by the matrix types that do not support it.
+
+   Level: intermediate
+
+.seealso: PCSORGetOrdering(), MatSetSOROrdering(), PCSORSetSymmetric(), PCSORSetIterations()
+@*/
+PetscErrorCode  PCSORSetOrdering(PC pc,MatSOROrdering ordering)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(pc,ordering,2);
+  ierr = PetscTryMethod(pc,"PCSORSetOrdering_C",(PC,MatSOROrdering),(pc,ordering));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCSORGetOrdering - Gets the order in which the SOR preconditioner relaxes the rows on each process
+
+   Not Collective
+
+   Input Parameter:
+.  pc - the preconditioner context
+
+   Output Parameter:
+.  ordering - MAT_SOR_ORDERING_NATURAL or MAT_SOR_ORDERING_MULTICOLOR
+
+   Level: intermediate
+
+.seealso: PCSORSetOrdering()
+@*/
+PetscErrorCode  PCSORGetOrdering(PC pc,MatSOROrdering *ordering)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidPointer(ordering,2);
+  ierr = PetscUseMethod(pc,"PCSORGetOrdering_C",(PC,MatSOROrdering*),(pc,ordering));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
      PCSOR - (S)SOR (successive over relaxation, Gauss-Seidel) preconditioning
 
@@ -408,7 +504,8 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
 .  -pc_sor_omega <omega> - Sets omega
 .  -pc_sor_diagonal_shift <shift> - shift the diagonal entries; useful if the matrix has zeros on the diagonal
 .  -pc_sor_its <its> - Sets number of iterations   (default 1)
--  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+.  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+-  -pc_sor_ordering <natural,multicolor> - Relax the local rows in their natural order or color by color with threads (AIJ only)
 
    Level: beginner
 
@@ -431,7 +528,7 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
           the maximum number of iterations you've selected for KSP. It is usually used in this mode as a smoother for multigrid.
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
-           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCEISENSTAT
+           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCSORSetOrdering(), PCEISENSTAT
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
@@ -446,7 +543,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   pc->ops->applytranspose  = PCApplyTranspose_SOR;
   pc->ops->applyrichardson = PCApplyRichardson_SOR;
   pc->ops->setfromoptions  = PCSetFromOptions_SOR;
-  pc->ops->setup           = 0;
+  pc->ops->setup           = PCSetUp_SOR;
   pc->ops->view            = PCView_SOR;
   pc->ops->destroy         = PCDestroy_SOR;
   pc->data                 = (void*)jac;
@@ -455,6 +552,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   jac->fshift              = 0.0;
   jac->its                 = 1;
   jac->lits                = 1;
+  jac->ordering            = MAT_SOR_ORDERING_NATURAL;
+  jac->orderingset         = PETSC_FALSE;
 
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORSetSymmetric_C",PCSORSetSymmetric_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORSetOmega_C",PCSORSetOmega_SOR);CHKERRQ(ierr);
@@ -462,6 +561,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetSymmetric_C",PCSORGetSymmetric_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetOmega_C",PCSORGetOmega_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetIterations_C",PCSORGetIterations_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORSetOrdering_C",PCSORSetOrdering_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetOrdering_C",PCSORGetOrdering_SOR);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,114 @@
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO() against MatSetValues()\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       bs = 1,nb = 6,M,e,estart,eend,k,n,*coo_i,*coo_j;
+  PetscScalar    *coo_v;
+  PetscBool      flg;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nb",&nb,NULL);CHKERRQ(ierr);
+  M    = bs*nb;
+
+  /* 1d "elements" coupling rows e and e+1, split evenly among processes regardless of the row ownership,
+     plus a long range coupling (e,M-1-e), a repeated diagonal entry and an entry that must be ignored */
+  estart = (rank*(M-1))/size;
+  eend   = ((rank+1)*(M-1))/size;
+  n      = 7*(eend-estart) + 1;
+  ierr   = PetscMalloc3(n,&coo_i,n,&coo_j,n,&coo_v);CHKERRQ(ierr);
+  for (e=estart,k=0; e<eend; e++) {
+    coo_i[k] = e;   coo_j[k] = e;     coo_v[k++] = 2.0;
+    coo_i[k] = e;   coo_j[k] = e+1;   coo_v[k++] = -1.0;
+    coo_i[k] = e+1; coo_j[k] = e;     coo_v[k++] = -1.0;
+    coo_i[k] = e+1; coo_j[k] = e+1;   coo_v[k++] = 2.0;
+    coo_i[k] = e;   coo_j[k] = M-1-e; coo_v[k++] = (PetscScalar)(e%3);
+    coo_i[k] = e;   coo_j[k] = e;     coo_v[k++] = 1.0;
+    coo_i[k] = e;   coo_j[k] = -1;    coo_v[k++] = 100.0;
+  }
+  if (!rank) {coo_i[k] = M-1; coo_j[k] = 0; coo_v[k++] = 3.0;}
+  n = k;
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,M,M);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(A,bs);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,M,M);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(B,bs);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+
+  /* reference matrix */
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    ierr = MatSetValues(A,1,&coo_i[k],1,&coo_j[k],&coo_v[k],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatSetPreallocationCOO(B,n,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(B,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSetValuesCOO() with INSERT_VALUES does not match MatSetValues()\n");CHKERRQ(ierr);}
+
+  ierr = MatSetValuesCOO(B,coo_v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSetValuesCOO() with ADD_VALUES does not match MatSetValues()\n");CHKERRQ(ierr);}
+
+  /* a second pass reusing the matrix must give the same result and keep the options on new nonzeros */
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(B,n,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(B,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatScale(A,0.5);CHKERRQ(ierr);
+  ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Repeated MatSetPreallocationCOO() does not match MatSetValues()\n");CHKERRQ(ierr);}
+
+  /* (0,2) is not in the COO structure */
+  if (!rank) {
+    PetscInt    row = 0,col = 2;
+    PetscScalar v   = 5.0;
+
+    ierr = MatSetValues(A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(B,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatEqual(A,B,&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSetValues() outside the COO structure does not match\n");CHKERRQ(ierr);}
+
+  ierr = PetscFree3(coo_i,coo_j,coo_v);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+     suffix: aij
+     nsize: {{1 2 3}}
+     args: -mat_type aij -bs {{1 2}}
+
+   test:
+     suffix: baij
+     nsize: {{1 2 3}}
+     args: -mat_type baij -bs {{1 2 3}}
+
+   test:
+     suffix: dense
+     nsize: {{1 2}}
+     args: -mat_type dense
+
+TEST*/
@@ -0,0 +1,143 @@
+static char help[] = "Tests the threaded matrix-vector products of MATAIJOMP against MATAIJ\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckVecs(Vec x,Vec y,const char *op)
+{
+  PetscErrorCode ierr;
+  PetscReal      nrm,nrmx;
+
+  PetscFunctionBegin;
+  ierr = VecNorm(x,NORM_INFINITY,&nrmx);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  if (nrm > 100*PETSC_MACHINE_EPSILON*PetscMax(nrmx,1.0)) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s does not match MATAIJ, error %g\n",op,(double)nrm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w,xt,yt,zt,wt;
+  PetscErrorCode ierr;
+  PetscInt       M = 100,N = 80,i,j,rstart,rend;
+  PetscScalar    v;
+  PetscRandom    rctx;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-M",&M,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-N",&N,NULL);CHKERRQ(ierr);
+
+  /* rows with very different lengths, some of them empty, so that the partition is not uniform */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,M,N);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    if (i%7 == 3) continue;
+    for (j=i%N; j<N; j+=1+i%5) {
+      if (i%11 == 0 && j > N/4) break;
+      v    = (PetscScalar)(1 + (i*j)%13);
+      ierr = MatSetValues(A,1,&i,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJOMP,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&yt,&xt);CHKERRQ(ierr);
+  ierr = VecDuplicate(yt,&zt);CHKERRQ(ierr);
+  ierr = VecDuplicate(yt,&wt);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(xt,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(zt,rctx);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckVecs(y,w,"MatMult()");CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckVecs(y,w,"MatMultAdd()");CHKERRQ(ierr);
+
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = VecCopy(z,w);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,w,w);CHKERRQ(ierr);
+  ierr = CheckVecs(y,w,"In-place MatMultAdd()");CHKERRQ(ierr);
+
+  ierr = MatMultTranspose(A,xt,yt);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,xt,wt);CHKERRQ(ierr);
+  ierr = CheckVecs(yt,wt,"MatMultTranspose()");CHKERRQ(ierr);
+
+  ierr = MatMultTransposeAdd(A,xt,zt,yt);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,xt,zt,wt);CHKERRQ(ierr);
+  ierr = CheckVecs(yt,wt,"MatMultTransposeAdd()");CHKERRQ(ierr);
+
+  ierr = VecCopy(zt,yt);CHKERRQ(ierr);
+  ierr = VecCopy(zt,wt);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(A,xt,yt,yt);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,xt,wt,wt);CHKERRQ(ierr);
+  ierr = CheckVecs(yt,wt,"In-place MatMultTransposeAdd()");CHKERRQ(ierr);
+
+  /* change the nonzero structure, the partition must follow */
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    if (i%7 != 3) continue;
+    j    = N-1;
+    v    = 1.0;
+    ierr = MatSetValues(A,1,&i,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(B,1,&i,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckVecs(y,w,"MatMult() after new nonzeros");CHKERRQ(ierr);
+  ierr = MatMultTranspose(A,xt,yt);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,xt,wt);CHKERRQ(ierr);
+  ierr = CheckVecs(yt,wt,"MatMultTranspose() after new nonzeros");CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = VecDestroy(&zt);CHKERRQ(ierr);
+  ierr = VecDestroy(&wt);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+     requires: openmp
+
+   test:
+     nsize: {{1 2 3}}
+     args: -mat_aijomp_num_threads {{1 3}}
+
+   test:
+     suffix: 2
+     nsize: 2
+     args: -mat_aijomp_num_threads 4 -M 7 -N 5
+
+TEST*/
@@ -0,0 +1,95 @@
+static char help[] = "Tests MatSOR() with the multicolor ordering of MatSetSOROrdering()\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckResidual(Mat A,Vec b,Vec x,const char *msg)
+{
+  PetscErrorCode ierr;
+  Vec            r;
+  PetscReal      nrm,nrmb;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = MatMult(A,x,r);CHKERRQ(ierr);
+  ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&nrmb);CHKERRQ(ierr);
+  if (nrm > 1.e-8*nrmb) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: relative residual %g\n",msg,(double)(nrm/nrmb));CHKERRQ(ierr);}
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x,b;
+  PetscErrorCode ierr;
+  PetscInt       n = 40,i,j,row,col,rstart,rend,its = 200;
+  PetscScalar    v;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* diagonally dominant convection-diffusion operator with a nonsymmetric nonzero structure */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,6,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,6,NULL,6,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row/n; j = row - i*n;
+    v = 5.0;  ierr = MatSetValues(A,1,&row,1,&row,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v = -1.5; if (i>0)   {col = row - n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = -0.5; if (i<n-1) {col = row + n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = -1.0; if (j>0)   {col = row - 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = -1.0; if (j<n-1) {col = row + 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 0.25; if (!(row%7) && row+2*n+3 < n*n) {col = row + 2*n + 3; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  /* MatSOR() used as a solver must converge to the solution with any ordering of the rows */
+  ierr = MatSetSOROrdering(A,MAT_SOR_ORDERING_MULTICOLOR);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,its,1,x);CHKERRQ(ierr);
+  ierr = CheckResidual(A,b,x,"Multicolor symmetric sweeps");CHKERRQ(ierr);
+
+  ierr = VecSet(x,3.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.2,SOR_LOCAL_FORWARD_SWEEP,0.0,its,1,x);CHKERRQ(ierr);
+  ierr = CheckResidual(A,b,x,"Multicolor forward sweeps with omega");CHKERRQ(ierr);
+
+  ierr = VecSet(x,0.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,0.9,SOR_LOCAL_BACKWARD_SWEEP,0.0,its/2,2,x);CHKERRQ(ierr);
+  ierr = CheckResidual(A,b,x,"Multicolor backward sweeps with local iterations");CHKERRQ(ierr);
+
+  /* new values must be picked up */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,its,1,x);CHKERRQ(ierr);
+  ierr = CheckResidual(A,b,x,"Multicolor sweeps after new values");CHKERRQ(ierr);
+
+  /* the Eisenstat trick and back to the natural ordering */
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_EISENSTAT | SOR_LOCAL_SYMMETRIC_SWEEP),0.0,1,1,x);CHKERRQ(ierr);
+  ierr = MatSetSOROrdering(A,MAT_SOR_ORDERING_NATURAL);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,its,1,x);CHKERRQ(ierr);
+  ierr = CheckResidual(A,b,x,"Natural symmetric sweeps");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+     nsize: {{1 2}}
+     args: -mat_type aij
+
+   test:
+     suffix: noinode
+     args: -mat_type aij -mat_no_inode -n 13
+
+TEST*/
@@ -0,0 +1,121 @@
+static char help[] = "Tests the level scheduled MatSolve() of LU, ILU, Cholesky and ICC factors against the sequential one\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode TestFactor(Mat A,MatFactorType ftype,PetscInt levels,MatOrderingType otype,Vec b)
+{
+  PetscErrorCode ierr;
+  Mat            F[2];
+  IS             row,col;
+  MatFactorInfo  info;
+  Vec            x[2];
+  PetscReal      nrm,nrmx;
+  PetscInt       i,k;
+  const char     *prefix[2] = {"lev_","seq_"};
+
+  PetscFunctionBegin;
+  ierr = MatGetOrdering(A,otype,&row,&col);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = levels;
+  info.fill   = 5.0;
+  for (i=0; i<2; i++) {
+    ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&F[i]);CHKERRQ(ierr);
+    ierr = MatSetOptionsPrefix(F[i],prefix[i]);CHKERRQ(ierr);
+    switch (ftype) {
+    case MAT_FACTOR_LU:       ierr = MatLUFactorSymbolic(F[i],A,row,col,&info);CHKERRQ(ierr);break;
+    case MAT_FACTOR_ILU:      ierr = MatILUFactorSymbolic(F[i],A,row,col,&info);CHKERRQ(ierr);break;
+    case MAT_FACTOR_CHOLESKY: ierr = MatCholeskyFactorSymbolic(F[i],A,row,&info);CHKERRQ(ierr);break;
+    case MAT_FACTOR_ICC:      ierr = MatICCFactorSymbolic(F[i],A,row,&info);CHKERRQ(ierr);break;
+    default: SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not tested");
+    }
+    ierr = MatCreateVecs(A,&x[i],NULL);CHKERRQ(ierr);
+  }
+  /* the second numeric factorization reuses the levels computed by the first one */
+  for (k=0; k<2; k++) {
+    for (i=0; i<2; i++) {
+      if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) {ierr = MatLUFactorNumeric(F[i],A,&info);CHKERRQ(ierr);}
+      else {ierr = MatCholeskyFactorNumeric(F[i],A,&info);CHKERRQ(ierr);}
+      ierr = MatSolve(F[i],b,x[i]);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(x[1],NORM_INFINITY,&nrmx);CHKERRQ(ierr);
+    ierr = VecAXPY(x[0],-1.0,x[1]);CHKERRQ(ierr);
+    ierr = VecNorm(x[0],NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    if (nrm > 100*PETSC_MACHINE_EPSILON*nrmx) {ierr = PetscPrintf(PETSC_COMM_SELF,"%s(%D) with ordering %s: difference %g in solve %D\n",MatFactorTypes[ftype],levels,otype,(double)nrm,k);CHKERRQ(ierr);}
+    ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  }
+  ierr = MatShift(A,-2.0);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    ierr = VecDestroy(&x[i]);CHKERRQ(ierr);
+    ierr = MatDestroy(&F[i]);CHKERRQ(ierr);
+  }
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            b;
+  PetscErrorCode ierr;
+  PetscInt       n = 30,i,j,row,col;
+  PetscScalar    v;
+  PetscRandom    rctx;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* symmetric positive definite 2d Laplacian with a few long range couplings */
+  ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,n*n,n*n,n*n,n*n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,7,NULL);CHKERRQ(ierr);
+  for (row=0; row<n*n; row++) {
+    i = row/n; j = row - i*n;
+    v = 4.5;  ierr = MatSetValues(A,1,&row,1,&row,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v = -1.0;
+    if (i>0)   {col = row - n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<n-1) {col = row + n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {col = row - 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {col = row + 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = -0.25;
+    if (!(row%5) && row+3*n+2 < n*n) {
+      col  = row + 3*n + 2;
+      ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+      ierr = MatSetValues(A,1,&col,1,&row,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SYMMETRIC,PETSC_TRUE);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,NULL,&b);CHKERRQ(ierr);
+  ierr = VecSetRandom(b,rctx);CHKERRQ(ierr);
+
+  ierr = TestFactor(A,MAT_FACTOR_ILU,0,MATORDERINGNATURAL,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_ILU,2,MATORDERINGRCM,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_LU,0,MATORDERINGND,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_ICC,0,MATORDERINGNATURAL,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_ICC,1,MATORDERINGRCM,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_CHOLESKY,0,MATORDERINGND,b);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+     args: -lev_mat_solve_level_schedule -seq_mat_solve_level_schedule 0
+
+   test:
+     suffix: noinode
+     args: -lev_mat_solve_level_schedule -seq_mat_solve_level_schedule 0 -mat_no_inode -n 17
+
+TEST*/
@@ -0,0 +1,122 @@
+static char help[] = "Tests MatMult() and MatMultAdd() of MPIAIJ matrices with the local rows split into interior and boundary rows\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckProducts(Mat A,Mat S,Vec x,Vec y,const char *msg)
+{
+  PetscErrorCode ierr;
+  Vec            z[2];
+  PetscReal      nrm[2];
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<2; i++) {ierr = VecDuplicate(y,&z[i]);CHKERRQ(ierr);}
+  ierr = MatMult(A,x,z[0]);CHKERRQ(ierr);
+  ierr = MatMult(S,x,z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_INFINITY,&nrm[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_INFINITY,&nrm[1]);CHKERRQ(ierr);
+  if (nrm[1] > 100*PETSC_MACHINE_EPSILON*nrm[0]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: MatMult() difference %g\n",msg,(double)nrm[1]);CHKERRQ(ierr);}
+
+  ierr = MatMultAdd(A,x,y,z[0]);CHKERRQ(ierr);
+  ierr = MatMultAdd(S,x,y,z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_INFINITY,&nrm[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_INFINITY,&nrm[1]);CHKERRQ(ierr);
+  if (nrm[1] > 100*PETSC_MACHINE_EPSILON*nrm[0]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: MatMultAdd() difference %g\n",msg,(double)nrm[1]);CHKERRQ(ierr);}
+
+  /* in place, yy == zz */
+  ierr = VecCopy(y,z[0]);CHKERRQ(ierr);
+  ierr = VecCopy(y,z[1]);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,z[0],z[0]);CHKERRQ(ierr);
+  ierr = MatMultAdd(S,x,z[1],z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_INFINITY,&nrm[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_INFINITY,&nrm[1]);CHKERRQ(ierr);
+  if (nrm[1] > 100*PETSC_MACHINE_EPSILON*nrm[0]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: in place MatMultAdd() difference %g\n",msg,(double)nrm[1]);CHKERRQ(ierr);}
+  for (i=0; i<2; i++) {ierr = VecDestroy(&z[i]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,S;
+  Vec            x,y;
+  PetscErrorCode ierr;
+  PetscInt       n = 20,i,j,row,col,rstart,rend;
+  PetscScalar    v;
+  PetscRandom    rctx;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* 2d five point stencil with a few long range couplings */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row/n; j = row - i*n;
+    v = 4.0 + 0.1*j; ierr = MatSetValues(A,1,&row,1,&row,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v = -1.0;
+    if (i>0)   {col = row - n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<n-1) {col = row + n; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {col = row - 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {col = row + 1; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 0.5;
+    if (!(row%11)) {col = (row + n*n/2) % (n*n); ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&S);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetMultSplit(S,PETSC_TRUE);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,rctx);CHKERRQ(ierr);
+  ierr = CheckProducts(A,S,x,y,"Assembled");CHKERRQ(ierr);
+
+  /* new off-process entries change the split */
+  for (row=rstart; row<rend; row+=7) {
+    col  = (row + 3*n) % (n*n);
+    v    = -0.25;
+    ierr = MatSetValues(A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(S,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = CheckProducts(A,S,x,y,"New nonzeros");CHKERRQ(ierr);
+
+  /* new values only */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatScale(S,2.0);CHKERRQ(ierr);
+  ierr = CheckProducts(A,S,x,y,"New values");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&S);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+     nsize: {{1 3}}
+
+   test:
+     suffix: noinode
+     nsize: 2
+     args: -mat_no_inode -n 13
+
+TEST*/
@@ -15,6 +15,7 @@ int main(int argc,char **args)
   PetscMPIInt    rank,size;
   PetscErrorCode ierr;
   PetscViewer    viewer;
+  PetscBool      native = PETSC_FALSE;
 #if defined(PETSC_USE_LOG)
   PetscLogEvent MATRIX_GENERATE,MATRIX_READ;
 #endif
@@ -24,6 +25,7 @@ int main(int argc,char **args)
   ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
   ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-native",&native,NULL);CHKERRQ(ierr);
   N    = m*n;
 
   /* PART 1:  Generate matrix, then write it in binary format */
@@ -51,7 +53,9 @@ int main(int argc,char **args)
 
   ierr = PetscPrintf(PETSC_COMM_WORLD,"writing matrix in binary to matrix.dat ...\n");CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,"matrix.dat",FILE_MODE_WRITE,&viewer);CHKERRQ(ierr);
+  if (native) {ierr = PetscViewerPushFormat(viewer,PETSC_VIEWER_BINARY_MMAP);CHKERRQ(ierr);}
   ierr = MatView(C,viewer);CHKERRQ(ierr);
+  if (native) {ierr = PetscViewerPopFormat(viewer);CHKERRQ(ierr);}
   ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
   ierr = MatDestroy(&C);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(MATRIX_GENERATE,0,0,0,0);CHKERRQ(ierr);
@@ -86,4 +90,23 @@ int main(int argc,char **args)
    test:
       filter: grep -v "MPI processes"
 
+   test:
+      suffix: mpiio_aggregate
+      nsize: 3
+      args: -viewer_binary_mpiio -viewer_binary_mpiio_aggregators 2 -viewer_binary_mpiio_stripe_size 40
+      filter: grep -v "MPI processes"
+      requires: mpiio
+
+   test:
+      suffix: native
+      args: -native -matload_mmap
+      filter: grep -v "MPI processes"
+      output_file: output/ex31_1.out
+
+   test:
+      suffix: native_nommap
+      args: -native
+      filter: grep -v "MPI processes"
+      output_file: output/ex31_1.out
+
 TEST*/
@@ -340,4 +340,16 @@ int main(int argc,char **argv)
      args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via allatonce_merged
      output_file: output/ex96_1.out
 
+   test:
+     suffix: blocked
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via blocked
+     output_file: output/ex96_1.out
+
+   test:
+     suffix: blocked_small
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via blocked -matptap_blocked_block_size 16 -matptap_blocked_memory 0.001
+     output_file: output/ex96_1.out
+
 TEST*/
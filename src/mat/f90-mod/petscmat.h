@@ -245,6 +245,14 @@
       parameter (SOR_ZERO_INITIAL_GUESS=16,SOR_EISENSTAT=32)
       parameter (SOR_APPLY_UPPER=64,SOR_APPLY_LOWER=128)
 !
+!  MatSOROrdering
+!
+      PetscEnum MAT_SOR_ORDERING_NATURAL
+      PetscEnum MAT_SOR_ORDERING_MULTICOLOR
+
+      parameter (MAT_SOR_ORDERING_NATURAL=0)
+      parameter (MAT_SOR_ORDERING_MULTICOLOR=1)
+!
 !  MatOperation
 !
       PetscEnum MATOP_SET_VALUES
@@ -697,6 +705,8 @@
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_EISENSTAT
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_APPLY_UPPER
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_APPLY_LOWER
+!DEC$ ATTRIBUTES DLLEXPORT::MAT_SOR_ORDERING_NATURAL
+!DEC$ ATTRIBUTES DLLEXPORT::MAT_SOR_ORDERING_MULTICOLOR
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_SET_VALUES
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_GET_ROWMATOP_RESTORE_ROW
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_MULT
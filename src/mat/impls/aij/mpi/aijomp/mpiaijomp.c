@@ -0,0 +1,142 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+/*@C
+   MatCreateMPIAIJOMP - Creates a sparse parallel matrix whose local
+   portions are stored as SEQAIJOMP matrices (a matrix class that inherits
+   from SEQAIJ but threads the matrix-vector products with OpenMP).  The same
+   guidelines that apply to MPIAIJ matrices for preallocating the matrix
+   storage apply here as well.
+
+      Collective
+
+   Input Parameters:
++  comm - MPI communicator
+.  m - number of local rows (or PETSC_DECIDE to have calculated if M is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+.  n - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or PETSC_DECIDE to have
+       calculated if N is given) For square matrices n is almost always m.
+.  M - number of global rows (or PETSC_DETERMINE to have calculated if m is given)
+.  N - number of global columns (or PETSC_DETERMINE to have calculated if n is given)
+.  d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+.  d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or NULL, if d_nz is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e 'm'.
+.  o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+-  o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or NULL, if o_nz is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e 'm'.
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If the *_nnz parameter is given then the *_nz parameter is ignored
+
+   When calling this routine with a single process communicator, a matrix of
+   type SEQAIJOMP is returned.  If a matrix of type MPIAIJOMP is desired
+   for this type of communicator, use the construction mechanism:
+     MatCreate(...,&A); MatSetType(A,MPIAIJOMP); MatMPIAIJSetPreallocation(A,...);
+
+   The diagonal and off-diagonal blocks of an ordinary MPIAIJ matrix can also be made
+   SEQAIJOMP with the option -mat_seqaij_type seqaijomp.
+
+   Options Database Keys:
+.  -mat_aijomp_num_threads <n> - number of threads used in the products, defaults to the maximum number of OpenMP threads
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateSeqAIJOMP(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateMPIAIJOMP(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt M,PetscInt N,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,M,N);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) {
+    ierr = MatSetType(*A,MATMPIAIJOMP);CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(*A,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetType(*A,MATSEQAIJOMP);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(*A,d_nz,d_nnz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat,MatType,MatReuse,Mat*);
+
+PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJOMP(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(b->A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(b->B,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJOMP(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_MPIAIJ     *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  /* Convert the diagonal and off-diagonal blocks if the matrix has already been preallocated */
+  b = (Mat_MPIAIJ*)B->data;
+  if (b->A) {
+    ierr = MatConvert_SeqAIJ_SeqAIJOMP(b->A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  }
+  if (b->B) {
+    ierr = MatConvert_SeqAIJ_SeqAIJOMP(b->B,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJOMP);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJOMP(A,MATMPIAIJOMP,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJOMP - MATAIJOMP = "aijomp" - A matrix type to be used for sparse matrices.
+
+   This matrix type is identical to MATSEQAIJOMP when constructed with a single process communicator,
+   and MATMPIAIJOMP otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Options Database Keys:
++ -mat_type aijomp - sets the matrix type to "aijomp" during a call to MatSetFromOptions()
+- -mat_aijomp_num_threads <n> - number of threads used in the matrix-vector products
+
+  Level: beginner
+
+.seealso: MatCreateMPIAIJOMP(), MATSEQAIJOMP, MATMPIAIJOMP
+M*/
@@ -19,7 +19,7 @@
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -1065,6 +1065,107 @@ PetscErrorCode MatZeroRowsColumns_MPIAIJ(Mat A,PetscInt N,const PetscInt rows[],
   PetscFunctionReturn(0);
 }
 
+/*
+   Sorts the local rows into interior rows, which have no entries in the off-diagonal block B and only
+   need the locally owned part of x, and boundary rows, which also need the ghost values in lvec.
+   The split depends only on the nonzero structure of B and is recomputed when it changes.
+*/
+static PetscErrorCode MatMPIAIJSetUpMultSplit_Private(Mat A)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ     *b;
+  PetscInt       i,m = A->rmap->n,nint = 0,nbdry;
+  PetscBool      isA,isB;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->splitrows && a->splitstate == a->B->nonzerostate) PetscFunctionReturn(0);
+  ierr = PetscFree(a->splitrows);CHKERRQ(ierr);
+  /* the products below work directly on the CSR storage of the two blocks */
+  ierr = PetscObjectTypeCompare((PetscObject)a->A,MATSEQAIJ,&isA);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)a->B,MATSEQAIJ,&isB);CHKERRQ(ierr);
+  if (!isA || !isB) {
+    a->ninterior = -1;
+    PetscFunctionReturn(0);
+  }
+  b = (Mat_SeqAIJ*)a->B->data;
+  for (i=0; i<m; i++) if (b->i[i+1] == b->i[i]) nint++;
+  ierr  = PetscMalloc1(m+1,&a->splitrows);CHKERRQ(ierr);
+  nbdry = nint;
+  nint  = 0;
+  for (i=0; i<m; i++) {
+    if (b->i[i+1] == b->i[i]) a->splitrows[nint++]  = i;
+    else                      a->splitrows[nbdry++] = i;
+  }
+  a->ninterior  = nint;
+  a->splitstate = a->B->nonzerostate;
+  ierr = PetscInfo3(A,"Split %D local rows into %D interior and %D boundary rows for MatMult()\n",m,nint,m-nint);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   zz = A*xx (+ yy): the interior rows are computed while the ghost values are communicated, and the
+   boundary rows, both blocks at once, after they have arrived. Each row is summed in the same order
+   as in MatMult_MPIAIJ() and MatMultAdd_MPIAIJ().
+*/
+static PetscErrorCode MatMultSplit_MPIAIJ_Private(Mat A,VecScatter Mvctx,Vec xx,Vec yy,Vec zz)
+{
+  Mat_MPIAIJ        *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ        *ad = (Mat_SeqAIJ*)a->A->data,*bd = (Mat_SeqAIJ*)a->B->data;
+  const PetscInt    *ai = ad->i,*aj = ad->j,*bi = bd->i,*bj = bd->j,*rows = a->splitrows,*idx;
+  const MatScalar   *aa = ad->a,*ba = bd->a,*v;
+  const PetscScalar *x,*l;
+  PetscScalar       *y = NULL,*z,sum;
+  PetscInt          k,r,n,m = A->rmap->n,nint = a->ninterior;
+  PetscLogDouble    nz = 0.0;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_MultInterior,A,xx,zz,0);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else    {ierr = VecGetArray(zz,&z);CHKERRQ(ierr);}
+  for (k=0; k<nint; k++) {
+    r   = rows[k];
+    n   = ai[r+1] - ai[r];
+    idx = aj + ai[r];
+    v   = aa + ai[r];
+    sum = y ? y[r] : 0.0;
+    PetscSparseDensePlusDot(sum,x,v,idx,n);
+    z[r] = sum;
+    nz  += n;
+  }
+  ierr = PetscLogFlops(2.0*nz - (yy ? 0 : nint));CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_MultInterior,A,xx,zz,0);CHKERRQ(ierr);
+  ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_MultBoundary,A,xx,zz,0);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(a->lvec,&l);CHKERRQ(ierr);
+  nz   = 0.0;
+  for (k=nint; k<m; k++) {
+    r   = rows[k];
+    n   = ai[r+1] - ai[r];
+    idx = aj + ai[r];
+    v   = aa + ai[r];
+    sum = y ? y[r] : 0.0;
+    PetscSparseDensePlusDot(sum,x,v,idx,n);
+    nz += n;
+    n   = bi[r+1] - bi[r];
+    idx = bj + bi[r];
+    v   = ba + bi[r];
+    PetscSparseDensePlusDot(sum,l,v,idx,n);
+    z[r] = sum;
+    nz  += n;
+  }
+  ierr = VecRestoreArrayRead(a->lvec,&l);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);}
+  else    {ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);}
+  ierr = PetscLogFlops(2.0*nz - (yy ? 0 : m - nint));CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_MultBoundary,A,xx,zz,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
 {
   Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
@@ -1076,6 +1177,13 @@ PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
   ierr = VecGetLocalSize(xx,&nt);CHKERRQ(ierr);
   if (nt != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Incompatible partition of A (%D) and xx (%D)",A->cmap->n,nt);
 
+  if (a->multsplit) {
+    ierr = MatMPIAIJSetUpMultSplit_Private(A);CHKERRQ(ierr);
+    if (a->ninterior >= 0) {
+      ierr = MatMultSplit_MPIAIJ_Private(A,Mvctx,xx,NULL,yy);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
   ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -1101,6 +1209,13 @@ PetscErrorCode MatMultAdd_MPIAIJ(Mat A,Vec xx,Vec yy,Vec zz)
 
   PetscFunctionBegin;
   if (a->Mvctx_mpi1_flg) Mvctx = a->Mvctx_mpi1;
+  if (a->multsplit) {
+    ierr = MatMPIAIJSetUpMultSplit_Private(A);CHKERRQ(ierr);
+    if (a->ninterior >= 0) {
+      ierr = MatMultSplit_MPIAIJ_Private(A,Mvctx,xx,yy,zz);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->multadd)(a->A,xx,yy,zz);CHKERRQ(ierr);
   ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -1242,6 +1357,8 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  ierr = PetscFree(aij->splitrows);CHKERRQ(ierr);
+  ierr = MatCOODestroy_Private(&aij->coo);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1249,8 +1366,12 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatIsTranspose_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetSOROrdering_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetMultSplit_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpisbaij_C",NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_ELEMENTAL)
@@ -1265,6 +1386,57 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_MPIIO)
+/* Every rank writes its rows with PetscViewerBinaryWriteAllMPIIO(), in the same layout as MatView_MPIAIJ_Binary() */
+static PetscErrorCode MatView_MPIAIJ_Binary_MPIIO(Mat mat,PetscViewer viewer)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *A   = (Mat_SeqAIJ*)aij->A->data;
+  Mat_SeqAIJ     *B   = (Mat_SeqAIJ*)aij->B->data;
+  PetscErrorCode ierr;
+  PetscInt       nz,header[4],*row_lengths,*column_indices,i,j,k,col,*garray = aij->garray,cnt,cstart = mat->cmap->rstart;
+  PetscScalar    *column_values;
+  FILE           *file;
+
+  PetscFunctionBegin;
+  nz        = A->nz + B->nz;
+  header[0] = MAT_FILE_CLASSID;
+  header[1] = mat->rmap->N;
+  header[2] = mat->cmap->N;
+  ierr = MPIU_Allreduce(&nz,&header[3],1,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWrite(viewer,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+
+  ierr = PetscMalloc3(mat->rmap->n,&row_lengths,nz,&column_indices,nz,&column_values);CHKERRQ(ierr);
+  for (i=0; i<mat->rmap->n; i++) row_lengths[i] = A->i[i+1] - A->i[i] + B->i[i+1] - B->i[i];
+  cnt = 0;
+  for (i=0; i<mat->rmap->n; i++) {
+    for (j=B->i[i]; j<B->i[i+1]; j++) {
+      if ((col = garray[B->j[j]]) > cstart) break;
+      column_values[cnt]    = B->a[j];
+      column_indices[cnt++] = col;
+    }
+    for (k=A->i[i]; k<A->i[i+1]; k++) {
+      column_values[cnt]    = A->a[k];
+      column_indices[cnt++] = A->j[k] + cstart;
+    }
+    for (; j<B->i[i+1]; j++) {
+      column_values[cnt]    = B->a[j];
+      column_indices[cnt++] = garray[B->j[j]];
+    }
+  }
+  if (cnt != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Internal PETSc error: cnt = %D nz = %D",cnt,nz);
+
+  ierr = PetscViewerBinaryWriteAllMPIIO(viewer,row_lengths,mat->rmap->n,mat->rmap->rstart,mat->rmap->N,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWriteAllMPIIO(viewer,column_indices,nz,PETSC_DETERMINE,header[3],PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryWriteAllMPIIO(viewer,column_values,nz,PETSC_DETERMINE,header[3],PETSC_SCALAR);CHKERRQ(ierr);
+  ierr = PetscFree3(row_lengths,column_indices,column_values);CHKERRQ(ierr);
+
+  ierr = PetscViewerBinaryGetInfoPointer(viewer,&file);CHKERRQ(ierr);
+  if (file) fprintf(file,"-matload_block_size %d\n",(int)PetscAbs(mat->rmap->bs));
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatView_MPIAIJ_Binary(Mat mat,PetscViewer viewer)
 {
   Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
@@ -1278,8 +1450,18 @@ PetscErrorCode MatView_MPIAIJ_Binary(Mat mat,PetscViewer viewer)
   PetscScalar    *column_values;
   PetscInt       message_count,flowcontrolcount;
   FILE           *file;
+#if defined(PETSC_HAVE_MPIIO)
+  PetscBool      usempiio;
+#endif
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPIIO)
+  ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+  if (usempiio) {
+    ierr = MatView_MPIAIJ_Binary_MPIIO(mat,viewer);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
   ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)mat),&rank);CHKERRQ(ierr);
   ierr = MPI_Comm_size(PetscObjectComm((PetscObject)mat),&size);CHKERRQ(ierr);
   nz   = A->nz + B->nz;
@@ -1465,7 +1647,10 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       PetscFunctionReturn(0);
     }
   } else if (isbinary) {
-    if (size == 1) {
+    PetscBool usempiio;
+
+    ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+    if (size == 1 && !usempiio) {
       ierr = PetscObjectSetName((PetscObject)aij->A,((PetscObject)mat)->name);CHKERRQ(ierr);
       ierr = MatView(aij->A,viewer);CHKERRQ(ierr);
     } else {
@@ -1543,6 +1728,17 @@ PetscErrorCode MatView_MPIAIJ(Mat mat,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+/* the local sweeps of MatSOR_MPIAIJ() are done by the diagonal block */
+static PetscErrorCode MatSetSOROrdering_MPIAIJ(Mat A,MatSOROrdering ordering)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetSOROrdering(a->A,ordering);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSOR_MPIAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
 {
   Mat_MPIAIJ     *mat = (Mat_MPIAIJ*)matin->data;
@@ -2542,10 +2738,59 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A,PetscBool sc)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatMPIAIJSetMultSplit_MPIAIJ(Mat A,PetscBool flg)
+{
+  Mat_MPIAIJ *a = (Mat_MPIAIJ*)A->data;
+
+  PetscFunctionBegin;
+  a->multsplit = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatMPIAIJSetMultSplit - Determine if MatMult() and MatMultAdd() split the local rows into interior and boundary rows
+   to overlap the communication of the ghost values with more computation
+
+   Logically Collective on Mat
+
+   Input Parameters:
++    A - the matrix
+-    flg - PETSC_TRUE to split the rows (default is not to split them)
+
+   Options Database Key:
+.    -mat_mult_split - split the rows
+
+   Notes:
+   By default the products compute the diagonal block while the ghost values are communicated and then the off-diagonal
+   block. With the split the local rows that have no entries in the off-diagonal block are computed completely while the
+   ghost values are communicated; the remaining rows, with both blocks, are computed after they have arrived. The split is
+   computed at the first product and recomputed when the nonzero structure changes.
+
+   The two phases are logged with the events MatMultInterior and MatMultBoundary. The time of VecScatterEnd() reported
+   by -log_view, which is nested between the two, is the part of the communication that was not hidden.
+
+   The split is only used when the diagonal and off-diagonal blocks are of type MATSEQAIJ.
+
+   Level: advanced
+
+.seealso: MatMult(), MatMultAdd(), MATMPIAIJ
+@*/
+PetscErrorCode MatMPIAIJSetMultSplit(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatMPIAIJSetMultSplit_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode       ierr;
-  PetscBool            sc = PETSC_FALSE,flg;
+  PetscBool            sc = PETSC_FALSE,split,flg;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"MPIAIJ options");CHKERRQ(ierr);
@@ -2554,6 +2799,10 @@ PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat
   if (flg) {
     ierr = MatMPIAIJSetUseScalableIncreaseOverlap(A,sc);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-mat_mult_split","Compute the rows without off-process entries while communicating","MatMPIAIJSetMultSplit",a->multsplit,&split,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = MatMPIAIJSetMultSplit(A,split);CHKERRQ(ierr);
+  }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2874,6 +3123,7 @@ PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *ne
   a->rowindices   = 0;
   a->rowvalues    = 0;
   a->getrowactive = PETSC_FALSE;
+  a->multsplit    = oldmat->multsplit;
 
   ierr = PetscLayoutReference(matin->rmap,&mat->rmap);CHKERRQ(ierr);
   ierr = PetscLayoutReference(matin->cmap,&mat->cmap);CHKERRQ(ierr);
@@ -2940,6 +3190,80 @@ PetscErrorCode MatLoad_MPIAIJ(Mat newMat, PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_MPIIO)
+/* Every rank reads its rows with PetscViewerBinaryReadAllMPIIO(), the counterpart of MatView_MPIAIJ_Binary_MPIIO() */
+static PetscErrorCode MatLoad_MPIAIJ_Binary_MPIIO(Mat newMat,PetscViewer viewer)
+{
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       header[4],M,N,m,n,rstart,rend,cstart,cend,i,j,nz,*ourlens,*offlens,*cols,*ii;
+  PetscInt       bs = newMat->rmap->bs;
+  PetscScalar    *vals;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(viewer,header,4,NULL,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != MAT_FILE_CLASSID) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"not matrix object");
+  if (header[3] < 0) SETERRQ(comm,PETSC_ERR_FILE_UNEXPECTED,"Matrix stored in special format on disk,cannot load as MATMPIAIJ");
+
+  ierr = PetscOptionsBegin(comm,NULL,"Options for loading MATMPIAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-matload_block_size","Set the blocksize used to store the matrix","MatLoad",bs,&bs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (bs < 0) bs = 1;
+
+  M = header[1]; N = header[2];
+  if (newMat->rmap->N >= 0 && newMat->rmap->N != M) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Inconsistent # of rows:Matrix in file has (%D) and input matrix has (%D)",newMat->rmap->N,M);
+  if (newMat->cmap->N >= 0 && newMat->cmap->N != N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Inconsistent # of cols:Matrix in file has (%D) and input matrix has (%D)",newMat->cmap->N,N);
+  if (M%bs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Inconsistent # of rows (%D) and block size (%D)",M,bs);
+  if (newMat->rmap->n < 0) m = bs*((M/bs)/size + (((M/bs) % size) > rank));
+  else m = newMat->rmap->n;
+  ierr   = MPI_Scan(&m,&rend,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  rstart = rend - m;
+  if (N != M) {
+    if (newMat->cmap->n < 0) n = N/size + ((N % size) > rank);
+    else n = newMat->cmap->n;
+    ierr   = MPI_Scan(&n,&cend,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+    cstart = cend - n;
+  } else {
+    cstart = rstart;
+    cend   = rend;
+    n      = m;
+  }
+
+  /* Read my rows: their lengths, then their column indices and values */
+  ierr = PetscMalloc3(m,&ourlens,m,&offlens,m+1,&ii);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAllMPIIO(viewer,ourlens,m,rstart,M,PETSC_INT);CHKERRQ(ierr);
+  for (ii[0]=0,i=0; i<m; i++) ii[i+1] = ii[i] + ourlens[i];
+  nz   = ii[m];
+  ierr = PetscMalloc2(nz,&cols,nz,&vals);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAllMPIIO(viewer,cols,nz,PETSC_DETERMINE,header[3],PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryReadAllMPIIO(viewer,vals,nz,PETSC_DETERMINE,header[3],PETSC_SCALAR);CHKERRQ(ierr);
+
+  /* Split the row lengths into diagonal and off-diagonal blocks */
+  for (i=0; i<m; i++) {
+    offlens[i] = 0;
+    for (j=ii[i]; j<ii[i+1]; j++) if (cols[j] < cstart || cols[j] >= cend) offlens[i]++;
+    ourlens[i] -= offlens[i];
+  }
+  ierr = MatSetSizes(newMat,m,n,M,N);CHKERRQ(ierr);
+  if (bs > 1) {ierr = MatSetBlockSize(newMat,bs);CHKERRQ(ierr);}
+  ierr = MatMPIAIJSetPreallocation(newMat,0,ourlens,0,offlens);CHKERRQ(ierr);
+
+  for (i=0; i<m; i++) {
+    PetscInt row = rstart + i;
+    ierr = MatSetValues_MPIAIJ(newMat,1,&row,ii[i+1]-ii[i],cols+ii[i],vals+ii[i],INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(cols,vals);CHKERRQ(ierr);
+  ierr = PetscFree3(ourlens,offlens,ii);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 PetscErrorCode MatLoad_MPIAIJ_Binary(Mat newMat, PetscViewer viewer)
 {
   PetscScalar    *vals,*svals;
@@ -2952,8 +3276,18 @@ PetscErrorCode MatLoad_MPIAIJ_Binary(Mat newMat, PetscViewer viewer)
   PetscInt       cend,cstart,n,*rowners;
   int            fd;
   PetscInt       bs = newMat->rmap->bs;
+#if defined(PETSC_HAVE_MPIIO)
+  PetscBool      usempiio;
+#endif
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPIIO)
+  ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+  if (usempiio) {
+    ierr = MatLoad_MPIAIJ_Binary_MPIIO(newMat,viewer);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
   ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
   ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
   ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
@@ -3978,6 +4312,74 @@ PetscErrorCode MatMPIAIJSetPreallocationCSR_MPIAIJ(Mat B,const PetscInt Ii[],con
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *mpiaij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a,*b;
+  Mat_COO        coo;
+  PetscInt       r,row,lcol,nzA,rstart,cstart,cend,nonew,*oi,*oj,*ii,*jj,*slot;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  nonew = mpiaij->A ? ((Mat_SeqAIJ*)mpiaij->A->data)->nonew : 0;
+  ierr  = MatCOODestroy_Private(&mpiaij->coo);CHKERRQ(ierr);
+  ierr  = MatCOOCreate_Private(mat,n,coo_i,coo_j,&coo,&oi,&oj);CHKERRQ(ierr);
+  ierr  = MatCOOBuildCSR_Private(mat,coo,1,oi,oj,&ii,&jj);CHKERRQ(ierr);
+  ierr  = MatMPIAIJSetPreallocationCSR_MPIAIJ(mat,ii,jj,NULL);CHKERRQ(ierr);
+  /* the CSR preallocation leaves new nonzeros as errors in the new diagonal and off-diagonal blocks, keep the user's setting instead */
+  ((Mat_SeqAIJ*)mpiaij->A->data)->nonew = ((Mat_SeqAIJ*)mpiaij->B->data)->nonew = nonew;
+  ierr = PetscFree(ii);CHKERRQ(ierr);
+  ierr = PetscFree(jj);CHKERRQ(ierr);
+
+  /* locate each entry in the assembled diagonal or off-diagonal block, the latter has compacted columns given by garray[] */
+  a      = (Mat_SeqAIJ*)mpiaij->A->data;
+  b      = (Mat_SeqAIJ*)mpiaij->B->data;
+  nzA    = a->i[mat->rmap->n];
+  rstart = mat->rmap->rstart;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+  ierr   = PetscMalloc1(coo->nown,&slot);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) {
+    if (oi[r] < 0 || oj[r] < 0) {slot[r] = -1; continue;}
+    row = oi[r] - rstart;
+    if (cstart <= oj[r] && oj[r] < cend) {
+      ierr     = PetscFindInt(oj[r]-cstart,a->i[row+1]-a->i[row],a->j+a->i[row],&slot[r]);CHKERRQ(ierr);
+      slot[r] += a->i[row];
+    } else {
+      ierr     = PetscFindInt(oj[r],mpiaij->B->cmap->n,mpiaij->garray,&lcol);CHKERRQ(ierr);
+      ierr     = PetscFindInt(lcol,b->i[row+1]-b->i[row],b->j+b->i[row],&slot[r]);CHKERRQ(ierr);
+      slot[r] += nzA + b->i[row];
+    }
+  }
+  ierr = MatCOOSetSlots_Private(coo,nzA+b->i[mat->rmap->n],slot);CHKERRQ(ierr);
+  ierr = PetscFree(slot);CHKERRQ(ierr);
+  ierr = PetscFree2(oi,oj);CHKERRQ(ierr);
+  mpiaij->coo = coo;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIAIJ        *mpiaij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)mpiaij->A->data,*b = (Mat_SeqAIJ*)mpiaij->B->data;
+  Mat_COO           coo = mpiaij->coo;
+  const PetscScalar *vals;
+  PetscInt          nzA;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!coo) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  ierr = MatCOOGetValues_Private(coo,v,&vals);CHKERRQ(ierr);
+  nzA  = a->i[mat->rmap->n];
+  MatCOOScatter_Private(coo,0,nzA,vals,a->a,imode);
+  MatCOOScatter_Private(coo,nzA,coo->nslots-nzA,vals,b->a,imode);
+  ierr = PetscLogFlops(coo->jmap[coo->nslots]);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(mpiaij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)mpiaij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)mpiaij->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMPIAIJSetPreallocationCSR - Allocates memory for a sparse parallel matrix in AIJ format
    (the default parallel PETSc format).
@@ -5876,6 +6278,9 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+#if defined(PETSC_HAVE_OPENMP)
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJOMP(Mat,MatType,MatReuse,Mat*);
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -6013,15 +6418,22 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   b->spptr = NULL;
 
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetUseScalableIncreaseOverlap_C",MatMPIAIJSetUseScalableIncreaseOverlap_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetMultSplit_C",MatMPIAIJSetMultSplit_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",MatStoreValues_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsTranspose_C",MatIsTranspose_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetSOROrdering_C",MatSetSOROrdering_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocationCSR_C",MatMPIAIJSetPreallocationCSR_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijomp_C",MatConvert_MPIAIJ_MPIAIJOMP);CHKERRQ(ierr);
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
@@ -31,6 +31,9 @@ typedef struct { /* used by MatPtAP_MPIAIJ_MPIAIJ() and MatMatMult_MPIAIJ_MPIAIJ
   PetscInt                algType;                 /* implementation algorithm */
   PetscSF                 sf;                      /* use it to communicate remote part of C */
   PetscInt                *c_othi,*c_rmti;
+  PetscInt                *c_othj,*c_rmtj;          /* used by the blocked algorithm: column indices of the received and remote parts of C */
+  PetscInt                *rowperm,nrowperm,nrmtrows; /* used by the blocked algorithm: rows of A with entries of P, those contributing to remote rows of C first */
+  PetscInt                blocksize;               /* used by the blocked algorithm: number of products of A and P accumulated at once */
 
   Mat_Merge_SeqsToMPI *merge;
   PetscErrorCode (*destroy)(Mat);
@@ -79,6 +82,15 @@ typedef struct {
   /* used by MatMatMatMult() */
   Mat_MatMatMatMult *matmatmatmult;
 
+  /* used by MatMult() and MatMultAdd() when the local rows are split into interior and boundary rows */
+  PetscBool        multsplit;            /* set by MatMPIAIJSetMultSplit() */
+  PetscInt         ninterior;            /* number of local rows with no entries in B, -1 if the split is not usable */
+  PetscInt         *splitrows;           /* the interior rows followed by the boundary rows */
+  PetscObjectState splitstate;           /* nonzero state of B when splitrows was computed */
+
+  /* used by MatSetValuesCOO(), storage locations of A precede those of B */
+  Mat_COO coo;
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -128,9 +140,11 @@ PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_scalable(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat,Mat,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_blocked(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_scalable(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_blocked(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat);
 PETSC_INTERN PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_BC(Mat);
 
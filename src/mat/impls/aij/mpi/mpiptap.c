@@ -42,6 +42,8 @@ PetscErrorCode MatView_MPIAIJ_PtAP(Mat A,PetscViewer viewer)
         ierr = PetscViewerASCIIPrintf(viewer,"using allatonce MatPtAP() implementation\n");CHKERRQ(ierr);
       } else if (ptap->algType == 3) {
         ierr = PetscViewerASCIIPrintf(viewer,"using merged allatonce MatPtAP() implementation\n");CHKERRQ(ierr);
+      } else if (ptap->algType == 4) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using blocked MatPtAP() implementation\n");CHKERRQ(ierr);
       }
     }
   }
@@ -103,6 +105,9 @@ PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat A)
   ierr = PetscSFDestroy(&ptap->sf);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_othi);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_rmti);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_othj);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_rmtj);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->rowperm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -125,11 +130,11 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
   PetscBool      flg;
   MPI_Comm       comm;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char          *algTypes[4] = {"scalable","nonscalable","allatonce","allatonce_merged"};
-  PetscInt            nalg=4;
-#else
-  const char          *algTypes[5] = {"scalable","nonscalable","allatonce","allatonce_merged","hypre"};
+  const char          *algTypes[5] = {"scalable","nonscalable","allatonce","allatonce_merged","blocked"};
   PetscInt            nalg=5;
+#else
+  const char          *algTypes[6] = {"scalable","nonscalable","allatonce","allatonce_merged","blocked","hypre"};
+  PetscInt            nalg=6;
 #endif
   PetscInt            pN=P->cmap->N,alg=1; /* set default algorithm */
 
@@ -181,8 +186,14 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       ierr = MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(A,P,fill,C);CHKERRQ(ierr);
       ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
       break;
-#if defined(PETSC_HAVE_HYPRE)
     case 4:
+      /* compute C=P^T*A*P by blocks of rows of A, with bounded intermediate memory */
+      ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      ierr = MatPtAPSymbolic_MPIAIJ_MPIAIJ_blocked(A,P,fill,C);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      break;
+#if defined(PETSC_HAVE_HYPRE)
+    case 5:
       /* Use boomerAMGBuildCoarseOperator */
       ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
       ierr = MatPtAPSymbolic_AIJ_AIJ_wHYPRE(A,P,fill,C);CHKERRQ(ierr);
@@ -197,7 +208,7 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       break;
     }
 
-    if (alg == 0 || alg == 1 || alg == 2 || alg == 3) {
+    if (alg == 0 || alg == 1 || alg == 2 || alg == 3 || alg == 4) {
       Mat_MPIAIJ *c  = (Mat_MPIAIJ*)(*C)->data;
       Mat_APMPI  *ap = c->ap;
       ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)(*C)),((PetscObject)(*C))->prefix,"MatFreeIntermediateDataStructures","Mat");CHKERRQ(ierr);
@@ -1698,6 +1709,416 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,PetscR
   PetscFunctionReturn(0);
 }
 
+/*
+   Blocked C = P^T*A*P: hash-free and with a bounded amount of intermediate data
+
+   The local rows of A are processed in blocks whose products A(i,:)*P(:,:) fit in ptap->blocksize entries. The products of
+   each row are sorted and summed in the block buffer, which is all that is ever held of AP. Row i of AP is then added to the
+   rows of C given by the nonzeros of P(i,:): to C directly for the local rows and to the sorted remote rows C_rmt otherwise.
+   The rows of A contributing to C_rmt are processed first so that C_rmt is sent to its owners while the other rows are
+   processed.
+
+   The symbolic phase collects the (row,column) pairs of C in a buffer of -matptap_blocked_memory megabytes and merges it into
+   the sorted structure of C each time it is full, so it needs the structure of C and this buffer only.
+*/
+
+/* Number of products of row i of A with the rows of P */
+PETSC_STATIC_INLINE PetscInt MatPtAPBlockedRowWork_private(Mat A,Mat P,Mat P_oth,const PetscInt *map,PetscInt i)
+{
+  Mat_MPIAIJ *a=(Mat_MPIAIJ*)A->data,*p=(Mat_MPIAIJ*)P->data;
+  Mat_SeqAIJ *ad=(Mat_SeqAIJ*)(a->A)->data,*ao=(Mat_SeqAIJ*)(a->B)->data,*p_oth=(Mat_SeqAIJ*)P_oth->data,*pd=(Mat_SeqAIJ*)p->A->data,*po=(Mat_SeqAIJ*)p->B->data;
+  PetscInt   j,row,nw = 0;
+
+  for (j=ad->i[i]; j<ad->i[i+1]; j++) {
+    row = ad->j[j];
+    nw += pd->i[row+1] - pd->i[row] + po->i[row+1] - po->i[row];
+  }
+  for (j=ao->i[i]; j<ao->i[i+1]; j++) {
+    row = map[ao->j[j]];
+    nw += p_oth->i[row+1] - p_oth->i[row];
+  }
+  return nw;
+}
+
+/* Row i of AP in apj[0:n] with sorted global column indices, and its values in apa[] if apa is not NULL */
+static PetscErrorCode MatPtAPBlockedRowOfAP_private(Mat A,Mat P,Mat P_oth,const PetscInt *map,PetscInt i,PetscInt *n,PetscInt *apj,PetscScalar *apa)
+{
+  Mat_MPIAIJ     *a=(Mat_MPIAIJ*)A->data,*p=(Mat_MPIAIJ*)P->data;
+  Mat_SeqAIJ     *ad=(Mat_SeqAIJ*)(a->A)->data,*ao=(Mat_SeqAIJ*)(a->B)->data,*p_oth=(Mat_SeqAIJ*)P_oth->data,*pd=(Mat_SeqAIJ*)p->A->data,*po=(Mat_SeqAIJ*)p->B->data;
+  PetscInt       j,k,row,nw = 0,pcstart = P->cmap->rstart;
+  PetscScalar    ra = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (j=ad->i[i]; j<ad->i[i+1]; j++) {
+    row = ad->j[j];
+    if (apa) ra = ad->a[j];
+    for (k=pd->i[row]; k<pd->i[row+1]; k++, nw++) {
+      apj[nw] = pd->j[k] + pcstart;
+      if (apa) apa[nw] = ra*pd->a[k];
+    }
+    for (k=po->i[row]; k<po->i[row+1]; k++, nw++) {
+      apj[nw] = p->garray[po->j[k]];
+      if (apa) apa[nw] = ra*po->a[k];
+    }
+  }
+  for (j=ao->i[i]; j<ao->i[i+1]; j++) {
+    row = map[ao->j[j]];
+    if (apa) ra = ao->a[j];
+    for (k=p_oth->i[row]; k<p_oth->i[row+1]; k++, nw++) {
+      apj[nw] = p_oth->j[k];
+      if (apa) apa[nw] = ra*p_oth->a[k];
+    }
+  }
+  if (!apa) {
+    ierr = PetscSortRemoveDupsInt(&nw,apj);CHKERRQ(ierr);
+  } else {
+    /* sum the products with the same column */
+    ierr = PetscSortIntWithScalarArray(nw,apj,apa);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*nw);CHKERRQ(ierr);
+    for (j=0, k=0; j<nw; j++) {
+      if (k && apj[k-1] == apj[j]) apa[k-1] += apa[j];
+      else {
+        apj[k] = apj[j];
+        apa[k] = apa[j];
+        k++;
+      }
+    }
+    nw = k;
+  }
+  *n = nw;
+  PetscFunctionReturn(0);
+}
+
+/* Gathers the rows rowperm[s:*e] of AP, as many as fit in the block buffer, in apj[bstart[k]:bstart[k]+blen[k]] (and apa[]) */
+static PetscErrorCode MatPtAPBlockedBlockOfAP_private(Mat A,Mat P,Mat P_oth,const PetscInt *map,const PetscInt *rowperm,PetscInt bs,PetscInt s,PetscInt end,PetscInt *e,PetscInt *bstart,PetscInt *blen,PetscInt *apj,PetscScalar *apa)
+{
+  PetscInt       k,nw = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; s+k<end && k<bs; k++) {
+    if (nw + MatPtAPBlockedRowWork_private(A,P,P_oth,map,rowperm[s+k]) > bs) break;
+    bstart[k] = nw;
+    ierr = MatPtAPBlockedRowOfAP_private(A,P,P_oth,map,rowperm[s+k],&blen[k],apj+nw,apa ? apa+nw : NULL);CHKERRQ(ierr);
+    nw  += blen[k];
+  }
+  *e = s + k;
+  PetscFunctionReturn(0);
+}
+
+/* Merges the (row,column) pairs sprow[]/spcol[] into the sorted structure ci[]/cj[] of nrows rows */
+static PetscErrorCode MatPtAPBlockedMergeStructure_private(PetscInt nrows,PetscInt nsp,const PetscInt *sprow,const PetscInt *spcol,PetscInt **ci,PetscInt **cj)
+{
+  PetscInt       *oi = *ci,*oj = *cj,*ni,*nj,*pos,i,k,n,nz;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(nrows+1,&ni);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nrows,&pos);CHKERRQ(ierr);
+  for (i=0; i<nrows; i++) pos[i] = oi[i+1] - oi[i];
+  for (k=0; k<nsp; k++) pos[sprow[k]]++;
+  ni[0] = 0;
+  for (i=0; i<nrows; i++) ni[i+1] = ni[i] + pos[i];
+  ierr = PetscMalloc1(ni[nrows],&nj);CHKERRQ(ierr);
+  for (i=0; i<nrows; i++) {
+    ierr   = PetscArraycpy(nj+ni[i],oj+oi[i],oi[i+1]-oi[i]);CHKERRQ(ierr);
+    pos[i] = ni[i] + oi[i+1] - oi[i];
+  }
+  for (k=0; k<nsp; k++) nj[pos[sprow[k]]++] = spcol[k];
+  ierr = PetscFree(pos);CHKERRQ(ierr);
+  ierr = PetscFree(oi);CHKERRQ(ierr);
+  ierr = PetscFree(oj);CHKERRQ(ierr);
+
+  /* sort the rows and remove the duplicates, compressing in place */
+  for (i=0, nz=0; i<nrows; i++) {
+    n     = ni[i+1] - ni[i];
+    ierr  = PetscSortRemoveDupsInt(&n,nj+ni[i]);CHKERRQ(ierr);
+    ierr  = PetscArraymove(nj+nz,nj+ni[i],n);CHKERRQ(ierr);
+    ni[i] = nz;
+    nz   += n;
+  }
+  ni[nrows] = nz;
+  *ci = ni;
+  *cj = nj;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_blocked(Mat A,Mat P,PetscReal fill,Mat *C)
+{
+  Mat_APMPI      *ptap;
+  Mat_MPIAIJ     *p=(Mat_MPIAIJ*)P->data,*c;
+  Mat_SeqAIJ     *pd=(Mat_SeqAIJ*)p->A->data,*po=(Mat_SeqAIJ*)p->B->data;
+  MPI_Comm       comm;
+  Mat            Cmpi;
+  MatType        mtype;
+  PetscSF        sf;
+  PetscSFNode    *iremote;
+  IS             map;
+  const PetscInt *mappingindices,*rootdegrees;
+  PetscInt       am,pn,pon,pcstart,pcend,i,j,k,l,r,s,e,n,bs,*bstart,*blen,*apj,*ci,*cj,nsp,spmax,*sprow,*spcol;
+  PetscInt       *c_rmtc,*c_rmtoffsets,*rootspace,*rootoffsets,rootspacesize,nleaves,owner,lidx,*cols,ncols,maxc,*dnz,*onz;
+  PetscReal      mem = 64.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(A,&am,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
+
+  ierr            = PetscNew(&ptap);CHKERRQ(ierr);
+  ptap->reuse     = MAT_INITIAL_MATRIX;
+  ptap->algType   = 4;
+  ptap->blocksize = 8192;
+  ierr = PetscOptionsBegin(comm,((PetscObject)A)->prefix,"MatPtAP","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-matptap_blocked_block_size","Number of products of A and P accumulated at once","MatPtAP",ptap->blocksize,&ptap->blocksize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-matptap_blocked_memory","Megabytes of the buffer used to build the structure of C","MatPtAP",mem,&mem,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  /* Get P_oth by taking rows of P (= non-zero cols of local A) from other processors */
+  ierr = MatGetBrowsOfAcols_MPIXAIJ(A,P,1,MAT_INITIAL_MATRIX,&ptap->P_oth);CHKERRQ(ierr);
+  ierr = PetscObjectQuery((PetscObject)ptap->P_oth,"aoffdiagtopothmapping",(PetscObject*)&map);CHKERRQ(ierr);
+  ierr = ISGetIndices(map,&mappingindices);CHKERRQ(ierr);
+
+  /* Rows of A contributing to remote rows of C, then those contributing to local rows only. The block holds at least one row */
+  ierr = PetscMalloc1(am,&ptap->rowperm);CHKERRQ(ierr);
+  for (i=0, k=0; i<am; i++) if (po->i[i+1] > po->i[i]) ptap->rowperm[k++] = i;
+  ptap->nrmtrows = k;
+  for (i=0; i<am; i++) if (po->i[i+1] == po->i[i] && pd->i[i+1] > pd->i[i]) ptap->rowperm[k++] = i;
+  ptap->nrowperm = k;
+  for (k=0; k<ptap->nrowperm; k++) ptap->blocksize = PetscMax(ptap->blocksize,MatPtAPBlockedRowWork_private(A,P,ptap->P_oth,mappingindices,ptap->rowperm[k]));
+  bs    = ptap->blocksize;
+  spmax = PetscMax((PetscInt)(mem*1048576.0/(2*sizeof(PetscInt))),bs);
+  ierr  = PetscInfo3(A,"Blocks of %D products, %D rows of %D contribute to remote rows\n",bs,ptap->nrmtrows,am);CHKERRQ(ierr);
+
+  /* Structure of the local rows of C followed by the remote rows, built from the pairs of each block */
+  ierr = PetscMalloc3(bs,&apj,bs,&bstart,bs,&blen);CHKERRQ(ierr);
+  ierr = PetscMalloc2(spmax,&sprow,spmax,&spcol);CHKERRQ(ierr);
+  ierr = PetscCalloc1(pn+pon+1,&ci);CHKERRQ(ierr);
+  cj   = NULL;
+  nsp  = 0;
+  for (s=0; s<ptap->nrowperm; s=e) {
+    ierr = MatPtAPBlockedBlockOfAP_private(A,P,ptap->P_oth,mappingindices,ptap->rowperm,bs,s,ptap->nrowperm,&e,bstart,blen,apj,NULL);CHKERRQ(ierr);
+    for (k=0; k<e-s; k++) {
+      i = ptap->rowperm[s+k];
+      n = blen[k];
+      for (j=pd->i[i]; j<pd->i[i+1]+po->i[i+1]-po->i[i]; j++) {
+        r = j < pd->i[i+1] ? pd->j[j] : pn + po->j[po->i[i]+j-pd->i[i+1]];
+        if (nsp + n > spmax) {
+          ierr = MatPtAPBlockedMergeStructure_private(pn+pon,nsp,sprow,spcol,&ci,&cj);CHKERRQ(ierr);
+          nsp  = 0;
+        }
+        for (l=0; l<n; l++, nsp++) {
+          sprow[nsp] = r;
+          spcol[nsp] = apj[bstart[k]+l];
+        }
+      }
+    }
+  }
+  ierr = MatPtAPBlockedMergeStructure_private(pn+pon,nsp,sprow,spcol,&ci,&cj);CHKERRQ(ierr);
+  ierr = PetscFree2(sprow,spcol);CHKERRQ(ierr);
+  ierr = PetscFree3(apj,bstart,blen);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(map,&mappingindices);CHKERRQ(ierr);
+
+  /* Keep the remote rows */
+  ierr = PetscMalloc1(pon+1,&ptap->c_rmti);CHKERRQ(ierr);
+  ierr = PetscMalloc1(pon,&c_rmtc);CHKERRQ(ierr);
+  for (i=0; i<=pon; i++) ptap->c_rmti[i] = ci[pn+i] - ci[pn];
+  for (i=0; i<pon; i++) c_rmtc[i] = ptap->c_rmti[i+1] - ptap->c_rmti[i];
+  ierr = PetscMalloc1(ptap->c_rmti[pon],&ptap->c_rmtj);CHKERRQ(ierr);
+  ierr = PetscArraycpy(ptap->c_rmtj,cj+ci[pn],ptap->c_rmti[pon]);CHKERRQ(ierr);
+
+  /* The owners of the remote rows learn how many columns each contribution has, and where each one goes */
+  ierr = PetscMalloc1(pon,&iremote);CHKERRQ(ierr);
+  for (i=0; i<pon; i++) {
+    ierr = PetscLayoutFindOwnerIndex(P->cmap,p->garray[i],&owner,&lidx);CHKERRQ(ierr);
+    iremote[i].index = lidx;
+    iremote[i].rank  = owner;
+  }
+  ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,pn,pon,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  /* Reorder ranks properly so that the data handled by gather and scatter have the same order */
+  ierr = PetscSFSetRankOrder(sf,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeBegin(sf,&rootdegrees);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(sf,&rootdegrees);CHKERRQ(ierr);
+  for (i=0, rootspacesize=0; i<pn; i++) rootspacesize += rootdegrees[i];
+  ierr = PetscMalloc2(rootspacesize,&rootspace,rootspacesize+1,&rootoffsets);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(sf,MPIU_INT,c_rmtc,rootspace);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(sf,MPIU_INT,c_rmtc,rootspace);CHKERRQ(ierr);
+  ierr = PetscMalloc1(pn+1,&ptap->c_othi);CHKERRQ(ierr);
+  ptap->c_othi[0] = 0;
+  rootoffsets[0]  = 0;
+  for (i=0, k=0; i<pn; i++) {
+    ptap->c_othi[i+1] = ptap->c_othi[i];
+    for (j=0; j<rootdegrees[i]; j++, k++) {
+      ptap->c_othi[i+1] += rootspace[k];
+      rootoffsets[k+1]   = rootoffsets[k] + rootspace[k];
+    }
+  }
+  ierr = PetscMalloc1(pon,&c_rmtoffsets);CHKERRQ(ierr);
+  ierr = PetscSFScatterBegin(sf,MPIU_INT,rootoffsets,c_rmtoffsets);CHKERRQ(ierr);
+  ierr = PetscSFScatterEnd(sf,MPIU_INT,rootoffsets,c_rmtoffsets);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFree2(rootspace,rootoffsets);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(ptap->c_rmti[pon],&iremote);CHKERRQ(ierr);
+  for (i=0, nleaves=0; i<pon; i++) {
+    ierr = PetscLayoutFindOwnerIndex(P->cmap,p->garray[i],&owner,NULL);CHKERRQ(ierr);
+    for (j=0; j<c_rmtc[i]; j++, nleaves++) {
+      iremote[nleaves].rank  = owner;
+      iremote[nleaves].index = c_rmtoffsets[i] + j;
+    }
+  }
+  ierr = PetscFree(c_rmtoffsets);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmtc);CHKERRQ(ierr);
+  ierr = PetscSFCreate(comm,&ptap->sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(ptap->sf,ptap->c_othi[pn],nleaves,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(ptap->sf);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&ptap->c_othj);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,ptap->c_rmtj,ptap->c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,ptap->c_rmtj,ptap->c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+
+  /* Preallocation of the local rows of C with the contributions received */
+  for (i=0, maxc=0; i<pn; i++) maxc = PetscMax(maxc,ci[i+1]-ci[i]+ptap->c_othi[i+1]-ptap->c_othi[i]);
+  ierr = PetscMalloc3(maxc,&cols,pn,&dnz,pn,&onz);CHKERRQ(ierr);
+  for (i=0; i<pn; i++) {
+    ncols = ci[i+1] - ci[i];
+    ierr  = PetscArraycpy(cols,cj+ci[i],ncols);CHKERRQ(ierr);
+    ierr  = PetscArraycpy(cols+ncols,ptap->c_othj+ptap->c_othi[i],ptap->c_othi[i+1]-ptap->c_othi[i]);CHKERRQ(ierr);
+    ncols += ptap->c_othi[i+1] - ptap->c_othi[i];
+    ierr  = PetscSortRemoveDupsInt(&ncols,cols);CHKERRQ(ierr);
+    dnz[i] = onz[i] = 0;
+    for (j=0; j<ncols; j++) {
+      if (cols[j] >= pcstart && cols[j] < pcend) dnz[i]++;
+      else onz[i]++;
+    }
+  }
+  ierr = PetscFree(ci);CHKERRQ(ierr);
+  ierr = PetscFree(cj);CHKERRQ(ierr);
+
+  ierr = MatCreate(comm,&Cmpi);CHKERRQ(ierr);
+  ierr = MatGetType(A,&mtype);CHKERRQ(ierr);
+  ierr = MatSetType(Cmpi,mtype);CHKERRQ(ierr);
+  ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = MatSetBlockSizes(Cmpi,P->cmap->bs,P->cmap->bs);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(Cmpi,0,dnz,0,onz);CHKERRQ(ierr);
+  ierr = MatSetUp(Cmpi);CHKERRQ(ierr);
+  ierr = PetscFree3(cols,dnz,onz);CHKERRQ(ierr);
+
+  /* attach the supporting struct to Cmpi for reuse */
+  c = (Mat_MPIAIJ*)Cmpi->data;
+  c->ap           = ptap;
+  ptap->duplicate = Cmpi->ops->duplicate;
+  ptap->destroy   = Cmpi->ops->destroy;
+  ptap->view      = Cmpi->ops->view;
+
+  /* Cmpi is not ready for use - assembly will be done by MatPtAPNumeric() */
+  Cmpi->assembled        = PETSC_FALSE;
+  Cmpi->ops->ptapnumeric = MatPtAPNumeric_MPIAIJ_MPIAIJ_blocked;
+  Cmpi->ops->destroy     = MatDestroy_MPIAIJ_PtAP;
+  Cmpi->ops->view        = MatView_MPIAIJ_PtAP;
+  Cmpi->ops->freeintermediatedatastructures = MatFreeIntermediateDataStructures_MPIAIJ_AP;
+  *C                     = Cmpi;
+  PetscFunctionReturn(0);
+}
+
+/* Adds the rows rowperm[start:end] of A times P to the local rows of C and to the remote rows c_rmta[] */
+static PetscErrorCode MatPtAPNumericBlockedRows_private(Mat A,Mat P,Mat C,const PetscInt *map,PetscInt start,PetscInt end,PetscScalar *c_rmta)
+{
+  Mat_MPIAIJ     *p=(Mat_MPIAIJ*)P->data,*c=(Mat_MPIAIJ*)C->data;
+  Mat_SeqAIJ     *pd=(Mat_SeqAIJ*)p->A->data,*po=(Mat_SeqAIJ*)p->B->data;
+  Mat_APMPI      *ptap = c->ap;
+  PetscInt       i,j,k,l,m,s,e,n,row,bs = ptap->blocksize,pcstart = P->cmap->rstart,*apj,*bstart,*blen,*rj;
+  PetscScalar    *apa,*vals,*ra,pv;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc5(bs,&apj,bs,&apa,bs,&vals,bs,&bstart,bs,&blen);CHKERRQ(ierr);
+  for (s=start; s<end; s=e) {
+    ierr = MatPtAPBlockedBlockOfAP_private(A,P,ptap->P_oth,map,ptap->rowperm,bs,s,end,&e,bstart,blen,apj,apa);CHKERRQ(ierr);
+    for (k=0; k<e-s; k++) {
+      i = ptap->rowperm[s+k];
+      n = blen[k];
+      /* C(row,:) += P(i,row)*AP(i,:) for the local rows */
+      for (j=pd->i[i]; j<pd->i[i+1]; j++) {
+        row = pd->j[j] + pcstart;
+        pv  = pd->a[j];
+        for (l=0; l<n; l++) vals[l] = pv*apa[bstart[k]+l];
+        ierr = MatSetValues(C,1,&row,n,apj+bstart[k],vals,ADD_VALUES);CHKERRQ(ierr);
+      }
+      /* and the remote rows, whose sorted columns include those of AP(i,:) */
+      for (j=po->i[i]; j<po->i[i+1]; j++) {
+        rj = ptap->c_rmtj + ptap->c_rmti[po->j[j]];
+        ra = c_rmta + ptap->c_rmti[po->j[j]];
+        pv = po->a[j];
+        for (l=0, m=0; l<n; l++) {
+          while (rj[m] < apj[bstart[k]+l]) m++;
+          ra[m] += pv*apa[bstart[k]+l];
+        }
+      }
+      ierr = PetscLogFlops(2.0*n*(pd->i[i+1]-pd->i[i]+po->i[i+1]-po->i[i]));CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree5(apj,apa,vals,bstart,blen);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_blocked(Mat A,Mat P,Mat C)
+{
+  Mat_MPIAIJ     *p=(Mat_MPIAIJ*)P->data,*c=(Mat_MPIAIJ*)C->data;
+  Mat_APMPI      *ptap = c->ap;
+  IS             map;
+  const PetscInt *mappingindices;
+  PetscInt       i,row,pn,pon;
+  PetscScalar    *c_rmta,*c_otha;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptap->P_oth) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONGSTATE,"PtAP cannot be reused. Do not call MatFreeIntermediateDataStructures() or use '-mat_freeintermediatedatastructures'");
+
+  ierr = MatZeroEntries(C);CHKERRQ(ierr);
+  if (ptap->reuse == MAT_REUSE_MATRIX) {
+    /* P_oth is obtained in MatPtAPSymbolic() when reuse == MAT_INITIAL_MATRIX */
+    ierr = MatGetBrowsOfAcols_MPIXAIJ(A,P,1,MAT_REUSE_MATRIX,&ptap->P_oth);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectQuery((PetscObject)ptap->P_oth,"aoffdiagtopothmapping",(PetscObject*)&map);CHKERRQ(ierr);
+  ierr = ISGetIndices(map,&mappingindices);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
+  ierr = PetscCalloc1(ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
+
+  /* remote rows first, sent while the other rows are computed */
+  ierr = MatPtAPNumericBlockedRows_private(A,P,C,mappingindices,0,ptap->nrmtrows,c_rmta);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = MatPtAPNumericBlockedRows_private(A,P,C,mappingindices,ptap->nrmtrows,ptap->nrowperm,c_rmta);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(map,&mappingindices);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmta);CHKERRQ(ierr);
+
+  /* Add contributions from remote */
+  for (i=0; i<pn; i++) {
+    row  = i + P->cmap->rstart;
+    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],ptap->c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(c_otha);CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ptap->reuse = MAT_REUSE_MATRIX;
+
+  /* supporting struct ptap consumes almost same amount of memory as C=PtAP, release it if C will not be updated by A and P */
+  if (ptap->freestruct) {
+    ierr = MatFreeIntermediateDataStructures(C);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ(Mat A,Mat P,PetscReal fill,Mat *C)
 {
   PetscErrorCode      ierr;
@@ -82,6 +82,36 @@ typedef struct {
   matrix elements are stored with the rest of the nonzeros (not separately).
 */
 
+/* Rows grouped by color in slices of MAT_SEQAIJ_MC_SLICE rows, used by MatSOR() with MAT_SOR_ORDERING_MULTICOLOR */
+#define MAT_SEQAIJ_MC_SLICE 8
+typedef struct {
+  PetscInt         ncolors;
+  PetscInt         nslices;
+  PetscInt         *cslice;                        /* the slices of color c are cslice[c] <= s < cslice[c+1] */
+  PetscInt         *sliidx;                        /* start of slice s in colidx[] and val[] */
+  PetscInt         *rows;                          /* rows of the slices, -1 for padding */
+  PetscInt         *colidx;                        /* column indices of the off-diagonal entries, slice by slice */
+  MatScalar        *val;                           /* off-diagonal values, stored column by column in each slice */
+  MatScalar        *idiag;                         /* omega/(diagonal + fshift) for each entry of rows[] */
+  PetscBool        valuesvalid;
+  PetscReal        omega,fshift;                   /* values used for idiag[] */
+  PetscObjectState state;                          /* state of the matrix when val[] and idiag[] were set */
+  PetscObjectState nonzerostate;                   /* nonzero state of the matrix when the coloring was computed */
+} Mat_SeqAIJ_Multicolor;
+
+/* Level sets of the triangular factors of a factored matrix, used by the threaded MatSolve() */
+typedef struct {
+  PetscBool   use;                                 /* use the level scheduled solve */
+  PetscInt    nlevels[2];                          /* number of levels of the forward and the backward solves */
+  PetscInt    *lptr,*lrows;                        /* rows of level l of the forward solve are lrows[lptr[l]] to lrows[lptr[l+1]-1] */
+  PetscInt    *uptr,*urows;                        /* same for the backward solve */
+  PetscInt    *ti,*tj,*tmap;                       /* structure of U^T and location of its entries in the factor, Cholesky only */
+  PetscScalar *work;                               /* Cholesky only */
+} Mat_SeqAIJ_Levels;
+
+PETSC_INTERN PetscErrorCode MatSeqAIJLevelsDestroy_Private(Mat_SeqAIJ_Levels**);
+PETSC_INTERN PetscErrorCode MatSeqAIJFactorSetUpLevels_Private(Mat);
+
 /* Info about i-nodes (identical nodes) helper class for SeqAIJ */
 typedef struct {
   MatScalar        *bdiag,*ibdiag,*ssor_work;        /* diagonal blocks of matrix used for MatSOR_SeqAIJ_Inode() */
@@ -127,6 +157,10 @@ typedef struct {
   Mat_RARt            *rart;               /* used by MatRARt() */
   Mat_MatMatTransMult *abt;                /* used by MatMatTransposeMult() */
   Mat_MatTransMatMult *atb;                /* used by MatTransposeMatMult() */
+
+  Mat_COO             coo;                 /* used by MatSetValuesCOO() */
+  Mat_SeqAIJ_Multicolor *mcsor;           /* used by MatSOR() with MAT_SOR_ORDERING_MULTICOLOR */
+  Mat_SeqAIJ_Levels   *levels;             /* used by MatSolve() of factored matrices */
 } Mat_SeqAIJ;
 
 /*
@@ -235,6 +269,9 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat A,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Multicolor(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSetSOROrdering_SeqAIJ(Mat,MatSOROrdering);
+PETSC_INTERN PetscErrorCode MatSeqAIJMulticolorDestroy_Private(Mat);
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat,MatOption,PetscBool);
 
@@ -271,6 +308,8 @@ PETSC_INTERN PetscErrorCode MatFDColoringSetUp_SeqXAIJ(Mat,ISColoring,MatFDColor
 PETSC_INTERN PetscErrorCode MatFDColoringSetUpBlocked_AIJ_Private(Mat,MatFDColoring,PetscInt);
 PETSC_INTERN PetscErrorCode MatLoad_AIJ_HDF5(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatLoad_SeqAIJ_Binary(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatLoad_SeqAIJ_Binary_Native(Mat,PetscViewer,PetscInt,PetscInt);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Binary_Native(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatLoad_SeqAIJ(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode RegisterApplyPtAPRoutines_Private(Mat);
 
@@ -345,6 +384,8 @@ PETSC_INTERN PetscErrorCode MatSetUp_SeqAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatView_SeqAIJ(Mat,PetscViewer);
 
 PETSC_INTERN PetscErrorCode MatSeqAIJInvalidateDiagonal(Mat);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat,const PetscScalar[],InsertMode);
 PETSC_INTERN PetscErrorCode MatSeqAIJInvalidateDiagonal_Inode(Mat);
 PETSC_INTERN PetscErrorCode MatSeqAIJCheckInode(Mat);
 PETSC_INTERN PetscErrorCode MatSeqAIJCheckInode_FactorLU(Mat);
@@ -364,6 +405,7 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_Elemental(Mat,MatType,MatReuse,Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat,PetscReal,IS,IS);
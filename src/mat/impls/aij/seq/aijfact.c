@@ -372,6 +372,7 @@ PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B,Mat A,IS isrow,IS iscol,const Ma
   ierr = MatSeqAIJSetPreallocation_SeqAIJ(B,MAT_SKIP_ALLOCATION,NULL);CHKERRQ(ierr);
   ierr = PetscLogObjectParent((PetscObject)B,(PetscObject)isicol);CHKERRQ(ierr);
   b    = (Mat_SeqAIJ*)(B)->data;
+  ierr = MatSeqAIJLevelsDestroy_Private(&b->levels);CHKERRQ(ierr);
 
   b->free_a       = PETSC_TRUE;
   b->free_ij      = PETSC_TRUE;
@@ -592,6 +593,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  ierr = MatSeqAIJFactorSetUpLevels_Private(C);CHKERRQ(ierr);
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -1602,6 +1604,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ilu0(Mat fact,Mat A,IS isrow,IS iscol
   ierr = ISInvertPermutation(iscol,PETSC_DECIDE,&isicol);CHKERRQ(ierr);
   ierr = MatDuplicateNoCreate_SeqAIJ(fact,A,MAT_DO_NOT_COPY_VALUES,PETSC_FALSE);CHKERRQ(ierr);
   b    = (Mat_SeqAIJ*)(fact)->data;
+  ierr = MatSeqAIJLevelsDestroy_Private(&b->levels);CHKERRQ(ierr);
 
   /* allocate matrix arrays for new data structure */
   ierr = PetscMalloc3(ai[n]+1,&b->a,ai[n]+1,&b->j,n+1,&b->i);CHKERRQ(ierr);
@@ -1807,6 +1810,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS isrow,IS iscol,cons
   ierr = MatSeqAIJSetPreallocation_SeqAIJ(fact,MAT_SKIP_ALLOCATION,NULL);CHKERRQ(ierr);
   ierr = PetscLogObjectParent((PetscObject)fact,(PetscObject)isicol);CHKERRQ(ierr);
   b    = (Mat_SeqAIJ*)(fact)->data;
+  ierr = MatSeqAIJLevelsDestroy_Private(&b->levels);CHKERRQ(ierr);
 
   b->free_a       = PETSC_TRUE;
   b->free_ij      = PETSC_TRUE;
@@ -2171,6 +2175,7 @@ PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *
     B->ops->forwardsolve   = MatForwardSolve_SeqSBAIJ_1;
     B->ops->backwardsolve  = MatBackwardSolve_SeqSBAIJ_1;
   }
+  ierr = MatSeqAIJFactorSetUpLevels_Private(B);CHKERRQ(ierr);
 
   C->assembled    = PETSC_TRUE;
   C->preallocated = PETSC_TRUE;
@@ -2517,6 +2522,7 @@ PetscErrorCode MatICCFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS perm,const MatFacto
 
   /* put together the new matrix in MATSEQSBAIJ format */
   b               = (Mat_SeqSBAIJ*)(fact)->data;
+  ierr = MatSeqAIJLevelsDestroy_Private(&b->levels);CHKERRQ(ierr);
   b->singlemalloc = PETSC_FALSE;
 
   ierr = PetscMalloc1(ui[am]+1,&b->a);CHKERRQ(ierr);
@@ -2888,6 +2894,7 @@ PetscErrorCode MatCholeskyFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS perm,const Mat
   /* put together the new matrix in MATSEQSBAIJ format */
 
   b               = (Mat_SeqSBAIJ*)fact->data;
+  ierr = MatSeqAIJLevelsDestroy_Private(&b->levels);CHKERRQ(ierr);
   b->singlemalloc = PETSC_FALSE;
   b->free_a       = PETSC_TRUE;
   b->free_ij      = PETSC_TRUE;
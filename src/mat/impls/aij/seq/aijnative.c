@@ -0,0 +1,237 @@
+
+/*
+   Native binary format for SeqAIJ matrices: MatView() with PETSC_VIEWER_BINARY_MMAP and the matching MatLoad().
+
+   The usual big-endian header is followed by the CSR arrays exactly as they are stored in memory:
+
+     header      MAT_FILE_CLASSID, M, N, MATRIX_BINARY_FORMAT_AIJ_NATIVE   (PetscInt, big-endian as all PETSc binary headers)
+     descriptor  magic, sizeof(PetscInt), sizeof(PetscScalar), nz,
+                 offsets in the file of i, j and a, offset of the end       (PetscInt64, native byte order)
+     i           M+1 PetscInt row pointers
+     j           nz PetscInt column indices
+     a           nz PetscScalar values
+
+   Each array starts at a file offset aligned to MAT_AIJ_NATIVE_ALIGN bytes, so the loader can mmap() the file and use the
+   arrays in place with -matload_mmap: nothing is read, converted or copied, and the pages are shared by all the processes
+   of the node that load the same file. The mapping is private, hence changing the values only copies the modified pages.
+   Without -matload_mmap the arrays are read, still without any conversion.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#include <errno.h>
+
+#define MAT_AIJ_NATIVE_ALIGN 64
+#define MAT_AIJ_NATIVE_MAGIC ((PetscInt64)0x0102030405060708LL)
+#define MAT_AIJ_NATIVE_CHUNK ((size_t)1 << 30) /* largest transfer passed at once to PetscBinaryRead()/PetscBinaryWrite() */
+
+PETSC_STATIC_INLINE PetscInt64 MatAIJNativeAlign(PetscInt64 off) {return (off + MAT_AIJ_NATIVE_ALIGN - 1) & ~(PetscInt64)(MAT_AIJ_NATIVE_ALIGN - 1);}
+
+static PetscErrorCode MatAIJNativeWrite_Private(int fd,const void *p,size_t bytes)
+{
+  PetscErrorCode ierr;
+  size_t         n;
+
+  PetscFunctionBegin;
+  while (bytes) {
+    n     = PetscMin(bytes,MAT_AIJ_NATIVE_CHUNK);
+    ierr  = PetscBinaryWrite(fd,(void*)p,(PetscInt)n,PETSC_CHAR,PETSC_FALSE);CHKERRQ(ierr);
+    p     = (const char*)p + n;
+    bytes -= n;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAIJNativeRead_Private(int fd,void *p,size_t bytes)
+{
+  PetscErrorCode ierr;
+  size_t         n;
+
+  PetscFunctionBegin;
+  while (bytes) {
+    n     = PetscMin(bytes,MAT_AIJ_NATIVE_CHUNK);
+    ierr  = PetscBinaryRead(fd,p,(PetscInt)n,NULL,PETSC_CHAR);CHKERRQ(ierr);
+    p     = (char*)p + n;
+    bytes -= n;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Pad the file with zeros up to the offset off */
+static PetscErrorCode MatAIJNativePad_Private(int fd,PetscInt64 *cur,PetscInt64 off)
+{
+  PetscErrorCode ierr;
+  char           zeros[MAT_AIJ_NATIVE_ALIGN];
+
+  PetscFunctionBegin;
+  if (off == *cur) PetscFunctionReturn(0);
+  ierr = PetscMemzero(zeros,sizeof(zeros));CHKERRQ(ierr);
+  ierr = MatAIJNativeWrite_Private(fd,zeros,(size_t)(off-*cur));CHKERRQ(ierr);
+  *cur = off;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_Binary_Native(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       header[4],m = A->rmap->n,nz = a->i[A->rmap->n];
+  PetscInt64     desc[8],cur;
+  off_t          off;
+  int            fd;
+  FILE           *file;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+  header[0] = MAT_FILE_CLASSID;
+  header[1] = m;
+  header[2] = A->cmap->n;
+  header[3] = MATRIX_BINARY_FORMAT_AIJ_NATIVE;
+  ierr = PetscBinaryWrite(fd,header,4,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* The offsets are absolute since the matrix may follow other objects in the file */
+  ierr    = PetscBinarySeek(fd,0,PETSC_BINARY_SEEK_CUR,&off);CHKERRQ(ierr);
+  cur     = (PetscInt64)off + sizeof(desc);
+  desc[0] = MAT_AIJ_NATIVE_MAGIC;
+  desc[1] = sizeof(PetscInt);
+  desc[2] = sizeof(PetscScalar);
+  desc[3] = nz;
+  desc[4] = MatAIJNativeAlign(cur);
+  desc[5] = MatAIJNativeAlign(desc[4] + (m+1)*(PetscInt64)sizeof(PetscInt));
+  desc[6] = MatAIJNativeAlign(desc[5] + nz*(PetscInt64)sizeof(PetscInt));
+  desc[7] = desc[6] + nz*(PetscInt64)sizeof(PetscScalar);
+  ierr = MatAIJNativeWrite_Private(fd,desc,sizeof(desc));CHKERRQ(ierr);
+
+  ierr = MatAIJNativePad_Private(fd,&cur,desc[4]);CHKERRQ(ierr);
+  ierr = MatAIJNativeWrite_Private(fd,a->i,(m+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  cur += (m+1)*(PetscInt64)sizeof(PetscInt);
+  ierr = MatAIJNativePad_Private(fd,&cur,desc[5]);CHKERRQ(ierr);
+  ierr = MatAIJNativeWrite_Private(fd,a->j,nz*sizeof(PetscInt));CHKERRQ(ierr);
+  cur += nz*(PetscInt64)sizeof(PetscInt);
+  ierr = MatAIJNativePad_Private(fd,&cur,desc[6]);CHKERRQ(ierr);
+  ierr = MatAIJNativeWrite_Private(fd,a->a,nz*sizeof(PetscScalar));CHKERRQ(ierr);
+
+  ierr = PetscViewerBinaryGetInfoPointer(viewer,&file);CHKERRQ(ierr);
+  if (file) {
+    fprintf(file,"-matload_block_size %d\n",(int)PetscAbs(A->rmap->bs));
+  }
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MMAP)
+typedef struct {
+  void   *addr;
+  size_t len;
+} MatAIJNativeMap;
+
+static PetscErrorCode MatAIJNativeUnmap_Private(void *ctx)
+{
+  MatAIJNativeMap *map = (MatAIJNativeMap*)ctx;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (munmap(map->addr,map->len)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"munmap() failed with errno %d",errno);
+  ierr = PetscFree(map);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
+/* Called by MatLoad_SeqAIJ_Binary() once it has read a header with MATRIX_BINARY_FORMAT_AIJ_NATIVE */
+PetscErrorCode MatLoad_SeqAIJ_Binary_Native(Mat newMat,PetscViewer viewer,PetscInt M,PetscInt N)
+{
+  Mat_SeqAIJ     *aij;
+  PetscErrorCode ierr;
+  PetscInt       *ai,*aj,i,nz,rows,cols;
+  PetscScalar    *aa;
+  PetscInt64     desc[8];
+  PetscBool      usemmap = PETSC_FALSE,mapped = PETSC_FALSE;
+  PetscContainer container = NULL;
+  off_t          off;
+  int            fd;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+  ierr = MatAIJNativeRead_Private(fd,desc,sizeof(desc));CHKERRQ(ierr);
+  if (desc[0] != MAT_AIJ_NATIVE_MAGIC) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Native AIJ matrix in file was written on a machine with a different byte order");
+  if (desc[1] != (PetscInt64)sizeof(PetscInt) || desc[2] != (PetscInt64)sizeof(PetscScalar)) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Native AIJ matrix in file has %d byte indices and %d byte scalars, PETSc was configured with %d and %d",(int)desc[1],(int)desc[2],(int)sizeof(PetscInt),(int)sizeof(PetscScalar));
+  nz = (PetscInt)desc[3];
+
+  if (newMat->rmap->n < 0 && newMat->rmap->N < 0 && newMat->cmap->n < 0 && newMat->cmap->N < 0) {
+    ierr = MatSetSizes(newMat,PETSC_DECIDE,PETSC_DECIDE,M,N);CHKERRQ(ierr);
+  } else {
+    ierr = MatGetSize(newMat,&rows,&cols);CHKERRQ(ierr);
+    if (rows < 0 && cols < 0) {
+      ierr = MatGetLocalSize(newMat,&rows,&cols);CHKERRQ(ierr);
+    }
+    if (M != rows ||  N != cols) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED, "Matrix in file of different length (%D, %D) than the input matrix (%D, %D)",M,N,rows,cols);
+  }
+
+  ierr = PetscOptionsGetBool(((PetscObject)newMat)->options,((PetscObject)newMat)->prefix,"-matload_mmap",&usemmap,NULL);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MMAP)
+  if (usemmap) {
+    MatAIJNativeMap *map;
+    PetscInt64      pagesize = (PetscInt64)sysconf(_SC_PAGESIZE),start = desc[4] & ~(pagesize-1);
+
+    ierr      = PetscNew(&map);CHKERRQ(ierr);
+    map->len  = (size_t)(desc[7] - start);
+    map->addr = mmap(NULL,map->len,PROT_READ | PROT_WRITE,MAP_PRIVATE,fd,(off_t)start);
+    if (map->addr == MAP_FAILED) {
+      ierr = PetscInfo1(newMat,"mmap() failed with errno %d, reading the matrix instead\n",errno);CHKERRQ(ierr);
+      ierr = PetscFree(map);CHKERRQ(ierr);
+    } else {
+      ai     = (PetscInt*)((char*)map->addr + (desc[4] - start));
+      aj     = (PetscInt*)((char*)map->addr + (desc[5] - start));
+      aa     = (PetscScalar*)((char*)map->addr + (desc[6] - start));
+      mapped = PETSC_TRUE;
+      ierr   = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+      ierr   = PetscContainerSetPointer(container,map);CHKERRQ(ierr);
+      ierr   = PetscContainerSetUserDestroy(container,MatAIJNativeUnmap_Private);CHKERRQ(ierr);
+      ierr   = PetscInfo2(newMat,"Mapped %D rows and %D nonzeros from the file\n",M,nz);CHKERRQ(ierr);
+    }
+  }
+#endif
+  if (!mapped) {
+    ierr = PetscMalloc1(M+1,&ai);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&aj);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&aa);CHKERRQ(ierr);
+    ierr = PetscBinarySeek(fd,(off_t)desc[4],PETSC_BINARY_SEEK_SET,&off);CHKERRQ(ierr);
+    ierr = MatAIJNativeRead_Private(fd,ai,(M+1)*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscBinarySeek(fd,(off_t)desc[5],PETSC_BINARY_SEEK_SET,&off);CHKERRQ(ierr);
+    ierr = MatAIJNativeRead_Private(fd,aj,nz*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscBinarySeek(fd,(off_t)desc[6],PETSC_BINARY_SEEK_SET,&off);CHKERRQ(ierr);
+    ierr = MatAIJNativeRead_Private(fd,aa,nz*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  /* Leave the file positioned after the matrix for the next object */
+  ierr = PetscBinarySeek(fd,(off_t)desc[7],PETSC_BINARY_SEEK_SET,&off);CHKERRQ(ierr);
+
+  /* Only the row pointers are checked, checking the columns would touch every page of the mapping */
+  if (ai[0] || ai[M] != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Inconsistent matrix data in file. no-nonzeros = %D, last row pointer = %D",nz,ai[M]);
+
+  /* Release the arrays of a matrix loaded into, then the mapping of a previous load, if any, and keep the new mapping as long as the matrix */
+  aij  = (Mat_SeqAIJ*)newMat->data;
+  ierr = MatSeqXAIJFreeAIJ(newMat,&aij->a,&aij->j,&aij->i);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)newMat,"MatLoad_SeqAIJ_Native_mmap",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(newMat,MAT_SKIP_ALLOCATION,0);CHKERRQ(ierr);
+  if (!aij->imax) {ierr = PetscMalloc1(M,&aij->imax);CHKERRQ(ierr);}
+  if (!aij->ilen) {ierr = PetscMalloc1(M,&aij->ilen);CHKERRQ(ierr);}
+  for (i=0; i<M; i++) {
+    aij->ilen[i] = aij->imax[i] = ai[i+1] - ai[i];
+    if (aij->ilen[i] < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Negative length %D of row %D in file",aij->ilen[i],i);
+  }
+  aij->maxnz        = nz;
+  aij->i            = ai;
+  aij->j            = aj;
+  aij->a            = aa;
+  aij->singlemalloc = PETSC_FALSE;
+  aij->free_a       = mapped ? PETSC_FALSE : PETSC_TRUE;
+  aij->free_ij      = mapped ? PETSC_FALSE : PETSC_TRUE;
+
+  ierr = MatAssemblyBegin(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(newMat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,489 @@
+/*
+  Defines basic operations for the MATSEQAIJOMP matrix class.
+  This class is derived from the MATSEQAIJ class and uses the same storage,
+  but the matrix-vector products are threaded with OpenMP. The rows are split
+  among the threads so that each thread handles about the same number of nonzeros.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <omp.h>
+
+typedef struct {
+  PetscInt         nthreads;
+  PetscInt         *rstart;       /* thread t handles (compressed) rows rstart[t] to rstart[t+1]-1 */
+  PetscInt         *cstart,*cend; /* range of columns touched by the rows of thread t, used by MatMultTranspose() */
+  PetscScalar      *work;         /* nthreads*n private accumulation arrays for MatMultTranspose() */
+  PetscBool        cprow;         /* the partition refers to the compressed rows */
+  PetscObjectState nonzerostate;  /* nonzero state of the matrix when the partition was computed */
+} Mat_SeqAIJOMP;
+
+/*
+   Splits the (possibly compressed) rows of the matrix into contiguous blocks with about
+   the same number of nonzeros, one for each thread.
+*/
+static PetscErrorCode MatSeqAIJOMPSetUpPartition(Mat A)
+{
+  Mat_SeqAIJ     *a       = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp  = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt       nt       = aijomp->nthreads,nrows,nz,t,r,target;
+  const PetscInt *ii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->compressedrow.use) {
+    nrows = a->compressedrow.nrows;
+    ii    = a->compressedrow.i;
+  } else {
+    nrows = A->rmap->n;
+    ii    = a->i;
+  }
+  if (!aijomp->rstart) {
+    ierr = PetscMalloc3(nt+1,&aijomp->rstart,nt,&aijomp->cstart,nt,&aijomp->cend);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(3*nt+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  }
+  nz                = ii[nrows] - ii[0];
+  aijomp->rstart[0] = 0;
+  for (t=1,r=0; t<nt; t++) {
+    target = ii[0] + (PetscInt)(((PetscInt64)t*nz)/nt);
+    while (r < nrows && ii[r] < target) r++;
+    aijomp->rstart[t] = r;
+  }
+  aijomp->rstart[nt] = nrows;
+
+  /* the column indices of each row are sorted, so only the first and last entries are needed */
+  for (t=0; t<nt; t++) {
+    aijomp->cstart[t] = A->cmap->n;
+    aijomp->cend[t]   = 0;
+    for (r=aijomp->rstart[t]; r<aijomp->rstart[t+1]; r++) {
+      if (ii[r+1] == ii[r]) continue;
+      aijomp->cstart[t] = PetscMin(aijomp->cstart[t],a->j[ii[r]]);
+      aijomp->cend[t]   = PetscMax(aijomp->cend[t],a->j[ii[r+1]-1]+1);
+    }
+    if (aijomp->cstart[t] > aijomp->cend[t]) aijomp->cstart[t] = aijomp->cend[t] = 0;
+  }
+  aijomp->cprow        = a->compressedrow.use;
+  aijomp->nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+/* Recomputes the partition only if the nonzero structure changed since it was last built */
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJOMPCheckPartition(Mat A)
+{
+  Mat_SeqAIJ     *a      = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aijomp->rstart || aijomp->nonzerostate != A->nonzerostate || aijomp->cprow != a->compressedrow.use) {
+    ierr = MatSeqAIJOMPSetUpPartition(A);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJOMPFreePartition(Mat_SeqAIJOMP *aijomp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(aijomp->rstart,aijomp->cstart,aijomp->cend);CHKERRQ(ierr);
+  ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJOMP_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJOMP to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJOMP  *aijomp;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  aijomp = (Mat_SeqAIJOMP*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+
+  ierr = MatSeqAIJOMPFreePartition(aijomp);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJOMP matrix will not have an spptr pointer. */
+  if (aijomp) {
+    ierr = MatSeqAIJOMPFreePartition(aijomp);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJOMP(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr,*aijomp_dest;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  aijomp_dest = (Mat_SeqAIJOMP*)(*M)->spptr;
+  /* The partition is not shared, it is recomputed for the new matrix when first needed. */
+  if (aijomp_dest->nthreads != aijomp->nthreads) {
+    ierr = MatSeqAIJOMPFreePartition(aijomp_dest);CHKERRQ(ierr);
+    aijomp_dest->nthreads = aijomp->nthreads;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJOMP(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the use of the inode routines so that the threaded products are used instead. */
+  a->inode.use = PETSC_FALSE;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJOMPSetUpPartition(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a       = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp  = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          nt       = aijomp->nthreads,t;
+  const PetscInt    *rstart,*ii,*ridx = NULL;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (nt == 1) {
+    ierr = MatMult_SeqAIJ(A,xx,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr   = MatSeqAIJOMPCheckPartition(A);CHKERRQ(ierr);
+  rstart = aijomp->rstart;
+  ierr   = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr   = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) {
+    ierr = PetscArrayzero(y,A->rmap->n);CHKERRQ(ierr);
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    ii = a->i;
+  }
+#pragma omp parallel for schedule(static,1) num_threads(nt)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = 0.0;
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      if (usecprow) y[ridx[i]] = sum;
+      else y[i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJOMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a       = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp  = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          nt       = aijomp->nthreads,t;
+  const PetscInt    *rstart,*ii,*ridx = NULL;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (nt == 1) {
+    ierr = MatMultAdd_SeqAIJ(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr   = MatSeqAIJOMPCheckPartition(A);CHKERRQ(ierr);
+  rstart = aijomp->rstart;
+  ierr   = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr   = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (usecprow) {
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,A->rmap->n);CHKERRQ(ierr);
+    }
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    ii = a->i;
+  }
+#pragma omp parallel for schedule(static,1) num_threads(nt)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj;
+    const MatScalar *aa;
+    PetscScalar     sum;
+    PetscInt        i,n,r;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      r   = usecprow ? ridx[i] : i;
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = y[r];
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      z[r] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Each thread accumulates the contribution of its rows into a private array restricted to the
+   columns its rows touch; the private arrays are then summed into y, split by columns.
+   Computes y = A^T x, or y = z + A^T x if z is given.
+*/
+static PetscErrorCode MatMultTransposeKernel_SeqAIJOMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a       = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp  = (Mat_SeqAIJOMP*)A->spptr;
+  PetscInt          nt       = aijomp->nthreads,n = A->cmap->n,t,j;
+  const PetscInt    *rstart,*cstart,*cend,*ii,*ridx = NULL;
+  PetscScalar       *y,*work;
+  const PetscScalar *x,*z = NULL;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMPCheckPartition(A);CHKERRQ(ierr);
+  if (!aijomp->work) {
+    ierr = PetscMalloc1(nt*n,&aijomp->work);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,nt*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  rstart = aijomp->rstart;
+  cstart = aijomp->cstart;
+  cend   = aijomp->cend;
+  work   = aijomp->work;
+  ierr   = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz && zz != yy) {ierr = VecGetArrayRead(zz,&z);CHKERRQ(ierr);}
+  ierr   = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (zz == yy) z = y;
+  if (usecprow) {
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    ii = a->i;
+  }
+#pragma omp parallel num_threads(nt)
+  {
+#pragma omp for schedule(static,1)
+    for (t=0; t<nt; t++) {
+      PetscScalar     *w = work + t*n,alpha;
+      const PetscInt  *idx;
+      const MatScalar *v;
+      PetscInt        i,k,nz;
+
+      for (k=cstart[t]; k<cend[t]; k++) w[k] = 0.0;
+      for (i=rstart[t]; i<rstart[t+1]; i++) {
+        idx   = a->j + ii[i];
+        v     = a->a + ii[i];
+        nz    = ii[i+1] - ii[i];
+        alpha = usecprow ? x[ridx[i]] : x[i];
+        for (k=0; k<nz; k++) w[idx[k]] += alpha*v[k];
+      }
+    }
+#pragma omp for schedule(static)
+    for (j=0; j<n; j++) {
+      PetscScalar sum = z ? z[j] : 0.0;
+      PetscInt    s;
+
+      for (s=0; s<nt; s++) {
+        if (cstart[s] <= j && j < cend[s]) sum += work[s*n+j];
+      }
+      y[j] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz && zz != yy) {ierr = VecRestoreArrayRead(zz,&z);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (aijomp->nthreads == 1) {
+    ierr = MatMultTranspose_SeqAIJ(A,xx,yy);CHKERRQ(ierr);
+  } else {
+    ierr = MatMultTransposeKernel_SeqAIJOMP(A,xx,NULL,yy);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJOMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (aijomp->nthreads == 1) {
+    ierr = MatMultTransposeAdd_SeqAIJ(A,xx,zz,yy);CHKERRQ(ierr);
+  } else {
+    ierr = MatMultTransposeKernel_SeqAIJOMP(A,xx,zz,yy);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJOMP converts a SeqAIJ matrix into a
+ * SeqAIJOMP matrix.  This routine is called by the MatCreate_SeqAIJOMP()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJOMP one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJ     *b;
+  Mat_SeqAIJOMP  *aijomp;
+  PetscBool      sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijomp);CHKERRQ(ierr);
+  b        = (Mat_SeqAIJ*)B->data;
+  B->spptr = (void*)aijomp;
+
+  /* Disable use of the inode routines so that the threaded ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJOMP as well, but the assembly end may not be called, so set it here, too. */
+  b->inode.use = PETSC_FALSE;
+
+  aijomp->nthreads = (PetscInt)omp_get_max_threads();
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"AIJOMP Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijomp_num_threads","Number of OpenMP threads used in the matrix-vector products","MatCreateSeqAIJOMP",aijomp->nthreads,&aijomp->nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (aijomp->nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",aijomp->nthreads);
+
+  B->ops->duplicate        = MatDuplicate_SeqAIJOMP;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJOMP;
+  B->ops->destroy          = MatDestroy_SeqAIJOMP;
+  B->ops->mult             = MatMult_SeqAIJOMP;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJOMP;
+  B->ops->multadd          = MatMultAdd_SeqAIJOMP;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJOMP;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",MatConvert_SeqAIJOMP_SeqAIJ);CHKERRQ(ierr);
+
+  /* If B has already been assembled, build the partition now. */
+  if (B->assembled) {
+    ierr = MatSeqAIJOMPSetUpPartition(B);CHKERRQ(ierr);
+  }
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJOMP);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJOMP - Creates a sparse matrix of type SEQAIJOMP.
+   This type inherits from AIJ and uses the same storage, but MatMult(), MatMultAdd(),
+   MatMultTranspose() and MatMultTransposeAdd() are threaded with OpenMP.
+
+   Because SEQAIJOMP is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijomp" can be used to make
+   sequential AIJ matrices, including the diagonal and off-diagonal blocks of MPIAIJ matrices,
+   default to being instances of MATSEQAIJOMP.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijomp_num_threads <n> - number of threads used in the products, defaults to the maximum number of OpenMP threads
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The rows are split into contiguous blocks holding about the same number of nonzeros, one per thread.
+   The split is computed in MatAssemblyEnd() and recomputed only when the nonzero structure changes.
+   MatMultTranspose() accumulates into one private array of length n per thread.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJOMP(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJOMP(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,297 @@
+
+/*
+    Level scheduled (wavefront) triangular solves for the LU/ILU and Cholesky/ICC factors of SeqAIJ matrices.
+
+    The rows of each triangular factor are grouped in levels such that a row only depends on rows of earlier
+    levels; the rows of one level are then computed concurrently with OpenMP threads. Each row is computed with
+    exactly the same operations, in the same order, as in the sequential solves so the results are identical.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/sbaij/seq/sbaij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+/* the schedule is used by default only if the levels contain on average at least this many rows */
+#define MAT_LEVELS_MIN_WIDTH 64
+
+/* groups the rows by level, keeping the natural order inside each level */
+static PetscErrorCode MatSeqAIJLevelsSort_Private(PetscInt n,const PetscInt lev[],PetscInt *nlevels,PetscInt **ptr,PetscInt **rows)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l,nl = 0,*p,*r;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) nl = PetscMax(nl,lev[i]+1);
+  ierr = PetscCalloc1(nl+1,&p);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&r);CHKERRQ(ierr);
+  for (i=0; i<n; i++) p[lev[i]+1]++;
+  for (l=0; l<nl; l++) p[l+1] += p[l];
+  for (i=0; i<n; i++) r[p[lev[i]]++] = i;
+  for (l=nl; l>0; l--) p[l] = p[l-1];
+  p[0]     = 0;
+  *nlevels = nl;
+  *ptr     = p;
+  *rows    = r;
+  PetscFunctionReturn(0);
+}
+
+/* frees the levels but keeps the decision whether to use them */
+static PetscErrorCode MatSeqAIJLevelsReset_Private(Mat_SeqAIJ_Levels *lv)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(lv->lptr);CHKERRQ(ierr);
+  ierr = PetscFree(lv->lrows);CHKERRQ(ierr);
+  ierr = PetscFree(lv->uptr);CHKERRQ(ierr);
+  ierr = PetscFree(lv->urows);CHKERRQ(ierr);
+  ierr = PetscFree3(lv->ti,lv->tj,lv->tmap);CHKERRQ(ierr);
+  ierr = PetscFree(lv->work);CHKERRQ(ierr);
+  lv->nlevels[0] = lv->nlevels[1] = 0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSeqAIJLevelsDestroy_Private(Mat_SeqAIJ_Levels **levels)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*levels) PetscFunctionReturn(0);
+  ierr = MatSeqAIJLevelsReset_Private(*levels);CHKERRQ(ierr);
+  ierr = PetscFree(*levels);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* levels of L and U of a factor stored as in MatLUFactorNumeric_SeqAIJ() */
+static PetscErrorCode MatSeqAIJLevelsCreate_LU(Mat fact,Mat_SeqAIJ_Levels *lv)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)fact->data;
+  PetscErrorCode ierr;
+  PetscInt       n = fact->rmap->n,i,k,*lev;
+  const PetscInt *bi = b->i,*bj = b->j,*bdiag = b->diag;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&lev);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    lev[i] = 0;
+    for (k=bi[i]; k<bi[i+1]; k++) lev[i] = PetscMax(lev[i],lev[bj[k]]+1);
+  }
+  ierr = MatSeqAIJLevelsSort_Private(n,lev,&lv->nlevels[0],&lv->lptr,&lv->lrows);CHKERRQ(ierr);
+  for (i=n-1; i>=0; i--) {
+    lev[i] = 0;
+    for (k=bdiag[i+1]+1; k<bdiag[i]; k++) lev[i] = PetscMax(lev[i],lev[bj[k]]+1);
+  }
+  ierr = MatSeqAIJLevelsSort_Private(n,lev,&lv->nlevels[1],&lv->uptr,&lv->urows);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   levels of U^T D and U of a factor stored as in MatCholeskyFactorNumeric_SeqAIJ(); the forward solve with U^T is
+   done by rows of U^T, whose structure is stored in ti[], tj[] with tmap[] giving the location of the entries in b->a
+*/
+static PetscErrorCode MatSeqAIJLevelsCreate_Cholesky(Mat fact,Mat_SeqAIJ_Levels *lv)
+{
+  Mat_SeqSBAIJ   *b = (Mat_SeqSBAIJ*)fact->data;
+  PetscErrorCode ierr;
+  PetscInt       n = fact->rmap->n,i,k,*lev,*cnt;
+  const PetscInt *bi = b->i,*bj = b->j;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(n+1,&lv->ti,bi[n]-n,&lv->tj,bi[n]-n,&lv->tmap);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&lv->work);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&lev,n,&cnt);CHKERRQ(ierr);
+  ierr = PetscMemzero(lev,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscMemzero(lv->ti,(n+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (k=bi[i]; k<bi[i+1]-1; k++) {
+      lev[bj[k]] = PetscMax(lev[bj[k]],lev[i]+1);
+      lv->ti[bj[k]+1]++;
+    }
+  }
+  ierr = MatSeqAIJLevelsSort_Private(n,lev,&lv->nlevels[0],&lv->lptr,&lv->lrows);CHKERRQ(ierr);
+  for (i=0; i<n; i++) lv->ti[i+1] += lv->ti[i];
+  ierr = PetscMemcpy(cnt,lv->ti,n*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (k=bi[i]; k<bi[i+1]-1; k++) {
+      lv->tj[cnt[bj[k]]]     = i;
+      lv->tmap[cnt[bj[k]]++] = k;
+    }
+  }
+  for (i=n-1; i>=0; i--) {
+    lev[i] = 0;
+    for (k=bi[i]; k<bi[i+1]-1; k++) lev[i] = PetscMax(lev[i],lev[bj[k]]+1);
+  }
+  ierr = MatSeqAIJLevelsSort_Private(n,lev,&lv->nlevels[1],&lv->uptr,&lv->urows);CHKERRQ(ierr);
+  ierr = PetscFree2(lev,cnt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a  = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Levels *lv = a->levels;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n,l,k,i,nz;
+  const PetscInt    *ai = a->i,*aj = a->j,*adiag = a->diag,*rout,*cout,*r,*c,*vi;
+  const PetscInt    *lptr = lv->lptr,*lrows = lv->lrows,*uptr = lv->uptr,*urows = lv->urows;
+  PetscScalar       *x,*tmp,sum;
+  const PetscScalar *b;
+  const MatScalar   *aa = a->a,*v;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  tmp  = a->solve_work;
+  ierr = ISGetIndices(a->row,&rout);CHKERRQ(ierr); r = rout;
+  ierr = ISGetIndices(a->col,&cout);CHKERRQ(ierr); c = cout;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel private(l,k,i,nz,v,vi,sum)
+#endif
+  {
+    /* forward solve the lower triangular, level by level */
+    for (l=0; l<lv->nlevels[0]; l++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+      for (k=lptr[l]; k<lptr[l+1]; k++) {
+        i   = lrows[k];
+        v   = aa + ai[i];
+        vi  = aj + ai[i];
+        nz  = ai[i+1] - ai[i];
+        sum = b[r[i]];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum;
+      }
+    }
+    /* backward solve the upper triangular */
+    for (l=0; l<lv->nlevels[1]; l++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+      for (k=uptr[l]; k<uptr[l+1]; k++) {
+        i   = urows[k];
+        v   = aa + adiag[i+1]+1;
+        vi  = aj + adiag[i+1]+1;
+        nz  = adiag[i]-adiag[i+1]-1;
+        sum = tmp[i];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        x[c[i]] = tmp[i] = sum*v[nz];
+      }
+    }
+  }
+
+  ierr = ISRestoreIndices(a->row,&rout);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&cout);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqSBAIJ      *a  = (Mat_SeqSBAIJ*)A->data;
+  Mat_SeqAIJ_Levels *lv = a->levels;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n,l,k,i,j,nz;
+  const PetscInt    *ai = a->i,*aj = a->j,*adiag = a->diag,*rp,*vj;
+  const PetscInt    *ti = lv->ti,*tj = lv->tj,*tmap = lv->tmap;
+  const PetscInt    *lptr = lv->lptr,*lrows = lv->lrows,*uptr = lv->uptr,*urows = lv->urows;
+  PetscScalar       *x,*t,*y = lv->work,sum;
+  const PetscScalar *b;
+  const MatScalar   *aa = a->a,*v;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  t    = a->solve_work;
+  ierr = ISGetIndices(a->row,&rp);CHKERRQ(ierr);
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel private(l,k,i,j,nz,v,vj,sum)
+#endif
+  {
+    /* solve U^T*D*y = perm(b) by rows of U^T; y[] holds the values before the scaling by D^{-1} */
+    for (l=0; l<lv->nlevels[0]; l++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+      for (k=lptr[l]; k<lptr[l+1]; k++) {
+        i   = lrows[k];
+        sum = b[rp[i]];
+        for (j=ti[i]; j<ti[i+1]; j++) sum += aa[tmap[j]]*y[tj[j]];
+        y[i] = sum;
+        t[i] = sum*aa[ai[i+1]-1]; /* 1/D(i) */
+      }
+    }
+    /* solve U*perm(x) = y by back substitution */
+    for (l=0; l<lv->nlevels[1]; l++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+      for (k=uptr[l]; k<uptr[l+1]; k++) {
+        i  = urows[k];
+        v  = aa + adiag[i] - 1;
+        vj = aj + adiag[i] - 1;
+        nz = ai[i+1] - ai[i] - 1;
+        for (j=0; j<nz; j++) t[i] += v[-j]*t[vj[-j]];
+        x[rp[i]] = t[i];
+      }
+    }
+  }
+
+  ierr = ISRestoreIndices(a->row,&rp);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*a->nz - 3.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called at the end of the numeric factorization: the levels are computed with the first numeric factorization
+   after the symbolic one and reused by the following ones. The level scheduled solve is selected if there are enough
+   threads and wide enough levels, or with -mat_solve_level_schedule
+*/
+PetscErrorCode MatSeqAIJFactorSetUpLevels_Private(Mat fact)
+{
+  PetscErrorCode    ierr;
+  Mat_SeqAIJ_Levels **levels,*lv;
+  PetscBool         cholesky = (fact->factortype == MAT_FACTOR_CHOLESKY || fact->factortype == MAT_FACTOR_ICC) ? PETSC_TRUE : PETSC_FALSE;
+  PetscInt          n = fact->rmap->n;
+
+  PetscFunctionBegin;
+  if (cholesky) levels = &((Mat_SeqSBAIJ*)fact->data)->levels;
+  else          levels = &((Mat_SeqAIJ*)fact->data)->levels;
+  if (!*levels) {
+    PetscBool use = PETSC_FALSE,flg;
+#if defined(PETSC_HAVE_OPENMP)
+    use = omp_get_max_threads() > 1 ? PETSC_TRUE : PETSC_FALSE;
+#endif
+    ierr = PetscOptionsGetBool(((PetscObject)fact)->options,((PetscObject)fact)->prefix,"-mat_solve_level_schedule",&use,&flg);CHKERRQ(ierr);
+    ierr = PetscNewLog(fact,levels);CHKERRQ(ierr);
+    lv   = *levels;
+    if (use) {
+      if (cholesky) {ierr = MatSeqAIJLevelsCreate_Cholesky(fact,lv);CHKERRQ(ierr);}
+      else          {ierr = MatSeqAIJLevelsCreate_LU(fact,lv);CHKERRQ(ierr);}
+      ierr = PetscInfo3(fact,"Triangular solves with %D and %D levels for %D rows\n",lv->nlevels[0],lv->nlevels[1],n);CHKERRQ(ierr);
+      if (!flg && n < MAT_LEVELS_MIN_WIDTH*PetscMax(lv->nlevels[0],lv->nlevels[1])) {
+        use  = PETSC_FALSE;
+        ierr = MatSeqAIJLevelsReset_Private(lv);CHKERRQ(ierr);
+      }
+    }
+    lv->use = use;
+  }
+  lv = *levels;
+  if (lv->use) {
+    if (cholesky) {
+      fact->ops->solve          = MatSolve_SeqSBAIJ_1_Levels;
+      fact->ops->solvetranspose = MatSolve_SeqSBAIJ_1_Levels;
+    } else fact->ops->solve = MatSolve_SeqAIJ_Levels;
+  }
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,248 @@
+
+/*
+    Multicolor SOR for SeqAIJ matrices: the rows are grouped by the colors of a greedy coloring of the
+    (symmetrized) matrix graph and stored as slices of MAT_SEQAIJ_MC_SLICE rows in a sliced ELLPACK layout,
+    so that all the rows of one color can be relaxed together with SIMD and OpenMP threads.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+/*
+   Greedy distance one coloring of the graph of A + A^T, followed by the sliced storage of the off-diagonal
+   part of the rows ordered by color. Only the structure is set here, the values are set by
+   MatSeqAIJMulticolorSetValues_Private()
+*/
+static PetscErrorCode MatSeqAIJMulticolorSetUp_Private(Mat A)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Multicolor *mc = a->mcsor;
+  PetscErrorCode        ierr;
+  PetscInt              m = A->rmap->n,i,j,k,c,r,s,row,nz,nslices,len,*ti,*tj,*color,*mark,*cnt,*perm,*width;
+  const PetscInt        *ai = a->i,*aj = a->j;
+
+  PetscFunctionBegin;
+  if (A->rmap->n != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_SUP,"Multicolor SOR requires a square matrix, not %D by %D",A->rmap->n,A->cmap->n);
+  ierr = PetscFree3(mc->cslice,mc->sliidx,mc->rows);CHKERRQ(ierr);
+  ierr = PetscFree(mc->colidx);CHKERRQ(ierr);
+  ierr = PetscFree2(mc->val,mc->idiag);CHKERRQ(ierr);
+
+  /* structure of A^T, so that the colors of the rows that couple to row i through column i are known */
+  ierr = PetscCalloc1(m+1,&ti);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ai[m],&tj);CHKERRQ(ierr);
+  for (k=0; k<ai[m]; k++) ti[aj[k]+1]++;
+  for (i=0; i<m; i++) ti[i+1] += ti[i];
+  ierr = PetscMalloc4(m,&color,m+1,&mark,m+1,&cnt,m,&perm);CHKERRQ(ierr);
+  ierr = PetscMemcpy(cnt,ti,m*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (k=ai[i]; k<ai[i+1]; k++) tj[cnt[aj[k]]++] = i;
+  }
+
+  /* rows are visited in their natural order, each gets the smallest color not used by its colored neighbors */
+  for (i=0; i<=m; i++) mark[i] = -1;
+  mc->ncolors = 0;
+  for (i=0; i<m; i++) {
+    for (k=ai[i]; k<ai[i+1]; k++) if (aj[k] < i) mark[color[aj[k]]] = i;
+    for (k=ti[i]; k<ti[i+1]; k++) if (tj[k] < i) mark[color[tj[k]]] = i;
+    for (c=0; mark[c] == i; c++) ;
+    color[i]    = c;
+    mc->ncolors = PetscMax(mc->ncolors,c+1);
+  }
+  ierr = PetscFree(tj);CHKERRQ(ierr);
+  ierr = PetscFree(ti);CHKERRQ(ierr);
+
+  /* rows sorted by color, keeping the natural order inside each color */
+  ierr = PetscMemzero(cnt,(mc->ncolors+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<m; i++) cnt[color[i]+1]++;
+  for (c=0; c<mc->ncolors; c++) cnt[c+1] += cnt[c];
+  for (i=0; i<m; i++) perm[cnt[color[i]]++] = i;
+  for (c=mc->ncolors; c>0; c--) cnt[c] = cnt[c-1];
+  cnt[0] = 0;
+
+  /* each color is cut into slices of MAT_SEQAIJ_MC_SLICE rows, the last slice of a color is padded */
+  nslices = 0;
+  for (c=0; c<mc->ncolors; c++) nslices += (cnt[c+1] - cnt[c] + MAT_SEQAIJ_MC_SLICE - 1)/MAT_SEQAIJ_MC_SLICE;
+  ierr = PetscMalloc1(nslices,&width);CHKERRQ(ierr);
+  ierr = PetscMalloc3(mc->ncolors+1,&mc->cslice,nslices+1,&mc->sliidx,nslices*MAT_SEQAIJ_MC_SLICE,&mc->rows);CHKERRQ(ierr);
+  mc->cslice[0] = 0;
+  mc->sliidx[0] = 0;
+  for (c=0,s=0; c<mc->ncolors; c++) {
+    for (k=cnt[c]; k<cnt[c+1]; k+=MAT_SEQAIJ_MC_SLICE,s++) {
+      width[s] = 0;
+      for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) {
+        if (k+r < cnt[c+1]) {
+          row = perm[k+r];
+          len = ai[row+1] - ai[row];
+          for (j=ai[row]; j<ai[row+1]; j++) if (aj[j] == row) len--;
+          width[s] = PetscMax(width[s],len);
+          mc->rows[s*MAT_SEQAIJ_MC_SLICE+r] = row;
+        } else mc->rows[s*MAT_SEQAIJ_MC_SLICE+r] = -1;
+      }
+      mc->sliidx[s+1] = mc->sliidx[s] + width[s]*MAT_SEQAIJ_MC_SLICE;
+    }
+    mc->cslice[c+1] = s;
+  }
+  ierr = PetscFree(width);CHKERRQ(ierr);
+  ierr = PetscFree4(color,mark,cnt,perm);CHKERRQ(ierr);
+
+  /* column indices; the padding of a row refers to the row itself with a zero value, and the padding rows at the end of a slice,
+     whose lanes are masked in the kernel, to the first row of their slice, so that they never read a value of x outside the slice
+     (such as a nonfinite x[0]) */
+  nz   = mc->sliidx[nslices];
+  ierr = PetscMalloc1(nz,&mc->colidx);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nz,&mc->val,nslices*MAT_SEQAIJ_MC_SLICE,&mc->idiag);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nz+nslices*MAT_SEQAIJ_MC_SLICE)*(sizeof(PetscInt)+sizeof(MatScalar)));CHKERRQ(ierr);
+  for (s=0; s<nslices; s++) {
+    for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) {
+      row = mc->rows[s*MAT_SEQAIJ_MC_SLICE+r];
+      k   = mc->sliidx[s] + r;
+      if (row >= 0) {
+        for (j=ai[row]; j<ai[row+1]; j++) {
+          if (aj[j] == row) continue;
+          mc->colidx[k] = aj[j];
+          k            += MAT_SEQAIJ_MC_SLICE;
+        }
+      }
+      for (; k<mc->sliidx[s+1]; k+=MAT_SEQAIJ_MC_SLICE) mc->colidx[k] = row >= 0 ? row : mc->rows[s*MAT_SEQAIJ_MC_SLICE];
+    }
+  }
+  mc->nslices      = nslices;
+  mc->nonzerostate = A->nonzerostate;
+  mc->valuesvalid  = PETSC_FALSE;
+  ierr = PetscInfo3(A,"Multicolor SOR ordering with %D colors, %D slices and %D stored entries\n",mc->ncolors,nslices,nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* copies the values of A into the sliced storage and inverts the (shifted) diagonal */
+static PetscErrorCode MatSeqAIJMulticolorSetValues_Private(Mat A,PetscReal omega,PetscReal fshift)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Multicolor *mc = a->mcsor;
+  PetscErrorCode        ierr;
+  PetscInt              s,r,j,k,row;
+  const PetscInt        *ai = a->i,*aj = a->j;
+  const MatScalar       *aa = a->a;
+  MatScalar             d;
+
+  PetscFunctionBegin;
+  for (s=0; s<mc->nslices; s++) {
+    for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) {
+      row = mc->rows[s*MAT_SEQAIJ_MC_SLICE+r];
+      k   = mc->sliidx[s] + r;
+      d   = 0.0;
+      if (row >= 0) {
+        for (j=ai[row]; j<ai[row+1]; j++) {
+          if (aj[j] == row) {d += aa[j]; continue;}
+          mc->val[k] = aa[j];
+          k         += MAT_SEQAIJ_MC_SLICE;
+        }
+        d += fshift;
+        if (!PetscAbsScalar(d)) {
+          if (A->erroriffailure) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MAT_LU_ZRPVT,"Zero diagonal on row %D",row);
+          ierr = PetscInfo1(A,"Zero diagonal on row %D\n",row);CHKERRQ(ierr);
+          A->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+          A->factorerror_zeropivot_value = 0.0;
+          A->factorerror_zeropivot_row   = row;
+          d                              = 1.0;
+        }
+        mc->idiag[s*MAT_SEQAIJ_MC_SLICE+r] = omega/d;
+      } else mc->idiag[s*MAT_SEQAIJ_MC_SLICE+r] = 0.0;
+      for (; k<mc->sliidx[s+1]; k+=MAT_SEQAIJ_MC_SLICE) mc->val[k] = 0.0;
+    }
+  }
+  ierr = PetscObjectStateGet((PetscObject)A,&mc->state);CHKERRQ(ierr);
+  mc->omega       = omega;
+  mc->fshift      = fshift;
+  mc->valuesvalid = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* relaxes all the rows of color c; the rows of one color do not couple so the slices are independent */
+PETSC_STATIC_INLINE void MatSeqAIJMulticolorRelaxColor_Private(Mat_SeqAIJ_Multicolor *mc,PetscInt c,PetscReal omega,const PetscScalar *b,PetscScalar *x)
+{
+  const PetscInt  *sliidx = mc->sliidx,*colidx = mc->colidx,*rows = mc->rows;
+  const MatScalar *val = mc->val,*idiag = mc->idiag;
+  PetscInt        s,k,r,row;
+  PetscScalar     sum[MAT_SEQAIJ_MC_SLICE];
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) private(k,r,row,sum) if (mc->cslice[c+1]-mc->cslice[c] > 8)
+#endif
+  for (s=mc->cslice[c]; s<mc->cslice[c+1]; s++) {
+    for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) sum[r] = 0.0;
+    for (k=sliidx[s]; k<sliidx[s+1]; k+=MAT_SEQAIJ_MC_SLICE) {
+      for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) sum[r] += val[k+r]*x[colidx[k+r]];
+    }
+    for (r=0; r<MAT_SEQAIJ_MC_SLICE; r++) {
+      row = rows[s*MAT_SEQAIJ_MC_SLICE+r];
+      if (row >= 0) x[row] = (1.0-omega)*x[row] + idiag[s*MAT_SEQAIJ_MC_SLICE+r]*(b[row] - sum[r]);
+    }
+  }
+}
+
+PetscErrorCode MatSOR_SeqAIJ_Multicolor(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Multicolor *mc = a->mcsor;
+  PetscErrorCode        ierr;
+  PetscScalar           *x;
+  const PetscScalar     *b;
+  PetscObjectState      state;
+  PetscInt              c,sweeps = 0;
+
+  PetscFunctionBegin;
+  if (mc->nonzerostate != A->nonzerostate || !mc->cslice) {ierr = MatSeqAIJMulticolorSetUp_Private(A);CHKERRQ(ierr);}
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (!mc->valuesvalid || state != mc->state || omega != mc->omega || fshift != mc->fshift) {
+    ierr = MatSeqAIJMulticolorSetValues_Private(A,omega,fshift);CHKERRQ(ierr);
+  }
+
+  its  = its*lits;
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecSet(xx,0.0);CHKERRQ(ierr);}
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (c=0; c<mc->ncolors; c++) MatSeqAIJMulticolorRelaxColor_Private(mc,c,omega,b,x);
+      sweeps++;
+    }
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (c=mc->ncolors-1; c>=0; c--) MatSeqAIJMulticolorRelaxColor_Private(mc,c,omega,b,x);
+      sweeps++;
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = PetscLogFlops(sweeps*(2.0*a->nz + 3.0*A->rmap->n));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSeqAIJMulticolorDestroy_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->mcsor) PetscFunctionReturn(0);
+  ierr = PetscFree3(a->mcsor->cslice,a->mcsor->sliidx,a->mcsor->rows);CHKERRQ(ierr);
+  ierr = PetscFree(a->mcsor->colidx);CHKERRQ(ierr);
+  ierr = PetscFree2(a->mcsor->val,a->mcsor->idiag);CHKERRQ(ierr);
+  ierr = PetscFree(a->mcsor);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetSOROrdering_SeqAIJ(Mat A,MatSOROrdering ordering)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (ordering) {
+  case MAT_SOR_ORDERING_NATURAL:
+    ierr = MatSeqAIJMulticolorDestroy_Private(A);CHKERRQ(ierr);
+    break;
+  case MAT_SOR_ORDERING_MULTICOLOR:
+    if (!a->mcsor) {ierr = PetscNewLog(A,&a->mcsor);CHKERRQ(ierr);}
+    break;
+  default: SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Unknown SOR ordering %d",(int)ordering);
+  }
+  PetscFunctionReturn(0);
+}
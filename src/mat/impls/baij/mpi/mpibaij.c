@@ -1333,6 +1333,7 @@ PetscErrorCode MatDestroy_MPIBAIJ(Mat mat)
   ierr = PetscFree(baij->barray);CHKERRQ(ierr);
   ierr = PetscFree2(baij->hd,baij->ht);CHKERRQ(ierr);
   ierr = PetscFree(baij->rangebs);CHKERRQ(ierr);
+  ierr = MatCOODestroy_Private(&baij->coo);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1340,6 +1341,8 @@ PetscErrorCode MatDestroy_MPIBAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIBAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIBAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetHashTableFactor_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpibaij_mpisbaij_C",NULL);CHKERRQ(ierr);
@@ -2775,6 +2778,81 @@ PetscErrorCode MatMPIBAIJSetPreallocationCSR_MPIBAIJ(Mat B,PetscInt bs,const Pet
   PetscFunctionReturn(0);
 }
 
+/*
+   The COO indices are point indices; an entry is stored in its block in column-major order.
+*/
+static PetscErrorCode MatSetPreallocationCOO_MPIBAIJ(Mat mat,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIBAIJ    *baij = (Mat_MPIBAIJ*)mat->data;
+  Mat_SeqBAIJ    *a,*b;
+  Mat_COO        coo;
+  PetscInt       r,brow,bcol,lcol,nzA,bs,bs2,rstart,cstart,cend,nonew,*oi,*oj,*ii,*jj,*slot;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  nonew = baij->A ? ((Mat_SeqBAIJ*)baij->A->data)->nonew : 0;
+  ierr  = PetscLayoutGetBlockSize(mat->rmap,&bs);CHKERRQ(ierr);
+  bs2   = bs*bs;
+  ierr  = MatCOODestroy_Private(&baij->coo);CHKERRQ(ierr);
+  ierr  = MatCOOCreate_Private(mat,n,coo_i,coo_j,&coo,&oi,&oj);CHKERRQ(ierr);
+  ierr  = MatCOOBuildCSR_Private(mat,coo,bs,oi,oj,&ii,&jj);CHKERRQ(ierr);
+  ierr  = MatMPIBAIJSetPreallocationCSR_MPIBAIJ(mat,bs,ii,jj,NULL);CHKERRQ(ierr);
+  /* the CSR preallocation leaves new nonzeros as errors in the new diagonal and off-diagonal blocks, keep the user's setting instead */
+  ((Mat_SeqBAIJ*)baij->A->data)->nonew = ((Mat_SeqBAIJ*)baij->B->data)->nonew = nonew;
+  ierr = PetscFree(ii);CHKERRQ(ierr);
+  ierr = PetscFree(jj);CHKERRQ(ierr);
+
+  /* locate each entry in the assembled diagonal or off-diagonal block, the latter has compacted block columns given by garray[] */
+  a      = (Mat_SeqBAIJ*)baij->A->data;
+  b      = (Mat_SeqBAIJ*)baij->B->data;
+  nzA    = a->i[baij->mbs]*bs2;
+  rstart = mat->rmap->rstart;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+  ierr   = PetscMalloc1(coo->nown,&slot);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) {
+    if (oi[r] < 0 || oj[r] < 0) {slot[r] = -1; continue;}
+    brow = (oi[r]-rstart)/bs;
+    if (cstart <= oj[r] && oj[r] < cend) {
+      bcol    = (oj[r]-cstart)/bs;
+      ierr    = PetscFindInt(bcol,a->i[brow+1]-a->i[brow],a->j+a->i[brow],&slot[r]);CHKERRQ(ierr);
+      slot[r] = (a->i[brow]+slot[r])*bs2;
+    } else {
+      ierr    = PetscFindInt(oj[r]/bs,baij->B->cmap->n/bs,baij->garray,&lcol);CHKERRQ(ierr);
+      ierr    = PetscFindInt(lcol,b->i[brow+1]-b->i[brow],b->j+b->i[brow],&slot[r]);CHKERRQ(ierr);
+      slot[r] = nzA + (b->i[brow]+slot[r])*bs2;
+    }
+    slot[r] += (oj[r]%bs)*bs + oi[r]%bs;
+  }
+  ierr = MatCOOSetSlots_Private(coo,nzA+b->i[baij->mbs]*bs2,slot);CHKERRQ(ierr);
+  ierr = PetscFree(slot);CHKERRQ(ierr);
+  ierr = PetscFree2(oi,oj);CHKERRQ(ierr);
+  baij->coo = coo;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_MPIBAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIBAIJ       *baij = (Mat_MPIBAIJ*)mat->data;
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)baij->A->data,*b = (Mat_SeqBAIJ*)baij->B->data;
+  Mat_COO           coo = baij->coo;
+  const PetscScalar *vals;
+  PetscInt          nzA;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!coo) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  ierr = MatCOOGetValues_Private(coo,v,&vals);CHKERRQ(ierr);
+  nzA  = a->i[baij->mbs]*a->bs2;
+  MatCOOScatter_Private(coo,0,nzA,vals,a->a,imode);
+  MatCOOScatter_Private(coo,nzA,coo->nslots-nzA,vals,b->a,imode);
+  ierr = PetscLogFlops(coo->jmap[coo->nslots]);CHKERRQ(ierr);
+  a->idiagvalid = PETSC_FALSE;
+  ierr = PetscObjectStateIncrease((PetscObject)baij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)baij->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    MatMPIBAIJSetPreallocationCSR - Creates a sparse parallel matrix in BAIJ format using the given nonzero structure and (optional) numerical values
 
@@ -3059,6 +3137,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIBAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIBAIJSetPreallocation_C",MatMPIBAIJSetPreallocation_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIBAIJSetPreallocationCSR_C",MatMPIBAIJSetPreallocationCSR_MPIBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetHashTableFactor_C",MatSetHashTableFactor_MPIBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_mpibaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
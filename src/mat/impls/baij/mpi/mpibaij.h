@@ -66,6 +66,7 @@
 
 typedef struct {
   MPIBAIJHEADER;
+  Mat_COO coo;                  /* used by MatSetValuesCOO(), storage locations of A precede those of B */
 } Mat_MPIBAIJ;
 
 PETSC_INTERN PetscErrorCode MatLoad_MPIBAIJ(Mat,PetscViewer);
@@ -1208,6 +1208,7 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
 
   ierr = MatDestroy(&a->sbaijMat);CHKERRQ(ierr);
   ierr = MatDestroy(&a->parent);CHKERRQ(ierr);
+  ierr = MatCOODestroy_Private(&a->coo);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
@@ -1219,6 +1220,8 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqbaij_seqsbaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqBAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqBAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqbaij_seqbstrm_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatIsTranspose_C",NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_HYPRE)
@@ -2999,6 +3002,59 @@ PetscErrorCode MatSeqBAIJSetPreallocationCSR_SeqBAIJ(Mat B,PetscInt bs,const Pet
   PetscFunctionReturn(0);
 }
 
+/*
+   The COO indices are point indices; an entry is stored in its block in column-major order.
+*/
+static PetscErrorCode MatSetPreallocationCOO_SeqBAIJ(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqBAIJ    *a = (Mat_SeqBAIJ*)A->data;
+  Mat_COO        coo;
+  PetscInt       r,brow,bs,bs2,nonew = a->nonew,*oi,*oj,*ii,*jj,*slot;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutGetBlockSize(A->rmap,&bs);CHKERRQ(ierr);
+  bs2  = bs*bs;
+  ierr = MatCOODestroy_Private(&a->coo);CHKERRQ(ierr);
+  ierr = MatCOOCreate_Private(A,n,coo_i,coo_j,&coo,&oi,&oj);CHKERRQ(ierr);
+  ierr = MatCOOBuildCSR_Private(A,coo,bs,oi,oj,&ii,&jj);CHKERRQ(ierr);
+  /* the CSR preallocation inserts the new structure with MatSetValues() and leaves new nonzeros as errors, keep the user's setting instead */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSeqBAIJSetPreallocationCSR_SeqBAIJ(A,bs,ii,jj,NULL);CHKERRQ(ierr);
+  a->nonew = nonew;
+  ierr = PetscFree(ii);CHKERRQ(ierr);
+  ierr = PetscFree(jj);CHKERRQ(ierr);
+
+  a    = (Mat_SeqBAIJ*)A->data;
+  ierr = PetscMalloc1(coo->nown,&slot);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) {
+    if (oi[r] < 0 || oj[r] < 0) {slot[r] = -1; continue;}
+    brow    = oi[r]/bs;
+    ierr    = PetscFindInt(oj[r]/bs,a->i[brow+1]-a->i[brow],a->j+a->i[brow],&slot[r]);CHKERRQ(ierr);
+    slot[r] = (a->i[brow]+slot[r])*bs2 + (oj[r]%bs)*bs + oi[r]%bs;
+  }
+  ierr = MatCOOSetSlots_Private(coo,a->i[A->rmap->n/bs]*bs2,slot);CHKERRQ(ierr);
+  ierr = PetscFree(slot);CHKERRQ(ierr);
+  ierr = PetscFree2(oi,oj);CHKERRQ(ierr);
+  a->coo = coo;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_SeqBAIJ(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;
+  const PetscScalar *vals;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!a->coo) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  ierr = MatCOOGetValues_Private(a->coo,v,&vals);CHKERRQ(ierr);
+  MatCOOScatter_Private(a->coo,0,a->coo->nslots,vals,a->a,imode);
+  ierr = PetscLogFlops(a->coo->jmap[a->coo->nslots]);CHKERRQ(ierr);
+  a->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
 /*MC
    MATSEQBAIJ - MATSEQBAIJ = "seqbaij" - A matrix type to be used for sequential block sparse matrices, based on
    block sparse compressed row format.
@@ -3052,6 +3108,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqBAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqbaij_seqsbaij_C",MatConvert_SeqBAIJ_SeqSBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqBAIJSetPreallocation_C",MatSeqBAIJSetPreallocation_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqBAIJSetPreallocationCSR_C",MatSeqBAIJSetPreallocationCSR_SeqBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsTranspose_C",MatIsTranspose_SeqBAIJ);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_HYPRE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqbaij_hypre_C",MatConvert_AIJ_HYPRE);CHKERRQ(ierr);
@@ -28,6 +28,7 @@
 typedef struct {
   SEQAIJHEADER(MatScalar);
   SEQBAIJHEADER;
+  Mat_COO coo;                       /* used by MatSetValuesCOO() */
 } Mat_SeqBAIJ;
 
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B,PetscInt bs,PetscInt nz,PetscInt *nnz);
@@ -180,6 +180,7 @@ PetscErrorCode MatDestroy_SeqSBAIJ(Mat A)
   ierr = ISDestroy(&a->icol);CHKERRQ(ierr);
   ierr = PetscFree(a->idiag);CHKERRQ(ierr);
   ierr = PetscFree(a->inode.size);CHKERRQ(ierr);
+  ierr = MatSeqAIJLevelsDestroy_Private(&a->levels);CHKERRQ(ierr);
   if (a->free_imax_ilen) {ierr = PetscFree2(a->imax,a->ilen);CHKERRQ(ierr);}
   ierr = PetscFree(a->solve_work);CHKERRQ(ierr);
   ierr = PetscFree(a->sor_work);CHKERRQ(ierr);
@@ -24,6 +24,7 @@ typedef struct {
   Mat_SeqAIJ_Inode inode;
   unsigned short   *jshort;
   PetscBool        free_jshort;
+  Mat_SeqAIJ_Levels *levels;     /* used by MatSolve() of Cholesky factors of SeqAIJ matrices */
 } Mat_SeqSBAIJ;
 
 PETSC_INTERN PetscErrorCode MatCholeskyFactorSymbolic_SeqSBAIJ(Mat,Mat,IS,const MatFactorInfo*);
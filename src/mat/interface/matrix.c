@@ -33,6 +33,8 @@ PetscLogEvent MAT_GetBrowsOfAocols, MAT_Getlocalmat, MAT_Getlocalmatcondensed, M
 PetscLogEvent MAT_Applypapt, MAT_Applypapt_numeric, MAT_Applypapt_symbolic, MAT_GetSequentialNonzeroStructure;
 PetscLogEvent MAT_GetMultiProcBlock;
 PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch;
+PetscLogEvent MAT_PreallCOO, MAT_SetValuesCOO;
+PetscLogEvent MAT_MultInterior, MAT_MultBoundary;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_DenseCopyToGPU, MAT_DenseCopyFromGPU;
 PetscLogEvent MAT_Merge,MAT_Residual,MAT_SetRandom;
@@ -969,9 +971,10 @@ PetscErrorCode MatView(Mat mat,PetscViewer viewer)
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&ibinary);CHKERRQ(ierr);
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
   if (ibinary) {
-    PetscBool mpiio;
+    PetscBool mpiio,ismpiaij;
     ierr = PetscViewerBinaryGetUseMPIIO(viewer,&mpiio);CHKERRQ(ierr);
-    if (mpiio) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"PETSc matrix viewers do not support using MPI-IO, turn off that flag");
+    ierr = PetscObjectTypeCompare((PetscObject)mat,MATMPIAIJ,&ismpiaij);CHKERRQ(ierr);
+    if (mpiio && !ismpiaij) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"PETSc matrix viewers only support using MPI-IO with MATMPIAIJ, turn off that flag");
   }
 
   ierr = PetscLogEventBegin(MAT_View,mat,viewer,0,0);CHKERRQ(ierr);
@@ -1081,6 +1084,9 @@ PETSC_UNUSED static int TV_display_type(const struct _p_Mat *mat)
    Used with block matrix formats (MATSEQBAIJ,  ...) to specify
    block size
 .    -matload_block_size <bs>
+   Used with MATSEQAIJ matrices written with the PETSC_VIEWER_BINARY_MMAP format to map
+   the arrays from the file instead of reading them
+.    -matload_mmap
 
    Level: beginner
 
@@ -1145,6 +1151,13 @@ linux, Windows and the paragon; thus if you write your own binary
 read/write routines you have to swap the bytes; see PetscBinaryRead()
 and PetscBinaryWrite() to see how this may be done.
 
+   A MATSEQAIJ matrix viewed with PetscViewerPushFormat(viewer,PETSC_VIEWER_BINARY_MMAP)
+   is instead stored with its arrays in the byte order of the machine, and can only be
+   loaded into a MATSEQAIJ matrix on a machine with the same byte order. With -matload_mmap
+   MatLoad() maps these arrays from the file with a private mmap() and uses them in place.
+   The file must then not be truncated or rewritten while the matrix exists: accessing
+   the entries would raise SIGBUS or see the new content of pages not yet modified.
+
    Notes about the HDF5 (MATLAB MAT-File Version 7.3) format:
    In case of PETSCVIEWERHDF5, a parallel HDF5 reader is used.
    Each processor's chunk is loaded independently by its owning rank.
@@ -3906,6 +3919,46 @@ PetscErrorCode MatSOR(Mat mat,Vec b,PetscReal omega,MatSORType flag,PetscReal sh
   PetscFunctionReturn(0);
 }
 
+/*@
+   MatSetSOROrdering - Sets the order in which MatSOR() relaxes the local rows of the matrix
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+-  ordering - MAT_SOR_ORDERING_NATURAL (the default) or MAT_SOR_ORDERING_MULTICOLOR
+
+   Notes:
+   With MAT_SOR_ORDERING_MULTICOLOR a coloring of the graph of the local (diagonal block of the) matrix
+   is computed the first time MatSOR() is called after the nonzero structure changed. The rows
+   are then stored grouped by color in a sliced ELLPACK layout, and all the rows of one color, which do
+   not couple to each other, are relaxed at once using SIMD and OpenMP threads (when PETSc is configured
+   with OpenMP). A forward sweep visits the colors in increasing order and a backward sweep in decreasing
+   order, so the symmetric sweep is still a symmetric preconditioner.
+
+   The iterates differ from those of the natural ordering, and the multicolor ordering usually needs
+   somewhat more iterations, but each sweep is much cheaper on many-core processors.
+
+   Matrix types that do not support a multicolor ordering ignore this call. Currently it is supported by
+   MATSEQAIJ and MATMPIAIJ (and their subtypes) without the Eisenstat trick or SOR_APPLY_UPPER/LOWER
+   which always use the natural ordering.
+
+   Level: intermediate
+
+.seealso: MatSOR(), MatSOROrdering, PCSORSetOrdering()
+@*/
+PetscErrorCode MatSetSOROrdering(Mat mat,MatSOROrdering ordering)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(mat,ordering,2);
+  MatCheckPreallocated(mat,1);
+  ierr = PetscTryMethod(mat,"MatSetSOROrdering_C",(Mat,MatSOROrdering),(mat,ordering));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
       Default matrix copy routine.
 */
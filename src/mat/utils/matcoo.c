@@ -0,0 +1,347 @@
+/*
+   Assembly of matrices from coordinate (COO) lists: the sparsity pattern and the map from the
+   user COO entries to the matrix storage are built once by MatSetPreallocationCOO(), after which
+   MatSetValuesCOO() only moves the values of the off-process entries with a single PetscSF
+   reduction and sums them into the matrix storage in one streaming pass.
+*/
+#include <petsc/private/matimpl.h>      /*I "petscmat.h" I*/
+#include <petscsf.h>
+
+/*
+   MatCOOCreate_Private - Creates the assembly plan and gathers the COO entries at the process owning their row
+
+   Output Parameters:
++  coo - the plan, coo->nown is the number of entries owned by this process
+.  oi - global row indices of the owned entries
+-  oj - global column indices of the owned entries
+
+   Notes:
+   For sequential matrices the owned entries are exactly the user entries (including those with negative
+   indices, which the callers must ignore), so the plan can index the user values directly.
+   For parallel matrices only the entries with nonnegative indices are sent to their owners; the owned
+   entries are ordered by the rank that provided them so that the summation order is reproducible.
+
+   oi and oj are allocated with PetscMalloc2() and must be freed by the caller with PetscFree2()
+*/
+PetscErrorCode MatCOOCreate_Private(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[],Mat_COO *coo,PetscInt **oi,PetscInt **oj)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       comm;
+  PetscMPIInt    size,rank;
+  Mat_COO        c;
+  PetscInt       k,M = A->rmap->N,N = A->cmap->N;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    if (coo_i[k] >= M) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"COO entry %D has row index %D, must be less than %D",k,coo_i[k],M);
+    if (coo_j[k] >= N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"COO entry %D has column index %D, must be less than %D",k,coo_j[k],N);
+  }
+  ierr = PetscNew(&c);CHKERRQ(ierr);
+  c->n = n;
+  if (size == 1) {
+    c->nown = n;
+    ierr = PetscMalloc2(n,oi,n,oj);CHKERRQ(ierr);
+    ierr = PetscArraycpy(*oi,coo_i,n);CHKERRQ(ierr);
+    ierr = PetscArraycpy(*oj,coo_j,n);CHKERRQ(ierr);
+  } else {
+    const PetscInt *owners = A->rmap->range;
+    PetscInt       *sizes,*offsets,*ilocal,nleaves = 0,max,p = 0;
+    PetscSFNode    *iremote;
+
+    /* Count the entries sent to each process; PetscMaxSum() sums the odd entries of sizes[] giving the number of owned entries */
+    ierr = PetscCalloc2(2*size,&sizes,size,&offsets);CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+      if (coo_i[k] < owners[p] || owners[p+1] <= coo_i[k]) { /* short-circuit the search if the last p owns this row too */
+        ierr = PetscLayoutFindOwner(A->rmap,coo_i[k],&p);CHKERRQ(ierr);
+      }
+      sizes[2*p]++;
+      nleaves++;
+    }
+    for (p=0; p<size; p++) sizes[2*p+1] = sizes[2*p];
+    ierr = PetscMaxSum(comm,sizes,&max,&c->nown);CHKERRQ(ierr);
+    /* offsets[p] is the location in the root space of process p of the first entry sent by this process */
+    for (p=0; p<size; p++) offsets[p] = sizes[2*p];
+    ierr = MPI_Exscan(MPI_IN_PLACE,offsets,size,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+    if (!rank) {ierr = PetscArrayzero(offsets,size);CHKERRQ(ierr);}
+
+    ierr = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+    for (k=0,nleaves=0,p=0; k<n; k++) {
+      if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+      if (coo_i[k] < owners[p] || owners[p+1] <= coo_i[k]) {
+        ierr = PetscLayoutFindOwner(A->rmap,coo_i[k],&p);CHKERRQ(ierr);
+      }
+      ilocal[nleaves]        = k;
+      iremote[nleaves].rank  = p;
+      iremote[nleaves].index = offsets[p]++;
+      nleaves++;
+    }
+    ierr = PetscFree2(sizes,offsets);CHKERRQ(ierr);
+
+    ierr = PetscSFCreate(comm,&c->sf);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(c->sf,c->nown,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(c->sf);CHKERRQ(ierr);
+    ierr = PetscMalloc1(c->nown,&c->buf);CHKERRQ(ierr);
+    ierr = PetscMalloc2(c->nown,oi,c->nown,oj);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(c->sf,MPIU_INT,coo_i,*oi,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(c->sf,MPIU_INT,coo_i,*oi,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(c->sf,MPIU_INT,coo_j,*oj,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(c->sf,MPIU_INT,coo_j,*oj,MPIU_REPLACE);CHKERRQ(ierr);
+  }
+  *coo = c;
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatCOOBuildCSR_Private - Builds the CSR structure of blocks of size bs with global block column indices of
+   the owned COO entries, suitable for the MatXXXSetPreallocationCSR() routines
+
+   ii and jj must be freed by the caller with PetscFree()
+*/
+PetscErrorCode MatCOOBuildCSR_Private(Mat A,Mat_COO coo,PetscInt bs,const PetscInt oi[],const PetscInt oj[],PetscInt **ii,PetscInt **jj)
+{
+  PetscErrorCode ierr;
+  PetscInt       m = A->rmap->n/bs,rstart = A->rmap->rstart,r,row,nz,*i,*j,*cnt;
+
+  PetscFunctionBegin;
+  ierr = PetscCalloc1(m+1,&i);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) {
+    if (oi[r] < 0 || oj[r] < 0) continue;
+    i[(oi[r]-rstart)/bs+1]++;
+  }
+  for (row=0; row<m; row++) i[row+1] += i[row];
+  ierr = PetscMalloc1(i[m],&j);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,&cnt);CHKERRQ(ierr);
+  ierr = PetscArraycpy(cnt,i,m);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) {
+    if (oi[r] < 0 || oj[r] < 0) continue;
+    row           = (oi[r]-rstart)/bs;
+    j[cnt[row]++] = oj[r]/bs;
+  }
+  ierr = PetscFree(cnt);CHKERRQ(ierr);
+  /* sort and remove duplicates in each row, compressing the column indices in place */
+  for (row=0,nz=0; row<m; row++) {
+    PetscInt len = i[row+1]-i[row];
+
+    ierr = PetscSortRemoveDupsInt(&len,j+i[row]);CHKERRQ(ierr);
+    ierr = PetscArraymove(j+nz,j+i[row],len);CHKERRQ(ierr);
+    i[row] = nz;
+    nz    += len;
+  }
+  i[m] = nz;
+  *ii  = i;
+  *jj  = j;
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatCOOSetSlots_Private - Completes the plan given the storage location of each owned COO entry
+
+   Input Parameters:
++  coo - the plan
+.  nslots - number of storage locations of the matrix
+-  slot - the storage location of each owned entry, negative for entries to be ignored
+
+   Notes:
+   The entries summed into each location are grouped with a counting sort so that the numerical phase
+   streams through the matrix storage exactly once. Within a location the entries keep their original order.
+*/
+PetscErrorCode MatCOOSetSlots_Private(Mat_COO coo,PetscInt nslots,const PetscInt slot[])
+{
+  PetscErrorCode ierr;
+  PetscInt       r,t,*pos;
+
+  PetscFunctionBegin;
+  coo->nslots = nslots;
+  ierr = PetscCalloc1(nslots+1,&coo->jmap);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) if (slot[r] >= 0) coo->jmap[slot[r]+1]++;
+  for (t=0; t<nslots; t++) coo->jmap[t+1] += coo->jmap[t];
+  ierr = PetscMalloc1(coo->jmap[nslots],&coo->perm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nslots,&pos);CHKERRQ(ierr);
+  ierr = PetscArraycpy(pos,coo->jmap,nslots);CHKERRQ(ierr);
+  for (r=0; r<coo->nown; r++) if (slot[r] >= 0) coo->perm[pos[slot[r]]++] = r;
+  ierr = PetscFree(pos);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatCOOGetValues_Private - Returns the values of the owned COO entries, communicating the off-process values if needed
+*/
+PetscErrorCode MatCOOGetValues_Private(Mat_COO coo,const PetscScalar v[],const PetscScalar **vals)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (coo->sf) {
+    ierr  = PetscSFReduceBegin(coo->sf,MPIU_SCALAR,v,coo->buf,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr  = PetscSFReduceEnd(coo->sf,MPIU_SCALAR,v,coo->buf,MPIU_REPLACE);CHKERRQ(ierr);
+    *vals = coo->buf;
+  } else *vals = v;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatCOODestroy_Private(Mat_COO *coo)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*coo) PetscFunctionReturn(0);
+  ierr = PetscSFDestroy(&(*coo)->sf);CHKERRQ(ierr);
+  ierr = PetscFree((*coo)->buf);CHKERRQ(ierr);
+  ierr = PetscFree((*coo)->jmap);CHKERRQ(ierr);
+  ierr = PetscFree((*coo)->perm);CHKERRQ(ierr);
+  ierr = PetscFree(*coo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+typedef struct {
+  PetscInt n,*i,*j;
+} MatCOO_Basic;
+
+static PetscErrorCode MatCOODestroy_Basic(void *ctx)
+{
+  MatCOO_Basic   *basic = (MatCOO_Basic*)ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(basic->i,basic->j);CHKERRQ(ierr);
+  ierr = PetscFree(basic);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetPreallocationCOO_Basic(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode ierr;
+  PetscContainer container;
+  MatCOO_Basic   *basic;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&basic);CHKERRQ(ierr);
+  basic->n = n;
+  ierr = PetscMalloc2(n,&basic->i,n,&basic->j);CHKERRQ(ierr);
+  ierr = PetscArraycpy(basic->i,coo_i,n);CHKERRQ(ierr);
+  ierr = PetscArraycpy(basic->j,coo_j,n);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,basic);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatCOODestroy_Basic);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)A,"__PETSc_MatCOO_Basic",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_Basic(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  PetscErrorCode ierr;
+  PetscContainer container;
+  MatCOO_Basic   *basic;
+  PetscInt       k;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)A,"__PETSc_MatCOO_Basic",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ORDER,"Must call MatSetPreallocationCOO() first");
+  ierr = PetscContainerGetPointer(container,(void**)&basic);CHKERRQ(ierr);
+  if (imode == INSERT_VALUES && A->assembled) {ierr = MatZeroEntries(A);CHKERRQ(ierr);}
+  for (k=0; k<basic->n; k++) {
+    ierr = MatSetValue(A,basic->i[k],basic->j[k],v[k],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSetPreallocationCOO - set the nonzero structure of a matrix from a list of entries in coordinate (COO) format
+
+   Collective on Mat
+
+   Input Parameters:
++  A - the matrix, with its sizes and type set
+.  n - number of COO entries provided on this process
+.  coo_i - global row indices of the entries
+-  coo_j - global column indices of the entries
+
+   Notes:
+   Entries may be repeated and may belong to rows owned by other processes. Entries with a negative row or
+   column index are ignored. The matrix nonzero structure is exactly the set of distinct entries provided
+   by all processes; any previous preallocation and values are discarded.
+
+   For MATSEQAIJ, MATMPIAIJ, MATSEQBAIJ and MATMPIBAIJ this routine also builds the map from the COO entries
+   to the matrix storage and the communication pattern of the off-process entries, so that
+   MatSetValuesCOO() does not search, stash or sort. For the BAIJ formats the indices are point (not block)
+   indices and the block size of the matrix is used. Other matrix types fall back to MatSetValues().
+
+   The arrays coo_i and coo_j are copied as needed and can be freed after this call.
+
+   The options MAT_NEW_NONZERO_LOCATIONS, MAT_NEW_NONZERO_LOCATION_ERR and MAT_NEW_NONZERO_ALLOCATION_ERR set on the matrix
+   are kept, they only apply to later calls of MatSetValues() outside the COO nonzero structure.
+
+   Level: beginner
+
+.seealso: MatSetValuesCOO(), MatSeqAIJSetPreallocation(), MatMPIAIJSetPreallocation(), MatSeqBAIJSetPreallocation(),
+          MatMPIBAIJSetPreallocation(), MatSeqAIJSetPreallocationCSR()
+@*/
+PetscErrorCode MatSetPreallocationCOO(Mat A,PetscInt n,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode ierr,(*f)(Mat,PetscInt,const PetscInt[],const PetscInt[]) = NULL;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  if (n) PetscValidIntPointer(coo_i,3);
+  if (n) PetscValidIntPointer(coo_j,4);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of COO entries cannot be negative %D",n);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetPreallocationCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,n,coo_i,coo_j);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetPreallocationCOO_Basic(A,n,coo_i,coo_j);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSetValuesCOO - set values of the entries given to MatSetPreallocationCOO()
+
+   Collective on Mat
+
+   Input Parameters:
++  A - the matrix
+.  v - the values, in the same order as the indices given to MatSetPreallocationCOO()
+-  imode - INSERT_VALUES to replace the matrix values, ADD_VALUES to add to them
+
+   Notes:
+   Values of repeated entries are summed, also with INSERT_VALUES. The matrix is assembled on return,
+   there is no need to call MatAssemblyBegin() and MatAssemblyEnd().
+
+   Level: beginner
+
+.seealso: MatSetPreallocationCOO(), MatSetValues()
+@*/
+PetscErrorCode MatSetValuesCOO(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  PetscErrorCode ierr,(*f)(Mat,const PetscScalar[],InsertMode) = NULL;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONG,"Only INSERT_VALUES and ADD_VALUES are supported");
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetValuesCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_SetValuesCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,v,imode);CHKERRQ(ierr);
+    ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetValuesCOO_Basic(A,v,imode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_SetValuesCOO,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -28,6 +28,7 @@ typedef struct {
   PetscInt       debug;             /* The debugging level */
   RunType        runType;           /* Whether to run tests, or solve the full problem */
   PetscBool      jacobianMF;        /* Whether to calculate the Jacobian action on the fly */
+  PetscBool      batch;             /* Whether to use the batched pointwise functions */
   PetscLogEvent  createMeshEvent;
   PetscBool      showInitial, showSolution, restart, quiet, nonzInit;
   /* Domain and mesh definition */
@@ -362,6 +363,47 @@ void g3_analytic_nonlinear_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
   }
 }
 
+/* The same functions for a batch of Np points, in struct-of-arrays layout: component i of point p is stored in entry i*Np+p */
+static void f0_analytic_nonlinear_u_batch(PetscInt dim, PetscInt Nf, PetscInt NfAux, PetscInt Np,
+                                          const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                                          const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                                          PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+{
+  PetscInt p;
+  for (p = 0; p < Np; ++p) f0[p] = 16.0*(x[p]*x[p] + x[Np+p]*x[Np+p]);
+}
+
+static void f1_analytic_nonlinear_u_batch(PetscInt dim, PetscInt Nf, PetscInt NfAux, PetscInt Np,
+                                          const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                                          const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                                          PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f1[])
+{
+  PetscInt d, p;
+  for (p = 0; p < Np; ++p) {
+    PetscScalar nu = 0.0;
+    for (d = 0; d < dim; ++d) nu += u_x[d*Np+p]*u_x[d*Np+p];
+    for (d = 0; d < dim; ++d) f1[d*Np+p] = 0.5*nu*u_x[d*Np+p];
+  }
+}
+
+static void g3_analytic_nonlinear_uu_batch(PetscInt dim, PetscInt Nf, PetscInt NfAux, PetscInt Np,
+                                           const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                                           const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                                           PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  PetscInt d, e, p;
+  for (p = 0; p < Np; ++p) {
+    PetscScalar nu = 0.0;
+    for (d = 0; d < dim; ++d) nu += u_x[d*Np+p]*u_x[d*Np+p];
+    for (d = 0; d < dim; ++d) {
+      g3[(d*dim+d)*Np+p] = 0.5*nu;
+      for (e = 0; e < dim; ++e) {
+        g3[(d*dim+e)*Np+p] += u_x[d*Np+p]*u_x[e*Np+p];
+      }
+    }
+  }
+}
+
 /*
   In 3D for Dirichlet conditions we use exact solution:
 
@@ -433,6 +475,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->variableCoefficient = COEFF_NONE;
   options->fieldBC             = PETSC_FALSE;
   options->jacobianMF          = PETSC_FALSE;
+  options->batch               = PETSC_FALSE;
   options->showInitial         = PETSC_FALSE;
   options->showSolution        = PETSC_FALSE;
   options->restart             = PETSC_FALSE;
@@ -473,6 +516,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
 
   ierr = PetscOptionsBool("-field_bc", "Use a field representation for the BC", "ex12.c", options->fieldBC, &options->fieldBC, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-jacobian_mf", "Calculate the action of the Jacobian on the fly", "ex12.c", options->jacobianMF, &options->jacobianMF, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-batch", "Use the batched pointwise functions for the nonlinear coefficient", "ex12.c", options->batch, &options->batch, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-show_initial", "Output the initial guess for verification", "ex12.c", options->showInitial, &options->showInitial, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-show_solution", "Output the solution for verification", "ex12.c", options->showSolution, &options->showSolution, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-restart", "Read in the mesh and solution from a file", "ex12.c", options->restart, &options->restart, NULL);CHKERRQ(ierr);
@@ -655,6 +699,10 @@ static PetscErrorCode SetupProblem(DM dm, AppCtx *user)
   case COEFF_NONLINEAR:
     ierr = PetscDSSetResidual(prob, 0, f0_analytic_nonlinear_u, f1_analytic_nonlinear_u);CHKERRQ(ierr);
     ierr = PetscDSSetJacobian(prob, 0, 0, NULL, NULL, NULL, g3_analytic_nonlinear_uu);CHKERRQ(ierr);
+    if (user->batch) {
+      ierr = PetscDSSetResidualBatch(prob, 0, f0_analytic_nonlinear_u_batch, f1_analytic_nonlinear_u_batch);CHKERRQ(ierr);
+      ierr = PetscDSSetJacobianBatch(prob, 0, 0, NULL, NULL, NULL, g3_analytic_nonlinear_uu_batch);CHKERRQ(ierr);
+    }
     break;
   case COEFF_CIRCLE:
     ierr = PetscDSSetResidual(prob, 0, f0_circle_u, f1_u);CHKERRQ(ierr);
@@ -941,7 +989,6 @@ int main(int argc, char **argv)
   Mat            A,J;         /* Jacobian matrix */
   MatNullSpace   nullSpace;   /* May be necessary for Neumann conditions */
   AppCtx         user;        /* user-defined work context */
-  JacActionCtx   userJ;       /* context for Jacobian MF action */
   PetscReal      error = 0.0; /* L_2 error in the solution */
   PetscBool      isFAS;
   PetscErrorCode ierr;
@@ -961,26 +1008,7 @@ int main(int argc, char **argv)
 
   ierr = DMCreateMatrix(dm, &J);CHKERRQ(ierr);
   if (user.jacobianMF) {
-    PetscInt M, m, N, n;
-
-    ierr = MatGetSize(J, &M, &N);CHKERRQ(ierr);
-    ierr = MatGetLocalSize(J, &m, &n);CHKERRQ(ierr);
-    ierr = MatCreate(PETSC_COMM_WORLD, &A);CHKERRQ(ierr);
-    ierr = MatSetSizes(A, m, n, M, N);CHKERRQ(ierr);
-    ierr = MatSetType(A, MATSHELL);CHKERRQ(ierr);
-    ierr = MatSetUp(A);CHKERRQ(ierr);
-#if 0
-    ierr = MatShellSetOperation(A, MATOP_MULT, (void (*)(void))FormJacobianAction);CHKERRQ(ierr);
-#endif
-
-    userJ.dm   = dm;
-    userJ.J    = J;
-    userJ.user = &user;
-
-    ierr = DMCreateLocalVector(dm, &userJ.u);CHKERRQ(ierr);
-    if (user.fieldBC) {ierr = DMProjectFieldLocal(dm, 0.0, userJ.u, user.exactFields, INSERT_BC_VALUES, userJ.u);CHKERRQ(ierr);}
-    else              {ierr = DMProjectFunctionLocal(dm, 0.0, user.exactFuncs, NULL, INSERT_BC_VALUES, userJ.u);CHKERRQ(ierr);}
-    ierr = MatShellSetContext(A, &userJ);CHKERRQ(ierr);
+    ierr = DMPlexSNESCreateJacobianMF(dm, &user, &A);CHKERRQ(ierr);
   } else {
     A = J;
   }
@@ -1128,7 +1156,6 @@ int main(int argc, char **argv)
   }
 
   if (user.bcType == NEUMANN) {ierr = MatNullSpaceDestroy(&nullSpace);CHKERRQ(ierr);}
-  if (user.jacobianMF) {ierr = VecDestroy(&userJ.u);CHKERRQ(ierr);}
   if (A != J) {ierr = MatDestroy(&A);CHKERRQ(ierr);}
   ierr = MatDestroy(&J);CHKERRQ(ierr);
   ierr = VecDestroy(&u);CHKERRQ(ierr);
@@ -1538,6 +1565,32 @@ int main(int argc, char **argv)
       suffix: quad_bddc_viennacl
       args: -matis_localmat_type aijviennacl
 
+  # Full solve tensor: matrix-free sum factorized Jacobian
+  test:
+    suffix: hex_tensor_mf
+    requires: !single
+    nsize: 2
+    args: -run_type full -dim 3 -simplex 0 -cells 2,2,2 -interpolate 1 -bc_type dirichlet -variable_coefficient nonlinear -petscspace_degree 2 -petscspace_poly_tensor -petscfe_type tensor -jacobian_mf -pc_type jacobi -ksp_rtol 1.0e-10 -snes_monitor_short -snes_converged_reason -show_solution 0
+
+  # Full solve tensor: batched pointwise functions
+  test:
+    suffix: quad_batch
+    requires: !single
+    args: -run_type full -simplex 0 -cells 3,3 -interpolate 1 -bc_type dirichlet -variable_coefficient nonlinear -petscspace_degree 2 -petscspace_poly_tensor -nonzero_initial_guess 1 -batch -petscfe_num_blocks 2 -petscfe_num_batches 2 -pc_type lu -snes_monitor_short -snes_converged_reason -show_solution 0
+
+  # Full solve tensor: cached closure dof indices
+  test:
+    suffix: quad_closure_cache
+    requires: !single
+    nsize: 2
+    args: -run_type full -simplex 0 -cells 3,3 -dm_refine 1 -interpolate 1 -bc_type dirichlet -variable_coefficient nonlinear -nonzero_initial_guess 1 -petscspace_degree 2 -petscspace_poly_tensor -ksp_rtol 1.0e-10 -snes_monitor_short -snes_converged_reason -show_solution 0 -dm_plex_closure_cache
+  test:
+    suffix: quad_hilbert
+    requires: !single
+    nsize: 2
+    args: -run_type full -simplex 0 -cells 3,3 -dm_refine 1 -interpolate 1 -bc_type dirichlet -variable_coefficient nonlinear -nonzero_initial_guess 1 -petscspace_degree 2 -petscspace_poly_tensor -ksp_rtol 1.0e-10 -snes_monitor_short -snes_converged_reason -show_solution 0 -dm_plex_reorder hilbert
+    output_file: output/ex12_quad_closure_cache.out
+
   # Full solve simplex: ASM
   test:
     suffix: tri_q2q1_asm_lu
@@ -1911,6 +1911,13 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
   ierr = PetscDSGetTotalDimension(prob, &totDim);CHKERRQ(ierr);
   ierr = PetscDSHasJacobian(prob, &hasJac);CHKERRQ(ierr);
   ierr = PetscDSHasJacobianPreconditioner(prob, &hasPrec);CHKERRQ(ierr);
+  if (hasJac && hasPrec) {
+    PetscErrorCode (*setbase)(Mat, Vec);
+
+    /* A matrix-free Jacobian is not assembled, only the preconditioner is */
+    ierr = PetscObjectQueryFunction((PetscObject) Jac, "DMPlexSNESJacobianMFSetBase_C", &setbase);CHKERRQ(ierr);
+    if (setbase) hasJac = PETSC_FALSE;
+  }
   ierr = PetscDSHasDynamicJacobian(prob, &hasDyn);CHKERRQ(ierr);
   hasDyn = hasDyn && (X_tShift != 0.0) ? PETSC_TRUE : PETSC_FALSE;
   ierr = PetscSectionGetNumFields(section, &Nf);CHKERRQ(ierr);
@@ -2123,11 +2130,12 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
 
   Note:
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
-  like a GPU, or vectorize on a multicore machine.
+  like a GPU, or vectorize on a multicore machine. If all fields are discretized with a PetscFE that provides
+  PetscFEIntegrateJacobianAction(), such as PETSCFETENSOR, the element Jacobians are applied without being formed.
 
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), DMPlexSNESCreateJacobianMF()
 @*/
 PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscReal X_tShift, Vec X, Vec X_t, Vec Y, Vec Z, void *user)
 {
@@ -2138,12 +2146,12 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
   PetscDS           prob, probAux = NULL;
   PetscQuadrature   quad;
   PetscSection      section, globalSection, sectionAux;
-  PetscScalar      *elemMat, *elemMatD, *u, *u_t, *a = NULL, *y, *z;
+  PetscScalar      *elemMat, *elemMatD, *u, *u_t, *a = NULL, *y, *yD, *z;
   PetscInt          Nf, fieldI, fieldJ;
   PetscInt          totDim, totDimAux = 0;
   const PetscInt   *cells;
   PetscInt          cStart, cEnd, numCells, c;
-  PetscBool         hasDyn;
+  PetscBool         hasDyn, useAction = PETSC_TRUE;
   DMField           coordField;
   PetscErrorCode    ierr;
 
@@ -2176,8 +2184,19 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = DMGetDS(dmAux, &probAux);CHKERRQ(ierr);
     ierr = PetscDSGetTotalDimension(probAux, &totDimAux);CHKERRQ(ierr);
   }
+  /* Apply the element Jacobians without forming them if every discretization can */
+  for (fieldI = 0; fieldI < Nf; ++fieldI) {
+    PetscObject obj;
+
+    ierr = PetscDSGetDiscretization(prob, fieldI, &obj);CHKERRQ(ierr);
+    if (obj->classid != PETSCFE_CLASSID || !((PetscFE) obj)->ops->integratejacobianaction) useAction = PETSC_FALSE;
+  }
   ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
-  ierr = PetscMalloc6(numCells*totDim,&u,X_t ? numCells*totDim : 0,&u_t,numCells*totDim*totDim,&elemMat,hasDyn ? numCells*totDim*totDim : 0, &elemMatD,numCells*totDim,&y,totDim,&z);CHKERRQ(ierr);
+  if (useAction) {
+    ierr = PetscMalloc6(numCells*totDim,&u,X_t ? numCells*totDim : 0,&u_t,0,&elemMat,0,&elemMatD,numCells*totDim,&y,numCells*totDim,&z);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMalloc6(numCells*totDim,&u,X_t ? numCells*totDim : 0,&u_t,numCells*totDim*totDim,&elemMat,hasDyn ? numCells*totDim*totDim : 0, &elemMatD,numCells*totDim,&y,totDim,&z);CHKERRQ(ierr);
+  }
   if (dmAux) {ierr = PetscMalloc1(numCells*totDimAux, &a);CHKERRQ(ierr);}
   ierr = DMGetCoordinateField(dm, &coordField);CHKERRQ(ierr);
   for (c = cStart; c < cEnd; ++c) {
@@ -2205,8 +2224,17 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     for (i = 0; i < totDim; ++i) y[cind*totDim+i] = x[i];
     ierr = DMPlexVecRestoreClosure(dm, section, Y, cell, NULL, &x);CHKERRQ(ierr);
   }
-  ierr = PetscArrayzero(elemMat, numCells*totDim*totDim);CHKERRQ(ierr);
-  if (hasDyn)  {ierr = PetscArrayzero(elemMatD, numCells*totDim*totDim);CHKERRQ(ierr);}
+  if (useAction) {
+    ierr = PetscArrayzero(z, numCells*totDim);CHKERRQ(ierr);
+    if (hasDyn) {
+      /* The action is linear in Y, so we scale Y instead of the dynamic Jacobian */
+      ierr = PetscMalloc1(numCells*totDim, &yD);CHKERRQ(ierr);
+      for (c = 0; c < numCells*totDim; ++c) yD[c] = X_tShift*y[c];
+    }
+  } else {
+    ierr = PetscArrayzero(elemMat, numCells*totDim*totDim);CHKERRQ(ierr);
+    if (hasDyn)  {ierr = PetscArrayzero(elemMatD, numCells*totDim*totDim);CHKERRQ(ierr);}
+  }
   for (fieldI = 0; fieldI < Nf; ++fieldI) {
     PetscFE  fe;
     PetscInt Nb;
@@ -2240,6 +2268,15 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = PetscFEGeomGetChunk(cgeomFEM,0,offset,&chunkGeom);CHKERRQ(ierr);
     ierr = PetscFEGeomGetChunk(cgeomFEM,offset,numCells,&remGeom);CHKERRQ(ierr);
     for (fieldJ = 0; fieldJ < Nf; ++fieldJ) {
+      if (useAction) {
+        ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, y, probAux, a, t, X_tShift, z);CHKERRQ(ierr);
+        ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, &y[offset*totDim], probAux, &a[offset*totDimAux], t, X_tShift, &z[offset*totDim]);CHKERRQ(ierr);
+        if (hasDyn) {
+          ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN_DYN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, yD, probAux, a, t, X_tShift, z);CHKERRQ(ierr);
+          ierr = PetscFEIntegrateJacobianAction(prob, PETSCFE_JACOBIAN_DYN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, &yD[offset*totDim], probAux, &a[offset*totDimAux], t, X_tShift, &z[offset*totDim]);CHKERRQ(ierr);
+        }
+        continue;
+      }
       ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Ne, chunkGeom, u, u_t, probAux, a, t, X_tShift, elemMat);CHKERRQ(ierr);
       ierr = PetscFEIntegrateJacobian(prob, PETSCFE_JACOBIAN, fieldI, fieldJ, Nr, remGeom, &u[offset*totDim], u_t ? &u_t[offset*totDim] : NULL, probAux, &a[offset*totDimAux], t, X_tShift, &elemMat[offset*totDim*totDim]);CHKERRQ(ierr);
       if (hasDyn) {
@@ -2252,22 +2289,36 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
     ierr = DMSNESRestoreFEGeom(coordField,cellIS,qGeom,PETSC_FALSE,&cgeomFEM);CHKERRQ(ierr);
     ierr = PetscQuadratureDestroy(&qGeom);CHKERRQ(ierr);
   }
-  if (hasDyn) {
-    for (c = 0; c < numCells*totDim*totDim; ++c) elemMat[c] += X_tShift*elemMatD[c];
-  }
-  for (c = cStart; c < cEnd; ++c) {
-    const PetscInt     cell = cells ? cells[c] : c;
-    const PetscInt     cind = c - cStart;
-    const PetscBLASInt M = totDim, one = 1;
-    const PetscScalar  a = 1.0, b = 0.0;
-
-    PetscStackCallBLAS("BLASgemv", BLASgemv_("N", &M, &M, &a, &elemMat[cind*totDim*totDim], &M, &y[cind*totDim], &one, &b, z, &one));
-    if (mesh->printFEM > 1) {
-      ierr = DMPrintCellMatrix(c, name, totDim, totDim, &elemMat[cind*totDim*totDim]);CHKERRQ(ierr);
-      ierr = DMPrintCellVector(c, "Y",  totDim, &y[cind*totDim]);CHKERRQ(ierr);
-      ierr = DMPrintCellVector(c, "Z",  totDim, z);CHKERRQ(ierr);
+  if (useAction) {
+    for (c = cStart; c < cEnd; ++c) {
+      const PetscInt cell = cells ? cells[c] : c;
+      const PetscInt cind = c - cStart;
+
+      if (mesh->printFEM > 1) {
+        ierr = DMPrintCellVector(c, "Y",  totDim, &y[cind*totDim]);CHKERRQ(ierr);
+        ierr = DMPrintCellVector(c, "Z",  totDim, &z[cind*totDim]);CHKERRQ(ierr);
+      }
+      ierr = DMPlexVecSetClosure(dm, section, Z, cell, &z[cind*totDim], ADD_VALUES);CHKERRQ(ierr);
+    }
+    if (hasDyn) {ierr = PetscFree(yD);CHKERRQ(ierr);}
+  } else {
+    if (hasDyn) {
+      for (c = 0; c < numCells*totDim*totDim; ++c) elemMat[c] += X_tShift*elemMatD[c];
+    }
+    for (c = cStart; c < cEnd; ++c) {
+      const PetscInt     cell = cells ? cells[c] : c;
+      const PetscInt     cind = c - cStart;
+      const PetscBLASInt M = totDim, one = 1;
+      const PetscScalar  a = 1.0, b = 0.0;
+
+      PetscStackCallBLAS("BLASgemv", BLASgemv_("N", &M, &M, &a, &elemMat[cind*totDim*totDim], &M, &y[cind*totDim], &one, &b, z, &one));
+      if (mesh->printFEM > 1) {
+        ierr = DMPrintCellMatrix(c, name, totDim, totDim, &elemMat[cind*totDim*totDim]);CHKERRQ(ierr);
+        ierr = DMPrintCellVector(c, "Y",  totDim, &y[cind*totDim]);CHKERRQ(ierr);
+        ierr = DMPrintCellVector(c, "Z",  totDim, z);CHKERRQ(ierr);
+      }
+      ierr = DMPlexVecSetClosure(dm, section, Z, cell, z, ADD_VALUES);CHKERRQ(ierr);
     }
-    ierr = DMPlexVecSetClosure(dm, section, Z, cell, z, ADD_VALUES);CHKERRQ(ierr);
   }
   ierr = PetscFree6(u,u_t,elemMat,elemMatD,y,z);CHKERRQ(ierr);
   if (mesh->printFEM) {
@@ -2297,9 +2348,11 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
   like a GPU, or vectorize on a multicore machine.
 
+  If Jac was created with DMPlexSNESCreateJacobianMF(), it only records X, and JacP is assembled unless it is Jac.
+
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), DMPlexSNESCreateJacobianMF()
 @*/
 PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void *user)
 {
@@ -2308,6 +2361,7 @@ PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void
   IS             cellIS;
   PetscBool      hasJac, hasPrec;
   PetscInt       depth;
+  PetscErrorCode (*setbase)(Mat, Vec);
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -2318,14 +2372,118 @@ PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void
   ierr = DMGetDS(dm, &prob);CHKERRQ(ierr);
   ierr = PetscDSHasJacobian(prob, &hasJac);CHKERRQ(ierr);
   ierr = PetscDSHasJacobianPreconditioner(prob, &hasPrec);CHKERRQ(ierr);
-  if (hasJac && hasPrec) {ierr = MatZeroEntries(Jac);CHKERRQ(ierr);}
-  ierr = MatZeroEntries(JacP);CHKERRQ(ierr);
-  ierr = DMPlexComputeJacobian_Internal(plex, cellIS, 0.0, 0.0, X, NULL, Jac, JacP, user);CHKERRQ(ierr);
+  /* A matrix-free Jacobian only needs the new linearization point */
+  ierr = PetscObjectQueryFunction((PetscObject) Jac, "DMPlexSNESJacobianMFSetBase_C", &setbase);CHKERRQ(ierr);
+  if (setbase) {ierr = (*setbase)(Jac, X);CHKERRQ(ierr);}
+  else if (hasJac && hasPrec) {ierr = MatZeroEntries(Jac);CHKERRQ(ierr);}
+  if (!setbase || Jac != JacP) {
+    ierr = MatZeroEntries(JacP);CHKERRQ(ierr);
+    ierr = DMPlexComputeJacobian_Internal(plex, cellIS, 0.0, 0.0, X, NULL, Jac, JacP, user);CHKERRQ(ierr);
+  }
   ierr = ISDestroy(&cellIS);CHKERRQ(ierr);
   ierr = DMDestroy(&plex);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatMult_DMPlexSNESJacobianMF(Mat J, Vec Y, Vec Z)
+{
+  JacActionCtx  *ctx;
+  Vec            locY, locZ;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &ctx);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(ctx->dm, &locY);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(ctx->dm, &locZ);CHKERRQ(ierr);
+  /* Constrained dofs are not perturbed */
+  ierr = VecSet(locY, 0.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(ctx->dm, Y, INSERT_VALUES, locY);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(ctx->dm, Y, INSERT_VALUES, locY);CHKERRQ(ierr);
+  ierr = DMPlexComputeJacobianAction(ctx->dm, NULL, 0.0, 0.0, ctx->u, NULL, locY, locZ, ctx->user);CHKERRQ(ierr);
+  ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(ctx->dm, locZ, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(ctx->dm, locZ, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(ctx->dm, &locY);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(ctx->dm, &locZ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_DMPlexSNESJacobianMF(Mat J)
+{
+  JacActionCtx  *ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &ctx);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject) J, "DMPlexSNESJacobianMFSetBase_C", NULL);CHKERRQ(ierr);
+  ierr = VecDestroy(&ctx->u);CHKERRQ(ierr);
+  ierr = DMDestroy(&ctx->dm);CHKERRQ(ierr);
+  ierr = PetscFree(ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexSNESJacobianMFSetBase_Plex(Mat J, Vec X)
+{
+  JacActionCtx  *ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &ctx);CHKERRQ(ierr);
+  ierr = VecCopy(X, ctx->u);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexSNESCreateJacobianMF - Create a matrix-free Jacobian for the pointwise FEM functions of a DMPlex
+
+  Collective on dm
+
+  Input Parameters:
++ dm   - The mesh
+- user - The user context passed to the pointwise functions
+
+  Output Parameter:
+. J - The Jacobian, a MATSHELL
+
+  Notes:
+  The matrix applies the Jacobian at the last point given to DMPlexSNESComputeJacobianFEM() using DMPlexComputeJacobianAction(),
+  so it is never assembled. Pass it to SNESSetJacobian() along with an assembled preconditioning matrix, or as both matrices if
+  the preconditioner does not need the entries. With PETSCFETENSOR discretizations, the action is computed by sum factorization.
+
+  Boundary terms of the Jacobian are not included in the action.
+
+  Level: intermediate
+
+.seealso: DMPlexSNESComputeJacobianFEM(), DMPlexComputeJacobianAction(), DMPlexSetSNESLocalFEM(), PETSCFETENSOR
+@*/
+PetscErrorCode DMPlexSNESCreateJacobianMF(DM dm, void *user, Mat *J)
+{
+  JacActionCtx  *ctx;
+  Vec            u;
+  PetscInt       m, M, bs;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidPointer(J, 3);
+  ierr = PetscNew(&ctx);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject) dm);CHKERRQ(ierr);
+  ctx->dm   = dm;
+  ctx->user = user;
+  ierr = DMCreateLocalVector(dm, &ctx->u);CHKERRQ(ierr);
+  ierr = DMGetGlobalVector(dm, &u);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(u, &m);CHKERRQ(ierr);
+  ierr = VecGetSize(u, &M);CHKERRQ(ierr);
+  ierr = VecGetBlockSize(u, &bs);CHKERRQ(ierr);
+  ierr = DMRestoreGlobalVector(dm, &u);CHKERRQ(ierr);
+  ierr = MatCreateShell(PetscObjectComm((PetscObject) dm), m, m, M, M, ctx, J);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(*J, bs);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_MULT, (void (*)(void)) MatMult_DMPlexSNESJacobianMF);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_DESTROY, (void (*)(void)) MatDestroy_DMPlexSNESJacobianMF);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject) *J, "DMPlexSNESJacobianMFSetBase_C", DMPlexSNESJacobianMFSetBase_Plex);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMPlexSetSNESLocalFEM - Use DMPlex's internal FEM routines to compute SNES boundary values, residual, and Jacobian.
 
@@ -15,6 +15,9 @@ typedef struct  {
   MPI_File      mfdes;                /* ignored unless using MPI IO */
   MPI_File      mfsub;                /* subviewer support */
   MPI_Offset    moff;
+  PetscInt      aggrpernode;          /* number of aggregator ranks per node for PetscViewerBinaryWriteAllMPIIO(), 0 to let MPI_File_write_all() decide */
+  PetscInt      stripesize;           /* size in bytes of the file stripes written by each aggregator */
+  PetscMPIInt   naggr,*aggr;          /* ranks acting as aggregators, computed on first use */
 #endif
   PetscFileMode btype;                /* read or write? */
   FILE          *fdes_info;           /* optional file containing info on binary file*/
@@ -745,6 +748,7 @@ static PetscErrorCode PetscViewerDestroy_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   if (vbinary->usempiio) {
     ierr = PetscViewerFileClose_BinaryMPIIO(v);CHKERRQ(ierr);
+    ierr = PetscFree(vbinary->aggr);CHKERRQ(ierr);
   } else {
 #endif
     ierr = PetscViewerFileClose_Binary(v);CHKERRQ(ierr);
@@ -842,6 +846,279 @@ static PetscErrorCode PetscViewerBinaryWriteReadMPIIO(PetscViewer viewer,void *d
   if (count) *count = cnt;
   PetscFunctionReturn(0);
 }
+
+/* Pick the aggregators: the first aggrpernode ranks of each node, in rank order. Collective */
+static PetscErrorCode PetscViewerBinaryMPIIOSetUpAggregators_Private(PetscViewer viewer)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  MPI_Comm           comm = PetscObjectComm((PetscObject)viewer);
+  PetscErrorCode     ierr;
+  PetscMPIInt        rank,size,lrank,isaggr,*flags,i;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscShmComm       pshmcomm;
+  MPI_Comm           shmcomm;
+#endif
+
+  PetscFunctionBegin;
+  if (vbinary->aggr) PetscFunctionReturn(0);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(shmcomm,&lrank);CHKERRQ(ierr);
+#else
+  lrank = rank; /* cannot tell the nodes apart, treat the communicator as a single node */
+#endif
+  isaggr = (lrank < vbinary->aggrpernode) ? 1 : 0;
+  ierr = PetscMalloc1(size,&flags);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&isaggr,1,MPI_INT,flags,1,MPI_INT,comm);CHKERRQ(ierr);
+  for (vbinary->naggr=0,i=0; i<size; i++) vbinary->naggr += flags[i];
+  ierr = PetscMalloc1(vbinary->naggr,&vbinary->aggr);CHKERRQ(ierr);
+  for (vbinary->naggr=0,i=0; i<size; i++) if (flags[i]) vbinary->aggr[vbinary->naggr++] = i;
+  ierr = PetscFree(flags);CHKERRQ(ierr);
+  ierr = PetscInfo3(viewer,"Using %d MPI-IO aggregators (%D per node) with stripes of %D bytes\n",vbinary->naggr,vbinary->aggrpernode,vbinary->stripesize);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Two-phase transfer of a distributed array stored contiguously in the file at the current offset.
+
+   Each rank owns the bytes [lstart,lstart+lbytes) of the array, and the ranks own consecutive pieces in rank order. The file
+   region is cut into stripes aligned on multiples of the stripe size, stripe k going to aggregator k % naggr. At each round
+   every aggregator handles one stripe: when writing it receives the pieces of the stripe from their owners and writes the
+   stripe with a single call, when reading it reads the stripe and sends the pieces to their owners. An aggregator therefore
+   never holds more than one stripe, and the file system only sees large aligned requests.
+*/
+static PetscErrorCode PetscViewerBinaryMPIIOAggregate_Private(PetscViewer viewer,char *data,PetscInt64 lstart,PetscInt64 lbytes,PetscInt64 total,PetscBool write)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  MPI_Comm           comm = PetscObjectComm((PetscObject)viewer);
+  MPI_File           mfdes = vbinary->mfdes;
+  PetscMPIInt        rank,size,tag = ((PetscObject)viewer)->tag,cnt,nreq,p,a,lo,hi,mid;
+  PetscInt64         stripe = vbinary->stripesize,base = (PetscInt64)vbinary->moff,first,nstripes,r,k,slo,shi,mylo = 0,myhi = 0,olo,ohi,mine[2],*owned;
+  char               *sbuf = NULL;
+  MPI_Request        *reqs;
+  MPI_Status         status;
+  PetscBool          isaggr,have;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (!total) PetscFunctionReturn(0);
+  ierr = PetscViewerBinaryMPIIOSetUpAggregators_Private(viewer);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+
+  /* Gather the piece owned by each rank */
+  mine[0] = lstart; mine[1] = lbytes;
+  ierr = PetscMalloc1(2*size,&owned);CHKERRQ(ierr);
+  ierr = MPI_Allgather(mine,2,MPIU_INT64,owned,2,MPIU_INT64,comm);CHKERRQ(ierr);
+  for (p=0; p<size; p++) {
+    if (owned[2*p] != (p ? owned[2*(p-1)] + owned[2*(p-1)+1] : 0)) SETERRQ1(comm,PETSC_ERR_ARG_WRONG,"Rank %d does not own the piece of the array following the one of the previous rank",p);
+  }
+  if (owned[2*(size-1)] + owned[2*(size-1)+1] != total) SETERRQ(comm,PETSC_ERR_ARG_SIZ,"Sum of the local sizes does not match the global size");
+
+  for (isaggr=PETSC_FALSE,a=0; a<vbinary->naggr; a++) if (vbinary->aggr[a] == rank) isaggr = PETSC_TRUE;
+  if (isaggr) {ierr = PetscMalloc1(stripe,&sbuf);CHKERRQ(ierr);}
+  ierr = PetscMalloc1(vbinary->naggr+size,&reqs);CHKERRQ(ierr);
+
+  /* Offsets below are absolute and in bytes */
+  ierr = MPI_File_set_view(mfdes,0,MPI_BYTE,MPI_BYTE,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+  first    = base/stripe;
+  nstripes = (base+total-1)/stripe - first + 1;
+  for (r=0; r<nstripes; r+=vbinary->naggr) {
+    nreq = 0;
+    have = PETSC_FALSE;
+    for (a=0; a<vbinary->naggr && r+a<nstripes; a++) {
+      k   = first+r+a;
+      slo = PetscMax(k*stripe-base,0);
+      shi = PetscMin((k+1)*stripe-base,total);
+      /* My piece of the stripe */
+      olo = PetscMax(slo,lstart);
+      ohi = PetscMin(shi,lstart+lbytes);
+      if (ohi > olo) {
+        ierr = PetscMPIIntCast(ohi-olo,&cnt);CHKERRQ(ierr);
+        if (write) {ierr = MPI_Isend(data+(olo-lstart),cnt,MPI_BYTE,vbinary->aggr[a],tag,comm,&reqs[nreq++]);CHKERRQ(ierr);}
+        else       {ierr = MPI_Irecv(data+(olo-lstart),cnt,MPI_BYTE,vbinary->aggr[a],tag,comm,&reqs[nreq++]);CHKERRQ(ierr);}
+      }
+      if (vbinary->aggr[a] == rank) {have = PETSC_TRUE; mylo = slo; myhi = shi;}
+    }
+    if (have) {
+      ierr = PetscMPIIntCast(myhi-mylo,&cnt);CHKERRQ(ierr);
+      if (!write) {ierr = MPI_File_read_at(mfdes,(MPI_Offset)(base+mylo),sbuf,cnt,MPI_BYTE,&status);CHKERRQ(ierr);}
+      /* Find the first rank owning part of my stripe, then exchange with the owners */
+      lo = 0; hi = size-1;
+      while (lo < hi) {
+        mid = lo + (hi-lo)/2;
+        if (owned[2*mid]+owned[2*mid+1] <= mylo) lo = mid+1;
+        else hi = mid;
+      }
+      for (p=lo; p<size && owned[2*p]<myhi; p++) {
+        olo = PetscMax(mylo,owned[2*p]);
+        ohi = PetscMin(myhi,owned[2*p]+owned[2*p+1]);
+        if (ohi <= olo) continue;
+        ierr = PetscMPIIntCast(ohi-olo,&cnt);CHKERRQ(ierr);
+        if (write) {ierr = MPI_Irecv(sbuf+(olo-mylo),cnt,MPI_BYTE,p,tag,comm,&reqs[nreq++]);CHKERRQ(ierr);}
+        else       {ierr = MPI_Isend(sbuf+(olo-mylo),cnt,MPI_BYTE,p,tag,comm,&reqs[nreq++]);CHKERRQ(ierr);}
+      }
+    }
+    ierr = MPI_Waitall(nreq,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    if (have && write) {
+      ierr = PetscMPIIntCast(myhi-mylo,&cnt);CHKERRQ(ierr);
+      ierr = MPI_File_write_at(mfdes,(MPI_Offset)(base+mylo),sbuf,cnt,MPI_BYTE,&status);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+  ierr = PetscFree(sbuf);CHKERRQ(ierr);
+  ierr = PetscFree(owned);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Fill in start and total when the caller asked for them to be determined. Collective */
+static PetscErrorCode PetscViewerBinaryMPIIOGetLayout_Private(PetscViewer viewer,PetscInt count,PetscInt *start,PetscInt *total)
+{
+  MPI_Comm       comm = PetscObjectComm((PetscObject)viewer);
+  PetscInt       end;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (*start == PETSC_DETERMINE) {
+    ierr   = MPI_Scan(&count,&end,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+    *start = end - count;
+  }
+  if (*total == PETSC_DETERMINE) {
+    ierr = MPIU_Allreduce(&count,total,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscViewerBinaryWriteAllMPIIO - Writes a distributed array with MPI-IO at the current offset of the file
+
+   Collective
+
+   Input Parameters:
++  viewer - the binary viewer, it must be using MPI-IO
+.  data - the local part of the array
+.  count - the number of items in the local part
+.  start - the global index of the first local item, or PETSC_DETERMINE if the ranks own consecutive parts in rank order
+.  total - the global number of items, or PETSC_DETERMINE
+-  dtype - type of data to write
+
+   Notes:
+   The data is byte-swapped in place while it is written, hence it cannot be declared const. It is left unchanged on return.
+
+   The offset of the viewer is advanced past the array.
+
+   When aggregation is on, see PetscViewerBinarySetMPIIOAggregation(), the ranks must own consecutive parts of the array in
+   rank order and the file is written by the aggregators only, with large stripe-aligned requests. Otherwise the array
+   is written with MPI_File_write_all().
+
+   Level: advanced
+
+.seealso: PetscViewerBinaryReadAllMPIIO(), PetscViewerBinarySetMPIIOAggregation(), PetscViewerBinarySetUseMPIIO(), PetscViewerBinaryWrite()
+@*/
+PetscErrorCode PetscViewerBinaryWriteAllMPIIO(PetscViewer viewer,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscErrorCode     ierr;
+  MPI_Datatype       mdtype;
+  PetscMPIInt        cnt;
+  size_t             dsize;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  ierr = PetscViewerSetUp(viewer);CHKERRQ(ierr);
+  if (!vbinary->usempiio) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_ARG_WRONGSTATE,"Viewer is not using MPI-IO");
+  ierr = PetscViewerBinaryMPIIOGetLayout_Private(viewer,count,&start,&total);CHKERRQ(ierr);
+  ierr = PetscDataTypeGetSize(dtype,&dsize);CHKERRQ(ierr);
+  if (vbinary->aggrpernode > 0) {
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,dtype,count);CHKERRQ(ierr);}
+    ierr = PetscViewerBinaryMPIIOAggregate_Private(viewer,(char*)data,(PetscInt64)start*dsize,(PetscInt64)count*dsize,(PetscInt64)total*dsize,PETSC_TRUE);CHKERRQ(ierr);
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,dtype,count);CHKERRQ(ierr);}
+  } else {
+    ierr = PetscMPIIntCast(count,&cnt);CHKERRQ(ierr);
+    ierr = PetscDataTypeToMPIDataType(dtype,&mdtype);CHKERRQ(ierr);
+    ierr = MPI_File_set_view(vbinary->mfdes,vbinary->moff+(MPI_Offset)start*dsize,mdtype,mdtype,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+    ierr = MPIU_File_write_all(vbinary->mfdes,data,cnt,mdtype,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  }
+  vbinary->moff += (MPI_Offset)total*dsize;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscViewerBinaryReadAllMPIIO - Reads a distributed array with MPI-IO from the current offset of the file
+
+   Collective
+
+   Input Parameters:
++  viewer - the binary viewer, it must be using MPI-IO
+.  count - the number of items in the local part
+.  start - the global index of the first local item, or PETSC_DETERMINE if the ranks own consecutive parts in rank order
+.  total - the global number of items, or PETSC_DETERMINE
+-  dtype - type of data to read
+
+   Output Parameter:
+.  data - the local part of the array
+
+   Notes:
+   The offset of the viewer is advanced past the array. See PetscViewerBinaryWriteAllMPIIO() for the use of aggregation.
+
+   Level: advanced
+
+.seealso: PetscViewerBinaryWriteAllMPIIO(), PetscViewerBinarySetMPIIOAggregation(), PetscViewerBinarySetUseMPIIO(), PetscViewerBinaryRead()
+@*/
+PetscErrorCode PetscViewerBinaryReadAllMPIIO(PetscViewer viewer,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscErrorCode     ierr;
+  MPI_Datatype       mdtype;
+  PetscMPIInt        cnt;
+  size_t             dsize;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  ierr = PetscViewerSetUp(viewer);CHKERRQ(ierr);
+  if (!vbinary->usempiio) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_ARG_WRONGSTATE,"Viewer is not using MPI-IO");
+  ierr = PetscViewerBinaryMPIIOGetLayout_Private(viewer,count,&start,&total);CHKERRQ(ierr);
+  ierr = PetscDataTypeGetSize(dtype,&dsize);CHKERRQ(ierr);
+  if (vbinary->aggrpernode > 0) {
+    ierr = PetscViewerBinaryMPIIOAggregate_Private(viewer,(char*)data,(PetscInt64)start*dsize,(PetscInt64)count*dsize,(PetscInt64)total*dsize,PETSC_FALSE);CHKERRQ(ierr);
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,dtype,count);CHKERRQ(ierr);}
+  } else {
+    ierr = PetscMPIIntCast(count,&cnt);CHKERRQ(ierr);
+    ierr = PetscDataTypeToMPIDataType(dtype,&mdtype);CHKERRQ(ierr);
+    ierr = MPI_File_set_view(vbinary->mfdes,vbinary->moff+(MPI_Offset)start*dsize,mdtype,mdtype,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+    ierr = MPIU_File_read_all(vbinary->mfdes,data,cnt,mdtype,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  }
+  vbinary->moff += (MPI_Offset)total*dsize;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscViewerBinarySetMPIIOAggregation_Binary(PetscViewer viewer,PetscInt naggr,PetscInt stripesize)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (naggr < 0) SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_ARG_OUTOFRANGE,"Number of aggregators per node %D cannot be negative",naggr);
+  if (stripesize != PETSC_DEFAULT && (stripesize < 1 || stripesize > PETSC_MPI_INT_MAX)) SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_ARG_OUTOFRANGE,"Stripe size %D must be positive and fit in an int",stripesize);
+  vbinary->aggrpernode = naggr;
+  if (stripesize != PETSC_DEFAULT) vbinary->stripesize = stripesize;
+  ierr = PetscFree(vbinary->aggr);CHKERRQ(ierr);
+  vbinary->naggr = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscViewerBinaryGetMPIIOAggregation_Binary(PetscViewer viewer,PetscInt *naggr,PetscInt *stripesize)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+
+  PetscFunctionBegin;
+  if (naggr) *naggr = vbinary->aggrpernode;
+  if (stripesize) *stripesize = vbinary->stripesize;
+  PetscFunctionReturn(0);
+}
 #endif
 
 /*@C
@@ -1077,6 +1354,76 @@ PetscErrorCode PetscViewerBinarySetUseMPIIO(PetscViewer viewer,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+    PetscViewerBinarySetMPIIOAggregation - Sets the number of aggregator ranks per node and the stripe size used by
+        PetscViewerBinaryWriteAllMPIIO() and PetscViewerBinaryReadAllMPIIO(). Must be called before PetscViewerFileSetName()
+
+    Logically Collective on PetscViewer
+
+    Input Parameters:
++   viewer - the PetscViewer; must be a binary
+.   naggr - number of aggregator ranks on each node, 0 to hand each array to MPI_File_write_all()/MPI_File_read_all()
+-   stripesize - size in bytes of the file stripes transferred by the aggregators, or PETSC_DEFAULT
+
+    Options Database:
++   -viewer_binary_mpiio_aggregators <naggr> - number of aggregator ranks per node
+-   -viewer_binary_mpiio_stripe_size <stripesize> - stripe size in bytes
+
+    Notes:
+    With aggregation, the file is cut into stripes aligned on multiples of stripesize. The stripes are dealt round robin to
+    the aggregators, which gather the pieces owned by the other ranks, then read or write each stripe with a single
+    contiguous call. Choose stripesize as the stripe size of the parallel file system (it is also passed to MPI_File_open()
+    as the striping_unit hint) and naggr so that the aggregators saturate the network links of the node.
+
+    This only has an effect when MPI-IO is in use, see PetscViewerBinarySetUseMPIIO()
+
+    Level: advanced
+
+.seealso: PetscViewerBinarySetUseMPIIO(), PetscViewerBinaryGetMPIIOAggregation(), PetscViewerBinaryWriteAllMPIIO(), PetscViewerBinaryReadAllMPIIO()
+
+@*/
+PetscErrorCode PetscViewerBinarySetMPIIOAggregation(PetscViewer viewer,PetscInt naggr,PetscInt stripesize)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  PetscValidLogicalCollectiveInt(viewer,naggr,2);
+  PetscValidLogicalCollectiveInt(viewer,stripesize,3);
+  ierr = PetscTryMethod(viewer,"PetscViewerBinarySetMPIIOAggregation_C",(PetscViewer,PetscInt,PetscInt),(viewer,naggr,stripesize));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+    PetscViewerBinaryGetMPIIOAggregation - Gets the number of aggregator ranks per node and the stripe size used by
+        PetscViewerBinaryWriteAllMPIIO() and PetscViewerBinaryReadAllMPIIO()
+
+    Not Collective
+
+    Input Parameter:
+.   viewer - the PetscViewer; must be a binary
+
+    Output Parameters:
++   naggr - number of aggregator ranks on each node, 0 if aggregation is off
+-   stripesize - size in bytes of the file stripes
+
+    Level: advanced
+
+.seealso: PetscViewerBinarySetMPIIOAggregation(), PetscViewerBinaryGetUseMPIIO()
+
+@*/
+PetscErrorCode PetscViewerBinaryGetMPIIOAggregation(PetscViewer viewer,PetscInt *naggr,PetscInt *stripesize)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  if (naggr) *naggr = 0;
+  if (stripesize) *stripesize = 0;
+  ierr = PetscTryMethod(viewer,"PetscViewerBinaryGetMPIIOAggregation_C",(PetscViewer,PetscInt*,PetscInt*),(viewer,naggr,stripesize));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
      PetscViewerFileSetMode - Sets the type of file to be open
 
@@ -1263,7 +1610,19 @@ static PetscErrorCode PetscViewerFileSetUp_BinaryMPIIO(PetscViewer viewer)
   case FILE_MODE_WRITE: amode = MPI_MODE_WRONLY | MPI_MODE_CREATE; break;
   default: SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"Unsupported file mode %s",PetscFileModes[type]);
   }
-  ierr = MPI_File_open(PetscObjectComm((PetscObject)viewer),vbinary->filename,amode,MPI_INFO_NULL,&vbinary->mfdes);CHKERRQ(ierr);
+  if (vbinary->aggrpernode > 0) {
+    MPI_Info info;
+    char     unit[32];
+
+    /* Let the file system lay out the file in the stripes the aggregators transfer */
+    ierr = PetscSNPrintf(unit,sizeof(unit),"%D",vbinary->stripesize);CHKERRQ(ierr);
+    ierr = MPI_Info_create(&info);CHKERRQ(ierr);
+    ierr = MPI_Info_set(info,(char*)"striping_unit",unit);CHKERRQ(ierr);
+    ierr = MPI_File_open(PetscObjectComm((PetscObject)viewer),vbinary->filename,amode,info,&vbinary->mfdes);CHKERRQ(ierr);
+    ierr = MPI_Info_free(&info);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_File_open(PetscObjectComm((PetscObject)viewer),vbinary->filename,amode,MPI_INFO_NULL,&vbinary->mfdes);CHKERRQ(ierr);
+  }
 
   /*
       try to open info file: all processors open this file if read only
@@ -1356,6 +1715,14 @@ static PetscErrorCode PetscViewerSetFromOptions_Binary(PetscOptionItems *PetscOp
   ierr = PetscOptionsBool("-viewer_binary_skip_header","Skip writing/reading header information","PetscViewerBinarySetSkipHeader",PETSC_FALSE,&binary->skipheader,NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPIIO)
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file","PetscViewerBinarySetUseMPIIO",PETSC_FALSE,&binary->usempiio,NULL);CHKERRQ(ierr);
+  {
+    PetscInt  naggr = binary->aggrpernode,stripesize = binary->stripesize;
+    PetscBool flg1,flg2;
+
+    ierr = PetscOptionsInt("-viewer_binary_mpiio_aggregators","Number of aggregator ranks per node for MPI-IO, 0 to use MPI_File_write_all()","PetscViewerBinarySetMPIIOAggregation",naggr,&naggr,&flg1);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-viewer_binary_mpiio_stripe_size","Size in bytes of the file stripes transferred by the MPI-IO aggregators","PetscViewerBinarySetMPIIOAggregation",stripesize,&stripesize,&flg2);CHKERRQ(ierr);
+    if (flg1 || flg2) {ierr = PetscViewerBinarySetMPIIOAggregation_Binary(v,naggr,stripesize);CHKERRQ(ierr);}
+  }
 #elif defined(PETSC_HAVE_MPIUNI)
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file","PetscViewerBinarySetUseMPIIO",PETSC_FALSE,NULL,NULL);CHKERRQ(ierr);  
 #endif
@@ -1394,6 +1761,8 @@ PETSC_EXTERN PetscErrorCode PetscViewerCreate_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   vbinary->mfdes           = MPI_FILE_NULL;
   vbinary->mfsub           = MPI_FILE_NULL;
+  vbinary->aggrpernode     = 0;
+  vbinary->stripesize      = 4194304;
 #endif
   vbinary->fdes_info       = 0;
   vbinary->skipinfo        = PETSC_FALSE;
@@ -1425,6 +1794,8 @@ PETSC_EXTERN PetscErrorCode PetscViewerCreate_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMPIIO_C",PetscViewerBinaryGetUseMPIIO_Binary);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMPIIO_C",PetscViewerBinarySetUseMPIIO_Binary);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetMPIIOAggregation_C",PetscViewerBinaryGetMPIIOAggregation_Binary);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetMPIIOAggregation_C",PetscViewerBinarySetMPIIOAggregation_Binary);CHKERRQ(ierr);
 #endif
   PetscFunctionReturn(0);
 }
@@ -1452,7 +1823,9 @@ PetscMPIInt Petsc_Viewer_Binary_keyval = MPI_KEYVAL_INVALID;
 .    -viewer_binary_skip_info
 .    -viewer_binary_skip_options
 .    -viewer_binary_skip_header
--    -viewer_binary_mpiio
+.    -viewer_binary_mpiio
+.    -viewer_binary_mpiio_aggregators <naggr>
+-    -viewer_binary_mpiio_stripe_size <bytes>
 
    Environmental variables:
 -   PETSC_VIEWER_BINARY_FILENAME
@@ -39,6 +39,7 @@ const char *const PetscViewerFormats[] = {
   "HDF5_MAT",
   "NOFORMAT",
   "LOAD_BALANCE",
+  "BINARY_MMAP",
   "PetscViewerFormat",
   "PETSC_VIEWER_",
   0
@@ -76,4 +76,16 @@ int main(int argc,char **argv)
       # Do not need to output timing results for test
       filter: grep -v "per unique value took"
 
+   test:
+      suffix: quicksort
+      args: -n 1000 -r 1 -d 4 -sort_radix_threshold -1
+      filter: grep -v "per unique value took"
+      output_file: output/ex52_1.out
+
+   test:
+      suffix: radix_threads
+      args: -n 1000 -r 1 -d 4 -sort_radix_threads_threshold 0 -omp_num_threads 3
+      filter: grep -v "per unique value took"
+      output_file: output/ex52_1.out
+
 TEST*/
@@ -0,0 +1,77 @@
+static char help[] = "Tests PetscMalloc(), PetscCalloc() and PetscRealloc() of many sizes, for use with -malloc_pool and -malloc_hugepage\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscLogStage  stage;
+  PetscInt       i,j,n = 200,sizes[] = {1,7,16,17,100,1000,4096,8192,8193,100000},nsizes = sizeof(sizes)/sizeof(sizes[0]);
+  char           **a;
+  PetscBool      ok = PETSC_TRUE;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscLogStageRegister("Allocations",&stage);CHKERRQ(ierr);
+  ierr = PetscLogStagePush(stage);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  /* Allocate and free twice so that the second pass reuses the blocks */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < n; ++i) {
+      const PetscInt sz = sizes[i%nsizes];
+      PetscInt       k;
+
+      ierr = PetscCalloc1(sz,&a[i]);CHKERRQ(ierr);
+      if (((size_t) a[i]) % PETSC_MEMALIGN) ok = PETSC_FALSE;
+      for (k = 0; k < sz; ++k) {
+        if (a[i][k]) ok = PETSC_FALSE;
+        a[i][k] = (char) (i+k);
+      }
+    }
+    for (i = 0; i < n; ++i) {
+      const PetscInt sz = sizes[i%nsizes],nsz = sizes[(i+j+1)%nsizes];
+      PetscInt       k;
+
+      ierr = PetscRealloc(nsz*sizeof(char),&a[i]);CHKERRQ(ierr);
+      if (((size_t) a[i]) % PETSC_MEMALIGN) ok = PETSC_FALSE;
+      for (k = 0; k < PetscMin(sz,nsz); ++k) if (a[i][k] != (char) (i+k)) ok = PETSC_FALSE;
+    }
+    for (i = 0; i < n; ++i) {ierr = PetscFree(a[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  ierr = PetscLogStagePop();CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Allocations %s\n",ok ? "correct" : "WRONG");CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: pool
+      args: -malloc_pool
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: pool_debug
+      args: -malloc_pool -malloc_debug -malloc_dump
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: pool_nomalloc
+      args: -malloc_pool -malloc 0
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: hugepage
+      args: -malloc_hugepage -malloc_hugepage_threshold 4096 -malloc_numa interleave -malloc_first_touch
+      output_file: output/ex53_1.out
+
+   test:
+      suffix: hugepage_pool
+      args: -malloc_hugepage -malloc_hugepage_threshold 4096 -malloc_pool -malloc_debug
+      output_file: output/ex53_1.out
+
+TEST*/
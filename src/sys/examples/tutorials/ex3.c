@@ -91,4 +91,15 @@ int main(int argc,char **argv)
 
    test:
 
+   test:
+     suffix: hwcounters
+     args: -log_view -log_view_hwcounters
+     filter: grep -E "^   (IPC|LLCmiss|Flop/B|Not available)|^User event" | grep -v -E "^   Not available on this machine, so reported as zero:( cycles)?( instructions)?( LLCmiss)?$" | sed -E "s/[0-9][0-9.e+-]+|[0-9]/N/g"
+
+   test:
+     suffix: chrome_trace
+     nsize: 2
+     args: -log_chrome_trace ex3_trace.json
+     filter: grep -E "traceEvents|thread_name|User event|^]}" ex3_trace.json | sed -E -e "s/,\"ts\":[0-9.]+//" -e "s/,$//" | sort | uniq -c | sed -E "s/^ +//"
+
 TEST*/
@@ -0,0 +1,304 @@
+/*
+     Timeline of the logged events and the MPI waits in the Chrome trace event format, which chrome://tracing and
+   https://ui.perfetto.dev display with one track per process.
+
+   Each process appends a time stamped begin and end record for every event to a ring buffer that keeps the most
+   recent records once it is full. PetscLogChromeTraceDump() formats the records of each process as JSON and process 0
+   writes them, one process after the other, into a single file. Times are measured from the barrier in
+   PetscLogChromeTraceBegin() so that the tracks of the processes line up.
+*/
+#include <petsc/private/logimpl.h>  /*I "petscsys.h" I*/
+#include <petsctime.h>
+
+#if defined(PETSC_USE_LOG)
+
+typedef struct {
+  PetscLogDouble time;  /* PetscTime() when the record was made */
+  int            event; /* The event, or one of PETSC_CHROME_MPI_WAIT* for the MPI waits */
+  int            begin; /* 1 for the beginning of the event and 0 for its end */
+} PetscChromeTraceRecord;
+
+#define PETSC_CHROME_MPI_WAIT    -1
+#define PETSC_CHROME_MPI_WAITANY -2
+#define PETSC_CHROME_MPI_WAITALL -3
+
+PetscBool PetscLogChromeTraceOn = PETSC_FALSE;
+
+static PetscChromeTraceRecord *petsc_chrome_records = NULL;
+static size_t                  petsc_chrome_size    = 0;   /* Capacity of the ring buffer */
+static size_t                  petsc_chrome_count   = 0;   /* Number of records ever made */
+static PetscLogDouble          petsc_chrome_time    = 0.0; /* Origin of the time stamps */
+static PetscErrorCode        (*petsc_chrome_PLB)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+static PetscErrorCode        (*petsc_chrome_PLE)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+
+PETSC_STATIC_INLINE void PetscLogChromeTraceRecord_Private(int event,int begin)
+{
+  PetscChromeTraceRecord *rec = &petsc_chrome_records[petsc_chrome_count++ % petsc_chrome_size];
+
+  PetscTime(&rec->time);
+  rec->event = event;
+  rec->begin = begin;
+}
+
+static PetscErrorCode PetscLogEventBeginChromeTrace(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = (*petsc_chrome_PLB)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);
+  PetscLogChromeTraceRecord_Private(event,1);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogEventEndChromeTrace(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscLogChromeTraceRecord_Private(event,0);
+  ierr = (*petsc_chrome_PLE)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if !defined(MPIUNI_H) && !defined(PETSC_HAVE_BROKEN_RECURSIVE_MACRO) && !defined (PETSC_HAVE_MPI_MISSING_TYPESIZE)
+/* The MPI_Wait() macros of petsclog.h call these when the trace is on; the parentheses keep the macros from expanding */
+int PetscLogChromeTraceMPIWait(MPI_Request *request,MPI_Status *status)
+{
+  int err;
+
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAIT,1);
+  err = (MPI_Wait)(request,status);
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAIT,0);
+  return err;
+}
+
+int PetscLogChromeTraceMPIWaitany(int count,MPI_Request requests[],int *index,MPI_Status *status)
+{
+  int err;
+
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAITANY,1);
+  err = (MPI_Waitany)(count,requests,index,status);
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAITANY,0);
+  return err;
+}
+
+int PetscLogChromeTraceMPIWaitall(int count,MPI_Request requests[],MPI_Status statuses[])
+{
+  int err;
+
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAITALL,1);
+  err = (MPI_Waitall)(count,requests,statuses);
+  PetscLogChromeTraceRecord_Private(PETSC_CHROME_MPI_WAITALL,0);
+  return err;
+}
+#endif
+
+/*@C
+  PetscLogChromeTraceBegin - Turns on the logging of a timeline of all events and MPI waits, which
+  PetscLogChromeTraceDump() writes in the Chrome trace event format.
+
+  Collective over PETSC_COMM_WORLD
+
+  Options Database Keys:
++ -log_chrome_trace [filename] - Calls PetscLogChromeTraceBegin() in PetscInitialize() and PetscLogChromeTraceDump() in
+                                 PetscFinalize(), the default file name is petsc_trace.json
+- -log_chrome_trace_records <n> - Number of records kept by each process, default 1048576
+
+  Notes:
+  The timeline is logged on top of the logging that is already on, so that -log_view still works, and turns on the
+  default logging if there is none. Every event and every MPI_Wait(), MPI_Waitany() and MPI_Waitall() called by PETSc
+  takes two records of 16 bytes. When the buffer is full the oldest records are overwritten.
+
+  Open the file with chrome://tracing or https://ui.perfetto.dev to see the timeline.
+
+  Level: advanced
+
+.seealso: PetscLogChromeTraceDump(), PetscLogDefaultBegin(), PetscLogTraceBegin(), PetscLogView()
+@*/
+PetscErrorCode PetscLogChromeTraceBegin(void)
+{
+  PetscInt       n = 1048576;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petsc_chrome_records) PetscFunctionReturn(0);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-log_chrome_trace_records",&n,NULL);CHKERRQ(ierr);
+  if (n < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of trace records %D must be positive",n);
+  if (!PetscLogPLB) {ierr = PetscLogDefaultBegin();CHKERRQ(ierr);}
+  ierr = PetscMalloc1(n,&petsc_chrome_records);CHKERRQ(ierr);
+  petsc_chrome_size  = (size_t) n;
+  petsc_chrome_count = 0;
+  petsc_chrome_PLB   = PetscLogPLB;
+  petsc_chrome_PLE   = PetscLogPLE;
+  ierr = PetscLogSet(PetscLogEventBeginChromeTrace,PetscLogEventEndChromeTrace);CHKERRQ(ierr);
+  ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+  PetscTime(&petsc_chrome_time);
+  PetscLogChromeTraceOn = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscLogChromeTraceEnd_Internal - Frees the trace records, called from PetscLogFinalize()
+
+  Not collective
+
+  Level: developer
+*/
+PetscErrorCode PetscLogChromeTraceEnd_Internal(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscLogChromeTraceOn = PETSC_FALSE;
+  ierr = PetscFree(petsc_chrome_records);CHKERRQ(ierr);
+  petsc_chrome_size  = 0;
+  petsc_chrome_count = 0;
+  petsc_chrome_PLB   = NULL;
+  petsc_chrome_PLE   = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Appends the printf() style text to the growing buffer */
+static PetscErrorCode PetscLogChromeTraceAppend_Private(char **buf,size_t *len,size_t *cap,const char format[],...)
+{
+  va_list        Argp;
+  size_t         n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (*len + 1024 > *cap) {
+    char *tmp;
+
+    *cap = PetscMax(2*(*cap),*len + 1024);
+    ierr = PetscMalloc1(*cap,&tmp);CHKERRQ(ierr);
+    ierr = PetscMemcpy(tmp,*buf,*len);CHKERRQ(ierr);
+    ierr = PetscFree(*buf);CHKERRQ(ierr);
+    *buf = tmp;
+  }
+  va_start(Argp,format);
+  ierr = PetscVSNPrintf(*buf + *len,*cap - *len,format,&n,Argp);CHKERRQ(ierr);
+  va_end(Argp);
+  ierr = PetscStrlen(*buf + *len,&n);CHKERRQ(ierr);
+  *len += n;
+  PetscFunctionReturn(0);
+}
+
+/* Copies the event name with the characters that JSON does not allow in strings replaced */
+static PetscErrorCode PetscLogChromeTraceEscape_Private(const char name[],char escaped[],size_t size)
+{
+  size_t i,j;
+
+  PetscFunctionBegin;
+  for (i = 0, j = 0; name[i] && j < size-2; ++i) {
+    if (name[i] == '"' || name[i] == '\\') escaped[j++] = '\\';
+    escaped[j++] = ((unsigned char) name[i] < 0x20) ? ' ' : name[i];
+  }
+  escaped[j] = 0;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogChromeTraceDump - Writes the timeline logged since PetscLogChromeTraceBegin() in the Chrome trace event
+  format, with one track per process.
+
+  Collective over PETSC_COMM_WORLD
+
+  Input Parameter:
+. filename - The file name, or NULL for petsc_trace.json
+
+  Notes:
+  Each process formats its own records and process 0 writes them to the file one process after the other, so that
+  process 0 never holds more than the records of one other process. The time stamps are in microseconds from the
+  barrier in PetscLogChromeTraceBegin(). Events that were still open when the records were written, such as those
+  around the call to this function, show as not ended in the viewer.
+
+  Level: advanced
+
+.seealso: PetscLogChromeTraceBegin(), PetscLogDump(), PetscLogView()
+@*/
+PetscErrorCode PetscLogChromeTraceDump(const char filename[])
+{
+  PetscStageLog  stageLog;
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size,tag,r;
+  char           *buf = NULL,name[512];
+  size_t         len = 0,cap = 0,first,i;
+  PetscInt       depth = 0;
+  FILE           *fd = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!petsc_chrome_records) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call PetscLogChromeTraceBegin() first");
+  ierr = PetscLogGetStageLog(&stageLog);CHKERRQ(ierr);
+  ierr = PetscCommDuplicate(PETSC_COMM_WORLD,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+
+  first = petsc_chrome_count > petsc_chrome_size ? petsc_chrome_count - petsc_chrome_size : 0;
+  if (first) {ierr = PetscInfo1(NULL,"The oldest %D trace records were overwritten, use -log_chrome_trace_records to keep more\n",(PetscInt) first);CHKERRQ(ierr);}
+  ierr = PetscLogChromeTraceAppend_Private(&buf,&len,&cap,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"Rank %d\"}}",rank,rank);CHKERRQ(ierr);
+  ierr = PetscLogChromeTraceAppend_Private(&buf,&len,&cap,",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"sort_index\":%d}}",rank,rank);CHKERRQ(ierr);
+  for (i = first; i < petsc_chrome_count; ++i) {
+    const PetscChromeTraceRecord *rec = &petsc_chrome_records[i % petsc_chrome_size];
+    const char                   *ename,*cat = "MPI";
+
+    /* Skip the ends whose beginnings were overwritten */
+    if (rec->begin) ++depth;
+    else if (!depth) continue;
+    else --depth;
+    switch (rec->event) {
+    case PETSC_CHROME_MPI_WAIT:    ename = "MPI_Wait";break;
+    case PETSC_CHROME_MPI_WAITANY: ename = "MPI_Waitany";break;
+    case PETSC_CHROME_MPI_WAITALL: ename = "MPI_Waitall";break;
+    default:
+      ename = stageLog->eventLog->eventInfo[rec->event].name;
+      cat   = "PETSc";
+    }
+    ierr = PetscLogChromeTraceEscape_Private(ename,name,sizeof(name));CHKERRQ(ierr);
+    ierr = PetscLogChromeTraceAppend_Private(&buf,&len,&cap,",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",\"pid\":0,\"tid\":%d,\"ts\":%.3f}",name,cat,rec->begin ? "B" : "E",rank,(rec->time - petsc_chrome_time)*1.e6);CHKERRQ(ierr);
+  }
+
+  if (!rank) {
+    char fname[PETSC_MAX_PATH_LEN];
+
+    ierr = PetscStrncpy(fname,filename && filename[0] ? filename : "petsc_trace.json",sizeof(fname));CHKERRQ(ierr);
+    ierr = PetscFOpen(PETSC_COMM_SELF,fname,"w",&fd);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"PETSc\"}}");CHKERRQ(ierr);
+    if (fwrite(buf,1,len,fd) != len) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Unable to write trace file");
+    for (r = 1; r < size; ++r) {
+      PetscInt64 rlen;
+      size_t     off;
+
+      ierr = MPI_Recv(&rlen,1,MPIU_INT64,r,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      if ((size_t) rlen > cap) {
+        ierr = PetscFree(buf);CHKERRQ(ierr);
+        cap  = (size_t) rlen;
+        ierr = PetscMalloc1(cap,&buf);CHKERRQ(ierr);
+      }
+      for (off = 0; off < (size_t) rlen; off += PETSC_MPI_INT_MAX) {
+        PetscMPIInt chunk = (PetscMPIInt) PetscMin((size_t) rlen - off,(size_t) PETSC_MPI_INT_MAX);
+
+        ierr = MPI_Recv(buf + off,chunk,MPI_CHAR,r,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      }
+      if (fwrite(buf,1,(size_t) rlen,fd) != (size_t) rlen) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Unable to write trace file");
+    }
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"\n]}\n");CHKERRQ(ierr);
+    ierr = PetscFClose(PETSC_COMM_SELF,fd);CHKERRQ(ierr);
+  } else {
+    PetscInt64 slen = (PetscInt64) len;
+    size_t     off;
+
+    ierr = MPI_Send(&slen,1,MPIU_INT64,0,tag,comm);CHKERRQ(ierr);
+    for (off = 0; off < len; off += PETSC_MPI_INT_MAX) {
+      PetscMPIInt chunk = (PetscMPIInt) PetscMin(len - off,(size_t) PETSC_MPI_INT_MAX);
+
+      ierr = MPI_Send(buf + off,chunk,MPI_CHAR,0,tag,comm);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree(buf);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#endif
@@ -145,6 +145,8 @@ PETSC_INTERN PetscErrorCode PetscLogFinalize(void)
   ierr = PetscFree(petsc_actions);CHKERRQ(ierr);
   ierr = PetscFree(petsc_objects);CHKERRQ(ierr);
   ierr = PetscLogNestedEnd();CHKERRQ(ierr);
+  ierr = PetscLogHWCountersEnd_Internal();CHKERRQ(ierr);
+  ierr = PetscLogChromeTraceEnd_Internal();CHKERRQ(ierr);
   ierr = PetscLogSet(NULL, NULL);CHKERRQ(ierr);
 
   /* Resetting phase */
@@ -1249,6 +1251,18 @@ PetscErrorCode  PetscLogView_Detailed(PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+/* Hardware counter columns of a CSV line, with the memory traffic estimated from the last level cache misses */
+static PetscErrorCode PetscLogViewHWCounters_CSV(PetscViewer viewer,PetscEventPerfInfo *info,PetscLogDouble lineSize)
+{
+  PetscLogDouble bytes = info->cacheMisses*lineSize;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerASCIISynchronizedPrintf(viewer,",%g,%g,%g,%g,%g,%g",info->cycles,info->instructions,info->cacheMisses,bytes,
+                                            info->time > 0.0 ? bytes/info->time : 0.0,bytes > 0.0 ? info->flops/bytes : 0.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
   PetscLogView_CSV - Each process prints the times for its own events in Comma-Separated Value Format
 */
@@ -1256,7 +1270,7 @@ PetscErrorCode  PetscLogView_CSV(PetscViewer viewer)
 {
   PetscStageLog      stageLog;
   PetscEventPerfInfo *eventInfo = NULL;
-  PetscLogDouble     locTotalTime, maxMem;
+  PetscLogDouble     locTotalTime, maxMem, lineSize = 0.0;
   int                numStages,numEvents,stage,event;
   MPI_Comm           comm = PetscObjectComm((PetscObject) viewer);
   PetscMPIInt        rank,size;
@@ -1272,19 +1286,27 @@ PetscErrorCode  PetscLogView_CSV(PetscViewer viewer)
   ierr = MPIU_Allreduce(&stageLog->numStages, &numStages, 1, MPI_INT, MPI_MAX, comm);CHKERRQ(ierr);
   ierr = PetscMallocGetMaximumUsage(&maxMem);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
-  ierr = PetscViewerASCIIPrintf(viewer,"Stage Name,Event Name,Rank,Time,Num Messages,Message Length,Num Reductions,FLOP,dof0,dof1,dof2,dof3,dof4,dof5,dof6,dof7,e0,e1,e2,e3,e4,e5,e6,e7,%d\n", size);
+  if (PetscLogHWCounters) {
+    ierr = PetscLogHWCountersGetInfo_Internal(NULL, &lineSize);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"Stage Name,Event Name,Rank,Time,Num Messages,Message Length,Num Reductions,FLOP,Cycles,Instructions,LLC Misses,Memory Bytes,Bandwidth,Arithmetic Intensity,dof0,dof1,dof2,dof3,dof4,dof5,dof6,dof7,e0,e1,e2,e3,e4,e5,e6,e7,%d\n", size);
+  } else {
+    ierr = PetscViewerASCIIPrintf(viewer,"Stage Name,Event Name,Rank,Time,Num Messages,Message Length,Num Reductions,FLOP,dof0,dof1,dof2,dof3,dof4,dof5,dof6,dof7,e0,e1,e2,e3,e4,e5,e6,e7,%d\n", size);
+  }
   ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
   for (stage=0; stage<numStages; stage++) {
     PetscEventPerfInfo *stageInfo = &stageLog->stageInfo[stage].perfInfo;
 
-    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"%s,summary,%d,%g,%g,%g,%g,%g\n",
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"%s,summary,%d,%g,%g,%g,%g,%g",
                                               stageLog->stageInfo[stage].name,rank,stageInfo->time,stageInfo->numMessages,stageInfo->messageLength,stageInfo->numReductions,stageInfo->flops);CHKERRQ(ierr);
+    if (PetscLogHWCounters) {ierr = PetscLogViewHWCounters_CSV(viewer,stageInfo,lineSize);CHKERRQ(ierr);}
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"\n");CHKERRQ(ierr);
     ierr = MPIU_Allreduce(&stageLog->stageInfo[stage].eventLog->numEvents, &numEvents, 1, MPI_INT, MPI_MAX, comm);CHKERRQ(ierr);
     for (event = 0; event < numEvents; event++) {
       eventInfo = &stageLog->stageInfo[stage].eventLog->eventInfo[event];
       ierr = PetscViewerASCIISynchronizedPrintf(viewer,"%s,%s,%d,%g,%g,%g,%g,%g",stageLog->stageInfo[stage].name,
                                                 stageLog->eventLog->eventInfo[event].name,rank,eventInfo->time,eventInfo->numMessages,
                                                 eventInfo->messageLength,eventInfo->numReductions,eventInfo->flops);CHKERRQ(ierr);
+      if (PetscLogHWCounters) {ierr = PetscLogViewHWCounters_CSV(viewer,eventInfo,lineSize);CHKERRQ(ierr);}
       if (eventInfo->dof[0] >= 0.) {
         PetscInt d, e;
 
@@ -1367,6 +1389,8 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   PetscLogDouble     fracStageTime, fracStageFlops, fracStageMess, fracStageMessLen, fracStageRed;
   PetscLogDouble     min, max, tot, ratio, avg, x, y;
   PetscLogDouble     minf, maxf, totf, ratf, mint, maxt, tott, ratt, ratC, totm, totml, totr, mal, malmax, emalmax;
+  PetscLogDouble     totcyc, totins, totllc, lineSize = 0.0;
+  PetscBool          hwAvailable[PETSC_LOG_HW_NUM];
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   PetscLogDouble     cct, gct, csz, gsz, gmaxt, gflops, gflopr, fracgflops;
   #endif
@@ -1571,6 +1595,16 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
     ierr = PetscFPrintf(comm, fd, "   MMalloc Mbytes: Increase in high water mark of allocated memory (sum over all calls to event)\n");CHKERRQ(ierr);
     ierr = PetscFPrintf(comm, fd, "   RMI Mbytes: Increase in resident memory (sum over all calls to event)\n");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscLogHWCountersGetInfo_Internal(hwAvailable, &lineSize);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   IPC: instructions per cycle, (sum of instructions over all processors)/(sum of cycles over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   LLCmiss: last level cache misses (sum over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   MB/s: 10e-6 * (sum of LLCmiss * %g byte cache line over all processors)/(max time over all processors), the achieved memory bandwidth\n", lineSize);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   Flop/B: arithmetic intensity, flop per byte of memory traffic estimated from LLCmiss\n");CHKERRQ(ierr);
+    if (!hwAvailable[0] || !hwAvailable[1] || !hwAvailable[2]) {
+      ierr = PetscFPrintf(comm, fd, "   Not available on this machine, so reported as zero:%s%s%s\n", hwAvailable[0] ? "" : " cycles", hwAvailable[1] ? "" : " instructions", hwAvailable[2] ? "" : " LLCmiss");CHKERRQ(ierr);
+    }
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd, "   GPU Mflop/s: 10e-6 * (sum of flop on GPU over all processors)/(max GPU time over all processors)\n");CHKERRQ(ierr);
   ierr = PetscFPrintf(comm, fd, "   CpuToGpu Count: total number of CPU to GPU copies per processor\n");CHKERRQ(ierr);
@@ -1588,6 +1622,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd,"  Malloc EMalloc MMalloc RMI");CHKERRQ(ierr);
   } 
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd,"  --------- Hardware ---------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd,"   GPU    - CpuToGpu -   - GpuToCpu - GPU");CHKERRQ(ierr);
   #endif
@@ -1596,6 +1633,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd," Mbytes Mbytes Mbytes Mbytes");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd,"  IPC   LLCmiss    MB/s Flop/B");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd," Mflop/s Count   Size   Count   Size  %%F");CHKERRQ(ierr); 
   #endif
@@ -1604,6 +1644,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd,"-----------------------------");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd,"------------------------------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd,"---------------------------------------");CHKERRQ(ierr); 
   #endif
@@ -1664,6 +1707,11 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncrease, &malmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncreaseEvent, &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogHWCounters) {
+          ierr  = MPI_Allreduce(&eventInfo[event].cycles,         &totcyc, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+          ierr  = MPI_Allreduce(&eventInfo[event].instructions,   &totins, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+          ierr  = MPI_Allreduce(&eventInfo[event].cacheMisses,    &totllc, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
         ierr  = MPI_Allreduce(&eventInfo[event].CpuToGpuCount,    &cct,   1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         ierr  = MPI_Allreduce(&eventInfo[event].GpuToCpuCount,    &gct,   1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
@@ -1692,6 +1740,11 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&zero,                        &malmax, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&zero,                        &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogHWCounters) {
+          ierr  = MPI_Allreduce(&zero,                        &totcyc, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+          ierr  = MPI_Allreduce(&zero,                        &totins, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+          ierr  = MPI_Allreduce(&zero,                        &totllc, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
         ierr  = MPI_Allreduce(&zero,                          &cct,    1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         ierr  = MPI_Allreduce(&zero,                          &gct,    1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
@@ -1735,6 +1788,14 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
         if (PetscLogMemory) {
           ierr = PetscFPrintf(comm, fd," %5.0f   %5.0f   %5.0f   %5.0f",mal/1.0e6,emalmax/1.0e6,malmax/1.0e6,mem/1.0e6);CHKERRQ(ierr);
         } 
+        if (PetscLogHWCounters) {
+          PetscLogDouble ipc = 0.0, bw = 0.0, ai = 0.0, bytes = totllc*lineSize;
+
+          if (totcyc != 0.0) ipc = totins/totcyc;
+          if (maxt   != 0.0) bw  = bytes/maxt;
+          if (bytes  != 0.0) ai  = totf/bytes;
+          ierr = PetscFPrintf(comm, fd," %4.2f %9.3e %7.0f %6.2f",ipc,totllc,bw/1.0e6,ai);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
         if (totf  != 0.0) fracgflops = gflops/totf;  else fracgflops = 0.0;
         if (gmaxt != 0.0) gflopr     = gflops/gmaxt; else gflopr     = 0.0;
@@ -1750,6 +1811,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd, "-----------------------------");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd, "------------------------------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd, "---------------------------------------");CHKERRQ(ierr); 
   #endif
@@ -1872,6 +1936,7 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
 +  -log_view [:filename] - Prints summary of log information
 .  -log_view :filename.py:ascii_info_detail - Saves logging information from each process as a Python file
 .  -log_view :filename.xml:ascii_xml - Saves a summary of the logging information in a nested format (see below for how to view it)
+.  -log_view_hwcounters - Adds hardware counters (Linux perf_event) to the summary: instructions per cycle, last level cache misses, and the memory bandwidth and arithmetic intensity derived from them
 .  -log_all - Saves a file Log.rank for each MPI process with details of each step of the computation
 -  -log_trace [filename] - Displays a trace of what each process is doing
 
@@ -163,6 +163,9 @@ PetscErrorCode PetscEventPerfInfoClear(PetscEventPerfInfo *eventInfo)
   eventInfo->numMessages   = 0.0;
   eventInfo->messageLength = 0.0;
   eventInfo->numReductions = 0.0;
+  eventInfo->cycles        = 0.0;
+  eventInfo->instructions  = 0.0;
+  eventInfo->cacheMisses   = 0.0;
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventInfo->CpuToGpuCount = 0.0;
   eventInfo->GpuToCpuCount = 0.0;
@@ -667,6 +670,13 @@ PetscErrorCode PetscLogEventBeginDefault(PetscLogEvent event,int t,PetscObject o
     eventLog->eventInfo[event].mallocIncrease -= usage;
     ierr = PetscMallocPushMaximumUsage((int)event);CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    PetscLogDouble hw[PETSC_LOG_HW_NUM];
+    ierr = PetscLogHWCountersGet_Internal(hw);CHKERRQ(ierr);
+    eventLog->eventInfo[event].cycles       -= hw[0];
+    eventLog->eventInfo[event].instructions -= hw[1];
+    eventLog->eventInfo[event].cacheMisses  -= hw[2];
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventLog->eventInfo[event].CpuToGpuCount -= petsc_ctog_ct;
   eventLog->eventInfo[event].GpuToCpuCount -= petsc_gtoc_ct;
@@ -714,6 +724,13 @@ PetscErrorCode PetscLogEventEndDefault(PetscLogEvent event,int t,PetscObject o1,
     ierr = PetscMallocGetMaximumUsage(&usage);CHKERRQ(ierr);
     eventLog->eventInfo[event].mallocIncrease += usage;
   }
+  if (PetscLogHWCounters) {
+    PetscLogDouble hw[PETSC_LOG_HW_NUM];
+    ierr = PetscLogHWCountersGet_Internal(hw);CHKERRQ(ierr);
+    eventLog->eventInfo[event].cycles       += hw[0];
+    eventLog->eventInfo[event].instructions += hw[1];
+    eventLog->eventInfo[event].cacheMisses  += hw[2];
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventLog->eventInfo[event].CpuToGpuCount += petsc_ctog_ct;
   eventLog->eventInfo[event].GpuToCpuCount += petsc_gtoc_ct;
@@ -0,0 +1,169 @@
+/*
+     Hardware performance counters for the default PETSc logging, enabled with -log_view_hwcounters.
+
+   On Linux the counters are opened with perf_event_open() for the calling thread, in user space only, as one group so
+   that a single read() returns all of them. PetscLogEventBeginDefault()/PetscLogEventEndDefault() and the stage push/pop
+   difference the running totals exactly as they do for the flop count. Counters that the kernel or the hardware does not
+   provide (for example in most virtual machines) read as zero, and PetscLogView() says so.
+*/
+#include <petsc/private/logimpl.h>  /*I    "petscsys.h"   I*/
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <errno.h>
+#endif
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+PetscBool PetscLogHWCounters = PETSC_FALSE;
+
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+static const unsigned long long PetscLogHWConfig[PETSC_LOG_HW_NUM] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+static int                      PetscLogHWFd[PETSC_LOG_HW_NUM]     = {-1, -1, -1};
+static int                      PetscLogHWSlot[PETSC_LOG_HW_NUM]   = {-1, -1, -1}; /* Position of each counter in the group read, or -1 */
+static int                      PetscLogHWNum                      = 0;            /* Number of counters in the group */
+static int                      PetscLogHWLeader                   = -1;           /* The group leader, which is read */
+#endif
+static PetscLogDouble           PetscLogHWLineSize                 = 64.0;
+
+/*
+  PetscLogHWCountersBegin_Internal - Opens the hardware counters, called from PetscOptionsCheckInitial_Private()
+
+  Not collective
+
+  Level: developer
+*/
+PetscErrorCode PetscLogHWCountersBegin_Internal(void)
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  int            c;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_UNISTD_H) && defined(_SC_LEVEL1_DCACHE_LINESIZE)
+  {
+    long sz = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+
+    if (sz > 0) PetscLogHWLineSize = (PetscLogDouble) sz;
+  }
+#endif
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  for (c = 0; c < PETSC_LOG_HW_NUM; ++c) {
+    struct perf_event_attr attr;
+    int                    fd;
+
+    ierr = PetscMemzero(&attr, sizeof(attr));CHKERRQ(ierr);
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PetscLogHWConfig[c];
+    attr.read_format    = PERF_FORMAT_GROUP;
+    attr.disabled       = PetscLogHWLeader < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, PetscLogHWLeader, 0);
+    if (fd < 0) {
+      ierr = PetscInfo2(NULL, "Hardware counter %d is not available, errno %d\n", c, errno);CHKERRQ(ierr);
+      continue;
+    }
+    if (PetscLogHWLeader < 0) PetscLogHWLeader = fd;
+    PetscLogHWFd[c]   = fd;
+    PetscLogHWSlot[c] = PetscLogHWNum++;
+  }
+  if (PetscLogHWLeader >= 0) {
+    ioctl(PetscLogHWLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(PetscLogHWLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+  PetscLogHWCounters = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscLogHWCountersEnd_Internal - Closes the hardware counters, called from PetscLogFinalize()
+
+  Not collective
+
+  Level: developer
+*/
+PetscErrorCode PetscLogHWCountersEnd_Internal(void)
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  int c;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  /* Close the group members before the leader */
+  for (c = PETSC_LOG_HW_NUM-1; c >= 0; --c) {
+    if (PetscLogHWFd[c] >= 0) close(PetscLogHWFd[c]);
+    PetscLogHWFd[c]   = -1;
+    PetscLogHWSlot[c] = -1;
+  }
+  PetscLogHWNum    = 0;
+  PetscLogHWLeader = -1;
+#endif
+  PetscLogHWCounters = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscLogHWCountersGet_Internal - Reads the running totals of the hardware counters for the calling thread
+
+  Not collective
+
+  Output Parameter:
+. counts - The cycles, instructions and last level cache misses, zero for those not available
+
+  Level: developer
+*/
+PetscErrorCode PetscLogHWCountersGet_Internal(PetscLogDouble counts[])
+{
+  int c;
+
+  PetscFunctionBegin;
+  for (c = 0; c < PETSC_LOG_HW_NUM; ++c) counts[c] = 0.0;
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  if (PetscLogHWNum) {
+    unsigned long long buf[1+PETSC_LOG_HW_NUM];
+    ssize_t            n;
+
+    n = read(PetscLogHWLeader, buf, sizeof(buf));
+    if (n < (ssize_t) ((1+PetscLogHWNum)*sizeof(unsigned long long))) PetscFunctionReturn(0);
+    for (c = 0; c < PETSC_LOG_HW_NUM; ++c) if (PetscLogHWSlot[c] >= 0) counts[c] = (PetscLogDouble) buf[1+PetscLogHWSlot[c]];
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscLogHWCountersGetInfo_Internal - Tells which hardware counters could be opened, and the cache line size used to
+  turn last level cache misses into memory traffic
+
+  Not collective
+
+  Output Parameters:
++ available - [Optional] Flags for the cycles, instructions and last level cache misses counters
+- lineSize  - [Optional] The cache line size in bytes
+
+  Level: developer
+*/
+PetscErrorCode PetscLogHWCountersGetInfo_Internal(PetscBool available[], PetscLogDouble *lineSize)
+{
+  int c;
+
+  PetscFunctionBegin;
+  if (available) {
+    for (c = 0; c < PETSC_LOG_HW_NUM; ++c) {
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+      available[c] = PetscLogHWSlot[c] >= 0 ? PETSC_TRUE : PETSC_FALSE;
+#else
+      available[c] = PETSC_FALSE;
+#endif
+    }
+  }
+  if (lineSize) *lineSize = PetscLogHWLineSize;
+  PetscFunctionReturn(0);
+}
@@ -210,6 +210,20 @@ PetscErrorCode  PetscStageLogRegister(PetscStageLog stageLog, const char sname[]
   PetscFunctionReturn(0);
 }
 
+/* Add (sign = 1) or subtract (sign = -1) the running totals of the hardware counters, as is done for the flops */
+static PetscErrorCode PetscEventPerfInfoAddHWCounters_Private(PetscEventPerfInfo *perfInfo, PetscLogDouble sign)
+{
+  PetscLogDouble hw[PETSC_LOG_HW_NUM];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLogHWCountersGet_Internal(hw);CHKERRQ(ierr);
+  perfInfo->cycles       += sign*hw[0];
+  perfInfo->instructions += sign*hw[1];
+  perfInfo->cacheMisses  += sign*hw[2];
+  PetscFunctionReturn(0);
+}
+
 /*@C
   PetscStageLogPush - This function pushes a stage on the stack.
 
@@ -264,6 +278,7 @@ PetscErrorCode  PetscStageLogPush(PetscStageLog stageLog, int stage)
       stageLog->stageInfo[curStage].perfInfo.numMessages   += petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
       stageLog->stageInfo[curStage].perfInfo.messageLength += petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
       stageLog->stageInfo[curStage].perfInfo.numReductions += petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+      if (PetscLogHWCounters) {ierr = PetscEventPerfInfoAddHWCounters_Private(&stageLog->stageInfo[curStage].perfInfo, 1.0);CHKERRQ(ierr);}
     }
   }
   /* Activate the stage */
@@ -279,6 +294,7 @@ PetscErrorCode  PetscStageLogPush(PetscStageLog stageLog, int stage)
     stageLog->stageInfo[stage].perfInfo.numMessages   -= petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
     stageLog->stageInfo[stage].perfInfo.messageLength -= petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
     stageLog->stageInfo[stage].perfInfo.numReductions -= petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+    if (PetscLogHWCounters) {ierr = PetscEventPerfInfoAddHWCounters_Private(&stageLog->stageInfo[stage].perfInfo, -1.0);CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -328,6 +344,7 @@ PetscErrorCode  PetscStageLogPop(PetscStageLog stageLog)
     stageLog->stageInfo[curStage].perfInfo.numMessages   += petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
     stageLog->stageInfo[curStage].perfInfo.messageLength += petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
     stageLog->stageInfo[curStage].perfInfo.numReductions += petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+    if (PetscLogHWCounters) {ierr = PetscEventPerfInfoAddHWCounters_Private(&stageLog->stageInfo[curStage].perfInfo, 1.0);CHKERRQ(ierr);}
   }
   ierr = PetscIntStackEmpty(stageLog->stack, &empty);CHKERRQ(ierr);
   if (!empty) {
@@ -339,6 +356,7 @@ PetscErrorCode  PetscStageLogPop(PetscStageLog stageLog)
       stageLog->stageInfo[curStage].perfInfo.numMessages   -= petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
       stageLog->stageInfo[curStage].perfInfo.messageLength -= petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
       stageLog->stageInfo[curStage].perfInfo.numReductions -= petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+      if (PetscLogHWCounters) {ierr = PetscEventPerfInfoAddHWCounters_Private(&stageLog->stageInfo[curStage].perfInfo, -1.0);CHKERRQ(ierr);}
     }
     stageLog->curStage = curStage;
   } else stageLog->curStage = -1;
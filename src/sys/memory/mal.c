@@ -23,11 +23,22 @@ PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 */
 #define SHIFT_CLASSID 456123
 
+/*
+   Allocations of PetscMallocLargeThreshold bytes or more go to mhuge.c, which places them on huge pages and NUMA nodes
+*/
+PETSC_INTERN size_t         PetscMallocLargeThreshold;
+PETSC_INTERN PetscBool      PetscMallocLargeUsed;
+PETSC_INTERN PetscErrorCode PetscMallocLarge_Private(size_t,PetscBool,int,const char[],const char[],void**);
+PETSC_INTERN PetscBool      PetscMallocIsLarge_Private(void*);
+PETSC_INTERN PetscErrorCode PetscFreeLarge_Private(void*,int,const char[],const char[]);
+PETSC_INTERN PetscErrorCode PetscReallocLarge_Private(size_t,int,const char[],const char[],void**);
+
 PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line,const char func[],const char file[],void **result)
 {
   PetscErrorCode ierr;
 
   if (!mem) {*result = NULL; return 0;}
+  if (PetscMallocLargeThreshold && mem >= PetscMallocLargeThreshold) return PetscMallocLarge_Private(mem,clear,line,func,file,result);
 #if defined(PETSC_HAVE_MEMKIND)
   {
     if (!currentmktype) ierr = memkind_posix_memalign(MEMKIND_DEFAULT,result,PETSC_MEMALIGN,mem);
@@ -82,6 +93,7 @@ PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line
 PETSC_EXTERN PetscErrorCode PetscFreeAlign(void *ptr,int line,const char func[],const char file[])
 {
   if (!ptr) return 0;
+  if (PetscMallocLargeUsed && PetscMallocIsLarge_Private(ptr)) return PetscFreeLarge_Private(ptr,line,func,file);
 #if defined(PETSC_HAVE_MEMKIND)
   memkind_free(0,ptr); /* specify the kind to 0 so that memkind will look up for the right type */
 #else
@@ -118,6 +130,7 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t mem, int line, const char f
     *result = NULL;
     return 0;
   }
+  if (PetscMallocLargeUsed && PetscMallocIsLarge_Private(*result)) return PetscReallocLarge_Private(mem,line,func,file,result);
 #if defined(PETSC_HAVE_MEMKIND)
   if (!currentmktype) *result = memkind_realloc(MEMKIND_DEFAULT,*result,mem);
   else *result = memkind_realloc(MEMKIND_HBW_PREFERRED,*result,mem);
@@ -0,0 +1,212 @@
+/*
+     Placement of large allocations: transparent huge pages and NUMA policy, turned on with -malloc_hugepage or
+   -malloc_numa.
+
+   PetscMallocAlign() passes requests of at least -malloc_hugepage_threshold bytes to PetscMallocLarge_Private(), which
+   maps them with mmap() at a huge page boundary and asks for transparent huge pages with madvise(), cutting the TLB
+   misses of the sweeps over large Vec and Mat arrays. The pages are then bound to or interleaved over NUMA nodes with
+   mbind() and, with -malloc_first_touch, touched by the OpenMP threads with the static schedule that the threaded
+   kernels use, so that each page lands on the node of the thread that computes on it. A header in front of the array
+   lets PetscFreeAlign() and PetscReallocAlign() recognize these blocks.
+*/
+#include <petscsys.h>             /*I   "petscsys.h"   I*/
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+#if defined(PETSC_HAVE_LINUX_MEMPOLICY_H)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+/*
+   Defined in mal.c, which also calls the routines below
+*/
+PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t,PetscBool,int,const char[],const char[],void**);
+
+#define PETSC_HUGEPAGE_SIZE         2097152
+#define PETSC_LARGE_HEADER_BYTES    64
+#define PETSC_LARGE_MAGIC           0x1a29e5a1
+#define PETSC_LARGE_MAX_NODES       1024
+
+typedef enum {PETSC_MALLOC_NUMA_DEFAULT,PETSC_MALLOC_NUMA_LOCAL,PETSC_MALLOC_NUMA_INTERLEAVE,PETSC_MALLOC_NUMA_BIND} PetscMallocNumaType;
+static const char *const PetscMallocNumaTypes[] = {"default","local","interleave","bind","PetscMallocNumaType","PETSC_MALLOC_NUMA_",0};
+
+typedef struct {
+  void   *self;   /* The header itself, to tell it from data that happens to match the magic number */
+  size_t length;  /* Length of the mapping */
+  size_t size;    /* Number of bytes requested */
+  int    magic;
+} PetscLargeHeader;
+
+PETSC_INTERN size_t    PetscMallocLargeThreshold;
+PETSC_INTERN PetscBool PetscMallocLargeUsed;
+size_t                 PetscMallocLargeThreshold = 0;           /* Zero unless the placement of large allocations is on */
+PetscBool              PetscMallocLargeUsed      = PETSC_FALSE; /* Stays true once on, blocks may be freed later */
+
+static PetscMallocNumaType PetscMallocNuma          = PETSC_MALLOC_NUMA_DEFAULT;
+static PetscBool           PetscMallocHugePages     = PETSC_FALSE;
+static PetscBool           PetscMallocFirstTouch    = PETSC_FALSE;
+static unsigned long       PetscMallocNumaMask[PETSC_LARGE_MAX_NODES/(8*sizeof(unsigned long))];
+
+/* Binds or interleaves the pages of the range according to -malloc_numa; failures only lose the placement */
+static void PetscMallocLargePlace_Private(void *addr,size_t length)
+{
+#if defined(PETSC_HAVE_LINUX_MEMPOLICY_H) && defined(__NR_mbind)
+  switch (PetscMallocNuma) {
+  case PETSC_MALLOC_NUMA_LOCAL:
+    syscall(__NR_mbind,addr,length,MPOL_PREFERRED,NULL,0,0);
+    break;
+  case PETSC_MALLOC_NUMA_INTERLEAVE:
+    syscall(__NR_mbind,addr,length,MPOL_INTERLEAVE,PetscMallocNumaMask,PETSC_LARGE_MAX_NODES,0);
+    break;
+  case PETSC_MALLOC_NUMA_BIND:
+    syscall(__NR_mbind,addr,length,MPOL_BIND,PetscMallocNumaMask,PETSC_LARGE_MAX_NODES,0);
+    break;
+  default:
+    break;
+  }
+#endif
+}
+
+/* Touches one byte of each page in the order the static OpenMP schedule hands out the array */
+static void PetscMallocLargeFirstTouch_Private(char *a,size_t size)
+{
+#if defined(PETSC_HAVE_UNISTD_H) && defined(_SC_PAGESIZE)
+  const PetscInt64 pagesize = (PetscInt64) sysconf(_SC_PAGESIZE);
+#else
+  const PetscInt64 pagesize = 4096;
+#endif
+  const PetscInt64 npages   = ((PetscInt64) size + pagesize - 1)/pagesize;
+  PetscInt64       p;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (p = 0; p < npages; ++p) a[p*pagesize] = 0;
+}
+
+PETSC_INTERN PetscErrorCode PetscMallocLarge_Private(size_t mem,PetscBool clear,int line,const char func[],const char file[],void **result)
+{
+#if defined(PETSC_HAVE_MMAP)
+  size_t           length = ((PETSC_LARGE_HEADER_BYTES + mem + PETSC_HUGEPAGE_SIZE-1)/PETSC_HUGEPAGE_SIZE)*PETSC_HUGEPAGE_SIZE;
+  char             *map,*base;
+  size_t           head;
+  PetscLargeHeader *h;
+
+  /* Map one huge page more than needed and unmap the ends so that the block starts at a huge page boundary */
+  map = (char*) mmap(NULL,length + PETSC_HUGEPAGE_SIZE,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+  if (map == (char*) MAP_FAILED) return PetscError(PETSC_COMM_SELF,line,func,file,PETSC_ERR_MEM,PETSC_ERROR_INITIAL,"Memory requested %.0f",(PetscLogDouble)mem);
+  head = (PETSC_HUGEPAGE_SIZE - ((PETSC_UINTPTR_T) map) % PETSC_HUGEPAGE_SIZE) % PETSC_HUGEPAGE_SIZE;
+  base = map + head;
+  if (head) munmap(map,head);
+  if (PETSC_HUGEPAGE_SIZE - head) munmap(base + length,PETSC_HUGEPAGE_SIZE - head);
+#if defined(PETSC_HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+  if (PetscMallocHugePages) madvise(base,length,MADV_HUGEPAGE);
+#endif
+  PetscMallocLargePlace_Private(base,length);
+  /* Anonymous pages read as zero, so clear needs nothing more */
+  if (PetscMallocFirstTouch) PetscMallocLargeFirstTouch_Private(base,length);
+  h         = (PetscLargeHeader*) base;
+  h->self   = h;
+  h->length = length;
+  h->size   = mem;
+  h->magic  = PETSC_LARGE_MAGIC;
+  *result   = (void*) (base + PETSC_LARGE_HEADER_BYTES);
+  return 0;
+#else
+  return PetscError(PETSC_COMM_SELF,line,func,file,PETSC_ERR_SUP_SYS,PETSC_ERROR_INITIAL,"Placement of large allocations requires mmap()");
+#endif
+}
+
+/* Tells whether the block came from PetscMallocLarge_Private(); only blocks at the right offset from a huge page boundary are looked at */
+PETSC_INTERN PetscBool PetscMallocIsLarge_Private(void *ptr)
+{
+  PetscLargeHeader *h;
+
+  if (!ptr || ((PETSC_UINTPTR_T) ptr) % PETSC_HUGEPAGE_SIZE != PETSC_LARGE_HEADER_BYTES) return PETSC_FALSE;
+  h = (PetscLargeHeader*) ((char*) ptr - PETSC_LARGE_HEADER_BYTES);
+  return (h->magic == PETSC_LARGE_MAGIC && h->self == (void*) h) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+PETSC_INTERN PetscErrorCode PetscFreeLarge_Private(void *ptr,int line,const char func[],const char file[])
+{
+#if defined(PETSC_HAVE_MMAP)
+  PetscLargeHeader *h = (PetscLargeHeader*) ((char*) ptr - PETSC_LARGE_HEADER_BYTES);
+
+  h->magic = 0;
+  if (munmap(h,h->length)) return PetscError(PETSC_COMM_SELF,line,func,file,PETSC_ERR_SYS,PETSC_ERROR_INITIAL,"munmap() failed");
+#endif
+  return 0;
+}
+
+/* Reallocates a block from PetscMallocLarge_Private(), the new block is placed according to its size */
+PETSC_INTERN PetscErrorCode PetscReallocLarge_Private(size_t mem,int line,const char func[],const char file[],void **result)
+{
+  PetscLargeHeader *h = (PetscLargeHeader*) ((char*) *result - PETSC_LARGE_HEADER_BYTES);
+  void             *inew;
+  PetscErrorCode   ierr;
+
+  if (mem <= h->length - PETSC_LARGE_HEADER_BYTES && mem >= PetscMallocLargeThreshold) {
+    h->size = mem;
+    return 0;
+  }
+  ierr = PetscMallocAlign(mem,PETSC_FALSE,line,func,file,&inew);if (ierr) return ierr;
+  ierr = PetscMemcpy(inew,*result,PetscMin(mem,h->size));if (ierr) return ierr;
+  ierr = PetscFreeLarge_Private(*result,line,func,file);if (ierr) return ierr;
+  *result = inew;
+  return 0;
+}
+
+/*
+   PetscSetUseLargeMalloc_Private - Reads the options for the placement of large allocations, called from
+   PetscOptionsCheckInitial_Private()
+*/
+PETSC_INTERN PetscErrorCode PetscSetUseLargeMalloc_Private(void)
+{
+  PetscInt       threshold = PETSC_HUGEPAGE_SIZE,nodes[PETSC_LARGE_MAX_NODES],nnodes = PETSC_LARGE_MAX_NODES,i;
+  PetscBool      flg,nflg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_hugepage",&PetscMallocHugePages,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-malloc_numa",PetscMallocNumaTypes,(PetscEnum*)&PetscMallocNuma,&flg);CHKERRQ(ierr);
+  if (!PetscMallocHugePages && !flg) PetscFunctionReturn(0);
+#if !defined(PETSC_HAVE_MMAP)
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP_SYS,"-malloc_hugepage and -malloc_numa require mmap()");
+#endif
+  ierr = PetscOptionsGetInt(NULL,NULL,"-malloc_hugepage_threshold",&threshold,NULL);CHKERRQ(ierr);
+  if (threshold < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Threshold %D must be positive",threshold);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_first_touch",&PetscMallocFirstTouch,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetIntArray(NULL,NULL,"-malloc_numa_nodes",nodes,&nnodes,&nflg);CHKERRQ(ierr);
+  ierr = PetscMemzero(PetscMallocNumaMask,sizeof(PetscMallocNumaMask));CHKERRQ(ierr);
+  if (nflg) {
+    for (i = 0; i < nnodes; ++i) {
+      if (nodes[i] < 0 || nodes[i] >= PETSC_LARGE_MAX_NODES) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"NUMA node %D must be in [0, %d)",nodes[i],PETSC_LARGE_MAX_NODES);
+      PetscMallocNumaMask[nodes[i]/(8*sizeof(unsigned long))] |= 1UL << (nodes[i] % (8*sizeof(unsigned long)));
+    }
+  } else if (PetscMallocNuma == PETSC_MALLOC_NUMA_INTERLEAVE || PetscMallocNuma == PETSC_MALLOC_NUMA_BIND) {
+#if defined(PETSC_HAVE_LINUX_MEMPOLICY_H) && defined(__NR_get_mempolicy)
+    /* All the nodes this process may use */
+    if (syscall(__NR_get_mempolicy,NULL,PetscMallocNumaMask,PETSC_LARGE_MAX_NODES,NULL,MPOL_F_MEMS_ALLOWED)) {
+      ierr = PetscInfo(NULL,"Unable to get the allowed NUMA nodes, using the default policy\n");CHKERRQ(ierr);
+      PetscMallocNuma = PETSC_MALLOC_NUMA_DEFAULT;
+    }
+#endif
+  }
+#if !defined(PETSC_HAVE_LINUX_MEMPOLICY_H)
+  if (PetscMallocNuma != PETSC_MALLOC_NUMA_DEFAULT) {ierr = PetscInfo(NULL,"NUMA placement is not available, ignoring -malloc_numa\n");CHKERRQ(ierr);}
+#endif
+#if !defined(PETSC_HAVE_MADVISE)
+  if (PetscMallocHugePages) {ierr = PetscInfo(NULL,"madvise() is not available, ignoring -malloc_hugepage\n");CHKERRQ(ierr);}
+#endif
+  ierr = PetscInfo4(NULL,"Allocations of %D bytes or more use huge pages %s, NUMA policy %s, first touch %s\n",threshold,PetscBools[PetscMallocHugePages],PetscMallocNumaTypes[PetscMallocNuma],PetscBools[PetscMallocFirstTouch]);CHKERRQ(ierr);
+  PetscMallocLargeThreshold = (size_t) threshold;
+  PetscMallocLargeUsed      = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
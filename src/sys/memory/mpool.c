@@ -0,0 +1,329 @@
+/*
+     Pool allocator for PetscMalloc(), turned on with -malloc_pool.
+
+   Requests up to PETSC_POOL_MAX_SIZE bytes are rounded up to one of a few size classes and served from a free list for
+   that class; the lists are refilled by carving chunks obtained with PetscMallocAlign(), and freed blocks go back on the
+   list instead of to the system. Larger requests are passed on to PetscMallocAlign(). Every block starts with a small
+   header that records its class so that PetscFree() and PetscRealloc() need no size. With the tracing of mtr.c
+   (-malloc_debug, -malloc_dump and the default -malloc of debugging builds) the pool sits underneath the tracing, so
+   that the tracing checks and reports work as before.
+
+   The free lists and the usage statistics, which are kept for each logging stage, live in a cache that is thread
+   local in builds configured with --with-threadsafety; only the chunk list is shared and protected by a lock.
+*/
+#include <petsc/private/petscimpl.h>  /*I   "petscsys.h"   I*/
+#include <petscviewer.h>
+
+/*
+   These are defined in mal.c and ensure that malloced space is PetscScalar aligned
+*/
+PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t,PetscBool,int,const char[],const char[],void**);
+PETSC_EXTERN PetscErrorCode PetscFreeAlign(void*,int,const char[],const char[]);
+PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t,int,const char[],const char[],void**);
+
+#define PETSC_POOL_NUM_CLASSES 18
+#define PETSC_POOL_MAX_SIZE    8192
+#define PETSC_POOL_GRANULE     16
+#define PETSC_POOL_CHUNK_SIZE  65536
+#define PETSC_POOL_MAGIC       0x5a17c0de
+#define PETSC_POOL_FREED       0x0f4eed00
+
+static const size_t PetscPoolClassSize[PETSC_POOL_NUM_CLASSES] = {16,32,48,64,96,128,192,256,384,512,768,1024,1536,2048,3072,4096,6144,8192};
+static unsigned char PetscPoolClass[PETSC_POOL_MAX_SIZE/PETSC_POOL_GRANULE]; /* Size class of each multiple of PETSC_POOL_GRANULE */
+
+typedef struct {
+  size_t size;  /* The size of the class, or the size requested for blocks larger than PETSC_POOL_MAX_SIZE */
+  int    cls;   /* The size class, or -1 for blocks from PetscMallocAlign() */
+  int    magic; /* PETSC_POOL_MAGIC while the block is in use */
+} PetscPoolHeader;
+
+/* The header padded to keep the alignment of the block handed out */
+#define PETSC_POOL_HEADER_BYTES ((sizeof(PetscPoolHeader)+(PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1))
+/* The blocks of a class are this far apart, so that every block of a chunk keeps the alignment when PETSC_MEMALIGN exceeds 16 */
+#define PetscPoolClassBytes(cls) ((PetscPoolClassSize[cls]+(PETSC_MEMALIGN-1)) & ~(size_t)(PETSC_MEMALIGN-1))
+
+typedef struct {
+  PetscLogDouble requests; /* Number of PetscMalloc() calls */
+  PetscLogDouble reused;   /* Number of them served from a free list */
+  PetscLogDouble large;    /* Number of them passed on to PetscMallocAlign() */
+  PetscLogDouble bytes;    /* Number of bytes requested */
+} PetscPoolStats;
+
+typedef struct {
+  PetscPoolHeader *free[PETSC_POOL_NUM_CLASSES]; /* Free blocks, linked through their first word after the header */
+  PetscPoolStats  *stats;                        /* Statistics for each logging stage */
+  int             nstats;
+  PetscLogDouble  inuse;                         /* Number of blocks allocated and not freed */
+} PetscPoolCache;
+
+#if defined(PETSC_HAVE_THREADSAFETY)
+#  if defined(__cplusplus) && (__cplusplus >= 201103L)
+#    define PETSC_POOL_THREAD_LOCAL thread_local
+#  elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#    define PETSC_POOL_THREAD_LOCAL _Thread_local
+#  else
+#    define PETSC_POOL_THREAD_LOCAL __thread
+#  endif
+static PetscSpinlock PetscPoolSpinLock;
+#else
+#  define PETSC_POOL_THREAD_LOCAL
+#endif
+
+static PETSC_POOL_THREAD_LOCAL PetscPoolCache PetscPoolThreadCache;
+static void                                   *PetscPoolChunks     = NULL;  /* The chunks, linked through their first word */
+static PetscLogDouble                         PetscPoolChunkBytes  = 0.0;
+static PetscBool                              PetscPoolInitialized = PETSC_FALSE;
+
+/* The statistics of the current logging stage */
+PETSC_STATIC_INLINE PetscErrorCode PetscPoolGetStats_Private(PetscPoolCache *cache,PetscPoolStats **stats)
+{
+  int stage = 0;
+
+#if defined(PETSC_USE_LOG)
+  if (petsc_stageLog && petsc_stageLog->curStage > 0) stage = petsc_stageLog->curStage;
+#endif
+  if (stage >= cache->nstats) {
+    int            n = stage + 8;
+    PetscErrorCode ierr;
+
+    ierr = PetscReallocAlign(n*sizeof(PetscPoolStats),__LINE__,PETSC_FUNCTION_NAME,__FILE__,(void**)&cache->stats);if (ierr) return ierr;
+    ierr = PetscMemzero(cache->stats + cache->nstats,(n - cache->nstats)*sizeof(PetscPoolStats));if (ierr) return ierr;
+    cache->nstats = n;
+  }
+  *stats = &cache->stats[stage];
+  return 0;
+}
+
+/* Carves a new chunk into blocks of the size class and puts them on the free list */
+static PetscErrorCode PetscPoolRefill_Private(PetscPoolCache *cache,int cls,int lineno,const char function[],const char filename[])
+{
+  const size_t   bsize = PETSC_POOL_HEADER_BYTES + PetscPoolClassBytes(cls);
+  const size_t   n     = PetscMax(PETSC_POOL_CHUNK_SIZE/bsize,1);
+  char           *chunk;
+  size_t         i;
+  PetscErrorCode ierr;
+
+  ierr = PetscMallocAlign(PETSC_POOL_HEADER_BYTES + n*bsize,PETSC_FALSE,lineno,function,filename,(void**)&chunk);if (ierr) return ierr;
+#if defined(PETSC_HAVE_THREADSAFETY)
+  ierr = PetscSpinlockLock(&PetscPoolSpinLock);if (ierr) return ierr;
+#endif
+  *(void**)chunk       = PetscPoolChunks;
+  PetscPoolChunks      = chunk;
+  PetscPoolChunkBytes += (PetscLogDouble) (PETSC_POOL_HEADER_BYTES + n*bsize);
+#if defined(PETSC_HAVE_THREADSAFETY)
+  ierr = PetscSpinlockUnlock(&PetscPoolSpinLock);if (ierr) return ierr;
+#endif
+  for (i = n; i > 0; --i) {
+    PetscPoolHeader *head = (PetscPoolHeader*) (chunk + PETSC_POOL_HEADER_BYTES + (i-1)*bsize);
+
+    *(PetscPoolHeader**) ((char*) head + PETSC_POOL_HEADER_BYTES) = cache->free[cls];
+    cache->free[cls] = head;
+  }
+  return 0;
+}
+
+static PetscErrorCode PetscPoolMalloc(size_t a,PetscBool clear,int lineno,const char function[],const char filename[],void **result)
+{
+  PetscPoolCache  *cache = &PetscPoolThreadCache;
+  PetscPoolStats  *stats;
+  PetscPoolHeader *head;
+  PetscErrorCode  ierr;
+
+  if (!a) {*result = NULL; return 0;}
+  ierr = PetscPoolGetStats_Private(cache,&stats);if (ierr) return ierr;
+  stats->requests += 1.0;
+  stats->bytes    += (PetscLogDouble) a;
+  if (a > PETSC_POOL_MAX_SIZE) {
+    ierr = PetscMallocAlign(PETSC_POOL_HEADER_BYTES + a,clear,lineno,function,filename,(void**)&head);if (ierr) return ierr;
+    head->size    = a;
+    head->cls     = -1;
+    stats->large += 1.0;
+  } else {
+    int cls = PetscPoolClass[(a-1)/PETSC_POOL_GRANULE];
+
+    if (cache->free[cls]) stats->reused += 1.0;
+    else {ierr = PetscPoolRefill_Private(cache,cls,lineno,function,filename);if (ierr) return ierr;}
+    head             = cache->free[cls];
+    cache->free[cls] = *(PetscPoolHeader**) ((char*) head + PETSC_POOL_HEADER_BYTES);
+    head->size       = PetscPoolClassBytes(cls);
+    head->cls        = cls;
+    if (clear) {ierr = PetscMemzero((char*) head + PETSC_POOL_HEADER_BYTES,a);if (ierr) return ierr;}
+  }
+  head->magic   = PETSC_POOL_MAGIC;
+  cache->inuse += 1.0;
+  *result       = (void*) ((char*) head + PETSC_POOL_HEADER_BYTES);
+  return 0;
+}
+
+static PetscErrorCode PetscPoolFree(void *ptr,int lineno,const char function[],const char filename[])
+{
+  PetscPoolCache  *cache = &PetscPoolThreadCache;
+  PetscPoolHeader *head;
+
+  if (!ptr) return 0;
+  head = (PetscPoolHeader*) ((char*) ptr - PETSC_POOL_HEADER_BYTES);
+  if (head->magic != PETSC_POOL_MAGIC) {
+    if (head->magic == PETSC_POOL_FREED) return PetscError(PETSC_COMM_SELF,lineno,function,filename,PETSC_ERR_ARG_WRONG,PETSC_ERROR_INITIAL,"Block at address %p was already freed",ptr);
+    return PetscError(PETSC_COMM_SELF,lineno,function,filename,PETSC_ERR_MEMC,PETSC_ERROR_INITIAL,"Block at address %p is corrupted or was not allocated with PetscMalloc()",ptr);
+  }
+  head->magic   = PETSC_POOL_FREED;
+  cache->inuse -= 1.0;
+  if (head->cls < 0) return PetscFreeAlign(head,lineno,function,filename);
+  *(PetscPoolHeader**) ptr = cache->free[head->cls];
+  cache->free[head->cls]   = head;
+  return 0;
+}
+
+static PetscErrorCode PetscPoolRealloc(size_t a,int lineno,const char function[],const char filename[],void **result)
+{
+  PetscPoolHeader *head;
+  void            *inew;
+  PetscErrorCode  ierr;
+
+  if (!a) {
+    ierr = PetscPoolFree(*result,lineno,function,filename);if (ierr) return ierr;
+    *result = NULL;
+    return 0;
+  }
+  if (!*result) return PetscPoolMalloc(a,PETSC_FALSE,lineno,function,filename,result);
+  head = (PetscPoolHeader*) ((char*) *result - PETSC_POOL_HEADER_BYTES);
+  if (head->magic != PETSC_POOL_MAGIC) return PetscError(PETSC_COMM_SELF,lineno,function,filename,PETSC_ERR_MEMC,PETSC_ERROR_INITIAL,"Block at address %p is corrupted or was not allocated with PetscMalloc()",*result);
+  /* The block is still large enough */
+  if (head->cls >= 0 && a <= head->size) return 0;
+  /* Both the old and the new blocks come from PetscMallocAlign() */
+  if (head->cls < 0 && a > PETSC_POOL_MAX_SIZE) {
+    ierr = PetscReallocAlign(PETSC_POOL_HEADER_BYTES + a,lineno,function,filename,(void**)&head);if (ierr) return ierr;
+    head->size = a;
+    *result    = (void*) ((char*) head + PETSC_POOL_HEADER_BYTES);
+    return 0;
+  }
+  ierr = PetscPoolMalloc(a,PETSC_FALSE,lineno,function,filename,&inew);if (ierr) return ierr;
+  ierr = PetscMemcpy(inew,*result,PetscMin(a,head->size));if (ierr) return ierr;
+  ierr = PetscPoolFree(*result,lineno,function,filename);if (ierr) return ierr;
+  *result = inew;
+  return 0;
+}
+
+PETSC_INTERN PetscErrorCode PetscSetUseTrMallocBase_Private(PetscErrorCode (*)(size_t,PetscBool,int,const char[],const char[],void**),PetscErrorCode (*)(void*,int,const char[],const char[]),PetscErrorCode (*)(size_t,int,const char[],const char[],void**));
+
+PETSC_INTERN PetscErrorCode PetscSetUsePoolMalloc_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!PetscPoolInitialized) {
+    int i,cls = 0;
+
+    for (i = 0; i < PETSC_POOL_MAX_SIZE/PETSC_POOL_GRANULE; ++i) {
+      while ((size_t) (i+1)*PETSC_POOL_GRANULE > PetscPoolClassSize[cls]) ++cls;
+      PetscPoolClass[i] = (unsigned char) cls;
+    }
+#if defined(PETSC_HAVE_THREADSAFETY)
+    ierr = PetscSpinlockCreate(&PetscPoolSpinLock);CHKERRQ(ierr);
+#else
+    ierr = PetscSetUseTrMallocBase_Private(PetscPoolMalloc,PetscPoolFree,PetscPoolRealloc);CHKERRQ(ierr);
+#endif
+    PetscPoolInitialized = PETSC_TRUE;
+  }
+  ierr = PetscMallocSet(PetscPoolMalloc,PetscPoolFree);CHKERRQ(ierr);
+  PetscTrRealloc = PetscPoolRealloc;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolFinalize_Private - Returns the chunks of the pool to the system if no block is in use, called at the
+   end of PetscFinalize(). The pool stays usable.
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolFinalize_Private(void)
+{
+#if !defined(PETSC_HAVE_THREADSAFETY)
+  PetscPoolCache *cache = &PetscPoolThreadCache;
+  int            cls;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+  if (!PetscPoolInitialized) PetscFunctionReturn(0);
+#if !defined(PETSC_HAVE_THREADSAFETY)
+  /* With threads the caches of the other threads may still hold blocks of the chunks */
+  if (cache->inuse > 0.0) PetscFunctionReturn(0);
+  while (PetscPoolChunks) {
+    void *chunk = PetscPoolChunks;
+
+    PetscPoolChunks = *(void**)chunk;
+    ierr = PetscFreeAlign(chunk,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+  }
+  for (cls = 0; cls < PETSC_POOL_NUM_CLASSES; ++cls) cache->free[cls] = NULL;
+  ierr = PetscFreeAlign(cache->stats,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+  cache->stats        = NULL;
+  cache->nstats       = 0;
+  PetscPoolChunkBytes = 0.0;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPoolView - Prints the usage of the PetscMalloc() pool turned on with -malloc_pool, for each logging stage
+
+   Collective on PetscViewer
+
+   Input Parameter:
+.  viewer - the ASCII viewer, or NULL for PETSC_VIEWER_STDOUT_WORLD
+
+   Options Database Keys:
++  -malloc_pool - use the pool for PetscMalloc()
+-  -malloc_pool_view - calls PetscMallocPoolView() in PetscFinalize()
+
+   Notes:
+   The number of requests, the fraction of them served from a free list of the pool, the number of requests too large
+   for the pool and the number of bytes requested are summed over the processes. With --with-threadsafety only the
+   allocations of the calling thread are counted.
+
+   Level: advanced
+
+.seealso: PetscMallocDump(), PetscMemoryView(), PetscLogStageRegister()
+@*/
+PetscErrorCode PetscMallocPoolView(PetscViewer viewer)
+{
+  PetscPoolCache *cache = &PetscPoolThreadCache;
+  MPI_Comm       comm;
+  PetscBool      isascii;
+  PetscMPIInt    nloc,n;
+  PetscLogDouble *loc,*tot,chunkBytes,inuse;
+  int            s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!viewer) viewer = PETSC_VIEWER_STDOUT_WORLD;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&isascii);CHKERRQ(ierr);
+  if (!isascii) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"Only ASCII viewers are supported");
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  if (!PetscPoolInitialized) {
+    ierr = PetscViewerASCIIPrintf(viewer,"PetscMalloc() pool is not in use, run with -malloc_pool\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  nloc = cache->nstats;
+  ierr = MPIU_Allreduce(&nloc,&n,1,MPI_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = PetscCalloc2(4*n,&loc,4*n,&tot);CHKERRQ(ierr);
+  ierr = PetscMemcpy(loc,cache->stats,PetscMin(nloc,cache->nstats)*sizeof(PetscPoolStats));CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(loc,tot,4*n,MPIU_PETSCLOGDOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&PetscPoolChunkBytes,&chunkBytes,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&cache->inuse,&inuse,1,MPIU_PETSCLOGDOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+
+  ierr = PetscViewerASCIIPrintf(viewer,"PetscMalloc() pool: %d size classes up to %d bytes, at most %g MB of chunks per process, %.0f blocks in use\n",PETSC_POOL_NUM_CLASSES,PETSC_POOL_MAX_SIZE,chunkBytes*1.e-6,inuse);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"Stage                        Requests   Reused     Large  Requested (MB)\n");CHKERRQ(ierr);
+  for (s = 0; s < n; ++s) {
+    const PetscPoolStats *st = (PetscPoolStats*) &tot[4*s];
+    char                 name[64];
+
+    if (st->requests == 0.0) continue;
+    ierr = PetscSNPrintf(name,sizeof(name),"Stage %d",s);CHKERRQ(ierr);
+#if defined(PETSC_USE_LOG)
+    if (petsc_stageLog && s < petsc_stageLog->numStages) {ierr = PetscStrncpy(name,petsc_stageLog->stageInfo[s].name,sizeof(name));CHKERRQ(ierr);}
+#endif
+    ierr = PetscViewerASCIIPrintf(viewer,"%-24s %12.0f %7.1f%% %9.0f %15.3f\n",name,st->requests,100.0*st->reused/st->requests,st->large,st->bytes*1.e-6);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(loc,tot);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -20,6 +20,13 @@ PETSC_EXTERN PetscErrorCode PetscTrMallocDefault(size_t,PetscBool,int,const char
 PETSC_EXTERN PetscErrorCode PetscTrFreeDefault(void*,int,const char[],const char[]);
 PETSC_EXTERN PetscErrorCode PetscTrReallocDefault(size_t,int,const char[],const char[],void**);
 
+/*
+     The allocator underneath the tracing, PetscMallocAlign() unless -malloc_pool puts the pool of mpool.c there
+*/
+static PetscErrorCode (*PetscTrMallocBase)(size_t,PetscBool,int,const char[],const char[],void**) = PetscMallocAlign;
+static PetscErrorCode (*PetscTrFreeBase)(void*,int,const char[],const char[])                   = PetscFreeAlign;
+static PetscErrorCode (*PetscTrReallocBase)(size_t,int,const char[],const char[],void**)         = PetscReallocAlign;
+
 
 #define CLASSID_VALUE  ((PetscClassId) 0xf0e0d0c9)
 #define ALREADY_FREED  ((PetscClassId) 0x0f0e0d9c)
@@ -79,6 +86,8 @@ PETSC_INTERN PetscErrorCode PetscSetUseTrMalloc_Private(void)
   PetscFunctionBegin;
   if (PetscSetUseTrMallocCalled) PetscFunctionReturn(0);
   PetscSetUseTrMallocCalled = PETSC_TRUE;
+  /* The tracing goes on top of an allocator set by PetscSetUseTrMallocBase_Private() instead of replacing it */
+  if (PetscTrMalloc == PetscTrMallocBase) {ierr = PetscMallocClear();CHKERRQ(ierr);}
   ierr = PetscMallocSet(PetscTrMallocDefault,PetscTrFreeDefault);CHKERRQ(ierr);
   PetscTrRealloc = PetscTrReallocDefault;
 
@@ -93,6 +102,25 @@ PETSC_INTERN PetscErrorCode PetscSetUseTrMalloc_Private(void)
   PetscFunctionReturn(0);
 }
 
+/*
+   PetscSetUseTrMallocBase_Private - Sets the allocator that the tracing routines call to get and release memory
+
+   Not Collective
+
+   Level: developer
+*/
+PETSC_INTERN PetscErrorCode PetscSetUseTrMallocBase_Private(PetscErrorCode (*imalloc)(size_t,PetscBool,int,const char[],const char[],void**),
+                                                            PetscErrorCode (*ifree)(void*,int,const char[],const char[]),
+                                                            PetscErrorCode (*irealloc)(size_t,int,const char[],const char[],void**))
+{
+  PetscFunctionBegin;
+  if (TRfrags) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot change the allocator underneath the tracing after memory has been allocated");
+  PetscTrMallocBase  = imalloc;
+  PetscTrFreeBase    = ifree;
+  PetscTrReallocBase = irealloc;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscMallocValidate - Test the memory for corruption.  This can be used to
    check for memory overwrites.
@@ -187,7 +215,7 @@ PetscErrorCode  PetscTrMallocDefault(size_t a,PetscBool clear,int lineno,const c
   ierr = PetscMallocValidate(lineno,function,filename); if (ierr) PetscFunctionReturn(ierr);
 
   nsize = (a + (PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1);
-  ierr  = PetscMallocAlign(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),clear,lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
+  ierr  = (*PetscTrMallocBase)(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),clear,lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
 
   head  = (TRSPACE*)inew;
   inew += sizeof(TrSPACE);
@@ -315,7 +343,7 @@ PetscErrorCode  PetscTrFreeDefault(void *aa,int line,const char function[],const
   else TRhead = head->next;
 
   if (head->next) head->next->prev = head->prev;
-  ierr = PetscFreeAlign(a,line,function,file);CHKERRQ(ierr);
+  ierr = (*PetscTrFreeBase)(a,line,function,file);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -398,7 +426,7 @@ PetscErrorCode PetscTrReallocDefault(size_t len, int lineno, const char function
   if (head->next) head->next->prev = head->prev;
 
   nsize = (len + (PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1);
-  ierr  = PetscReallocAlign(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
+  ierr  = (*PetscTrReallocBase)(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
 
   head  = (TRSPACE*)inew;
   inew += sizeof(TrSPACE);
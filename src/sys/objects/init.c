@@ -8,6 +8,7 @@
 
 #include <petscsys.h>        /*I  "petscsys.h"   I*/
 #include <petsc/private/petscimpl.h>
+#include <petsc/private/logimpl.h>
 #include <petscvalgrind.h>
 #include <petscviewer.h>
 #if defined(PETSC_USE_LOG)
@@ -306,6 +307,8 @@ PetscErrorCode  PetscEnd(void)
 PetscBool PetscOptionsPublish = PETSC_FALSE;
 PETSC_INTERN PetscErrorCode PetscSetUseTrMalloc_Private(void);
 PETSC_INTERN PetscErrorCode PetscSetUseHBWMalloc_Private(void);
+PETSC_INTERN PetscErrorCode PetscSetUsePoolMalloc_Private(void);
+PETSC_INTERN PetscErrorCode PetscSetUseLargeMalloc_Private(void);
 PETSC_INTERN PetscBool      petscsetmallocvisited;
 static       char           emacsmachinename[256];
 
@@ -361,6 +364,19 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   PetscFunctionBegin;
   ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
 
+  /*
+      Placement of large allocations on huge pages and NUMA nodes, underneath any malloc
+  */
+  ierr = PetscSetUseLargeMalloc_Private();CHKERRQ(ierr);
+
+  /*
+      The pool goes first so that the tracing below is put on top of it
+  */
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool",&flg1,NULL);CHKERRQ(ierr);
+  /* ignore this option if malloc is already set */
+  if (flg1 && !petscsetmallocvisited) {ierr = PetscSetUsePoolMalloc_Private();CHKERRQ(ierr);}
+
 #if !defined(PETSC_HAVE_THREADSAFETY)
   /*
       Setup the memory management; support for tracing malloc() usage
@@ -498,6 +514,17 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   if (flg1) {ierr = PetscSetFPTrap(PETSC_FP_TRAP_ON);CHKERRQ(ierr);}
   ierr = PetscOptionsGetInt(NULL,NULL,"-check_pointer_intensity",&intensity,&flag);CHKERRQ(ierr);
   if (flag) {ierr = PetscCheckPointerSetIntensity(intensity);CHKERRQ(ierr);}
+  {
+    PetscInt  radix = PETSC_DEFAULT,threads = PETSC_DEFAULT;
+    PetscBool flgr,flgt;
+
+    ierr = PetscOptionsGetInt(NULL,NULL,"-sort_radix_threshold",&radix,&flgr);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(NULL,NULL,"-sort_radix_threads_threshold",&threads,&flgt);CHKERRQ(ierr);
+    /* a negative threshold means never, even -2 which PetscSortSetRadixThresholds() would take as PETSC_DEFAULT */
+    if (flgr && radix < 0)   radix   = PETSC_DETERMINE;
+    if (flgt && threads < 0) threads = PETSC_DETERMINE;
+    if (flgr || flgt) {ierr = PetscSortSetRadixThresholds(radix,threads);CHKERRQ(ierr);}
+  }
 
   /*
       Setup debugger information
@@ -631,12 +658,17 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     if (PetscLogMemory) {
       ierr = PetscSetUseTrMalloc_Private();CHKERRQ(ierr);
     }
+    flg1 = PETSC_FALSE;
+    ierr = PetscOptionsGetBool(NULL,NULL,"-log_view_hwcounters",&flg1,NULL);CHKERRQ(ierr);
+    if (flg1) {ierr = PetscLogHWCountersBegin_Internal();CHKERRQ(ierr);}
   }
   if (flg4 && format == PETSC_VIEWER_ASCII_XML) {
     PetscReal threshold = PetscRealConstant(0.01);
     ierr = PetscOptionsGetReal(NULL,NULL,"-log_threshold",&threshold,&flg1);CHKERRQ(ierr);
     if (flg1) {ierr = PetscLogSetThreshold((PetscLogDouble)threshold,NULL);CHKERRQ(ierr);}
   }
+  ierr = PetscOptionsHasName(NULL,NULL,"-log_chrome_trace",&flg1);CHKERRQ(ierr);
+  if (flg1) {ierr = PetscLogChromeTraceBegin();CHKERRQ(ierr);}
 #endif
 
   ierr = PetscOptionsGetBool(NULL,NULL,"-saws_options",&PetscOptionsPublish,NULL);CHKERRQ(ierr);
@@ -679,6 +711,13 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -malloc_info: prints total memory usage\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_log: keeps log of all memory allocations\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_debug: enables extended checking for memory corruption\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool: serve small PetscMalloc() requests from size class free lists\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool_view: print the usage of the -malloc_pool pool for each stage\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_hugepage: put allocations above -malloc_hugepage_threshold <2097152> bytes on transparent huge pages\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_numa <default,local,interleave,bind>: NUMA policy for those allocations, on the nodes of -malloc_numa_nodes <list>\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_first_touch: have the OpenMP threads touch those allocations with a static schedule\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -sort_radix_threshold <512>: PetscSortInt() and friends use a radix sort from this length on, negative for never\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -sort_radix_threads_threshold <1048576>: the radix sort uses all OpenMP threads from this length on, negative for never\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_view: dump list of options inputted\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left: dump list of unused options\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left no: don't dump list of unused options\n");CHKERRQ(ierr);
@@ -689,7 +728,9 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
 #if defined(PETSC_USE_LOG)
     ierr = (*PetscHelpPrintf)(comm," -get_total_flops: total flops over all processors\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_view [:filename:[format]]: logging objects and events\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_view_hwcounters: add hardware counters (cycles, instructions, cache misses) to -log_view\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_trace [filename]: prints trace of all PETSc calls\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_chrome_trace [filename]: timeline of events and MPI waits in the Chrome trace format, default petsc_trace.json\n");CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPE)
     ierr = (*PetscHelpPrintf)(comm," -log_mpe: Also create logfile viewable through Jumpshot\n");CHKERRQ(ierr);
 #endif
@@ -28,6 +28,7 @@ PETSC_INTERN PetscErrorCode PetscFunctionListPrintAll(void);
 PETSC_INTERN PetscErrorCode PetscSequentialPhaseBegin_Private(MPI_Comm,int);
 PETSC_INTERN PetscErrorCode PetscSequentialPhaseEnd_Private(MPI_Comm,int);
 PETSC_INTERN PetscErrorCode PetscCloseHistoryFile(FILE**);
+PETSC_INTERN PetscErrorCode PetscMallocPoolFinalize_Private(void);
 
 /* user may set this BEFORE calling PetscInitialize() */
 MPI_Comm PETSC_COMM_WORLD = MPI_COMM_NULL;
@@ -699,6 +700,10 @@ PetscInt PetscNumOMPThreads;
 .  -malloc_debug - check for memory corruption at EVERY malloc or free
 .  -malloc_dump - prints a list of all unfreed memory at the end of the run
 .  -malloc_test - like -malloc_dump -malloc_debug, but only active for debugging builds
+.  -malloc_pool - serve small allocations from size class free lists, see PetscMallocPoolView()
+.  -malloc_hugepage - map allocations of at least -malloc_hugepage_threshold <bytes> bytes on transparent huge pages
+.  -malloc_numa <default,local,interleave,bind> - NUMA placement of those allocations, -malloc_numa_nodes <list> selects the nodes
+.  -malloc_first_touch - initialize those allocations with the static OpenMP schedule of the threaded kernels
 .  -fp_trap - Stops on floating point exceptions (Note that on the
               IBM RS6000 this slows code by at least a factor of 10.)
 .  -no_signal_handler - Indicates not to trap error signals
@@ -722,6 +727,7 @@ PetscInt PetscNumOMPThreads;
 .  -log_exclude: <vec,mat,pc,ksp,snes> - excludes subset of object classes from logging
 .  -log_all [filename] - Logs extensive profiling information  See PetscLogDump().
 .  -log [filename] - Logs basic profiline information  See PetscLogDump().
+.  -log_chrome_trace [filename] - Writes a timeline of the events and MPI waits viewable with chrome://tracing or Perfetto. See PetscLogChromeTraceBegin().
 .  -log_mpe [filename] - Creates a logfile viewable by the utility Jumpshot (in MPICH distribution)
 .  -viewfromoptions on,off - Enable or disable XXXSetFromOptions() calls, for applications with many small solves turn this off
 -  -check_pointer_intensity 0,1,2 - if pointers are checked for validity (debug version only), using 0 will result in faster code
@@ -1360,8 +1366,16 @@ PetscErrorCode  PetscFinalize(void)
   ierr = PetscOptionsGetString(NULL,NULL,"-log_all",mname,PETSC_MAX_PATH_LEN,&flg1);CHKERRQ(ierr);
   ierr = PetscOptionsGetString(NULL,NULL,"-log",mname,PETSC_MAX_PATH_LEN,&flg2);CHKERRQ(ierr);
   if (flg1 || flg2) {ierr = PetscLogDump(mname);CHKERRQ(ierr);}
+
+  mname[0] = 0;
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_chrome_trace",mname,PETSC_MAX_PATH_LEN,&flg1);CHKERRQ(ierr);
+  if (flg1) {ierr = PetscLogChromeTraceDump(mname);CHKERRQ(ierr);}
 #endif
 
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool_view",&flg1,NULL);CHKERRQ(ierr);
+  if (flg1) {ierr = PetscMallocPoolView(PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);}
+
   ierr = PetscStackDestroy();CHKERRQ(ierr);
 
   flg1 = PETSC_FALSE;
@@ -1612,6 +1626,7 @@ PetscErrorCode  PetscFinalize(void)
    memory was not freed.
 
 */
+  ierr = PetscMallocPoolFinalize_Private();CHKERRQ(ierr);
   ierr = PetscMallocClear();CHKERRQ(ierr);
 
   PetscInitializeCalled = PETSC_FALSE;
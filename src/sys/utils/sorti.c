@@ -1,9 +1,12 @@
 
 /*
    This file contains routines for sorting integers. Values are sorted in place.
-   One can use src/sys/examples/tests/ex52.c for benchmarking.
+   One can use src/sys/examples/tests/ex52.c and src/benchmarks/PetscSortInt.c for benchmarking.
  */
 #include <petsc/private/petscimpl.h>                /*I  "petscsys.h"  I*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
 
 #define MEDIAN3(v,a,b,c)                                                        \
   (v[a]<v[b]                                                                    \
@@ -156,6 +159,142 @@
     }                                                                            \
   } while(0)
 
+/*
+   LSD radix sort of PetscInt keys, optionally carrying one or two PetscInt arrays along: one stable counting sort per
+   byte of the key, least significant byte first, ping-ponging between the arrays and a work array. The sign bit is
+   flipped in the most significant byte so that negative keys come first. The histograms of all bytes are gathered in a
+   single sweep, and a pass in which all keys have the same byte is skipped, so indices below 2^16 take two passes
+   whatever the size of PetscInt.
+
+   With OpenMP each thread histograms and scatters a contiguous block of the array; the offsets are ordered by bucket,
+   then by thread, which keeps every pass stable.
+*/
+#define PETSC_RADIX_BITS 8
+#define PETSC_RADIX_SIZE (1 << PETSC_RADIX_BITS)
+#define RadixDigit(x,d,nd) ((PetscInt)(((x) >> (PETSC_RADIX_BITS*(d))) & (PETSC_RADIX_SIZE-1)) ^ ((d) == (nd)-1 ? PETSC_RADIX_SIZE/2 : 0))
+
+static PetscInt PetscSortRadixThreshold       = 512;     /* Sorts of this many keys or more use the radix sort */
+static PetscInt PetscSortRadixThreadThreshold = 1048576; /* and of this many keys or more use all the OpenMP threads */
+
+static PetscErrorCode PetscSortIntRadix_Private(PetscInt n,PetscInt X[],PetscInt Y[],PetscInt Z[])
+{
+  PetscErrorCode ierr;
+  const PetscInt nd = (PetscInt) sizeof(PetscInt);
+  PetscInt       *X1 = X,*Y1 = Y,*Z1 = Z,*X2,*Y2,*Z2,*count,*t,d,b,c,s,nt = 1,th;
+  PetscBool      moved = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  /* Many index arrays come sorted already, which costs the radix sort as much as any other input */
+  for (s = 1; s < n; ++s) if (X[s-1] > X[s]) break;
+  if (s >= n) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_OPENMP)
+  if (n >= PetscSortRadixThreadThreshold && !omp_in_parallel()) nt = (PetscInt) omp_get_max_threads();
+#endif
+  ierr = PetscMalloc4(n,&X2,Y ? n : 0,&Y2,Z ? n : 0,&Z2,nt*nd*PETSC_RADIX_SIZE,&count);CHKERRQ(ierr);
+  /* count[(th*nd+d)*PETSC_RADIX_SIZE+b] is the number of keys of block th with byte d equal to b */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) private(d) if(nt > 1)
+#endif
+  for (th = 0; th < nt; ++th) {
+    const PetscInt lo = (PetscInt) (((PetscInt64) n*th)/nt),hi = (PetscInt) (((PetscInt64) n*(th+1))/nt);
+    PetscInt       *cnt = count+th*nd*PETSC_RADIX_SIZE,i;
+
+    for (i = 0; i < nd*PETSC_RADIX_SIZE; ++i) cnt[i] = 0;
+    for (i = lo; i < hi; ++i) for (d = 0; d < nd; ++d) cnt[d*PETSC_RADIX_SIZE+RadixDigit(X[i],d,nd)]++;
+  }
+  for (d = 0; d < nd; ++d) {
+    /* A pass in which every key has the same byte as the first one would not move anything */
+    b = RadixDigit(X1[0],d,nd);
+    for (c = 0, th = 0; th < nt; ++th) c += count[(th*nd+d)*PETSC_RADIX_SIZE+b];
+    if (c == n) continue;
+    if (nt > 1 && moved) {
+      /* The totals per bucket do not change, but the keys have moved between the blocks since the first sweep */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+      for (th = 0; th < nt; ++th) {
+        const PetscInt lo = (PetscInt) (((PetscInt64) n*th)/nt),hi = (PetscInt) (((PetscInt64) n*(th+1))/nt);
+        PetscInt       *cnt = count+(th*nd+d)*PETSC_RADIX_SIZE,i;
+
+        for (i = 0; i < PETSC_RADIX_SIZE; ++i) cnt[i] = 0;
+        for (i = lo; i < hi; ++i) cnt[RadixDigit(X1[i],d,nd)]++;
+      }
+    }
+    /* Turn the counts of this byte into the offset where each block puts its first key of each bucket */
+    for (s = 0, b = 0; b < PETSC_RADIX_SIZE; ++b) {
+      for (th = 0; th < nt; ++th) {
+        PetscInt *cnt = count+(th*nd+d)*PETSC_RADIX_SIZE+b;
+
+        c = *cnt; *cnt = s; s += c;
+      }
+    }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) if(nt > 1)
+#endif
+    for (th = 0; th < nt; ++th) {
+      const PetscInt lo = (PetscInt) (((PetscInt64) n*th)/nt),hi = (PetscInt) (((PetscInt64) n*(th+1))/nt);
+      PetscInt       *off = count+(th*nd+d)*PETSC_RADIX_SIZE,i,k;
+
+      if (Z1) {
+        for (i = lo; i < hi; ++i) {k = off[RadixDigit(X1[i],d,nd)]++; X2[k] = X1[i]; Y2[k] = Y1[i]; Z2[k] = Z1[i];}
+      } else if (Y1) {
+        for (i = lo; i < hi; ++i) {k = off[RadixDigit(X1[i],d,nd)]++; X2[k] = X1[i]; Y2[k] = Y1[i];}
+      } else {
+        for (i = lo; i < hi; ++i) {k = off[RadixDigit(X1[i],d,nd)]++; X2[k] = X1[i];}
+      }
+    }
+    t = X1; X1 = X2; X2 = t;
+    t = Y1; Y1 = Y2; Y2 = t;
+    t = Z1; Z1 = Z2; Z2 = t;
+    moved = PETSC_TRUE;
+  }
+  if (X1 != X) {
+    /* An odd number of passes was made, so the result is in the work arrays now pointed to by X1, Y1, Z1 */
+    ierr = PetscMemcpy(X,X1,n*sizeof(PetscInt));CHKERRQ(ierr);
+    if (Y) {ierr = PetscMemcpy(Y,Y1,n*sizeof(PetscInt));CHKERRQ(ierr);}
+    if (Z) {ierr = PetscMemcpy(Z,Z1,n*sizeof(PetscInt));CHKERRQ(ierr);}
+    X2 = X1; Y2 = Y1; Z2 = Z1;
+  }
+  ierr = PetscFree4(X2,Y2,Z2,count);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscSortSetRadixThresholds - Sets the array lengths from which PetscSortInt(), PetscSortIntWithArray() and
+   PetscSortIntWithArrayPair() use a radix sort instead of a quicksort, and from which the radix sort uses all the
+   OpenMP threads
+
+   Not Collective
+
+   Input Parameters:
++  radix   - sort arrays of at least this length with the radix sort, PETSC_DEFAULT for 512, or -1 (PETSC_DETERMINE) to never use it
+-  threads - use all the OpenMP threads for arrays of at least this length, PETSC_DEFAULT for 1048576, or -1 (PETSC_DETERMINE) to never use them
+
+   Options Database Keys:
++  -sort_radix_threshold <512> - the radix threshold, use a negative value to always use the quicksort
+-  -sort_radix_threads_threshold <1048576> - the threads threshold, a negative value keeps the radix sort on one thread; it has no effect without OpenMP
+
+   Level: developer
+
+   Notes:
+   Since PETSC_DEFAULT is -2, any negative value other than PETSC_DEFAULT also means never; the options database maps every
+   negative value to never.
+
+   The radix sort takes a work array of the size of the input and of each companion array. It is stable, so unlike
+   with the quicksort, the companion entries of equal keys keep their relative order.
+
+   The benchmark src/benchmarks/PetscSortInt.c compares the two on typical index distributions.
+
+.seealso: PetscSortInt(), PetscSortIntWithArray(), PetscSortIntWithArrayPair()
+@*/
+PetscErrorCode PetscSortSetRadixThresholds(PetscInt radix,PetscInt threads)
+{
+  PetscFunctionBegin;
+  PetscSortRadixThreshold       = radix == PETSC_DEFAULT ? 512 : (radix < 0 ? PETSC_MAX_INT : radix);
+  PetscSortRadixThreadThreshold = threads == PETSC_DEFAULT ? 1048576 : (threads < 0 ? PETSC_MAX_INT : threads);
+  PetscFunctionReturn(0);
+}
+
 /*@
    PetscSortInt - Sorts an array of integers in place in increasing order.
 
@@ -175,7 +314,8 @@ PetscErrorCode  PetscSortInt(PetscInt n,PetscInt X[])
   PetscInt       pivot,t1;
 
   PetscFunctionBegin;
-  QuickSort1(PetscSortInt,X,n,pivot,t1,ierr);
+  if (n >= PetscSortRadixThreshold) {ierr = PetscSortIntRadix_Private(n,X,NULL,NULL);CHKERRQ(ierr);}
+  else QuickSort1(PetscSortInt,X,n,pivot,t1,ierr);
   PetscFunctionReturn(0);
 }
 
@@ -325,7 +465,8 @@ PetscErrorCode  PetscSortIntWithArray(PetscInt n,PetscInt X[],PetscInt Y[])
   PetscInt       pivot,t1,t2;
 
   PetscFunctionBegin;
-  QuickSort2(PetscSortIntWithArray,X,Y,n,pivot,t1,t2,ierr);
+  if (n >= PetscSortRadixThreshold) {ierr = PetscSortIntRadix_Private(n,X,Y,NULL);CHKERRQ(ierr);}
+  else QuickSort2(PetscSortIntWithArray,X,Y,n,pivot,t1,t2,ierr);
   PetscFunctionReturn(0);
 }
 
@@ -351,7 +492,8 @@ PetscErrorCode  PetscSortIntWithArrayPair(PetscInt n,PetscInt X[],PetscInt Y[],P
   PetscInt       pivot,t1,t2,t3;
 
   PetscFunctionBegin;
-  QuickSort3(PetscSortIntWithArrayPair,X,Y,Z,n,pivot,t1,t2,t3,ierr);
+  if (n >= PetscSortRadixThreshold) {ierr = PetscSortIntRadix_Private(n,X,Y,Z);CHKERRQ(ierr);}
+  else QuickSort3(PetscSortIntWithArrayPair,X,Y,Z,n,pivot,t1,t2,t3,ierr);
   PetscFunctionReturn(0);
 }
 
@@ -612,6 +612,12 @@ PetscErrorCode IJacobian(TS ts,PetscReal t,Vec U,Vec Udot,PetscReal a,Mat A,Mat
       nsize: 2
       args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -ksp_monitor_short -da_grid_x 16 -da_grid_y 16 -ts_trajectory_dirname Test-dir -ts_trajectory_file_template test-%06D.cp
 
+   test:
+      suffix: async
+      nsize: 2
+      args: -ts_max_steps 10 -ts_monitor -ts_adjoint_monitor -ksp_monitor_short -da_grid_x 16 -da_grid_y 16 -ts_trajectory_type async -ts_trajectory_async_buffers 1 -ts_trajectory_dirname Test-async-dir
+      output_file: output/ex5adj_2.out
+
    test:
       suffix: 3
       nsize: 2
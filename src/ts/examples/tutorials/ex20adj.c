@@ -467,4 +467,29 @@ int main(int argc,char **argv)
       args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type memory -ts_trajectory_max_cps_ram 3 -ts_trajectory_max_cps_disk 8 -ts_trajectory_stride 5 -ts_trajectory_solution_only 0 -ts_trajectory_save_stack 0
       output_file: output/ex20adj_2.out
 
+    test:
+      suffix: 22
+      args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type memory -ts_trajectory_solution_only -ts_trajectory_compression lossless
+      output_file: output/ex20adj_2.out
+
+    test:
+      suffix: 23
+      args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type memory -ts_trajectory_stride 5 -ts_trajectory_solution_only 0 -ts_trajectory_save_stack -ts_trajectory_compression lossless
+      output_file: output/ex20adj_2.out
+
+    test:
+      suffix: 24
+      args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type memory -ts_trajectory_solution_only 0 -ts_trajectory_compression lossy -ts_trajectory_compression_tol 1e-14
+      output_file: output/ex20adj_2.out
+
+    test:
+      suffix: 25
+      args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type async -ts_trajectory_solution_only 0
+      output_file: output/ex20adj_2.out
+
+    test:
+      suffix: 26
+      args: -ts_type cn -ts_dt 0.001 -mu 100000 -ts_max_steps 15 -ts_trajectory_type memory -ts_trajectory_max_cps_ram 3 -ts_trajectory_stride 5 -ts_trajectory_solution_only 0 -ts_trajectory_compression lossless -ts_trajectory_compression_ratio 2
+      output_file: output/ex20adj_2.out
+
 TEST*/
@@ -1039,11 +1039,11 @@ PetscErrorCode TSAdjointSetUp(TS ts)
   if (!ts->vecs_sensi) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Must call TSSetCostGradients() first");
   if (ts->vecs_sensip && !ts->Jacp && !ts->Jacprhs) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Must call TSSetRHSJacobianP() or TSSetIJacobianP() first");
   ierr = TSGetTrajectory(ts,&tj);CHKERRQ(ierr);
-  ierr = PetscObjectTypeCompare((PetscObject)tj,TSTRAJECTORYBASIC,&match);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)tj,&match,TSTRAJECTORYBASIC,TSTRAJECTORYASYNC,"");CHKERRQ(ierr);
   if (match) {
     PetscBool solution_only;
     ierr = TSTrajectoryGetSolutionOnly(tj,&solution_only);CHKERRQ(ierr);
-    if (solution_only) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_USER,"TSAdjoint cannot use the solution-only mode when choosing the Basic TSTrajectory type. Turn it off with -ts_trajectory_solution_only 0");
+    if (solution_only) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_USER,"TSAdjoint cannot use the solution-only mode when choosing the %s TSTrajectory type. Turn it off with -ts_trajectory_solution_only 0",((PetscObject)tj)->type_name);
   }
   ierr = TSTrajectorySetUseHistory(tj,PETSC_FALSE);CHKERRQ(ierr); /* not use TSHistory */
 
@@ -0,0 +1,480 @@
+#include <petsc/private/tsimpl.h>        /*I "petscts.h"  I*/
+#include <errno.h>
+#include <fcntl.h>
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#if defined(PETSC_HAVE_IO_H)
+#include <io.h>
+#endif
+#if defined(PETSC_HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+
+/*
+   Each rank writes the local part of a checkpoint to its own file in the trajectory directory, so a background thread can do
+   the I/O without calling MPI. A checkpoint goes through one of the staging buffers: TSTrajectorySet() copies it in and queues
+   it for writing, TSTrajectoryGet() takes it from a buffer the thread has read it into. In the adjoint sweep the steps are
+   retrieved in decreasing order, so after each TSTrajectoryGet() the free buffers are queued to read the next steps.
+*/
+
+typedef enum {BUFFER_FREE,BUFFER_WRITE,BUFFER_READ,BUFFER_READY} BufferState;
+
+typedef struct {
+  BufferState state;
+  BufferState op;       /* last transfer queued, BUFFER_WRITE or BUFFER_READ */
+  PetscInt    ticket;   /* queued buffers are processed in the order of their tickets */
+  PetscInt    stepnum;
+  PetscInt    nvec;     /* number of vectors held: the solution and possibly the stages */
+  PetscReal   time,tprev;
+  PetscScalar *data;
+  int         err;      /* errno of a failed transfer, or one of the TSTRAJECTORYASYNC_ERR codes below */
+  char        filename[PETSC_MAX_PATH_LEN];
+} TSTrajectoryAsyncBuffer;
+
+typedef struct {
+  PetscInt                nbuf;
+  TSTrajectoryAsyncBuffer *buf;
+  PetscInt                n,ns;      /* local size of the solution and number of stages */
+  PetscInt                ticket;
+  PetscBool               ownsdir;   /* the directory was created by this rank on a node without rank 0 */
+  PetscInt                stalls,hits,misses;
+#if defined(PETSC_HAVE_PTHREAD)
+  pthread_t               thread;
+  pthread_mutex_t         lock;
+  pthread_cond_t          cond;
+  PetscBool               running,finish;
+#endif
+} TSTrajectory_Async;
+
+typedef struct {
+  PetscInt  stepnum,nvec,n;
+  PetscReal time,tprev;
+} TSTrajectoryAsyncHeader;
+
+/* Failures that do not set errno, negative so that they cannot clash with errno values */
+#define TSTRAJECTORYASYNC_ERR_EOF    -1
+#define TSTRAJECTORYASYNC_ERR_HEADER -2
+
+static const char *TSTrajectoryAsyncStrError(int err)
+{
+  if (err == TSTRAJECTORYASYNC_ERR_EOF)    return "unexpected end of file";
+  if (err == TSTRAJECTORYASYNC_ERR_HEADER) return "checkpoint header does not match the step or the vector size";
+  return strerror(err);
+}
+
+/* Moves a buffer to or from its file, called by the I/O thread without holding the lock. Uses no PETSc or MPI calls */
+static void TSTrajectoryAsyncTransfer(TSTrajectoryAsyncBuffer *b,PetscInt n)
+{
+  TSTrajectoryAsyncHeader hdr;
+  size_t                  len = (size_t)(b->nvec*n)*sizeof(PetscScalar),off;
+  char                    *p = (char*)b->data;
+  ssize_t                 m;
+  int                     fd;
+
+  b->err = 0;
+  errno  = 0;
+  if (b->op == BUFFER_WRITE) {
+    hdr.stepnum = b->stepnum;
+    hdr.nvec    = b->nvec;
+    hdr.n       = n;
+    hdr.time    = b->time;
+    hdr.tprev   = b->tprev;
+    if ((fd = open(b->filename,O_WRONLY|O_CREAT|O_TRUNC,0666)) == -1) {b->err = errno; return;}
+    errno = 0;
+    if (write(fd,&hdr,sizeof(hdr)) != (ssize_t)sizeof(hdr)) b->err = errno ? errno : EIO;
+    for (off=0; !b->err && off<len; off+=(size_t)m) {
+      errno = 0;
+      if ((m = write(fd,p+off,len-off)) <= 0) b->err = errno ? errno : EIO;
+    }
+  } else {
+    if ((fd = open(b->filename,O_RDONLY)) == -1) {b->err = errno; return;}
+    errno = 0;
+    m = read(fd,&hdr,sizeof(hdr));
+    if (m < 0) b->err = errno ? errno : EIO;
+    else if (m != (ssize_t)sizeof(hdr)) b->err = TSTRAJECTORYASYNC_ERR_EOF;
+    else if (hdr.stepnum != b->stepnum || hdr.n != n) b->err = TSTRAJECTORYASYNC_ERR_HEADER;
+    else {
+      b->nvec  = hdr.nvec;
+      b->time  = hdr.time;
+      b->tprev = hdr.tprev;
+      len      = (size_t)(b->nvec*n)*sizeof(PetscScalar);
+    }
+    for (off=0; !b->err && off<len; off+=(size_t)m) {
+      errno = 0;
+      if ((m = read(fd,p+off,len-off)) < 0) b->err = errno ? errno : EIO;
+      else if (!m) b->err = TSTRAJECTORYASYNC_ERR_EOF;
+    }
+  }
+  errno = 0;
+  if (close(fd) && !b->err) b->err = errno ? errno : EIO;
+}
+
+/* Without threads the transfers are done when they are queued, so nobody ever waits */
+#if defined(PETSC_HAVE_PTHREAD)
+#define TSTrajectoryAsyncLock(tja)   pthread_mutex_lock(&(tja)->lock)
+#define TSTrajectoryAsyncUnlock(tja) pthread_mutex_unlock(&(tja)->lock)
+#define TSTrajectoryAsyncSleep(tja)  pthread_cond_wait(&(tja)->cond,&(tja)->lock)
+
+static void *TSTrajectoryAsyncThread(void *ctx)
+{
+  TSTrajectory_Async      *tja = (TSTrajectory_Async*)ctx;
+  TSTrajectoryAsyncBuffer *b;
+  PetscInt                i;
+
+  TSTrajectoryAsyncLock(tja);
+  while (PETSC_TRUE) {
+    for (b=NULL,i=0; i<tja->nbuf; i++) {
+      if ((tja->buf[i].state == BUFFER_WRITE || tja->buf[i].state == BUFFER_READ) && (!b || tja->buf[i].ticket < b->ticket)) b = &tja->buf[i];
+    }
+    if (!b) {
+      if (tja->finish) break;
+      TSTrajectoryAsyncSleep(tja);
+      continue;
+    }
+    TSTrajectoryAsyncUnlock(tja);
+    TSTrajectoryAsyncTransfer(b,tja->n);
+    TSTrajectoryAsyncLock(tja);
+    b->state = b->op == BUFFER_WRITE ? BUFFER_FREE : BUFFER_READY;
+    pthread_cond_broadcast(&tja->cond);
+  }
+  TSTrajectoryAsyncUnlock(tja);
+  return NULL;
+}
+#else
+#define TSTrajectoryAsyncLock(tja)   (void)0
+#define TSTrajectoryAsyncUnlock(tja) (void)0
+#define TSTrajectoryAsyncSleep(tja)  (void)0
+#endif
+
+/* Queues a buffer for the I/O thread, called with the lock held */
+static void TSTrajectoryAsyncQueue(TSTrajectory_Async *tja,TSTrajectoryAsyncBuffer *b,BufferState op)
+{
+  b->op     = op;
+  b->state  = op;
+  b->ticket = tja->ticket++;
+#if defined(PETSC_HAVE_PTHREAD)
+  pthread_cond_broadcast(&tja->cond);
+#else
+  TSTrajectoryAsyncTransfer(b,tja->n);
+  b->state = op == BUFFER_WRITE ? BUFFER_FREE : BUFFER_READY;
+#endif
+}
+
+/* Returns an idle buffer, waiting for the I/O thread to drain one if needed. Buffers holding no step are taken first */
+static PetscErrorCode TSTrajectoryAsyncGetFree(TSTrajectory_Async *tja,TSTrajectoryAsyncBuffer **buf)
+{
+  TSTrajectoryAsyncBuffer *b = NULL;
+  PetscInt                i;
+
+  PetscFunctionBegin;
+  TSTrajectoryAsyncLock(tja);
+  while (!b) {
+    for (i=0; !b && i<tja->nbuf; i++) if (tja->buf[i].state == BUFFER_FREE && tja->buf[i].stepnum < 0) b = &tja->buf[i];
+    for (i=0; !b && i<tja->nbuf; i++) if (tja->buf[i].state == BUFFER_FREE || tja->buf[i].state == BUFFER_READY) b = &tja->buf[i];
+    if (!b) {
+      tja->stalls++;
+      TSTrajectoryAsyncSleep(tja);
+    }
+  }
+  b->state   = BUFFER_FREE;
+  b->stepnum = -1;
+  TSTrajectoryAsyncUnlock(tja);
+  if (b->err && b->op == BUFFER_WRITE) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Could not write checkpoint file %s: %s",b->filename,TSTrajectoryAsyncStrError(b->err));
+  b->err = 0;
+  *buf   = b;
+  PetscFunctionReturn(0);
+}
+
+/* Returns the buffer holding a step or NULL, called with the lock held */
+static TSTrajectoryAsyncBuffer *TSTrajectoryAsyncFind(TSTrajectory_Async *tja,PetscInt stepnum)
+{
+  PetscInt i;
+
+  for (i=0; i<tja->nbuf; i++) if (tja->buf[i].stepnum == stepnum) return &tja->buf[i];
+  return NULL;
+}
+
+static PetscErrorCode TSTrajectoryAsyncFileName(TSTrajectory tj,PetscInt stepnum,char filename[])
+{
+  char           base[PETSC_MAX_PATH_LEN];
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)tj),&rank);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(base,sizeof(base),tj->dirfiletemplate,stepnum);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(filename,PETSC_MAX_PATH_LEN,"%s.%d",base,rank);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryAsyncAllocate(TSTrajectory tj,TS ts)
+{
+  TSTrajectory_Async *tja = (TSTrajectory_Async*)tj->data;
+  PetscInt           i,nvec;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (tja->buf) PetscFunctionReturn(0);
+  if (ts->forward_solve) SETERRQ(PetscObjectComm((PetscObject)tj),PETSC_ERR_SUP,"Storing the forward sensitivities is not supported, use TSTRAJECTORYBASIC");
+  ierr = VecGetLocalSize(ts->vec_sol,&tja->n);CHKERRQ(ierr);
+  tja->ns = 0;
+  if (!tj->solution_only) {
+    ierr = TSGetStages(ts,&tja->ns,NULL);CHKERRQ(ierr);
+  }
+  nvec = 1+tja->ns;
+  ierr = PetscCalloc1(tja->nbuf,&tja->buf);CHKERRQ(ierr);
+  for (i=0; i<tja->nbuf; i++) {
+    ierr = PetscMalloc1(nvec*tja->n,&tja->buf[i].data);CHKERRQ(ierr);
+    tja->buf[i].stepnum = -1;
+  }
+#if defined(PETSC_HAVE_PTHREAD)
+  tja->finish = PETSC_FALSE;
+  if (pthread_mutex_init(&tja->lock,NULL) || pthread_cond_init(&tja->cond,NULL)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not initialize the I/O thread locks");
+  if (pthread_create(&tja->thread,NULL,TSTrajectoryAsyncThread,tja)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not create the I/O thread");
+  tja->running = PETSC_TRUE;
+#endif
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectorySet_Async(TSTrajectory tj,TS ts,PetscInt stepnum,PetscReal time,Vec X)
+{
+  TSTrajectory_Async      *tja = (TSTrajectory_Async*)tj->data;
+  TSTrajectoryAsyncBuffer *b,*old;
+  const PetscScalar       *x;
+  Vec                     *Y;
+  PetscInt                i;
+  PetscErrorCode          ierr;
+
+  PetscFunctionBegin;
+  ierr = TSTrajectoryAsyncAllocate(tj,ts);CHKERRQ(ierr);
+  ierr = TSTrajectoryAsyncGetFree(tja,&b);CHKERRQ(ierr);
+  /* a recomputed step replaces the one held in memory */
+  TSTrajectoryAsyncLock(tja);
+  while ((old = TSTrajectoryAsyncFind(tja,stepnum))) {
+    while (old->state == BUFFER_WRITE || old->state == BUFFER_READ) TSTrajectoryAsyncSleep(tja);
+    old->stepnum = -1;
+  }
+  TSTrajectoryAsyncUnlock(tja);
+  ierr = TSTrajectoryAsyncFileName(tj,stepnum,b->filename);CHKERRQ(ierr);
+  b->time  = time;
+  b->tprev = time;
+  b->nvec  = 1;
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = PetscArraycpy(b->data,x,tja->n);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  if (stepnum && !tj->solution_only) {
+    ierr = TSGetStages(ts,NULL,&Y);CHKERRQ(ierr);
+    for (i=0; i<tja->ns; i++) {
+      ierr = VecGetArrayRead(Y[i],&x);CHKERRQ(ierr);
+      ierr = PetscArraycpy(b->data+(i+1)*tja->n,x,tja->n);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(Y[i],&x);CHKERRQ(ierr);
+    }
+    b->nvec += tja->ns;
+    ierr = TSGetPrevTime(ts,&b->tprev);CHKERRQ(ierr);
+  }
+  TSTrajectoryAsyncLock(tja);
+  b->stepnum = stepnum;
+  TSTrajectoryAsyncQueue(tja,b,BUFFER_WRITE);
+  TSTrajectoryAsyncUnlock(tja);
+  tj->diskwrites++;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryGet_Async(TSTrajectory tj,TS ts,PetscInt stepnum,PetscReal *t)
+{
+  TSTrajectory_Async      *tja = (TSTrajectory_Async*)tj->data;
+  TSTrajectoryAsyncBuffer *b;
+  PetscScalar             *x;
+  Vec                     *Y;
+  PetscInt                i,next;
+  PetscErrorCode          ierr;
+
+  PetscFunctionBegin;
+  ierr = TSTrajectoryAsyncAllocate(tj,ts);CHKERRQ(ierr);
+  /* the step may still be in memory from being written or prefetched */
+  TSTrajectoryAsyncLock(tja);
+  b = TSTrajectoryAsyncFind(tja,stepnum);
+  while (b && b->state == BUFFER_READ) TSTrajectoryAsyncSleep(tja);
+  TSTrajectoryAsyncUnlock(tja);
+  if (b) tja->hits++;
+  else {
+    tja->misses++;
+    ierr = TSTrajectoryAsyncGetFree(tja,&b);CHKERRQ(ierr);
+    ierr = TSTrajectoryAsyncFileName(tj,stepnum,b->filename);CHKERRQ(ierr);
+    TSTrajectoryAsyncLock(tja);
+    b->stepnum = stepnum;
+    TSTrajectoryAsyncQueue(tja,b,BUFFER_READ);
+    while (b->state == BUFFER_READ) TSTrajectoryAsyncSleep(tja);
+    TSTrajectoryAsyncUnlock(tja);
+    tj->diskreads++;
+  }
+  if (b->err && b->op == BUFFER_READ) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Could not read checkpoint file %s: %s",b->filename,TSTrajectoryAsyncStrError(b->err));
+
+  ierr = VecGetArray(ts->vec_sol,&x);CHKERRQ(ierr);
+  ierr = PetscArraycpy(x,b->data,tja->n);CHKERRQ(ierr);
+  ierr = VecRestoreArray(ts->vec_sol,&x);CHKERRQ(ierr);
+  *t = b->time;
+  if (stepnum && !tj->solution_only) {
+    ierr = TSGetStages(ts,NULL,&Y);CHKERRQ(ierr);
+    for (i=0; i<tja->ns; i++) {
+      ierr = VecGetArray(Y[i],&x);CHKERRQ(ierr);
+      ierr = PetscArraycpy(x,b->data+(i+1)*tja->n,tja->n);CHKERRQ(ierr);
+      ierr = VecRestoreArray(Y[i],&x);CHKERRQ(ierr);
+    }
+    if (tj->adjoint_solve_mode) {
+      ierr = TSSetTimeStep(ts,-(*t)+b->tprev);CHKERRQ(ierr);
+    }
+  }
+
+  /* the adjoint sweep needs the previous steps next, read them into the buffers not holding any of them */
+  if (!tj->adjoint_solve_mode) PetscFunctionReturn(0);
+  TSTrajectoryAsyncLock(tja);
+  for (next=stepnum-1,i=0; i<tja->nbuf; i++) {
+    b = &tja->buf[i];
+    if (!(b->state == BUFFER_FREE || b->state == BUFFER_READY) || (b->stepnum >= 0 && b->stepnum < stepnum)) continue;
+    while (next >= 0 && TSTrajectoryAsyncFind(tja,next)) next--;
+    if (next < 0) break;
+    ierr = TSTrajectoryAsyncFileName(tj,next,b->filename);
+    if (ierr) {TSTrajectoryAsyncUnlock(tja);CHKERRQ(ierr);}
+    b->stepnum = next;
+    TSTrajectoryAsyncQueue(tja,b,BUFFER_READ);
+    tj->diskreads++;
+  }
+  TSTrajectoryAsyncUnlock(tja);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectorySetFromOptions_Async(PetscOptionItems *PetscOptionsObject,TSTrajectory tj)
+{
+  TSTrajectory_Async *tja = (TSTrajectory_Async*)tj->data;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"TS trajectory options for Async type");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ts_trajectory_async_buffers","Number of checkpoints staged in memory for the I/O thread","TSTrajectorySetType",tja->nbuf,&tja->nbuf,NULL);CHKERRQ(ierr);
+  if (tja->nbuf < 1) SETERRQ1(PetscObjectComm((PetscObject)tj),PETSC_ERR_ARG_OUTOFRANGE,"Need at least one staging buffer, not %D",tja->nbuf);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectorySetUp_Async(TSTrajectory tj,TS ts)
+{
+  TSTrajectory_Async *tja = (TSTrajectory_Async*)tj->data;
+  char               dirname[PETSC_MAX_PATH_LEN];
+  PetscMPIInt        rank;
+  PetscBool          flg;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = TSTrajectorySetUp_Basic(tj,ts);CHKERRQ(ierr);
+  /* all ranks write, so they need the directory rank 0 may have made up */
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)tj),&rank);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscStrncpy(dirname,tj->dirname,sizeof(dirname));CHKERRQ(ierr);
+  }
+  ierr = MPI_Bcast(dirname,sizeof(dirname),MPI_CHAR,0,PetscObjectComm((PetscObject)tj));CHKERRQ(ierr);
+  if (rank) {
+    ierr = PetscFree(tj->dirname);CHKERRQ(ierr);
+    ierr = PetscStrallocpy(dirname,&tj->dirname);CHKERRQ(ierr);
+  }
+  /* with node-local storage the ranks on other nodes than rank 0 make their own directory */
+  tja->ownsdir = PETSC_FALSE;
+  if (rank) {
+    ierr = PetscTestDirectory(tj->dirname,'w',&flg);CHKERRQ(ierr);
+    if (!flg) {
+      ierr = PetscMkdir(tj->dirname);CHKERRQ(ierr);
+      tja->ownsdir = PETSC_TRUE;
+    }
+  }
+  tja->stalls = tja->hits = tja->misses = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryReset_Async(TSTrajectory tj)
+{
+  TSTrajectory_Async *tja = (TSTrajectory_Async*)tj->data;
+  PetscInt           i;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (!tja->buf) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_PTHREAD)
+  if (tja->running) { /* the thread drains the queue before it finishes */
+    TSTrajectoryAsyncLock(tja);
+    tja->finish = PETSC_TRUE;
+    pthread_cond_broadcast(&tja->cond);
+    TSTrajectoryAsyncUnlock(tja);
+    pthread_join(tja->thread,NULL);
+    pthread_cond_destroy(&tja->cond);
+    pthread_mutex_destroy(&tja->lock);
+    tja->running = PETSC_FALSE;
+  }
+#endif
+  for (i=0; i<tja->nbuf; i++) {
+    if (tja->buf[i].op == BUFFER_WRITE && tja->buf[i].err) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Could not write checkpoint file %s: %s",tja->buf[i].filename,TSTrajectoryAsyncStrError(tja->buf[i].err));
+    ierr = PetscFree(tja->buf[i].data);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(tja->buf);CHKERRQ(ierr);
+  ierr = PetscInfo3(tj,"Forward sweep waited %D times for a staging buffer, adjoint sweep found %D prefetched checkpoints and read %D\n",tja->stalls,tja->hits,tja->misses);CHKERRQ(ierr);
+  /* All the I/O threads have finished before rank 0 may remove the shared directory in TSTrajectoryDestroy() */
+  ierr = MPI_Barrier(PetscObjectComm((PetscObject)tj));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryDestroy_Async(TSTrajectory tj)
+{
+  TSTrajectory_Async *tja = (TSTrajectory_Async*)tj->data;
+  PetscMPIInt        rank;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = TSTrajectoryReset_Async(tj);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)tj),&rank);CHKERRQ(ierr);
+  if (rank && tja->ownsdir && !tj->keepfiles) { /* this rank did not see the directory of rank 0 and created its own; rank 0 removes its directory in TSTrajectoryDestroy() */
+    ierr = PetscRMTree(tj->dirname);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(tja);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+      TSTRAJECTORYASYNC - Stores each solution of the ODE/DAE in a file per rank, written and read back by a background I/O thread
+
+  Options Database Keys:
+.  -ts_trajectory_async_buffers <n> - number of checkpoints staged in memory, 2 by default
+
+  Notes:
+  TSTrajectorySet() copies the checkpoint into a staging buffer and returns, a thread then writes the buffer to disk, so the
+  forward integration only waits when all buffers are still being written. In the adjoint sweep the checkpoints of the
+  previous steps are read into the free buffers ahead of their use.
+
+  Each rank writes the local part of the vectors in its native binary format to dirname/filetemplate.rank, so the files are
+  meant as scratch data, e.g. on node-local storage, and cannot be read by VecLoad(). Ranks that do not see the directory
+  created by rank 0 create their own. Without pthreads the files are written and read synchronously.
+
+  The forward sensitivities of the second-order adjoint are not stored, use TSTRAJECTORYBASIC for them.
+
+  Level: intermediate
+
+.seealso:  TSTrajectoryCreate(), TS, TSTrajectorySetType(), TSTrajectorySetDirname(), TSTrajectorySetFiletemplate(), TSTRAJECTORYBASIC
+
+M*/
+PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Async(TSTrajectory tj,TS ts)
+{
+  TSTrajectory_Async *tja;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&tja);CHKERRQ(ierr);
+  tja->nbuf = 2;
+  tj->data  = tja;
+
+  tj->ops->set            = TSTrajectorySet_Async;
+  tj->ops->get            = TSTrajectoryGet_Async;
+  tj->ops->setup          = TSTrajectorySetUp_Async;
+  tj->ops->reset          = TSTrajectoryReset_Async;
+  tj->ops->destroy        = TSTrajectoryDestroy_Async;
+  tj->ops->setfromoptions = TSTrajectorySetFromOptions_Async;
+  PetscFunctionReturn(0);
+}
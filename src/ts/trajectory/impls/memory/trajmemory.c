@@ -9,6 +9,9 @@ static PetscErrorCode TSTrajectorySet_Memory(TSTrajectory,TS,PetscInt,PetscReal,
 
 typedef enum {NONE,TWO_LEVEL_NOREVOLVE,TWO_LEVEL_REVOLVE,TWO_LEVEL_TWO_REVOLVE,REVOLVE_OFFLINE,REVOLVE_ONLINE,REVOLVE_MULTISTAGE} SchedulerType;
 
+typedef enum {CODEC_NONE,CODEC_LOSSLESS,CODEC_LOSSY} CodecType;
+static const char *const CodecTypes[] = {"none","lossless","lossy","CodecType","CODEC_",0};
+
 typedef struct _StackElement {
   PetscInt  stepnum;
   Vec       X;
@@ -16,6 +19,8 @@ typedef struct _StackElement {
   PetscReal time;
   PetscReal timeprev; /* for no solution_only mode */
   PetscReal timenext; /* for solution_only mode */
+  char      *cbuf;    /* compressed X and Y, replaces them when the stack uses a codec */
+  size_t    cbytes;
 } *StackElement;
 
 #if defined(PETSC_HAVE_REVOLVE)
@@ -39,6 +44,12 @@ typedef struct _Stack {
   PetscInt      numY;
   PetscBool     solution_only;
   PetscBool     use_dram;
+  CodecType     codec;
+  PetscReal     codec_tol;    /* absolute error bound of CODEC_LOSSY */
+  Vec           Xwork,*Ywork; /* uncompressed copies of an element for disk transfers */
+  unsigned char *swork,*cwork; /* staging and output buffers of the codec */
+  size_t        nswork,ncwork;
+  PetscLogDouble rawbytes,cbytes; /* total sizes of the checkpoints before and after compression */
 } Stack;
 
 typedef struct _DiskStack {
@@ -59,6 +70,8 @@ typedef struct _TJScheduler {
   PetscBool     save_stack;
   PetscInt      max_cps_ram;  /* maximum checkpoints in RAM */
   PetscInt      max_cps_disk; /* maximum checkpoints on disk */
+  PetscInt      max_cps_ram_budget; /* RAM budget in uncompressed checkpoints when the checkpoints are compressed */
+  PetscReal     compression_ratio;  /* expected compression ratio, scales max_cps_ram for the schedule */
   PetscInt      stride;
   PetscInt      total_steps;  /* total number of steps */
   Stack         stack;
@@ -101,6 +114,267 @@ static PetscErrorCode TurnBackward(TS ts)
   PetscFunctionReturn(0);
 }
 
+/*
+   Checkpoint codecs. Each vector of a stack element is staged into a byte stream and compressed with a small LZ77 coder in the
+   spirit of LZ4: a sequence is a token holding the literal and match lengths, the literals, and a back reference of at least 4
+   bytes into the last 64 KB of output.
+
+     CODEC_LOSSLESS stages the bytes of the values shuffled by significance, so that exponents and high mantissa bytes of
+                    neighbouring values line up and repeat.
+     CODEC_LOSSY    quantizes the values to multiples of 2*codec_tol, so that the absolute error is at most codec_tol, and stages
+                    the zigzag varint encoded differences of neighbouring quanta. Vectors that do not fit the quantization are
+                    stored with CODEC_LOSSLESS.
+*/
+#define LZ_HASHLOG  12
+#define LZ_MINMATCH 4
+/* Largest staged bytes per value: a varint of CODEC_LOSSY takes at most 10, CODEC_LOSSLESS takes sizeof(PetscReal) */
+#define CODEC_MAX_BYTES_PER_REAL PetscMax((size_t)10,sizeof(PetscReal))
+
+typedef struct {
+  size_t    n;      /* number of real values */
+  size_t    slen;   /* bytes of the staged stream */
+  size_t    clen;   /* bytes of the compressed stream */
+  PetscInt  method; /* CODEC_LOSSLESS or CODEC_LOSSY */
+  PetscReal step;   /* quantization step of CODEC_LOSSY */
+} CodecHeader;
+
+PETSC_STATIC_INLINE size_t LZBound(size_t n) {return n + n/255 + 16;}
+
+PETSC_STATIC_INLINE void LZPutLength(unsigned char **op,size_t len)
+{
+  while (len >= 255) {*(*op)++ = 255; len -= 255;}
+  *(*op)++ = (unsigned char)len;
+}
+
+static PetscErrorCode LZCompress(const unsigned char *in,size_t n,unsigned char *out,size_t *clen)
+{
+  size_t         table[1<<LZ_HASHLOG]; /* last position+1 of each hashed 4 byte sequence */
+  size_t         ip = 0,anchor = 0,ref,len,lit;
+  unsigned int   v,w,h;
+  unsigned char  *op = out,*token;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(table,sizeof(table));CHKERRQ(ierr);
+  while (ip+LZ_MINMATCH <= n) {
+    ierr = PetscMemcpy(&v,in+ip,4);CHKERRQ(ierr);
+    h        = (v*2654435761U) >> (32-LZ_HASHLOG);
+    ref      = table[h];
+    table[h] = ip+1;
+    if (!ref || ip+1-ref > 65535) {ip++; continue;}
+    ref--;
+    ierr = PetscMemcpy(&w,in+ref,4);CHKERRQ(ierr);
+    if (v != w) {ip++; continue;}
+    for (len=LZ_MINMATCH; ip+len<n && in[ref+len] == in[ip+len]; len++) ;
+    lit    = ip-anchor;
+    token  = op++;
+    *token = (unsigned char)(PetscMin(lit,15) << 4);
+    if (lit >= 15) LZPutLength(&op,lit-15);
+    ierr   = PetscMemcpy(op,in+anchor,lit);CHKERRQ(ierr);
+    op    += lit;
+    *op++  = (unsigned char)((ip-ref) & 0xff);
+    *op++  = (unsigned char)((ip-ref) >> 8);
+    *token |= (unsigned char)PetscMin(len-LZ_MINMATCH,15);
+    if (len-LZ_MINMATCH >= 15) LZPutLength(&op,len-LZ_MINMATCH-15);
+    ip    += len;
+    anchor = ip;
+  }
+  /* the last sequence only has literals */
+  lit    = n-anchor;
+  token  = op++;
+  *token = (unsigned char)(PetscMin(lit,15) << 4);
+  if (lit >= 15) LZPutLength(&op,lit-15);
+  ierr   = PetscMemcpy(op,in+anchor,lit);CHKERRQ(ierr);
+  op    += lit;
+  *clen  = (size_t)(op-out);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode LZDecompress(const unsigned char *in,size_t clen,unsigned char *out,size_t n)
+{
+  size_t         ip = 0,op = 0,lit,len,off,k;
+  unsigned char  token,b;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  while (ip < clen) {
+    token = in[ip++];
+    lit   = token >> 4;
+    if (lit == 15) do {b = in[ip++]; lit += b;} while (b == 255 && ip < clen);
+    if (ip+lit > clen || op+lit > n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+    ierr = PetscMemcpy(out+op,in+ip,lit);CHKERRQ(ierr);
+    ip  += lit;
+    op  += lit;
+    if (ip == clen) break;
+    if (ip+2 > clen) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+    off  = (size_t)in[ip] | ((size_t)in[ip+1] << 8);
+    ip  += 2;
+    len  = token & 15;
+    if (len == 15) do {b = in[ip++]; len += b;} while (b == 255 && ip < clen);
+    len += LZ_MINMATCH;
+    if (!off || off > op || op+len > n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+    for (k=0; k<len; k++) out[op+k] = out[op-off+k]; /* the reference may overlap the output */
+    op += len;
+  }
+  if (op != n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+  PetscFunctionReturn(0);
+}
+
+/* Compress n reals into buf, which holds at least sizeof(CodecHeader)+LZBound(CODEC_MAX_BYTES_PER_REAL*n) bytes, and return the bytes used */
+static PetscErrorCode CodecCompressArray(Stack *stack,const PetscReal *a,size_t n,unsigned char *buf,size_t *len)
+{
+  CodecHeader        hdr;
+  const unsigned char *bytes = (const unsigned char*)a;
+  unsigned char      *s = stack->swork;
+  unsigned long long z;
+  PetscInt64         q,qprev = 0;
+  PetscReal          r;
+  size_t             i,k;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  hdr.n      = n;
+  hdr.method = stack->codec;
+  hdr.step   = 2*stack->codec_tol;
+  if (hdr.method == CODEC_LOSSY) {
+    for (i=0; i<n; i++) {
+      r = a[i]/hdr.step;
+      if (PetscIsInfOrNanReal(r) || PetscAbsReal(r) > 4.0e15) {hdr.method = CODEC_LOSSLESS; break;}
+      q     = (PetscInt64)PetscFloorReal(r+0.5);
+      z     = q >= qprev ? (unsigned long long)(q-qprev) << 1 : ((unsigned long long)(qprev-q-1) << 1) | 1;
+      qprev = q;
+      while (z >= 0x80) {*s++ = (unsigned char)(z | 0x80); z >>= 7;}
+      *s++ = (unsigned char)z;
+    }
+  }
+  if (hdr.method == CODEC_LOSSLESS) {
+    s = stack->swork;
+    for (k=0; k<sizeof(PetscReal); k++) {
+      for (i=0; i<n; i++) *s++ = bytes[i*sizeof(PetscReal)+k];
+    }
+  }
+  hdr.slen = (size_t)(s-stack->swork);
+  ierr = LZCompress(stack->swork,hdr.slen,buf+sizeof(CodecHeader),&hdr.clen);CHKERRQ(ierr);
+  ierr = PetscMemcpy(buf,&hdr,sizeof(CodecHeader));CHKERRQ(ierr);
+  *len = sizeof(CodecHeader)+hdr.clen;
+  PetscFunctionReturn(0);
+}
+
+/* Decompress n reals from buf and return the bytes consumed */
+static PetscErrorCode CodecDecompressArray(Stack *stack,const unsigned char *buf,PetscReal *a,size_t n,size_t *len)
+{
+  CodecHeader         hdr;
+  unsigned char       *bytes = (unsigned char*)a;
+  const unsigned char *s = stack->swork;
+  unsigned long long  z;
+  PetscInt64          q = 0;
+  size_t              i,k;
+  int                 shift;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemcpy(&hdr,buf,sizeof(CodecHeader));CHKERRQ(ierr);
+  if (hdr.n != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Compressed checkpoint holds %D values, expected %D",(PetscInt)hdr.n,(PetscInt)n);
+  ierr = LZDecompress(buf+sizeof(CodecHeader),hdr.clen,stack->swork,hdr.slen);CHKERRQ(ierr);
+  if (hdr.method == CODEC_LOSSY) {
+    for (i=0; i<n; i++) {
+      for (z=0,shift=0; *s & 0x80; s++,shift+=7) z |= (unsigned long long)(*s & 0x7f) << shift;
+      z   |= (unsigned long long)*s++ << shift;
+      q   += z & 1 ? -(PetscInt64)(z >> 1)-1 : (PetscInt64)(z >> 1);
+      a[i] = q*hdr.step;
+    }
+  } else {
+    for (k=0; k<sizeof(PetscReal); k++) {
+      for (i=0; i<n; i++) bytes[i*sizeof(PetscReal)+k] = *s++;
+    }
+  }
+  *len = sizeof(CodecHeader)+hdr.clen;
+  PetscFunctionReturn(0);
+}
+
+/* Compress the solution X and, unless only the solution is stored, the stages Y into the element */
+static PetscErrorCode ElementCompress(Stack *stack,StackElement e,Vec X,Vec *Y)
+{
+  PetscInt          i,nv,n;
+  size_t            nr,off = 0,len = 0;
+  const PetscScalar *a;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  nv = (stack->numY > 0 && !stack->solution_only) ? stack->numY+1 : 1;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  nr = (size_t)n*(sizeof(PetscScalar)/sizeof(PetscReal));
+  if (stack->nswork < CODEC_MAX_BYTES_PER_REAL*nr) {
+    ierr = PetscFree(stack->swork);CHKERRQ(ierr);
+    stack->nswork = CODEC_MAX_BYTES_PER_REAL*nr;
+    ierr = PetscMalloc1(stack->nswork,&stack->swork);CHKERRQ(ierr);
+  }
+  if (stack->ncwork < nv*(sizeof(CodecHeader)+LZBound(CODEC_MAX_BYTES_PER_REAL*nr))) {
+    ierr = PetscFree(stack->cwork);CHKERRQ(ierr);
+    stack->ncwork = nv*(sizeof(CodecHeader)+LZBound(CODEC_MAX_BYTES_PER_REAL*nr));
+    ierr = PetscMalloc1(stack->ncwork,&stack->cwork);CHKERRQ(ierr);
+  }
+  for (i=0; i<nv; i++) {
+    Vec V = i ? Y[i-1] : X;
+
+    ierr = VecGetArrayRead(V,&a);CHKERRQ(ierr);
+    ierr = CodecCompressArray(stack,(const PetscReal*)a,nr,stack->cwork+off,&len);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(V,&a);CHKERRQ(ierr);
+    off += len;
+  }
+  if (stack->use_dram) {
+    ierr = PetscMallocSetDRAM();CHKERRQ(ierr);
+  }
+  ierr = PetscFree(e->cbuf);CHKERRQ(ierr);
+  ierr = PetscMalloc1(off,&e->cbuf);CHKERRQ(ierr);
+  if (stack->use_dram) {
+    ierr = PetscMallocResetDRAM();CHKERRQ(ierr);
+  }
+  ierr = PetscMemcpy(e->cbuf,stack->cwork,off);CHKERRQ(ierr);
+  e->cbytes        = off;
+  stack->rawbytes += (PetscLogDouble)(nv*nr*sizeof(PetscReal));
+  stack->cbytes   += (PetscLogDouble)off;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode ElementDecompress(Stack *stack,StackElement e,Vec X,Vec *Y)
+{
+  PetscInt       i,nv,n;
+  size_t         nr,off = 0,len = 0;
+  PetscScalar    *a;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  nv = (stack->numY > 0 && !stack->solution_only) ? stack->numY+1 : 1;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  nr = (size_t)n*(sizeof(PetscScalar)/sizeof(PetscReal));
+  for (i=0; i<nv; i++) {
+    Vec V = i ? Y[i-1] : X;
+
+    ierr = VecGetArray(V,&a);CHKERRQ(ierr);
+    ierr = CodecDecompressArray(stack,(const unsigned char*)e->cbuf+off,(PetscReal*)a,nr,&len);CHKERRQ(ierr);
+    ierr = VecRestoreArray(V,&a);CHKERRQ(ierr);
+    off += len;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Work vectors that hold an uncompressed element while it is moved to or from disk */
+static PetscErrorCode StackGetWorkVecs(TS ts,Stack *stack)
+{
+  Vec            *Y;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (stack->Xwork) PetscFunctionReturn(0);
+  ierr = VecDuplicate(ts->vec_sol,&stack->Xwork);CHKERRQ(ierr);
+  if (stack->numY > 0 && !stack->solution_only) {
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(Y[0],stack->numY,&stack->Ywork);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
 {
   Vec            X;
@@ -112,11 +386,13 @@ static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
     ierr = PetscMallocSetDRAM();CHKERRQ(ierr);
   }
   ierr = PetscNew(e);CHKERRQ(ierr);
-  ierr = TSGetSolution(ts,&X);CHKERRQ(ierr);
-  ierr = VecDuplicate(X,&(*e)->X);CHKERRQ(ierr);
-  if (stack->numY > 0 && !stack->solution_only) {
-    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-    ierr = VecDuplicateVecs(Y[0],stack->numY,&(*e)->Y);CHKERRQ(ierr);
+  if (stack->codec == CODEC_NONE) { /* compressed elements only hold cbuf */
+    ierr = TSGetSolution(ts,&X);CHKERRQ(ierr);
+    ierr = VecDuplicate(X,&(*e)->X);CHKERRQ(ierr);
+    if (stack->numY > 0 && !stack->solution_only) {
+      ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+      ierr = VecDuplicateVecs(Y[0],stack->numY,&(*e)->Y);CHKERRQ(ierr);
+    }
   }
   if (stack->use_dram) {
     ierr = PetscMallocResetDRAM();CHKERRQ(ierr);
@@ -124,21 +400,37 @@ static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode ElementSet(TS ts,Stack *stack,StackElement *e,PetscInt stepnum,PetscReal time,Vec X)
+/* Store the solution X and the current stages in the element, compressed if the stack uses a codec */
+static PetscErrorCode ElementSetState(TS ts,Stack *stack,StackElement e,Vec X)
 {
-  Vec            *Y;
+  Vec            *Y = NULL;
   PetscInt       i;
-  PetscReal      timeprev;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = VecCopy(X,(*e)->X);CHKERRQ(ierr);
   if (stack->numY > 0 && !stack->solution_only) {
     ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+  }
+  if (stack->codec != CODEC_NONE) {
+    ierr = ElementCompress(stack,e,X,Y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecCopy(X,e->X);CHKERRQ(ierr);
+  if (stack->numY > 0 && !stack->solution_only) {
     for (i=0;i<stack->numY;i++) {
-      ierr = VecCopy(Y[i],(*e)->Y[i]);CHKERRQ(ierr);
+      ierr = VecCopy(Y[i],e->Y[i]);CHKERRQ(ierr);
     }
   }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode ElementSet(TS ts,Stack *stack,StackElement *e,PetscInt stepnum,PetscReal time,Vec X)
+{
+  PetscReal      timeprev;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = ElementSetState(ts,stack,*e,X);CHKERRQ(ierr);
   (*e)->stepnum = stepnum;
   (*e)->time    = time;
   /* for consistency */
@@ -159,9 +451,13 @@ static PetscErrorCode ElementDestroy(Stack *stack,StackElement e)
   if (stack->use_dram) {
     ierr = PetscMallocSetDRAM();CHKERRQ(ierr);
   }
-  ierr = VecDestroy(&e->X);CHKERRQ(ierr);
-  if (stack->numY > 0 && !stack->solution_only) {
-    ierr = VecDestroyVecs(stack->numY,&e->Y);CHKERRQ(ierr);
+  if (stack->codec != CODEC_NONE) {
+    ierr = PetscFree(e->cbuf);CHKERRQ(ierr);
+  } else {
+    ierr = VecDestroy(&e->X);CHKERRQ(ierr);
+    if (stack->numY > 0 && !stack->solution_only) {
+      ierr = VecDestroyVecs(stack->numY,&e->Y);CHKERRQ(ierr);
+    }
   }
   ierr = PetscFree(e);CHKERRQ(ierr);
   if (stack->use_dram) {
@@ -239,6 +535,14 @@ static PetscErrorCode StackDestroy(Stack *stack)
     }
   }
   ierr = PetscFree(stack->container);CHKERRQ(ierr);
+  ierr = VecDestroy(&stack->Xwork);CHKERRQ(ierr);
+  if (stack->Ywork) {
+    ierr = VecDestroyVecs(stack->numY,&stack->Ywork);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(stack->swork);CHKERRQ(ierr);
+  ierr = PetscFree(stack->cwork);CHKERRQ(ierr);
+  stack->nswork = 0;
+  stack->ncwork = 0;
   PetscFunctionReturn(0);
 }
 
@@ -285,7 +589,7 @@ static PetscErrorCode ReadFromDisk(PetscInt *stepnum,PetscReal *time,PetscReal *
 
 static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 {
-  Vec            *Y;
+  Vec            X,*Y,*Ye;
   PetscInt       i;
   StackElement   e = NULL;
   TJScheduler    *tjsch = (TJScheduler*)tj->data;
@@ -303,10 +607,21 @@ static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
   ierr = PetscSNPrintf(filename,sizeof(filename),"%s/TS-STACK%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(tjsch->viewer,filename);CHKERRQ(ierr);
   ierr = PetscViewerSetUp(tjsch->viewer);CHKERRQ(ierr);
+  if (stack->codec != CODEC_NONE) {
+    ierr = StackGetWorkVecs(ts,stack);CHKERRQ(ierr);
+  }
   for (i=0;i<stack->stacksize;i++) {
     e = stack->container[i];
+    if (stack->codec != CODEC_NONE) {
+      ierr = ElementDecompress(stack,e,stack->Xwork,stack->Ywork);CHKERRQ(ierr);
+      X  = stack->Xwork;
+      Ye = stack->Ywork;
+    } else {
+      X  = e->X;
+      Ye = e->Y;
+    }
     ierr = PetscLogEventBegin(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
-    ierr = WriteToDisk(e->stepnum,e->time,e->timeprev,e->X,e->Y,stack->numY,stack->solution_only,tjsch->viewer);CHKERRQ(ierr);
+    ierr = WriteToDisk(e->stepnum,e->time,e->timeprev,X,Ye,stack->numY,stack->solution_only,tjsch->viewer);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(TSTrajectory_DiskWrite,tj,ts,0,0);CHKERRQ(ierr);
     ts->trajectory->diskwrites++;
   }
@@ -325,7 +640,7 @@ static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
 
 static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 {
-  Vec            *Y;
+  Vec            X,*Y,*Ye;
   PetscInt       i;
   StackElement   e;
   PetscViewer    viewer;
@@ -340,12 +655,20 @@ static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
   }
   ierr = PetscSNPrintf(filename,sizeof filename,"%s/TS-STACK%06d.bin",tj->dirname,id);CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PetscObjectComm((PetscObject)tj),filename,FILE_MODE_READ,&viewer);CHKERRQ(ierr);
+  if (stack->codec != CODEC_NONE) {
+    ierr = StackGetWorkVecs(ts,stack);CHKERRQ(ierr);
+  }
   for (i=0;i<stack->stacksize;i++) {
     ierr = ElementCreate(ts,stack,&e);CHKERRQ(ierr);
     ierr = StackPush(stack,e);CHKERRQ(ierr);
+    X    = stack->codec != CODEC_NONE ? stack->Xwork : e->X;
+    Ye   = stack->codec != CODEC_NONE ? stack->Ywork : e->Y;
     ierr = PetscLogEventBegin(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
-    ierr = ReadFromDisk(&e->stepnum,&e->time,&e->timeprev,e->X,e->Y,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
+    ierr = ReadFromDisk(&e->stepnum,&e->time,&e->timeprev,X,Ye,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(TSTrajectory_DiskRead,tj,ts,0,0);CHKERRQ(ierr);
+    if (stack->codec != CODEC_NONE) {
+      ierr = ElementCompress(stack,e,X,Ye);CHKERRQ(ierr);
+    }
     ts->trajectory->diskreads++;
   }
   /* load the last step into TS */
@@ -470,8 +793,13 @@ static PetscErrorCode UpdateTS(TS ts,Stack *stack,StackElement e, PetscBool adjo
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = VecCopy(e->X,ts->vec_sol);CHKERRQ(ierr);
-  if (!stack->solution_only) {
+  if (stack->codec != CODEC_NONE) {
+    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+    ierr = ElementDecompress(stack,e,ts->vec_sol,Y);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(e->X,ts->vec_sol);CHKERRQ(ierr);
+  }
+  if (!stack->solution_only && stack->codec == CODEC_NONE) {
     ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
     for (i=0;i<stack->numY;i++) {
       ierr = VecCopy(e->Y[i],Y[i]);CHKERRQ(ierr);
@@ -992,8 +1320,7 @@ static PetscErrorCode GetTrajROF(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscI
 static PetscErrorCode SetTrajRON(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscInt stepnum,PetscReal time,Vec X)
 {
   Stack          *stack = &tjsch->stack;
-  Vec            *Y;
-  PetscInt       i,store;
+  PetscInt       store;
   PetscReal      timeprev;
   StackElement   e;
   RevolveCTX     *rctx = tjsch->rctx;
@@ -1006,13 +1333,7 @@ static PetscErrorCode SetTrajRON(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscI
   if (store == 1) {
     if (rctx->check != stack->top+1) { /* overwrite some non-top checkpoint in the stack */
       ierr = StackFind(stack,&e,rctx->check);CHKERRQ(ierr);
-      ierr = VecCopy(X,e->X);CHKERRQ(ierr);
-      if (stack->numY > 0 && !stack->solution_only) {
-        ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-        for (i=0;i<stack->numY;i++) {
-          ierr = VecCopy(Y[i],e->Y[i]);CHKERRQ(ierr);
-        }
-      }
+      ierr = ElementSetState(ts,stack,e,X);CHKERRQ(ierr);
       e->stepnum  = stepnum;
       e->time     = time;
       ierr        = TSGetPrevTime(ts,&timeprev);CHKERRQ(ierr);
@@ -1653,15 +1974,28 @@ PETSC_UNUSED static PetscErrorCode TSTrajectorySetUseDRAM(TSTrajectory tj,PetscB
   PetscFunctionReturn(0);
 }
 
+PETSC_UNUSED static PetscErrorCode TSTrajectorySetCompression_Memory(TSTrajectory tj,CodecType codec,PetscReal tol,PetscReal ratio)
+{
+  TJScheduler *tjsch = (TJScheduler*)tj->data;
+
+  PetscFunctionBegin;
+  tjsch->stack.codec       = codec;
+  tjsch->stack.codec_tol   = tol;
+  tjsch->compression_ratio = ratio;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TSTrajectorySetFromOptions_Memory(PetscOptionItems *PetscOptionsObject,TSTrajectory tj)
 {
   TJScheduler    *tjsch = (TJScheduler*)tj->data;
+  PetscBool      flg;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"Memory based TS trajectory options");CHKERRQ(ierr);
   {
-    ierr = PetscOptionsInt("-ts_trajectory_max_cps_ram","Maximum number of checkpoints in RAM","TSTrajectorySetMaxCpsRAM_Memory",tjsch->max_cps_ram,&tjsch->max_cps_ram,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-ts_trajectory_max_cps_ram","Maximum number of checkpoints in RAM","TSTrajectorySetMaxCpsRAM_Memory",tjsch->max_cps_ram,&tjsch->max_cps_ram,&flg);CHKERRQ(ierr);
+    if (flg) tjsch->max_cps_ram_budget = -1;
     ierr = PetscOptionsInt("-ts_trajectory_max_cps_disk","Maximum number of checkpoints on disk","TSTrajectorySetMaxCpsDisk_Memory",tjsch->max_cps_disk,&tjsch->max_cps_disk,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsInt("-ts_trajectory_stride","Stride to save checkpoints to file","TSTrajectorySetStride_Memory",tjsch->stride,&tjsch->stride,NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_REVOLVE)
@@ -1669,6 +2003,9 @@ static PetscErrorCode TSTrajectorySetFromOptions_Memory(PetscOptionItems *PetscO
 #endif
     ierr = PetscOptionsBool("-ts_trajectory_save_stack","Save all stack to disk","TSTrajectorySetSaveStack",tjsch->save_stack,&tjsch->save_stack,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsBool("-ts_trajectory_use_dram","Use DRAM for checkpointing","TSTrajectorySetUseDRAM",tjsch->stack.use_dram,&tjsch->stack.use_dram,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsEnum("-ts_trajectory_compression","Compress the checkpoints in RAM","TSTrajectorySetCompression_Memory",CodecTypes,(PetscEnum)tjsch->stack.codec,(PetscEnum*)&tjsch->stack.codec,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_trajectory_compression_tol","Absolute error bound of lossy compression","TSTrajectorySetCompression_Memory",tjsch->stack.codec_tol,&tjsch->stack.codec_tol,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_trajectory_compression_ratio","Expected compression ratio, the checkpoints given by -ts_trajectory_max_cps_ram are scaled by it","TSTrajectorySetCompression_Memory",tjsch->compression_ratio,&tjsch->compression_ratio,NULL);CHKERRQ(ierr);
   }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   tjsch->stack.solution_only = tj->solution_only;
@@ -1695,6 +2032,12 @@ static PetscErrorCode TSTrajectorySetUp_Memory(TSTrajectory tj,TS ts)
   total_steps = (PetscInt)(PetscCeilReal((ts->max_time-ts->ptime)/ts->time_step));
   total_steps = total_steps < 0 ? PETSC_MAX_INT : total_steps;
   if (fixedtimestep) tjsch->total_steps = PetscMin(ts->max_steps,total_steps);
+  if (stack->codec == CODEC_LOSSY && tjsch->stack.codec_tol <= 0) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Lossy compression of the checkpoints needs a positive -ts_trajectory_compression_tol");
+  if (stack->codec != CODEC_NONE && tjsch->compression_ratio > 1.0) { /* the RAM given in uncompressed checkpoints holds more compressed ones */
+    if (tjsch->max_cps_ram_budget == -1) tjsch->max_cps_ram_budget = tjsch->max_cps_ram;
+    if (tjsch->max_cps_ram_budget > 0) tjsch->max_cps_ram = (PetscInt)(tjsch->max_cps_ram_budget*tjsch->compression_ratio);
+    ierr = PetscInfo2(tj,"Scheduling with %D compressed checkpoints in RAM for %D uncompressed ones\n",tjsch->max_cps_ram,tjsch->max_cps_ram_budget);CHKERRQ(ierr);
+  }
   if (tjsch->max_cps_ram > 0) stack->stacksize = tjsch->max_cps_ram;
 
   if (tjsch->stride > 1) { /* two level mode */
@@ -1798,6 +2141,16 @@ static PetscErrorCode TSTrajectoryReset_Memory(TSTrajectory tj)
     }
 #endif
   }
+  if (tjsch->stack.cbytes > 0) {
+    PetscReal ratio = tjsch->stack.rawbytes/tjsch->stack.cbytes;
+
+    ierr = PetscInfo3(tj,"Compressed %g MB of checkpoints to %g MB (ratio %g)\n",(double)(tjsch->stack.rawbytes/1048576.0),(double)(tjsch->stack.cbytes/1048576.0),(double)ratio);CHKERRQ(ierr);
+    if (tjsch->compression_ratio > 1.0 && ratio < tjsch->compression_ratio) {
+      ierr = PetscInfo2(tj,"The checkpoints compressed by %g but the schedule assumed %g, lower -ts_trajectory_compression_ratio to stay within the RAM budget\n",(double)ratio,(double)tjsch->compression_ratio);CHKERRQ(ierr);
+    }
+    tjsch->stack.rawbytes = 0;
+    tjsch->stack.cbytes   = 0;
+  }
   ierr = StackDestroy(&tjsch->stack);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_REVOLVE)
   if (tjsch->stype > TWO_LEVEL_NOREVOLVE) {
@@ -1822,6 +2175,20 @@ static PetscErrorCode TSTrajectoryDestroy_Memory(TSTrajectory tj)
 /*MC
       TSTRAJECTORYMEMORY - Stores each solution of the ODE/ADE in memory
 
+  Options Database Keys:
++  -ts_trajectory_max_cps_ram <n> - maximum number of checkpoints in RAM
+.  -ts_trajectory_max_cps_disk <n> - maximum number of checkpoints on disk
+.  -ts_trajectory_stride <n> - stride of the two level checkpointing
+.  -ts_trajectory_compression <none,lossless,lossy> - compress each checkpoint when it is stored in RAM and decompress it when it is restored
+.  -ts_trajectory_compression_tol <tol> - absolute error bound of each value of a lossy compressed checkpoint
+-  -ts_trajectory_compression_ratio <r> - expected compression ratio; the RAM of -ts_trajectory_max_cps_ram uncompressed checkpoints is then scheduled as r times as many compressed ones
+
+  Notes:
+  The lossless compression shuffles the bytes of the values by significance and applies an LZ77 coder; it pays off when
+  neighbouring values share exponents, e.g. smooth fields or fields with constant regions. The lossy compression quantizes
+  the values to the given tolerance before coding them, so the adjoint is computed with a perturbed forward trajectory.
+  Run with -info to see the compression ratio achieved and tune -ts_trajectory_compression_ratio.
+
   Level: intermediate
 
 .seealso:  TSTrajectoryCreate(), TS, TSTrajectorySetType()
@@ -1849,6 +2216,10 @@ PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Memory(TSTrajectory tj,TS ts)
   tjsch->use_online   = PETSC_FALSE;
 #endif
   tjsch->save_stack   = PETSC_TRUE;
+  tjsch->max_cps_ram_budget = -1;
+  tjsch->compression_ratio  = 1.0;
+  tjsch->stack.codec        = CODEC_NONE;
+  tjsch->stack.codec_tol    = 0.0;
 
   tjsch->stack.solution_only = tj->solution_only;
   ierr = PetscViewerCreate(PetscObjectComm((PetscObject)tj),&tjsch->viewer);CHKERRQ(ierr);
@@ -505,6 +505,7 @@ PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Basic(TSTrajectory,TS);
 PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Singlefile(TSTrajectory,TS);
 PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Memory(TSTrajectory,TS);
 PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Visualization(TSTrajectory,TS);
+PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Async(TSTrajectory,TS);
 
 /*@C
   TSTrajectoryRegisterAll - Registers all of the trajectory storage schecmes in the TS package.
@@ -527,6 +528,7 @@ PetscErrorCode  TSTrajectoryRegisterAll(void)
   ierr = TSTrajectoryRegister(TSTRAJECTORYSINGLEFILE,TSTrajectoryCreate_Singlefile);CHKERRQ(ierr);
   ierr = TSTrajectoryRegister(TSTRAJECTORYMEMORY,TSTrajectoryCreate_Memory);CHKERRQ(ierr);
   ierr = TSTrajectoryRegister(TSTRAJECTORYVISUALIZATION,TSTrajectoryCreate_Visualization);CHKERRQ(ierr);
+  ierr = TSTrajectoryRegister(TSTRAJECTORYASYNC,TSTrajectoryCreate_Async);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
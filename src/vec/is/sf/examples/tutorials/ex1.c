@@ -565,4 +565,16 @@ int main(int argc,char **argv)
       suffix: 9_char
       nsize: 4
       args: -sf_type basic -test_bcast -test_reduce -test_op max -test_char
+
+   test:
+      suffix: shm
+      nsize: 4
+      args: -sf_type basic -sf_basic_shared_memory -test_bcast -test_bcastop -test_reduce -test_degree -test_fetchandop -test_embed -test_gather -test_scatter -test_invert
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: neighbor
+      nsize: 4
+      args: -sf_type neighbor -test_bcast -test_bcastop -test_reduce
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
 TEST*/
@@ -76,6 +76,7 @@ static PetscErrorCode PetscSFPackGet_Neighbor(PetscSF sf,MPI_Datatype unit,const
   }
 
   ierr = PetscNew(&link);CHKERRQ(ierr);
+  link->shmused = PETSC_FALSE; /* Neighbor has no shared memory window, PetscSFBcastAndOpEnd_Basic() and PetscSFReduceEnd_Basic() must not look for one */
   ierr = PetscSFPackSetupType((PetscSFPack)link,unit);CHKERRQ(ierr);
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
   /* Double the requests. First half are used for reduce (leaf2root) communication, second half for bcast (root2leaf) communication */
@@ -84,23 +84,33 @@ static PetscErrorCode PetscSFPackGet_Basic(PetscSF sf,MPI_Datatype unit,const vo
   ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
   ierr = PetscNew(&link);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  link->shmwin = MPI_WIN_NULL;
+#endif
   ierr = PetscSFPackSetupType((PetscSFPack)link,unit);CHKERRQ(ierr);
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
   /* Double the requests. First half are used for reduce (leaf2root) communication, second half for bcast (root2leaf) communication */
   link->half = nrootranks + nleafranks;
-  ierr       = PetscMalloc1(link->half*2,&link->requests);CHKERRQ(ierr);
+  ierr       = PetscMalloc2(link->half*2,&link->requests,link->half,&link->done);CHKERRQ(ierr);
   for (i=0; i<link->half*2; i++) link->requests[i] = MPI_REQUEST_NULL; /* Must be init'ed since some are unused but we call MPI_Waitall on them in whole */
   /* One tag per link */
   ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr);
 
+  /* Buffers of the ranks on my node live in the shared memory window */
+  if (bas->shmsize) {ierr = PetscSFPackSetUpShm_Basic(sf,link);CHKERRQ(ierr);}
+
   /* Allocate root and leaf buffers */
-  for (i=0; i<nrootranks; i++) {ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);}
+  for (i=0; i<nrootranks; i++) {
+    if (bas->shmsize && bas->rootshm[i]) continue;
+    ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
+  }
   for (i=0; i<nleafranks; i++) {
     if (i < ndleafranks) { /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
       if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
       link->leaf[i] = link->root[0];
       continue;
     }
+    if (bas->shmsize && bas->leafshm[i]) continue;
     ierr = PetscMalloc((leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
   }
 
@@ -194,15 +204,24 @@ PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
   /* Setup packing optimization for root and leaf */
   ierr = PetscSFPackSetupOptimization(sf->nranks,sf->roffset,sf->rmine,&sf->leafpackopt);CHKERRQ(ierr);
   ierr = PetscSFPackSetupOptimization(bas->niranks,bas->ioffset,bas->irootloc,&bas->rootpackopt);CHKERRQ(ierr);
+
+  /* Find the ranks on my node that can be reached through shared memory */
+  if (bas->useshm) {ierr = PetscSFSetUpShm_Basic(sf);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
 static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
 {
   PetscErrorCode ierr;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+#endif
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  ierr = PetscOptionsBool("-sf_basic_shared_memory","Communicate with the ranks on the same node through MPI-3 shared memory windows","PetscSFSetFromOptions",bas->useshm,&bas->useshm,NULL);CHKERRQ(ierr);
+#endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -221,17 +240,26 @@ PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF sf)
     PetscInt i;
     next = (PetscSFPack_Basic)link->next;
     if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
-    for (i=0; i<bas->niranks; i++) {ierr = PetscFree(link->root[i]);CHKERRQ(ierr);}
-    for (i=sf->ndranks; i<sf->nranks; i++) {ierr = PetscFree(link->leaf[i]);CHKERRQ(ierr);} /* Free only non-distinguished leaf buffers */
+    for (i=0; i<bas->niranks; i++) {
+      if (bas->shmsize && bas->rootshm[i]) continue; /* Buffers in the shared memory window */
+      ierr = PetscFree(link->root[i]);CHKERRQ(ierr);
+    }
+    for (i=sf->ndranks; i<sf->nranks; i++) { /* Free only non-distinguished leaf buffers */
+      if (bas->shmsize && bas->leafshm[i]) continue;
+      ierr = PetscFree(link->leaf[i]);CHKERRQ(ierr);
+    }
     ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
+    ierr = PetscSFPackDestroyShm_Basic(sf,link);CHKERRQ(ierr);
     /* Free persistent requests using MPI_Request_free */
     for (i=0; i<link->half*2; i++) {
       if (link->requests[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->requests[i]);CHKERRQ(ierr);}
     }
-    ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscFree2(link->requests,link->done);CHKERRQ(ierr);
     ierr = PetscFree(link);CHKERRQ(ierr);
   }
   bas->avail = NULL;
+  ierr = PetscFree2(bas->rootshm,bas->leafshm);CHKERRQ(ierr);
+  bas->shmsize = 0;
   ierr = PetscSFPackDestoryOptimization(&sf->leafpackopt);CHKERRQ(ierr);
   ierr = PetscSFPackDestoryOptimization(&bas->rootpackopt);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -249,6 +277,7 @@ PETSC_INTERN PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
 
 PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 {
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
   PetscBool      iascii;
 
@@ -256,11 +285,13 @@ PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);
+    if (bas->useshm) {ierr = PetscViewerASCIIPrintf(viewer,"  shared memory with the ranks on the same node\n");CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+/* With useshm, the ranks on my node (if any) are reached through the shared memory window instead of MPI */
+static PetscErrorCode PetscSFBcastAndOpBegin_Basic_Private(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op,PetscBool useshm)
 {
   PetscErrorCode    ierr;
   PetscSFPack_Basic link;
@@ -276,22 +307,82 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
   ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc,NULL);CHKERRQ(ierr);
   ierr = PetscSFPackGet_Basic(sf,unit,rootdata,leafdata,PETSCSF_ROOT2LEAF_BCAST,&link);CHKERRQ(ierr);
 
+  link->shmused = (PetscBool)(useshm && bas->shmsize);
+
   ierr = PetscSFPackGetReqs_Basic(sf,unit,link,PETSCSF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post leaf receives, but only from non-distinguished ranks -- distinguished ranks will receive via shared memory */
-  ierr = PetscMPIIntCast(leafoffset[nleafranks]-leafoffset[ndleafranks],&n);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(n,unit,nleafranks-ndleafranks,leafreqs+ndleafranks);CHKERRQ(ierr); /* One can wait but not start a null request */
+  if (!link->shmused) {
+    ierr = PetscMPIIntCast(leafoffset[nleafranks]-leafoffset[ndleafranks],&n);CHKERRQ(ierr);
+    ierr = MPI_Startall_irecv(n,unit,nleafranks-ndleafranks,leafreqs+ndleafranks);CHKERRQ(ierr); /* One can wait but not start a null request */
+  } else {
+    for (i=ndleafranks; i<nleafranks; i++) {
+      if (bas->leafshm[i]) continue; /* on my node */
+      ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Startall_irecv(n,unit,1,&leafreqs[i]);CHKERRQ(ierr);
+    }
+  }
 
   /* Pack and send root data */
   for (i=0; i<nrootranks; i++) {
     void *packstart = link->root[i];
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    /* The buffer is in the window: wait until the leaf rank has unpacked the previous broadcast from it */
+    if (bas->shmsize && bas->rootshm[i]) {ierr = PetscSFPackShmWait_Basic(link,&link->leafpeercnt[i]->bcast,link->rootcnt[i].bcast);CHKERRQ(ierr);}
+#endif
     (*link->Pack)(n,link->bs,rootloc+rootoffset[i],i,bas->rootpackopt,rootdata,packstart);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    if (link->shmused && bas->rootshm[i]) {ierr = PetscSFPackShmPost_Basic(link,&link->rootcnt[i].bcast);CHKERRQ(ierr);continue;}
+#endif
     if (i < ndrootranks) continue; /* shared memory */
     ierr = MPI_Start_isend(n,unit,&rootreqs[i]);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Basic_Private(sf,unit,rootdata,leafdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Leaf data of rank i as received by PetscSFBcastAndOpBegin_Basic(), waiting for it if it comes through shared memory */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFPackGetLeafBcast_Basic(PetscSF sf,PetscSFPack_Basic link,PetscInt i,const char **packstart)
+{
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+  *packstart = link->leaf[i];
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  if (link->shmused && bas->leafshm[i]) {
+    ierr       = PetscSFPackShmWait_Basic(link,&link->rootpeercnt[i]->bcast,link->leafcnt[i].bcast+1);CHKERRQ(ierr);
+    *packstart = link->rootpeer[i];
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* Tell the root rank that the leaf data of rank i has been unpacked */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFPackRestoreLeafBcast_Basic(PetscSF sf,PetscSFPack_Basic link,PetscInt i)
+{
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  if (link->shmused && bas->leafshm[i]) {ierr = PetscSFPackShmPost_Basic(link,&link->leafcnt[i].bcast);CHKERRQ(ierr);}
+#endif
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
 {
   PetscErrorCode    ierr;
@@ -303,16 +394,53 @@ PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype u
 
   PetscFunctionBegin;
   ierr = PetscSFPackGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,(PetscSFPack*)&link);CHKERRQ(ierr);
-  ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc,NULL);CHKERRQ(ierr);
   ierr = PetscSFPackGetUnpackAndOp(sf,(PetscSFPack)link,op,&UnpackAndOp);CHKERRQ(ierr);
 
+  /* With the persistent point-to-point requests started by PetscSFBcastAndOpBegin_Basic() each leaf buffer can be unpacked as soon as
+     its message arrives, while the others are still in flight. Every leaf is written by one message, so with MPIU_REPLACE the result
+     does not depend on the order of arrival. */
+  if (sf->ops->BcastAndOpBegin == PetscSFBcastAndOpBegin_Basic && op == MPIU_REPLACE && UnpackAndOp) {
+    PetscMPIInt ndone,k;
+    MPI_Request *rootreqs,*leafreqs;
+
+    ierr = PetscSFPackGetReqs_Basic(sf,unit,link,PETSCSF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    for (i=0; i<ndleafranks; i++) {
+      (*UnpackAndOp)(leafoffset[i+1]-leafoffset[i],link->bs,leafloc+leafoffset[i],i,sf->leafpackopt,leafdata,(const void*)link->leaf[i]);
+    }
+    if (link->shmused) { /* the ranks on my node, whose requests were not started */
+      PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
+      const char    *packstart;
+
+      for (i=ndleafranks; i<nleafranks; i++) {
+        if (!bas->leafshm[i]) continue;
+        ierr = PetscSFPackGetLeafBcast_Basic(sf,link,i,&packstart);CHKERRQ(ierr);
+        (*UnpackAndOp)(leafoffset[i+1]-leafoffset[i],link->bs,leafloc+leafoffset[i],i,sf->leafpackopt,leafdata,(const void*)packstart);
+        ierr = PetscSFPackRestoreLeafBcast_Basic(sf,link,i);CHKERRQ(ierr);
+      }
+    }
+    while (1) {
+      ierr = MPI_Waitsome(nleafranks-ndleafranks,leafreqs+ndleafranks,&ndone,link->done,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+      if (ndone == MPI_UNDEFINED) break;
+      for (k=0; k<ndone; k++) {
+        i = ndleafranks + link->done[k];
+        (*UnpackAndOp)(leafoffset[i+1]-leafoffset[i],link->bs,leafloc+leafoffset[i],i,sf->leafpackopt,leafdata,(const void*)link->leaf[i]);
+      }
+    }
+    /* complete the root sends */
+    ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+    ierr = PetscSFPackReclaim(sf,(PetscSFPack*)&link);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   if (UnpackAndOp) { typesize = link->unitbytes; }
   else { ierr = MPI_Type_size(unit,&typesize);CHKERRQ(ierr); }
 
   for (i=0; i<nleafranks; i++) {
     PetscMPIInt n   = leafoffset[i+1] - leafoffset[i];
-    char *packstart = (char *) link->leaf[i];
+    const char  *packstart;
+    ierr = PetscSFPackGetLeafBcast_Basic(sf,link,i,&packstart);CHKERRQ(ierr);
     if (UnpackAndOp) { (*UnpackAndOp)(n,link->bs,leafloc+leafoffset[i],i,sf->leafpackopt,leafdata,(const void *)packstart); }
 #if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
     else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
@@ -322,14 +450,15 @@ PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype u
 #else
     else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
 #endif
+    ierr = PetscSFPackRestoreLeafBcast_Basic(sf,link,i);CHKERRQ(ierr);
   }
 
   ierr = PetscSFPackReclaim(sf,(PetscSFPack*)&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-/* leaf -> root with reduction */
-static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+/* leaf -> root with reduction. With useshm, the ranks on my node (if any) are reached through the shared memory window */
+static PetscErrorCode PetscSFReduceBegin_Basic_Private(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op,PetscBool useshm)
 {
   PetscSFPack_Basic link;
   PetscErrorCode    ierr;
@@ -338,28 +467,54 @@ static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,cons
   const PetscMPIInt *rootranks,*leafranks;
   MPI_Request       *rootreqs,*leafreqs;
   PetscMPIInt       n;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
 
   PetscFunctionBegin;
   ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc,NULL);CHKERRQ(ierr);
   ierr = PetscSFPackGet_Basic(sf,unit,rootdata,leafdata,PETSCSF_LEAF2ROOT_REDUCE,&link);CHKERRQ(ierr);
+  link->shmused = (PetscBool)(useshm && bas->shmsize);
 
   ierr = PetscSFPackGetReqs_Basic(sf,unit,link,PETSCSF_LEAF2ROOT_REDUCE,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post root receives for non-distinguished ranks */
-  ierr = PetscMPIIntCast(rootoffset[nrootranks]-rootoffset[ndrootranks],&n);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(n,unit,nrootranks-ndrootranks,rootreqs+ndrootranks);CHKERRQ(ierr);
+  if (!link->shmused) {
+    ierr = PetscMPIIntCast(rootoffset[nrootranks]-rootoffset[ndrootranks],&n);CHKERRQ(ierr);
+    ierr = MPI_Startall_irecv(n,unit,nrootranks-ndrootranks,rootreqs+ndrootranks);CHKERRQ(ierr);
+  } else {
+    for (i=ndrootranks; i<nrootranks; i++) {
+      if (bas->rootshm[i]) continue; /* on my node */
+      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Startall_irecv(n,unit,1,&rootreqs[i]);CHKERRQ(ierr);
+    }
+  }
 
   /* Pack and send leaf data */
   for (i=0; i<nleafranks; i++) {
     void *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    /* The buffer is in the window: wait until the root rank has consumed the previous reduction from it */
+    if (bas->shmsize && bas->leafshm[i]) {ierr = PetscSFPackShmWait_Basic(link,&link->rootpeercnt[i]->reduce,link->leafcnt[i].reduce);CHKERRQ(ierr);}
+#endif
     (*link->Pack)(n,link->bs,leafloc+leafoffset[i],i,sf->leafpackopt,leafdata,packstart);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    if (link->shmused && bas->leafshm[i]) {ierr = PetscSFPackShmPost_Basic(link,&link->leafcnt[i].reduce);CHKERRQ(ierr);continue;}
+#endif
     if (i < ndleafranks) continue; /* shared memory */
     ierr = MPI_Start_isend(n,unit,&leafreqs[i]);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Basic_Private(sf,unit,leafdata,rootdata,op,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
 {
   PetscErrorCode    (*UnpackAndOp)(PetscInt,PetscInt,const PetscInt*,PetscInt,PetscSFPackOpt,void*,const void*);
@@ -386,6 +541,12 @@ PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,
     PetscMPIInt n   = rootoffset[i+1] - rootoffset[i];
     char *packstart = (char *) link->root[i];
 
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    if (link->shmused && bas->rootshm[i]) { /* leaf data packed by a rank on my node, unpacked in rank order like the others */
+      ierr      = PetscSFPackShmWait_Basic(link,&link->leafpeercnt[i]->reduce,link->rootcnt[i].reduce+1);CHKERRQ(ierr);
+      packstart = link->leafpeer[i];
+    }
+#endif
     if (UnpackAndOp) {
       (*UnpackAndOp)(n,link->bs,rootloc+rootoffset[i],i,bas->rootpackopt,rootdata,(const void *)packstart);
     }
@@ -399,6 +560,9 @@ PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,
     }
 #else
     else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    if (link->shmused && bas->rootshm[i]) {ierr = PetscSFPackShmPost_Basic(link,&link->rootcnt[i].reduce);CHKERRQ(ierr);}
 #endif
   }
   ierr = PetscSFPackReclaim(sf,(PetscSFPack*)&link);CHKERRQ(ierr);
@@ -410,7 +574,9 @@ PETSC_INTERN PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = PetscSFReduceBegin(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  /* The fetched values are sent back from the root buffers, so basic does not use shared memory here */
+  if (sf->ops->ReduceBegin == PetscSFReduceBegin_Basic) {ierr = PetscSFReduceBegin_Basic_Private(sf,unit,leafdata,rootdata,op,PETSC_FALSE);CHKERRQ(ierr);}
+  else {ierr = PetscSFReduceBegin(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
@@ -504,7 +670,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedSF_Basic(PetscSF sf,PetscInt ns
      sf but do not do unpacking (from leaf buffer to leafdata). The raw data in leaf buffer is what we are
      interested in since it tells which leaves are connected to which ranks.
    */
-  ierr = PetscSFBcastAndOpBegin_Basic(sf,MPIU_INT,rootdata,leafdata-minleaf,MPIU_REPLACE);CHKERRQ(ierr); /* Need to give leafdata but we won't use it */
+  ierr = PetscSFBcastAndOpBegin_Basic_Private(sf,MPIU_INT,rootdata,leafdata-minleaf,MPIU_REPLACE,PETSC_FALSE);CHKERRQ(ierr); /* Need to give leafdata but we won't use it */
   ierr = PetscSFPackGetInUse(sf,MPIU_INT,rootdata,leafdata-minleaf,PETSC_OWN_POINTER,(PetscSFPack*)&link);CHKERRQ(ierr);
   ierr = PetscSFPackWaitall_Basic(link,PETSCSF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   ierr = PetscSFGetLeafInfo_Basic(sf,&nranks,&ndranks,&ranks,&roffset,&rmine,&rremote);CHKERRQ(ierr); /* Get send info */
@@ -650,7 +816,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreateEmbeddedLeafSF_Basic(PetscSF sf,PetscIn
   ierr = PetscMalloc1(ioffset[niranks],&bas->irootloc);CHKERRQ(ierr);
 
   /* Pass info about selected leaves to root buffer */
-  ierr = PetscSFReduceBegin_Basic(sf,MPIU_INT,leafdata-minleaf,rootdata,MPIU_REPLACE);CHKERRQ(ierr); /* -minleaf to re-adjust start address of leafdata */
+  ierr = PetscSFReduceBegin_Basic_Private(sf,MPIU_INT,leafdata-minleaf,rootdata,MPIU_REPLACE,PETSC_FALSE);CHKERRQ(ierr); /* -minleaf to re-adjust start address of leafdata */
   ierr = PetscSFPackGetInUse(sf,MPIU_INT,rootdata,leafdata-minleaf,PETSC_OWN_POINTER,(PetscSFPack*)&link);CHKERRQ(ierr);
   ierr = PetscSFPackWaitall_Basic(link,PETSCSF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
 
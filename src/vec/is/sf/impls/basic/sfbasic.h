@@ -12,11 +12,29 @@ typedef struct _n_PetscSFPack_Basic *PetscSFPack_Basic;
   char          **root;         /* Packed root data, indexed by leaf rank */                                                       \
   char          **leaf;         /* Packed leaf data, indexed by root rank */                                                       \
   PetscMPIInt   half;           /* Number of MPI_Requests used for either leaf2root or root2leaf communication */                  \
-  MPI_Request   *requests       /* [2*half] requests arranged in this order: leaf2root root/leaf reqs, root2leaf root/leaf reqs */
+  MPI_Request   *requests;      /* [2*half] requests arranged in this order: leaf2root root/leaf reqs, root2leaf root/leaf reqs */ \
+  PetscBool     shmused         /* Does the current operation communicate with the ranks on the node through shared memory? */
+
+/* Counters living in the shared memory window of a link, one per pair of ranks on the same node. The root rank counts the broadcasts
+   it posted and the reductions it consumed, the leaf rank counts the broadcasts it consumed and the reductions it posted. */
+typedef struct {
+  volatile PetscInt64 bcast;
+  volatile PetscInt64 reduce;
+} PetscSFShmCounter;
 
 struct _n_PetscSFPack_Basic {
   SPPACKBASICHEADER;
   PetscBool     initialized[2]; /* Is the communcation pattern in each direction initialized? [0] for leaf2root, [1] for root2leaf */
+  PetscMPIInt   *done;          /* [half] indices of the completed requests returned by MPI_Waitsome() */
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  MPI_Win           shmwin;     /* Window holding the buffers and counters used with the ranks on the node, MPI_WIN_NULL if not created */
+  PetscSFShmCounter *rootcnt;   /* [niranks] my counters as root for the leaf ranks on the node, in my part of the window */
+  PetscSFShmCounter *leafcnt;   /* [nranks] my counters as leaf for the root ranks on the node, in my part of the window */
+  PetscSFShmCounter **rootpeercnt; /* [nranks] counters of the root ranks on the node for me, in their part of the window */
+  PetscSFShmCounter **leafpeercnt; /* [niranks] counters of the leaf ranks on the node for me, in their part of the window */
+  char          **rootpeer;     /* [nranks] root data packed for me by the root ranks on the node */
+  char          **leafpeer;     /* [niranks] leaf data packed for me by the leaf ranks on the node */
+#endif
 };
 
 #define SFBASICHEADER \
@@ -28,7 +46,11 @@ struct _n_PetscSFPack_Basic {
   PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */                             \
   PetscSFPackOpt   rootpackopt; /* Optimization plans to (un)pack roots based on patterns in irootloc[]. NULL for no plans */  \
   PetscSFPack      avail;       /* One or more entries per MPI Datatype, lazily constructed */                                 \
-  PetscSFPack      inuse        /* Buffers being used for transactions that have not yet completed */
+  PetscSFPack      inuse;       /* Buffers being used for transactions that have not yet completed */                          \
+  PetscBool        useshm;      /* Communicate with the ranks on the same node through shared memory? */                       \
+  PetscMPIInt      shmsize;     /* Number of ranks on my node if shared memory is used, otherwise 0 */                          \
+  PetscBool        *rootshm;    /* [niranks] Is the incoming rank on my node? Only allocated if shmsize > 0 */                  \
+  PetscBool        *leafshm     /* [nranks] Is the root rank on my node? Only allocated if shmsize > 0 */
 
 typedef struct {
   SFBASICHEADER;
@@ -69,6 +91,34 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFPackWaitall_Basic(PetscSFPack_Basic li
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+/* Wait until the counter of a rank on the node has reached the given value, then make its data visible */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFPackShmWait_Basic(PetscSFPack_Basic link,volatile PetscInt64 *cnt,PetscInt64 value)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  while (*cnt < value) {ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);}
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Make my data visible to the ranks on the node, then increment my counter */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFPackShmPost_Basic(PetscSFPack_Basic link,volatile PetscInt64 *cnt)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+  (*cnt)++;
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
+PETSC_INTERN PetscErrorCode PetscSFSetUpShm_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFPackSetUpShm_Basic(PetscSF,PetscSFPack_Basic);
+PETSC_INTERN PetscErrorCode PetscSFPackDestroyShm_Basic(PetscSF,PetscSFPack_Basic);
 PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF);
 PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF,PetscViewer);
 PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF);
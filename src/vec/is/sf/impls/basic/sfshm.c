@@ -0,0 +1,172 @@
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+
+/*
+   Shared memory communication of PetscSF basic with the ranks on the same node.
+
+   Each link allocates a MPI-3 shared memory window on the node communicator. The part of the window owned by a rank holds
+
+     - a directory: the number of incoming (root side) and outgoing (leaf side) ranks, then for each of them its global rank and
+       the offset of the corresponding packed buffer, or -1 if the rank is not on the node;
+     - the PetscSFShmCounter of each incoming and outgoing rank;
+     - the packed root and leaf buffers exchanged with the ranks on the node.
+
+   Roots are packed by the root rank straight into its part of the window and unpacked by the leaf rank from there, and similarly
+   for leaves, so the data is copied once instead of going through MPI. The counters order the accesses: a buffer is only packed
+   after the peer has consumed the previous content and only unpacked after the peer has posted the new one.
+*/
+
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+#define PETSCSF_SHM_ALIGN 64 /* Cache line alignment of the counters and buffers in the window */
+
+PETSC_STATIC_INLINE size_t PetscSFShmAlign(size_t n) {return (n + PETSCSF_SHM_ALIGN - 1) & ~(size_t)(PETSCSF_SHM_ALIGN - 1);}
+#endif
+
+/* Find the incoming and outgoing ranks on my node. Does nothing if I am alone on my node */
+PETSC_INTERN PetscErrorCode PetscSFSetUpShm_Basic(PetscSF sf)
+{
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscShmComm   pshmcomm;
+  MPI_Comm       shmcomm;
+  PetscMPIInt    shmsize,lrank;
+  PetscInt       i,nshm = 0;
+
+  PetscFunctionBegin;
+  ierr = PetscShmCommGet(PetscObjectComm((PetscObject)sf),&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(shmcomm,&shmsize);CHKERRQ(ierr);
+  if (shmsize == 1) PetscFunctionReturn(0);
+  bas->shmsize = shmsize;
+  ierr = PetscCalloc2(bas->niranks,&bas->rootshm,sf->nranks,&bas->leafshm);CHKERRQ(ierr);
+  /* Distinguished ranks are myself and already communicate through memory */
+  for (i=bas->ndiranks; i<bas->niranks; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,bas->iranks[i],&lrank);CHKERRQ(ierr);
+    if (lrank != MPI_PROC_NULL) {bas->rootshm[i] = PETSC_TRUE; nshm++;}
+  }
+  for (i=sf->ndranks; i<sf->nranks; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,sf->ranks[i],&lrank);CHKERRQ(ierr);
+    if (lrank != MPI_PROC_NULL) {bas->leafshm[i] = PETSC_TRUE; nshm++;}
+  }
+  ierr = PetscInfo2(sf,"%D of my %D incoming and outgoing ranks are on my node\n",nshm,bas->niranks-bas->ndiranks+sf->nranks-sf->ndranks);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#else
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+#endif
+}
+
+/* Allocate the shared memory window of a new link and map the buffers and counters of the ranks on my node. Collective on the node */
+PETSC_INTERN PetscErrorCode PetscSFPackSetUpShm_Basic(PetscSF sf,PetscSFPack_Basic link)
+{
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscShmComm   pshmcomm;
+  MPI_Comm       shmcomm;
+  MPI_Info       info;
+  MPI_Aint       wsize;
+  PetscMPIInt    rank,lrank,dispunit;
+  PetscInt       i,j,nrootranks,nleafranks;
+  const PetscInt *rootoffset,*leafoffset;
+  size_t         cntoff,off;
+  char           *base,*pbase;
+  PetscInt64     *dir,*pdir;
+
+  PetscFunctionBegin;
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,NULL,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,NULL,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+  ierr = PetscShmCommGet(PetscObjectComm((PetscObject)sf),&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&shmcomm);CHKERRQ(ierr);
+
+  /* Size my part of the window */
+  cntoff = PetscSFShmAlign(sizeof(PetscInt64)*(2+2*(nrootranks+nleafranks)));
+  off    = PetscSFShmAlign(cntoff + sizeof(PetscSFShmCounter)*(nrootranks+nleafranks));
+  wsize  = (MPI_Aint)off;
+  for (i=0; i<nrootranks; i++) if (bas->rootshm[i]) wsize += (MPI_Aint)PetscSFShmAlign((rootoffset[i+1]-rootoffset[i])*link->unitbytes);
+  for (i=0; i<nleafranks; i++) if (bas->leafshm[i]) wsize += (MPI_Aint)PetscSFShmAlign((leafoffset[i+1]-leafoffset[i])*link->unitbytes);
+
+  /* Let the MPI implementation place each part of the window close to its owner */
+  ierr = MPI_Info_create(&info);CHKERRQ(ierr);
+  ierr = MPI_Info_set(info,"alloc_shared_noncontig","true");CHKERRQ(ierr);
+  ierr = MPI_Win_allocate_shared(wsize,1,info,shmcomm,&base,&link->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Info_free(&info);CHKERRQ(ierr);
+  ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->shmwin);CHKERRQ(ierr);
+
+  /* Fill the directory, zero the counters and place the buffers of the ranks on my node in the window */
+  dir           = (PetscInt64*)base;
+  dir[0]        = nrootranks;
+  dir[1]        = nleafranks;
+  link->rootcnt = (PetscSFShmCounter*)(base + cntoff);
+  link->leafcnt = link->rootcnt + nrootranks;
+  ierr = PetscMemzero(link->rootcnt,sizeof(PetscSFShmCounter)*(nrootranks+nleafranks));CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    dir[2+2*i]   = bas->iranks[i];
+    dir[2+2*i+1] = -1;
+    if (bas->rootshm[i]) {
+      dir[2+2*i+1]  = (PetscInt64)off;
+      link->root[i] = base + off;
+      off          += PetscSFShmAlign((rootoffset[i+1]-rootoffset[i])*link->unitbytes);
+    }
+  }
+  for (i=0; i<nleafranks; i++) {
+    dir[2+2*(nrootranks+i)]   = sf->ranks[i];
+    dir[2+2*(nrootranks+i)+1] = -1;
+    if (bas->leafshm[i]) {
+      dir[2+2*(nrootranks+i)+1] = (PetscInt64)off;
+      link->leaf[i]             = base + off;
+      off                      += PetscSFShmAlign((leafoffset[i+1]-leafoffset[i])*link->unitbytes);
+    }
+  }
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Barrier(shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+
+  /* Look myself up in the directories of the ranks on my node */
+  ierr = PetscCalloc4(nleafranks,&link->rootpeercnt,nrootranks,&link->leafpeercnt,nleafranks,&link->rootpeer,nrootranks,&link->leafpeer);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) { /* Root ranks: find me among their incoming ranks */
+    if (!bas->leafshm[i]) continue;
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,sf->ranks[i],&lrank);CHKERRQ(ierr);
+    ierr = MPI_Win_shared_query(link->shmwin,lrank,&wsize,&dispunit,&pbase);CHKERRQ(ierr);
+    pdir = (PetscInt64*)pbase;
+    for (j=0; j<pdir[0]; j++) if (pdir[2+2*j] == rank) break;
+    if (j == pdir[0] || pdir[2+2*j+1] < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %d on my node does not have me as incoming rank",sf->ranks[i]);
+    link->rootpeer[i]    = pbase + pdir[2+2*j+1];
+    link->rootpeercnt[i] = (PetscSFShmCounter*)(pbase + PetscSFShmAlign(sizeof(PetscInt64)*(2+2*(pdir[0]+pdir[1])))) + j;
+  }
+  for (i=0; i<nrootranks; i++) { /* Leaf ranks: find me among their root ranks */
+    if (!bas->rootshm[i]) continue;
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,bas->iranks[i],&lrank);CHKERRQ(ierr);
+    ierr = MPI_Win_shared_query(link->shmwin,lrank,&wsize,&dispunit,&pbase);CHKERRQ(ierr);
+    pdir = (PetscInt64*)pbase;
+    for (j=0; j<pdir[1]; j++) if (pdir[2+2*(pdir[0]+j)] == rank) break;
+    if (j == pdir[1] || pdir[2+2*(pdir[0]+j)+1] < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %d on my node does not have me as root rank",bas->iranks[i]);
+    link->leafpeer[i]    = pbase + pdir[2+2*(pdir[0]+j)+1];
+    link->leafpeercnt[i] = (PetscSFShmCounter*)(pbase + PetscSFShmAlign(sizeof(PetscInt64)*(2+2*(pdir[0]+pdir[1])))) + pdir[0] + j;
+  }
+  PetscFunctionReturn(0);
+#else
+  PetscFunctionBegin;
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP_SYS,"Requires MPI-3 process shared memory");
+  PetscFunctionReturn(0);
+#endif
+}
+
+/* Free the shared memory window of a link. Collective on the node */
+PETSC_INTERN PetscErrorCode PetscSFPackDestroyShm_Basic(PetscSF sf,PetscSFPack_Basic link)
+{
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (link->shmwin == MPI_WIN_NULL) PetscFunctionReturn(0);
+  ierr = MPI_Win_unlock_all(link->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Win_free(&link->shmwin);CHKERRQ(ierr);
+  ierr = PetscFree4(link->rootpeercnt,link->leafpeercnt,link->rootpeer,link->leafpeer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#else
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+#endif
+}
@@ -64,6 +64,15 @@ PetscErrorCode PetscSectionCreate(MPI_Comm comm, PetscSection *s)
   (*s)->clSize             = 0;
   (*s)->clPerm             = NULL;
   (*s)->clInvPerm          = NULL;
+  (*s)->clIdxObj           = NULL;
+  (*s)->clIdxState         = -1;
+  (*s)->clIdxStart         = 0;
+  (*s)->clIdxEnd           = 0;
+  (*s)->clIdxOff           = NULL;
+  (*s)->clIdx              = NULL;
+  (*s)->clIdxGSec          = NULL;
+  (*s)->clIdxGState        = -1;
+  (*s)->clIdxGlobal        = NULL;
   PetscFunctionReturn(0);
 }
 
@@ -1011,6 +1020,9 @@ PetscErrorCode PetscSectionSetUp(PetscSection s)
   PetscValidHeaderSpecific(s, PETSC_SECTION_CLASSID, 1);
   if (s->setup) PetscFunctionReturn(0);
   s->setup = PETSC_TRUE;
+  /* Offsets change, so cached closure indices built on this section or keyed to it are stale */
+  ierr = PetscSectionResetClosureDofIndex_Internal(s);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject) s);CHKERRQ(ierr);
   /* Set offsets and field offsets for all points */
   /*   Assume that all fields have the same chart */
   if (s->perm) {ierr = ISGetIndices(s->perm, &pind);CHKERRQ(ierr);}
@@ -1911,6 +1923,7 @@ PetscErrorCode PetscSectionReset(PetscSection s)
   ierr = ISDestroy(&s->perm);CHKERRQ(ierr);
   ierr = PetscFree(s->clPerm);CHKERRQ(ierr);
   ierr = PetscFree(s->clInvPerm);CHKERRQ(ierr);
+  ierr = PetscSectionResetClosureDofIndex_Internal(s);CHKERRQ(ierr);
   ierr = PetscSectionSymDestroy(&s->sym);CHKERRQ(ierr);
 
   s->pStart    = -1;
@@ -2410,6 +2423,7 @@ PetscErrorCode PetscSectionSetClosureIndex(PetscSection section, PetscObject obj
 
   PetscFunctionBegin;
   if (section->clObj != obj) {ierr = PetscFree(section->clPerm);CHKERRQ(ierr);ierr = PetscFree(section->clInvPerm);CHKERRQ(ierr);}
+  ierr = PetscSectionResetClosureDofIndex_Internal(section);CHKERRQ(ierr);
   section->clObj     = obj;
   ierr = PetscSectionDestroy(&section->clSection);CHKERRQ(ierr);
   ierr = ISDestroy(&section->clPoints);CHKERRQ(ierr);
@@ -2458,6 +2472,7 @@ PetscErrorCode PetscSectionSetClosurePermutation_Internal(PetscSection section,
     ierr = PetscSectionDestroy(&section->clSection);CHKERRQ(ierr);
     ierr = ISDestroy(&section->clPoints);CHKERRQ(ierr);
   }
+  ierr = PetscSectionResetClosureDofIndex_Internal(section);CHKERRQ(ierr);
   section->clObj  = obj;
   ierr = PetscFree(section->clPerm);CHKERRQ(ierr);
   ierr = PetscFree(section->clInvPerm);CHKERRQ(ierr);
@@ -2562,6 +2577,144 @@ PetscErrorCode PetscSectionGetClosureInversePermutation_Internal(PetscSection se
   PetscFunctionReturn(0);
 }
 
+/*
+  PetscSectionSetClosureDofIndex_Internal - Set the cache of dof indices in the closure of each point in [pStart, pEnd)
+
+  Input Parameters:
++ section - The PetscSection
+. obj     - A PetscObject which serves as the key for this cache
+. state   - The state of the topology of obj, so that the cache is ignored once obj changes
+. pStart  - The first cached point
+. pEnd    - One past the last cached point
+. clOff   - Offset of the closure of each point into clIdx, of size pEnd-pStart+1, or NULL to record that the closures cannot be cached
+- clIdx   - The local dof indices in closure order, with constrained dofs encoded as -(off+1)
+
+  Note: The section takes ownership of clOff and clIdx
+
+  Level: developer
+*/
+PetscErrorCode PetscSectionSetClosureDofIndex_Internal(PetscSection section, PetscObject obj, PetscObjectState state, PetscInt pStart, PetscInt pEnd, PetscInt *clOff, PetscInt *clIdx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 1);
+  ierr = PetscSectionResetClosureDofIndex_Internal(section);CHKERRQ(ierr);
+  section->clIdxObj   = obj;
+  section->clIdxState = state;
+  section->clIdxStart = pStart;
+  section->clIdxEnd   = pEnd;
+  section->clIdxOff   = clOff;
+  section->clIdx      = clIdx;
+  if (clOff) {ierr = PetscLogObjectMemory((PetscObject) section, (pEnd-pStart+1 + clOff[pEnd-pStart])*sizeof(PetscInt));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscSectionGetClosureDofIndex_Internal - Get the cache of dof indices in the closure of each point
+
+  Input Parameters:
++ section - The PetscSection
+. obj     - A PetscObject which serves as the key for this cache
+- state   - The current state of the topology of obj
+
+  Output Parameters:
++ cached  - PETSC_TRUE if a cache was built for this key and state, even if it turned out that the closures cannot be cached
+. pStart  - The first cached point
+. pEnd    - One past the last cached point
+. clOff   - Offset of the closure of each point into clIdx, or NULL if there is no usable cache
+- clIdx   - The local dof indices in closure order, with constrained dofs encoded as -(off+1)
+
+  Level: developer
+*/
+PetscErrorCode PetscSectionGetClosureDofIndex_Internal(PetscSection section, PetscObject obj, PetscObjectState state, PetscBool *cached, PetscInt *pStart, PetscInt *pEnd, const PetscInt *clOff[], const PetscInt *clIdx[])
+{
+  PetscFunctionBegin;
+  if (section->clIdxObj == obj && section->clIdxState == state) {
+    if (cached) *cached = PETSC_TRUE;
+    if (pStart) *pStart = section->clIdxStart;
+    if (pEnd)   *pEnd   = section->clIdxEnd;
+    if (clOff)  *clOff  = section->clIdxOff;
+    if (clIdx)  *clIdx  = section->clIdx;
+  } else {
+    if (cached) *cached = PETSC_FALSE;
+    if (pStart) *pStart = 0;
+    if (pEnd)   *pEnd   = 0;
+    if (clOff)  *clOff  = NULL;
+    if (clIdx)  *clIdx  = NULL;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscSectionSetClosureGlobalDofIndex_Internal - Set the global dof indices for the cached closures, laid out like the local closure index
+
+  Input Parameters:
++ section  - The PetscSection
+. gsection - The global section used to compute the indices
+- clIdx    - The global dof indices in closure order, which the section takes ownership of
+
+  Level: developer
+*/
+PetscErrorCode PetscSectionSetClosureGlobalDofIndex_Internal(PetscSection section, PetscSection gsection, PetscInt *clIdx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(section, PETSC_SECTION_CLASSID, 1);
+  PetscValidHeaderSpecific(gsection, PETSC_SECTION_CLASSID, 2);
+  if (!section->clIdxOff) SETERRQ(PetscObjectComm((PetscObject) section), PETSC_ERR_ARG_WRONGSTATE, "Section has no closure dof index");
+  ierr = PetscObjectReference((PetscObject) gsection);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&section->clIdxGSec);CHKERRQ(ierr);
+  ierr = PetscFree(section->clIdxGlobal);CHKERRQ(ierr);
+  section->clIdxGSec   = gsection;
+  section->clIdxGlobal = clIdx;
+  ierr = PetscObjectStateGet((PetscObject) gsection, &section->clIdxGState);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject) section, section->clIdxOff[section->clIdxEnd-section->clIdxStart]*sizeof(PetscInt));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscSectionGetClosureGlobalDofIndex_Internal - Get the global dof indices for the cached closures, or NULL if they were not computed for this global section
+
+  Level: developer
+*/
+PetscErrorCode PetscSectionGetClosureGlobalDofIndex_Internal(PetscSection section, PetscSection gsection, const PetscInt *clIdx[])
+{
+  PetscObjectState state;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  *clIdx = NULL;
+  if (section->clIdxGSec && section->clIdxGSec == gsection) {
+    ierr = PetscObjectStateGet((PetscObject) gsection, &state);CHKERRQ(ierr);
+    if (state == section->clIdxGState) *clIdx = section->clIdxGlobal;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  PetscSectionResetClosureDofIndex_Internal - Destroy the cache of closure dof indices
+
+  Level: developer
+*/
+PetscErrorCode PetscSectionResetClosureDofIndex_Internal(PetscSection section)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(section->clIdxOff);CHKERRQ(ierr);
+  ierr = PetscFree(section->clIdx);CHKERRQ(ierr);
+  ierr = PetscFree(section->clIdxGlobal);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&section->clIdxGSec);CHKERRQ(ierr);
+  section->clIdxObj    = NULL;
+  section->clIdxState  = -1;
+  section->clIdxStart  = 0;
+  section->clIdxEnd    = 0;
+  section->clIdxGState = -1;
+  PetscFunctionReturn(0);
+}
+
 /*@
   PetscSectionGetClosureInversePermutation - Get the inverse dof permutation for the closure of each cell in the section, meaning clPerm[oldIndex] = newIndex.
 
@@ -2818,6 +2971,7 @@ PetscErrorCode PetscSectionSetSym(PetscSection section, PetscSectionSym sym)
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(section,PETSC_SECTION_CLASSID,1);
+  ierr = PetscSectionResetClosureDofIndex_Internal(section);CHKERRQ(ierr);
   ierr = PetscSectionSymDestroy(&(section->sym));CHKERRQ(ierr);
   if (sym) {
     PetscValidHeaderSpecific(sym,PETSC_SECTION_SYM_CLASSID,2);
@@ -2872,6 +3026,7 @@ PetscErrorCode PetscSectionSetFieldSym(PetscSection section, PetscInt field, Pet
   PetscFunctionBegin;
   PetscValidHeaderSpecific(section,PETSC_SECTION_CLASSID,1);
   if (field < 0 || field >= section->numFields) SETERRQ2(PetscObjectComm((PetscObject)section),PETSC_ERR_ARG_OUTOFRANGE,"Invalid field number %D (not in [0,%D)", field, section->numFields);
+  ierr = PetscSectionResetClosureDofIndex_Internal(section);CHKERRQ(ierr);
   ierr = PetscSectionSetSym(section->field[field],sym);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -256,4 +256,11 @@ int main(int argc,char **args)
       output_file: output/ex46_2_p6.out
       requires: mpiio
 
+   test:
+      suffix: mpiio_aggregate
+      nsize: 6
+      args: -usempiio -viewer_binary_mpiio_aggregators 1 -viewer_binary_mpiio_stripe_size 24
+      output_file: output/ex46_2_p6.out
+      requires: mpiio
+
 TEST*/
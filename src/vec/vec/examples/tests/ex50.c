@@ -0,0 +1,96 @@
+static char help[] = "Tests VecMDot() and VecMAXPY() on many long vectors and the storage of VecDuplicateVecs().\n\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = 1037,nv = 7,i,k;
+  Vec               x,w,keep,*y;
+  PetscScalar       *z,*zz,*alpha;
+  const PetscScalar *a0,*a1,*a;
+  PetscReal         nrm;
+  PetscRandom       rctx;
+  PetscBool         flg;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&y);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {ierr = VecSetRandom(y[i],rctx);CHKERRQ(ierr);}
+  ierr = PetscMalloc3(nv,&z,nv,&zz,nv,&alpha);CHKERRQ(ierr);
+
+  /* the local parts of the vectors are stored with a constant stride */
+  ierr = PetscObjectTypeCompareAny((PetscObject)x,&flg,VECSEQ,VECMPI,"");CHKERRQ(ierr);
+  if (flg && nv > 2) {
+    ierr = VecGetArrayRead(y[0],&a0);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(y[1],&a1);CHKERRQ(ierr);
+    for (i=2; i<nv; i++) {
+      ierr = VecGetArrayRead(y[i],&a);CHKERRQ(ierr);
+      if (a - a0 != i*(a1 - a0)) {ierr = PetscPrintf(PETSC_COMM_SELF,"Vector %D is not stored after the previous ones\n",i);CHKERRQ(ierr);}
+      ierr = VecRestoreArrayRead(y[i],&a);CHKERRQ(ierr);
+    }
+    ierr = VecRestoreArrayRead(y[1],&a1);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(y[0],&a0);CHKERRQ(ierr);
+  }
+
+  /* all the vectors at once must give exactly the same results as four vectors at a time */
+  ierr = VecMDot(x,nv,y,z);CHKERRQ(ierr);
+  for (i=0; i<nv; i+=4) {ierr = VecMDot(x,PetscMin(4,nv-i),y+i,zz+i);CHKERRQ(ierr);}
+  for (i=0; i<nv; i++) {
+    if (z[i] != zz[i]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDot() result %D differs\n",i);CHKERRQ(ierr);}
+    ierr = VecDot(x,y[i],&zz[i]);CHKERRQ(ierr);
+    if (PetscAbsScalar(z[i]-zz[i]) > 100*PETSC_MACHINE_EPSILON*n*nv) {ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDot() result %D does not match VecDot()\n",i);CHKERRQ(ierr);}
+  }
+
+  /* VecMAXPY() applies the nv%4 leading vectors first, then groups of four */
+  for (i=0; i<nv; i++) alpha[i] = 1.0/(i+1);
+  ierr = VecCopy(x,w);CHKERRQ(ierr);
+  ierr = VecMAXPY(x,nv,alpha,y);CHKERRQ(ierr);
+  k    = nv%4;
+  if (k) {ierr = VecMAXPY(w,k,alpha,y);CHKERRQ(ierr);}
+  for (i=k; i<nv; i+=4) {ierr = VecMAXPY(w,4,alpha+i,y+i);CHKERRQ(ierr);}
+  ierr = VecAXPY(w,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  if (nrm != 0.0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMAXPY() results differ by %g\n",(double)nrm);CHKERRQ(ierr);}
+
+  /* a vector may outlive the others obtained with it */
+  keep = y[nv/2];
+  ierr = PetscObjectReference((PetscObject)keep);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&y);CHKERRQ(ierr);
+  ierr = VecSet(keep,1.0);CHKERRQ(ierr);
+  ierr = VecNorm(keep,NORM_1,&nrm);CHKERRQ(ierr);
+  ierr = VecGetSize(keep,&k);CHKERRQ(ierr);
+  if (nrm != (PetscReal)k) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Wrong norm %g of the remaining vector\n",(double)nrm);CHKERRQ(ierr);}
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(keep,&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&keep);CHKERRQ(ierr);
+  ierr = VecSet(w,2.0);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+
+  ierr = PetscFree3(z,zz,alpha);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+     nsize: {{1 2}}
+     args: -nv {{1 5 7 70}}
+
+   test:
+     suffix: standard
+     args: -vec_type standard -n 100 -nv 9
+
+TEST*/
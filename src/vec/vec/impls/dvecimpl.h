@@ -36,6 +36,9 @@ PETSC_INTERN PetscErrorCode VecMax_Seq(Vec,PetscInt*,PetscReal*);
 PETSC_INTERN PetscErrorCode VecNorm_Seq(Vec,NormType,PetscReal*);
 PETSC_INTERN PetscErrorCode VecDestroy_Seq(Vec);
 PETSC_INTERN PetscErrorCode VecDuplicate_Seq(Vec,Vec*);
+PETSC_INTERN PetscErrorCode VecDuplicateVecs_Seq(Vec,PetscInt,Vec*[]);
+PETSC_INTERN PetscErrorCode VecDuplicateVecsGetStorage_Private(Vec,PetscInt,PetscInt,PetscInt*,PetscScalar**,PetscContainer*);
+PETSC_INTERN PetscErrorCode VecDuplicateVecsSetStorage_Private(Vec,PetscContainer);
 PETSC_INTERN PetscErrorCode VecSetOption_Seq(Vec,VecOption,PetscBool);
 PETSC_INTERN PetscErrorCode VecGetValues_Seq(Vec,PetscInt,const PetscInt*,PetscScalar*);
 PETSC_INTERN PetscErrorCode VecSetValues_Seq(Vec,PetscInt,const PetscInt*,const PetscScalar*,InsertMode);
@@ -46,7 +46,8 @@ static PetscErrorCode VecPlaceArray_MPI(Vec vin,const PetscScalar *a)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
+/* Duplicates win using the given storage (of length n + nghost), or newly allocated storage if storage is NULL */
+static PetscErrorCode VecDuplicateWithArray_MPI_Private(Vec win,const PetscScalar storage[],Vec *v)
 {
   PetscErrorCode ierr;
   Vec_MPI        *vw,*w = (Vec_MPI*)win->data;
@@ -56,7 +57,7 @@ static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
   ierr = VecCreate(PetscObjectComm((PetscObject)win),v);CHKERRQ(ierr);
   ierr = PetscLayoutReference(win->map,&(*v)->map);CHKERRQ(ierr);
 
-  ierr = VecCreate_MPI_Private(*v,PETSC_TRUE,w->nghost,0);CHKERRQ(ierr);
+  ierr = VecCreate_MPI_Private(*v,storage ? PETSC_FALSE : PETSC_TRUE,w->nghost,storage);CHKERRQ(ierr);
   vw   = (Vec_MPI*)(*v)->data;
   ierr = PetscMemcpy((*v)->ops,win->ops,sizeof(struct _VecOps));CHKERRQ(ierr);
 
@@ -80,12 +81,52 @@ static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
 
   ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)(*v))->olist);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)(*v))->qlist);CHKERRQ(ierr);
+  ierr = VecDuplicateVecsSetStorage_Private(*v,NULL);CHKERRQ(ierr);
 
   (*v)->map->bs   = PetscAbs(win->map->bs);
   (*v)->bstash.bs = win->bstash.bs;
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicateWithArray_MPI_Private(win,NULL,v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The local parts of the vectors share one array, each one starting on an aligned address, so that
+   VecMDot() and VecMAXPY() on them, as done by the Krylov methods on their bases, walk through contiguous memory.
+*/
+static PetscErrorCode VecDuplicateVecs_MPI(Vec win,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  Vec_MPI        *w = (Vec_MPI*)win->data;
+  PetscBool      ismpi;
+  PetscInt       i,lda;
+  PetscScalar    *array;
+  PetscContainer container;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)win,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!ismpi || m <= 1) {
+    ierr = VecDuplicateVecs_Default(win,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecDuplicateVecsGetStorage_Private(win,m,w->nghost,&lda,&array,&container);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecDuplicateWithArray_MPI_Private(win,array+i*lda,*V+i);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)(*V)[i],lda*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecDuplicateVecsSetStorage_Private((*V)[i],container);CHKERRQ(ierr);
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 
 static PetscErrorCode VecSetOption_MPI(Vec V,VecOption op,PetscBool flag)
 {
@@ -415,7 +456,7 @@ static PetscErrorCode VecSetFromOptions_MPI(PetscOptionItems *PetscOptionsObject
 
 
 static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
-                                VecDuplicateVecs_Default,
+                                VecDuplicateVecs_MPI,
                                 VecDestroyVecs_Default,
                                 VecDot_MPI,
                                 VecMDot_MPI,
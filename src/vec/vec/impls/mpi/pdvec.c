@@ -457,17 +457,7 @@ PetscErrorCode VecView_MPI_Binary(Vec xin,PetscViewer viewer)
     }
 #if defined(PETSC_HAVE_MPIIO)
   } else {
-    MPI_Offset   off;
-    MPI_File     mfdes;
-    PetscMPIInt  lsize;
-
-    ierr = PetscMPIIntCast(xin->map->n,&lsize);CHKERRQ(ierr);
-    ierr = PetscViewerBinaryGetMPIIODescriptor(viewer,&mfdes);CHKERRQ(ierr);
-    ierr = PetscViewerBinaryGetMPIIOOffset(viewer,&off);CHKERRQ(ierr);
-    off += xin->map->rstart*sizeof(PetscScalar); /* off is MPI_Offset, not PetscMPIInt */
-    ierr = MPI_File_set_view(mfdes,off,MPIU_SCALAR,MPIU_SCALAR,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
-    ierr = MPIU_File_write_all(mfdes,(void*)xarray,lsize,MPIU_SCALAR,MPI_STATUS_IGNORE);CHKERRQ(ierr);
-    ierr = PetscViewerBinaryAddMPIIOOffset(viewer,xin->map->N*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscViewerBinaryWriteAllMPIIO(viewer,(void*)xarray,xin->map->n,xin->map->rstart,xin->map->N,PETSC_SCALAR);CHKERRQ(ierr);
   }
 #endif
 
@@ -816,14 +816,53 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
   ierr = PetscLayoutReference(win->map,&(*V)->map);CHKERRQ(ierr);
   ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)(*V))->olist);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)(*V))->qlist);CHKERRQ(ierr);
+  ierr = VecDuplicateVecsSetStorage_Private(*V,NULL);CHKERRQ(ierr);
 
   (*V)->ops->view          = win->ops->view;
   (*V)->stash.ignorenegidx = win->stash.ignorenegidx;
   PetscFunctionReturn(0);
 }
 
+/*
+   The vectors share one array, each one starting on an aligned address, so that VecMDot() and VecMAXPY()
+   on them, as done by the Krylov methods on their bases, walk through contiguous memory.
+*/
+PetscErrorCode VecDuplicateVecs_Seq(Vec w,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  PetscBool      isseq;
+  PetscInt       i,lda;
+  PetscScalar    *array;
+  PetscContainer container;
+  Vec            v;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECSEQ,&isseq);CHKERRQ(ierr);
+  if (!isseq || m <= 1) {
+    ierr = VecDuplicateVecs_Default(w,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecDuplicateVecsGetStorage_Private(w,m,0,&lda,&array,&container);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecCreate(PetscObjectComm((PetscObject)w),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(w->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_Seq_Private(v,array+i*lda);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)v,lda*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscObjectListDuplicate(((PetscObject)w)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)w)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    ierr = VecDuplicateVecsSetStorage_Private(v,container);CHKERRQ(ierr);
+
+    v->ops->view          = w->ops->view;
+    v->stash.ignorenegidx = w->stash.ignorenegidx;
+    (*V)[i]               = v;
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
-                               VecDuplicateVecs_Default,
+                               VecDuplicateVecs_Seq,
                                VecDestroyVecs_Default,
                                VecDot_Seq,
                                VecMDot_Seq,
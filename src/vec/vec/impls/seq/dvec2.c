@@ -6,11 +6,14 @@
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
-
+/* Number of entries of x kept in cache by the tiled multi-vector kernels, must be a multiple of 4 */
+#define VEC_MULTI_TILE  512
+/* Maximum number of vectors processed together by the tiled multi-vector kernels */
+#define VEC_MULTI_BATCH 64
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
-PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+static PetscErrorCode VecMDot_Seq_Private(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 {
   PetscErrorCode    ierr;
   PetscInt          i,nv_rem,n = xin->map->n;
@@ -86,12 +89,11 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
     i   -= 4;
   }
   ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
-  ierr = PetscLogFlops(PetscMax(nv*(2.0*xin->map->n-1),0.0));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
 #else
-PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+static PetscErrorCode VecMDot_Seq_Private(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 {
   PetscErrorCode    ierr;
   PetscInt          n = xin->map->n,i,j,nv_rem,j_rem;
@@ -285,11 +287,70 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
     yy  += 4;
   }
   ierr = VecRestoreArrayRead(xin,&xbase);CHKERRQ(ierr);
-  ierr = PetscLogFlops(PetscMax(nv*(2.0*xin->map->n-1),0.0));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 #endif
 
+/*
+   Cache-tiled VecMDot(): x is split into pieces of VEC_MULTI_TILE entries and each piece is kept in
+   cache while all the y vectors stream through, so x is read from memory once per VEC_MULTI_BATCH
+   vectors instead of once per four vectors. The sums are accumulated in the same order as in the
+   untiled kernel, so the results are identical.
+*/
+static PetscErrorCode VecMDot_Seq_Tiled(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,j_rem = n&0x3,nb,k,j,t,tn;
+  PetscScalar       sum;
+  const PetscScalar *x,*xt,*yt,*yy[VEC_MULTI_BATCH];
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (; nv>0; nv-=nb, yin+=nb, z+=nb) {
+    nb = PetscMin(nv,VEC_MULTI_BATCH);
+    for (k=0; k<nb; k++) {ierr = VecGetArrayRead(yin[k],&yy[k]);CHKERRQ(ierr);}
+    for (k=0; k<nb; k++) {
+      sum = 0.;
+      switch (j_rem) {
+      case 3: sum += x[2]*PetscConj(yy[k][2]);
+      case 2: sum += x[1]*PetscConj(yy[k][1]);
+      case 1: sum += x[0]*PetscConj(yy[k][0]);
+      case 0: break;
+      }
+      z[k] = sum;
+    }
+    for (t=j_rem; t<n; t+=VEC_MULTI_TILE) {
+      tn = PetscMin(VEC_MULTI_TILE,n-t);
+      xt = x + t;
+      for (k=0; k<nb; k++) {
+        yt  = yy[k] + t;
+        sum = z[k];
+        for (j=0; j<tn; j+=4) {
+          sum += xt[j]*PetscConj(yt[j]) + xt[j+1]*PetscConj(yt[j+1]) + xt[j+2]*PetscConj(yt[j+2]) + xt[j+3]*PetscConj(yt[j+3]);
+        }
+        z[k] = sum;
+      }
+    }
+    for (k=0; k<nb; k++) {ierr = VecRestoreArrayRead(yin[k],&yy[k]);CHKERRQ(ierr);}
+  }
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (nv > 4 && xin->map->n > VEC_MULTI_TILE) {
+    ierr = VecMDot_Seq_Tiled(xin,nv,yin,z);CHKERRQ(ierr);
+  } else {
+    ierr = VecMDot_Seq_Private(xin,nv,yin,z);CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*xin->map->n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* ----------------------------------------------------------------------------*/
 PetscErrorCode VecMTDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 {
@@ -553,6 +614,60 @@ PetscErrorCode VecSet_Seq(Vec xin,PetscScalar alpha)
   PetscFunctionReturn(0);
 }
 
+/*
+   Cache-tiled VecMAXPY(): each piece of VEC_MULTI_TILE entries of x is updated by all the y vectors
+   before moving to the next one, so x is read and written once per VEC_MULTI_BATCH vectors instead of
+   once per four vectors. The updates of each entry are applied in the same order as in the untiled
+   kernel, so the results are identical.
+*/
+static PetscErrorCode VecMAXPY_Seq_Tiled(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,nb,k,t,tn,j_rem;
+  const PetscScalar *yy[VEC_MULTI_BATCH],*yy0,*yy1,*yy2,*yy3;
+  PetscScalar       *xx,*xt,alpha0,alpha1,alpha2,alpha3;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
+  for (; nv>0; nv-=nb, y+=nb, alpha+=nb) {
+    /* only the first batch has nv%4 vectors left over, they are applied first like in VecMAXPY_Seq() */
+    j_rem = nv&0x3;
+    nb    = j_rem + PetscMin(nv-j_rem,VEC_MULTI_BATCH-4);
+    for (k=0; k<nb; k++) {ierr = VecGetArrayRead(y[k],&yy[k]);CHKERRQ(ierr);}
+    for (t=0; t<n; t+=VEC_MULTI_TILE) {
+      switch (j_rem) {
+      case 3:
+        xt     = xx + t; tn = PetscMin(VEC_MULTI_TILE,n-t);
+        yy0    = yy[0] + t; yy1 = yy[1] + t; yy2 = yy[2] + t;
+        alpha0 = alpha[0]; alpha1 = alpha[1]; alpha2 = alpha[2];
+        PetscKernelAXPY3(xt,alpha0,alpha1,alpha2,yy0,yy1,yy2,tn);
+        break;
+      case 2:
+        xt     = xx + t; tn = PetscMin(VEC_MULTI_TILE,n-t);
+        yy0    = yy[0] + t; yy1 = yy[1] + t;
+        alpha0 = alpha[0]; alpha1 = alpha[1];
+        PetscKernelAXPY2(xt,alpha0,alpha1,yy0,yy1,tn);
+        break;
+      case 1:
+        xt     = xx + t; tn = PetscMin(VEC_MULTI_TILE,n-t);
+        yy0    = yy[0] + t;
+        alpha0 = alpha[0];
+        PetscKernelAXPY(xt,alpha0,yy0,tn);
+        break;
+      }
+      for (k=j_rem; k<nb; k+=4) {
+        xt     = xx + t; tn = PetscMin(VEC_MULTI_TILE,n-t);
+        yy0    = yy[k] + t; yy1 = yy[k+1] + t; yy2 = yy[k+2] + t; yy3 = yy[k+3] + t;
+        alpha0 = alpha[k]; alpha1 = alpha[k+1]; alpha2 = alpha[k+2]; alpha3 = alpha[k+3];
+        PetscKernelAXPY4(xt,alpha0,alpha1,alpha2,alpha3,yy0,yy1,yy2,yy3,tn);
+      }
+    }
+    for (k=0; k<nb; k++) {ierr = VecRestoreArrayRead(y[k],&yy[k]);CHKERRQ(ierr);}
+  }
+  ierr = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y)
 {
   PetscErrorCode    ierr;
@@ -566,6 +681,10 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y
 
   PetscFunctionBegin;
   ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
+  if (nv > 4 && n > VEC_MULTI_TILE) {
+    ierr = VecMAXPY_Seq_Tiled(xin,nv,alpha,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
   switch (j_rem=nv&0x3) {
   case 3:
@@ -756,3 +875,32 @@ PetscErrorCode VecReplaceArray_Seq(Vec vin,const PetscScalar *a)
   v->array_allocated = v->array = (PetscScalar*)a;
   PetscFunctionReturn(0);
 }
+
+/*
+   Allocates a single array holding the local parts (plus nghost ghost entries) of m vectors laid out like w,
+   each one starting on an aligned address lda entries after the previous one. The array is owned by the
+   returned container, which each vector references, so it is freed once the last vector is destroyed.
+*/
+PetscErrorCode VecDuplicateVecsGetStorage_Private(Vec w,PetscInt m,PetscInt nghost,PetscInt *lda,PetscScalar **array,PetscContainer *container)
+{
+  PetscErrorCode ierr;
+  PetscInt       align = PetscMax(PETSC_MEMALIGN/(PetscInt)sizeof(PetscScalar),1);
+
+  PetscFunctionBegin;
+  *lda = ((w->map->n + nghost + align - 1)/align)*align;
+  ierr = PetscCalloc1(m*(*lda),array);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(*container,*array);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(*container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Attaches the shared storage to one of the vectors, or detaches it when container is NULL */
+PetscErrorCode VecDuplicateVecsSetStorage_Private(Vec v,PetscContainer container)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectCompose((PetscObject)v,"__PETSc_VecDuplicateVecs_Storage",(PetscObject)container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
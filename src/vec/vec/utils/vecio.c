@@ -34,22 +34,11 @@ static PetscErrorCode PetscViewerBinaryReadVecHeader_Private(PetscViewer viewer,
 static PetscErrorCode VecLoad_Binary_MPIIO(Vec vec, PetscViewer viewer)
 {
   PetscErrorCode ierr;
-  PetscMPIInt    lsize;
   PetscScalar    *avec;
-  MPI_File       mfdes;
-  MPI_Offset     off;
 
   PetscFunctionBegin;
   ierr = VecGetArray(vec,&avec);CHKERRQ(ierr);
-  ierr = PetscMPIIntCast(vec->map->n,&lsize);CHKERRQ(ierr);
-
-  ierr = PetscViewerBinaryGetMPIIODescriptor(viewer,&mfdes);CHKERRQ(ierr);
-  ierr = PetscViewerBinaryGetMPIIOOffset(viewer,&off);CHKERRQ(ierr);
-  off += vec->map->rstart*sizeof(PetscScalar);
-  ierr = MPI_File_set_view(mfdes,off,MPIU_SCALAR,MPIU_SCALAR,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
-  ierr = MPIU_File_read_all(mfdes,avec,lsize,MPIU_SCALAR,MPI_STATUS_IGNORE);CHKERRQ(ierr);
-  ierr = PetscViewerBinaryAddMPIIOOffset(viewer,vec->map->N*sizeof(PetscScalar));CHKERRQ(ierr);
-
+  ierr = PetscViewerBinaryReadAllMPIIO(viewer,avec,vec->map->n,vec->map->rstart,vec->map->N,PETSC_SCALAR);CHKERRQ(ierr);
   ierr = VecRestoreArray(vec,&avec);CHKERRQ(ierr);
   ierr = VecAssemblyBegin(vec);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vec);CHKERRQ(ierr);